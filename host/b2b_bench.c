@@ -0,0 +1,212 @@
+/******************************************************************************
+* File Name:   b2b_bench.c
+*
+* Description: Back-to-back command benchmark. The master sends command
+*              packets with no gap while the slave application only gets to
+*              run CheckEzI2Cbuffer() once per poll period, and the benchmark
+*              reports how many of the commands the slave executed. Commands
+*              are lost when a new packet overwrites one that has not been
+*              parsed yet.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "I2CDataRate.h"
+#include "sim.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define OFF                     CYBSP_LED_STATE_OFF
+#define ON                      CYBSP_LED_STATE_ON
+
+#define DEFAULT_COMMANDS        (10000UL)
+
+/* Granularity of the simulated application work done while a transfer runs */
+#define APP_WORK_SLICE_NS       (1000ULL)
+
+/*******************************************************************************
+* Function Name: bench_period
+****************************************************************************//**
+*
+* Summary:
+*   Sends commands back to back with the slave polled every periodUs and
+*   prints one result row.
+*
+* Return:
+*   Number of commands the slave executed.
+*
+*******************************************************************************/
+static uint32_t bench_period(uint32_t commands, uint32_t periodUs, uint8_t *lastCmd)
+{
+    uint8_t packet[WRITE_PACKET_SIZE];
+    uint8_t cmd = ON;
+    uint32_t sent = 0U;
+    uint32_t executed;
+    uint32_t i;
+    uint64_t t0 = sim_now_ns();
+    uint64_t nextPoll = t0 + (periodUs * SIM_NS_PER_US);
+    uint64_t elapsed;
+    uint32_t gpioWrites = sim_get_stats()->gpioWrites;
+
+    for (i = 0U; i < commands; i++)
+    {
+        if (TRANSFER_PENDING == WritePacketToEzI2CAsync(&CYBSP_I2C_master, packet,
+                                                        PrepareCommandPacket(&CYBSP_I2C_master, packet, cmd), NULL))
+        {
+            while (TRANSFER_PENDING == GetMasterTransferStatus(&CYBSP_I2C_master))
+            {
+                sim_cpu_work_ns(APP_WORK_SLICE_NS);
+                if (sim_now_ns() >= nextPoll)
+                {
+                    CheckEzI2Cbuffer();
+                    nextPoll += periodUs * SIM_NS_PER_US;
+                }
+            }
+            if (TRANSFER_CMPLT == GetMasterTransferStatus(&CYBSP_I2C_master))
+            {
+                sent++;
+                *lastCmd = cmd;
+            }
+        }
+        cmd = (cmd == ON) ? OFF : ON;
+    }
+    elapsed = sim_now_ns() - t0;
+
+    /* Let the slave catch up with what is still buffered. */
+    CheckEzI2Cbuffer();
+    executed = sim_get_stats()->gpioWrites - gpioWrites;
+
+    printf("  %9lu  %10lu  %10lu  %7.1f%%  %12.0f\n",
+           (unsigned long)periodUs, (unsigned long)sent, (unsigned long)executed,
+           (sent > 0U) ? (100.0 * (sent - executed) / sent) : 0.0,
+           (elapsed > 0U) ? ((double)executed * SIM_NS_PER_SEC / elapsed) : 0.0);
+
+    return (sent == commands) ? executed : 0U;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: b2b_bench [-n commands] [-r data_rate_hz] [-p poll_period_us] [-c]
+*
+*   Without -p the slave poll period is swept.
+*   -c checks that no command was lost and exits non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static const uint32_t sweep[] = { 50U, 100U, 150U, 200U, 300U, 500U };
+    uint32_t commands = DEFAULT_COMMANDS;
+    uint32_t dataRate = SIM_DEFAULT_DATA_RATE_HZ;
+    uint32_t periodUs = 0U;
+    bool check = false;
+    bool ok = true;
+    uint8_t lastCmd = ON;
+    uint32_t i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:r:p:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': commands = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'r': dataRate = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'p': periodUs = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': check    = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n commands] [-r data_rate_hz] [-p poll_period_us] [-c]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if ((0U == commands) || (0U == dataRate))
+    {
+        fprintf(stderr, "commands and data rate must be non-zero\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Same bring-up sequence as main.c */
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initSlave()) || (I2C_SUCCESS != initMaster()))
+    {
+        fprintf(stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    dataRate = SwitchDataRate(dataRate);
+    if (0U == dataRate)
+    {
+        fprintf(stderr, "data rate not supported\n");
+        return EXIT_FAILURE;
+    }
+    __enable_irq();
+
+    printf("Back-to-back command host benchmark\n");
+    printf("  data rate          : %lu Hz\n", (unsigned long)dataRate);
+    printf("  commands per period: %lu\n", (unsigned long)commands);
+    printf("  %9s  %10s  %10s  %8s  %12s\n", "poll (us)", "sent", "executed", "lost", "executed/s");
+
+    if (0U != periodUs)
+    {
+        ok = (bench_period(commands, periodUs, &lastCmd) == commands);
+    }
+    else
+    {
+        for (i = 0U; i < (sizeof(sweep) / sizeof(sweep[0])); i++)
+        {
+            (void)bench_period(commands, sweep[i], &lastCmd);
+        }
+    }
+
+    if (check && (!ok || (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) != lastCmd)))
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,141 @@
+/******************************************************************************
+* File Name:   bench_util.c
+*
+* Description: Reporting helpers shared by the host benchmarks.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "bench_util.h"
+
+/*******************************************************************************
+* Function Name: bench_host_ns
+****************************************************************************//**
+*
+* Summary:
+*   Returns a monotonic host timestamp in nanoseconds.
+*
+*******************************************************************************/
+uint64_t bench_host_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * SIM_NS_PER_SEC) + (uint64_t)ts.tv_nsec;
+}
+
+/*******************************************************************************
+* Function Name: bench_print_rate
+****************************************************************************//**
+*
+* Summary:
+*   Prints the number of operations per second of virtual time.
+*
+*******************************************************************************/
+void bench_print_rate(const char *what, uint32_t count, uint64_t elapsedNs)
+{
+    printf("  virtual time       : %.6f s\n", (double)elapsedNs / SIM_NS_PER_SEC);
+    printf("  %-19s: %.1f\n", what, (0U != elapsedNs) ? ((double)count * SIM_NS_PER_SEC / elapsedNs) : 0.0);
+}
+
+static int bench_cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/*******************************************************************************
+* Function Name: bench_print_latency
+****************************************************************************//**
+*
+* Summary:
+*   Prints min/avg/p50/p99/max of a set of virtual-time samples. The samples
+*   are sorted in place.
+*
+*******************************************************************************/
+void bench_print_latency(const char *what, uint64_t *samplesNs, uint32_t count)
+{
+    uint64_t sum = 0U;
+    uint32_t i;
+
+    if (0U == count)
+    {
+        return;
+    }
+
+    for (i = 0U; i < count; i++)
+    {
+        sum += samplesNs[i];
+    }
+    qsort(samplesNs, count, sizeof(*samplesNs), bench_cmp_u64);
+
+    printf("  %-19s: min %.1f  avg %.1f  p50 %.1f  p99 %.1f  max %.1f us\n", what,
+           (double)samplesNs[0] / SIM_NS_PER_US,
+           (double)sum / count / SIM_NS_PER_US,
+           (double)samplesNs[count / 2U] / SIM_NS_PER_US,
+           (double)samplesNs[((uint64_t)count * 99U) / 100U] / SIM_NS_PER_US,
+           (double)samplesNs[count - 1U] / SIM_NS_PER_US);
+}
+
+/*******************************************************************************
+* Function Name: bench_print_bus
+****************************************************************************//**
+*
+* Summary:
+*   Prints bus utilization, clock stretching and wire counters.
+*
+*******************************************************************************/
+void bench_print_bus(sim_stats_t const *stats, uint64_t elapsedNs)
+{
+    printf("  bus utilization    : %.1f %%\n",
+           (0U != elapsedNs) ? (100.0 * (double)stats->busActiveNs / elapsedNs) : 0.0);
+    printf("  clock stretching   : %.1f us total\n", (double)stats->stretchNs / SIM_NS_PER_US);
+    printf("  wire               : %lu START, %lu ReSTART, %lu STOP, %lu bytes, %lu NAK\n",
+           (unsigned long)stats->starts, (unsigned long)stats->restarts, (unsigned long)stats->stops,
+           (unsigned long)stats->bytes, (unsigned long)stats->naks);
+    printf("  CPU in delay loops : %.1f %%\n",
+           (0U != elapsedNs) ? (100.0 * (double)stats->cpuDelayNs / elapsedNs) : 0.0);
+    printf("  CPU free for app   : %.1f %%\n",
+           (0U != elapsedNs) ? (100.0 * (double)stats->cpuWorkNs / elapsedNs) : 0.0);
+}
+
+/* [] END OF FILE */
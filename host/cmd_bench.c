@@ -0,0 +1,271 @@
+/******************************************************************************
+* File Name:   cmd_bench.c
+*
+* Description: Command set benchmark. Sends every opcode of the command set
+*              to the EZI2C slave, checks the status and the result the
+*              handler published after the reply, including the rejection
+*              of unknown opcodes, wrong operand counts and operands out of
+*              range, and prints the slave cost of each command: dispatch
+*              goes through a table indexed by opcode, so the cost of a
+*              command does not depend on its opcode.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "I2CTuning.h"
+#include "sim.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DEFAULT_ITERATIONS      (2000UL)
+
+/* Result not checked */
+#define ANY_RESULT              (0xFFFFFFFFUL)
+
+/* Address of a second slave whose packets are only prepared */
+#define OTHER_SLAVE_ADDR        (I2C_TUNING_SLAVE_ADDR + 2U)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* One command of the sequence and what the slave must report for it */
+typedef struct
+{
+    char const* name;
+    uint8_t     opcode;
+    uint8_t     operands[CMD_OPERANDS_MAX];
+    uint32_t    count;
+    uint8_t     status;     /* STS_CMD_* */
+    uint32_t    result;     /* ANY_RESULT if not checked */
+} bench_cmd_t;
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Every opcode, in an order that makes each result predictable, then the
+ * commands the dispatcher must reject
+ */
+static const bench_cmd_t sequence[] =
+{
+    { "ping",               CMD_OP_PING,          { 0xA5U },             1U, STS_CMD_DONE,    0xA5UL },
+    { "led on",             CMD_OP_LED,           { CYBSP_LED_STATE_ON },  1U, STS_CMD_DONE,  0UL },
+    { "gpio read led",      CMD_OP_GPIO_READ,     { CMD_GPIO_LED1 },     1U, STS_CMD_DONE,    CYBSP_LED_STATE_ON },
+    { "gpio write led",     CMD_OP_GPIO_WRITE,    { CMD_GPIO_LED1, CYBSP_LED_STATE_OFF }, 2U, STS_CMD_DONE, 0UL },
+    { "gpio read led",      CMD_OP_GPIO_READ,     { CMD_GPIO_LED1 },     1U, STS_CMD_DONE,    CYBSP_LED_STATE_OFF },
+    { "reg write r3",       CMD_OP_REG_WRITE,     { 3U, 0x34U, 0x12U },  3U, STS_CMD_DONE,    0UL },
+    { "reg read r3",        CMD_OP_REG_READ,      { 3U },                1U, STS_CMD_DONE,    0x1234UL },
+    { "reg read r0",        CMD_OP_REG_READ,      { 0U },                1U, STS_CMD_DONE,    0UL },
+    { "counter clear cmds", CMD_OP_COUNTER_CLEAR, { CMD_COUNTER_COMMANDS }, 1U, STS_CMD_DONE, 0UL },
+    { "ping",               CMD_OP_PING,          { 0x5AU },             1U, STS_CMD_DONE,    0x5AUL },
+    { "counter read cmds",  CMD_OP_COUNTER_READ,  { CMD_COUNTER_COMMANDS }, 1U, STS_CMD_DONE, 2UL },
+    { "counter read errs",  CMD_OP_COUNTER_READ,  { CMD_COUNTER_BUS_ERRORS }, 1U, STS_CMD_DONE, 0UL },
+    { "stream open",        CMD_OP_STREAM_OPEN,   { 7U, 0x10U, 0x00U },  3U, STS_CMD_DONE,    0UL },
+    { "unknown opcode",     CMD_OP_COUNT,         { 0U },                1U, STS_CMD_BAD_OP,  ANY_RESULT },
+    { "opcode 0xFF",        0xFFU,                { 0U },                0U, STS_CMD_BAD_OP,  ANY_RESULT },
+    { "ping, 2 operands",   CMD_OP_PING,          { 1U, 2U },            2U, STS_CMD_BAD_OP,  ANY_RESULT },
+    { "reg read r8",        CMD_OP_REG_READ,      { CMD_REG_COUNT },     1U, STS_CMD_BAD_ARG, ANY_RESULT },
+    { "gpio write pin 1",   CMD_OP_GPIO_WRITE,    { CMD_GPIO_COUNT, 0U }, 2U, STS_CMD_BAD_ARG, ANY_RESULT },
+    { "counter read 4",     CMD_OP_COUNTER_READ,  { CMD_COUNTER_COUNT }, 1U, STS_CMD_BAD_ARG, ANY_RESULT },
+};
+
+/*******************************************************************************
+* Function Name: send
+****************************************************************************//**
+*
+* Summary:
+*   Writes one command, lets the slave execute it and reads the status and
+*   the result.
+*
+* Parameters:
+*   cmd: Command to send
+*   slaveNs: Incremented by the host time of the slave pass
+*   result: Set to the result of the command
+*
+* Return:
+*   STS_CMD_* reported by the slave, or STS_CMD_FAIL if a transfer failed.
+*
+*******************************************************************************/
+static uint8_t send(bench_cmd_t const *cmd, uint64_t *slaveNs, uint32_t *result)
+{
+    uint8_t packet[WRITE_PACKET_SIZE];
+    uint32_t size = PrepareOpcodePacket(&CYBSP_I2C_master, packet, cmd->opcode, cmd->operands, cmd->count);
+    uint8_t const *reply;
+    uint64_t t0;
+
+    if ((0U == size) || (TRANSFER_CMPLT != WritePacketToEzI2C(&CYBSP_I2C_master, packet, size)))
+    {
+        return (STS_CMD_FAIL);
+    }
+
+    t0 = bench_host_ns();
+    CheckEzI2Cbuffer();
+    *slaveNs += bench_host_ns() - t0;
+
+    /* A rejected command fails the read too; the status byte tells why. */
+    (void)ReadCommandResult(&CYBSP_I2C_master, result);
+    reply = &CYBSP_I2C_master.rxBuffer[MASTER_RX_POS(EZI2C_RPLY_SOP_POS)];
+    if ((PACKET_SOP != PROTO_GET(proto_reply_t, sop, reply)) ||
+        (packet[PACKET_SEQ_POS] != PROTO_GET(proto_reply_t, seq, reply)))
+    {
+        return (STS_CMD_FAIL);
+    }
+
+    return ((uint8_t)PROTO_GET(proto_reply_t, sts, reply));
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: cmd_bench [-n iterations] [-c]
+*
+*   Runs the command sequence -n times. -c checks that every command
+*   reported the expected status and result, and exits non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t const count = sizeof(sequence) / sizeof(sequence[0]);
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    bool check = false;
+    uint64_t slaveNs[sizeof(sequence) / sizeof(sequence[0])] = { 0U };
+    uint32_t mismatches[sizeof(sequence) / sizeof(sequence[0])] = { 0U };
+    uint8_t scratch[WRITE_PACKET_SIZE];
+    uint32_t result = 0U;
+    uint32_t errors = 0U;
+    uint8_t otherStatus;
+    uint8_t status;
+    double minNs = 0.0;
+    double maxNs = 0.0;
+    double ns;
+    uint32_t n;
+    uint32_t i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': iterations = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': check      = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n iterations] [-c]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (0U == iterations)
+    {
+        fprintf(stderr, "iterations must be non-zero\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Same bring-up sequence as main.c */
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initSlave()) || (I2C_SUCCESS != initMaster()))
+    {
+        fprintf(stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    __enable_irq();
+
+    for (n = 0U; n < iterations; n++)
+    {
+        for (i = 0U; i < count; i++)
+        {
+            status = send(&sequence[i], &slaveNs[i], &result);
+            if ((status != sequence[i].status) ||
+                ((STS_CMD_DONE == status) && (ANY_RESULT != sequence[i].result) && (result != sequence[i].result)))
+            {
+                mismatches[i]++;
+                errors++;
+            }
+        }
+    }
+
+    /* Packets prepared for another slave must not advance the sequence of
+     * this one: 255 of them on a shared counter make the next ping repeat the
+     * last sequence number, which the slave drops as a duplicate.
+     */
+    otherStatus = STS_CMD_FAIL;
+    if (TRANSFER_CMPLT == SelectEzI2CSlave(&CYBSP_I2C_master, OTHER_SLAVE_ADDR))
+    {
+        for (i = 0U; i < 255U; i++)
+        {
+            (void)PrepareOpcodePacket(&CYBSP_I2C_master, scratch, sequence[0].opcode,
+                                      sequence[0].operands, sequence[0].count);
+        }
+        if (TRANSFER_CMPLT == SelectEzI2CSlave(&CYBSP_I2C_master, I2C_TUNING_SLAVE_ADDR))
+        {
+            otherStatus = send(&sequence[0], &slaveNs[0], &result);
+        }
+    }
+
+    printf("Command set host benchmark (%lu opcodes, %lu passes)\n",
+           (unsigned long)CMD_OP_COUNT, (unsigned long)iterations);
+    printf("  %-20s %6s  %-8s  %12s  %10s\n", "command", "opcode", "status", "slave (ns)", "mismatches");
+    for (i = 0U; i < count; i++)
+    {
+        ns = (double)slaveNs[i] / iterations;
+        printf("  %-20s  0x%02X   0x%02X      %12.1f  %10lu\n", sequence[i].name, sequence[i].opcode,
+               sequence[i].status, ns, (unsigned long)mismatches[i]);
+        minNs = ((0U == i) || (ns < minNs)) ? ns : minNs;
+        maxNs = ((0U == i) || (ns > maxNs)) ? ns : maxNs;
+    }
+    printf("  slave pass         : %.1f to %.1f ns per command\n", minNs, maxNs);
+    printf("  register 3         : 0x%04lX (GetSlaveRegister)\n", (unsigned long)GetSlaveRegister(3U));
+    printf("  ping after switch  : 0x%02X (another slave selected in between)\n", otherStatus);
+
+    if (check && ((0U != errors) || (0x1234UL != GetSlaveRegister(3U)) || (STS_CMD_DONE != otherStatus)))
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
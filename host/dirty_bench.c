@@ -0,0 +1,283 @@
+/******************************************************************************
+* File Name:   dirty_bench.c
+*
+* Description: Dirty tracking benchmark. Writes to different regions of the
+*              EZI2C slave buffer and prints the host time of the slave
+*              pass for each, which follows the bytes written rather than
+*              the buffer size. It then plants valid frames in regions a
+*              write does not touch and checks that the slave leaves them
+*              alone.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "sim.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define OFF                     CYBSP_LED_STATE_OFF
+#define ON                      CYBSP_LED_STATE_ON
+
+#define DEFAULT_ITERATIONS      (2000UL)
+
+/* Ring batches timed */
+#define RING_SMALL_BATCH        (4UL)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* EZI2C buffers of the slave (I2CSlave.c) */
+extern uint8_t buffer[2][EZI2C_BUFFER_SIZE];
+
+static uint8_t writeBuffer[MASTER_TX_SIZE];
+static uint8_t commands[COMMAND_RING_MAX_BATCH];
+static uint8_t cmd = ON;
+
+/*******************************************************************************
+* Function Name: slave_pass
+****************************************************************************//**
+*
+* Summary:
+*   Runs the slave main loop once and returns its host time.
+*
+*******************************************************************************/
+static uint64_t slave_pass(void)
+{
+    uint64_t t0 = bench_host_ns();
+
+    CheckEzI2Cbuffer();
+    return (bench_host_ns() - t0);
+}
+
+/*******************************************************************************
+* Function Name: write_result_byte
+****************************************************************************//**
+*
+* Summary:
+*   Writes one byte into the result field of the slave buffer, a write that
+*   carries no frame.
+*
+*******************************************************************************/
+static uint32_t write_result_byte(void)
+{
+    writeBuffer[PACKET_ADDR_POS] = (uint8_t)EZI2C_RESULT_POS;
+    writeBuffer[1] = 0U;
+    return ((TRANSFER_CMPLT == WritePacketToEzI2C(&CYBSP_I2C_master, writeBuffer, 2U)) ? 1U : 0U);
+}
+
+/*******************************************************************************
+* Function Name: write_command
+****************************************************************************//**
+*
+* Summary:
+*   Writes one LED command frame to the command frame area.
+*
+*******************************************************************************/
+static uint32_t write_command(void)
+{
+    uint32_t size;
+
+    cmd  = (cmd == ON) ? OFF : ON;
+    size = PrepareCommandPacket(&CYBSP_I2C_master, writeBuffer, cmd);
+    return ((TRANSFER_CMPLT == WritePacketToEzI2C(&CYBSP_I2C_master, writeBuffer, size)) ? (size - 1U) : 0U);
+}
+
+/*******************************************************************************
+* Function Name: write_ring
+****************************************************************************//**
+*
+* Summary:
+*   Queues a batch of count LED commands in the command ring.
+*
+*******************************************************************************/
+static uint32_t write_ring(uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0U; i < count; i++)
+    {
+        cmd = (cmd == ON) ? OFF : ON;
+        commands[i] = cmd;
+    }
+    return ((TRANSFER_CMPLT == PushCommandsToEzI2C(&CYBSP_I2C_master, commands, count)) ?
+            (count * EZI2C_RING_SLOT_SIZE) : 0U);
+}
+
+static uint32_t write_ring_one(void)   { return write_ring(1U); }
+static uint32_t write_ring_small(void) { return write_ring(RING_SMALL_BATCH); }
+static uint32_t write_ring_full(void)  { return write_ring(COMMAND_RING_MAX_BATCH); }
+
+/*******************************************************************************
+* Function Name: plant_frames
+****************************************************************************//**
+*
+* Summary:
+*   Puts a valid LED command frame into the command frame area and into the
+*   next ring slot of both slave buffers, as stale data a write leaves
+*   behind would look.
+*
+*******************************************************************************/
+static void plant_frames(uint8_t state, uint32_t ringTail)
+{
+    uint8_t payload[COMMAND_PAYLOAD_SIZE];
+    uint32_t i;
+
+    payload[PROTO_OFS(proto_command_t, opcode)] = (uint8_t)CMD_OP_LED;
+    payload[PROTO_OFS(proto_command_t, operands)] = state;
+    for (i = 0U; i < 2U; i++)
+    {
+        (void)BuildFrame(&buffer[i][EZI2C_CMD_FRAME_POS], 0x80U, payload, sizeof(payload));
+        (void)BuildFrame(&buffer[i][EZI2C_RING_BASE_POS + (ringTail * EZI2C_RING_SLOT_SIZE)], 0x81U,
+                         payload, sizeof(payload));
+    }
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: dirty_bench [-n iterations] [-c]
+*
+*   -c checks that every write went through, that the slave executed every
+*   command written, and that frames in regions no write touched stayed
+*   unexecuted, and exits non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static const struct
+    {
+        char const* name;
+        uint32_t (*write)(void);
+    } cases[] =
+    {
+        { "result byte, no frame",  write_result_byte },
+        { "command frame",          write_command },
+        { "ring, 1 command",        write_ring_one },
+        { "ring, 4 commands",       write_ring_small },
+        { "ring, 15 commands",      write_ring_full },
+    };
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    bool check = false;
+    bool ok = true;
+    uint8_t tlm[TLM_SIZE];
+    uint32_t tail;
+    uint32_t bytes;
+    uint64_t ns;
+    uint32_t n;
+    uint32_t i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': iterations = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': check      = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n iterations] [-c]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (0U == iterations)
+    {
+        fprintf(stderr, "iterations must be non-zero\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Same bring-up sequence as main.c */
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initSlave()) || (I2C_SUCCESS != initMaster()))
+    {
+        fprintf(stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    __enable_irq();
+
+    printf("EZI2C dirty tracking host benchmark (%lu-byte buffer, %lu writes per case)\n",
+           (unsigned long)EZI2C_BUFFER_SIZE, (unsigned long)iterations);
+    printf("  %-24s %6s  %12s  %10s\n", "write", "bytes", "slave (ns)", "ns/byte");
+    for (i = 0U; i < (sizeof(cases) / sizeof(cases[0])); i++)
+    {
+        bytes = 0U;
+        ns    = 0U;
+        for (n = 0U; n < iterations; n++)
+        {
+            uint32_t written = cases[i].write();
+
+            ok = (0U != written) && ok;
+            bytes += written;
+            ns    += slave_pass();
+        }
+        printf("  %-24s %6lu  %12.1f  %10.2f\n", cases[i].name, (unsigned long)(bytes / iterations),
+               (double)ns / iterations, (0U != bytes) ? ((double)ns / bytes) : 0.0);
+    }
+    ok = (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) == cmd) && ok;
+
+    /* Stale frames outside the bytes written must not run. */
+    ok = (TRANSFER_CMPLT == ReadCommandRingStatus(&CYBSP_I2C_master)) && ok;
+    tail = CYBSP_I2C_master.rxBuffer[MASTER_RX_POS(EZI2C_RING_TAIL_POS)];
+    plant_frames((cmd == ON) ? OFF : ON, tail);
+    ok = (0U != write_result_byte()) && ok;
+    (void)slave_pass();
+    ok = (READ_CMPLT == ReadTelemetryFromEzI2C(&CYBSP_I2C_master, (uint8_t)TLM_SEQ_POS, tlm, TLM_SIZE)) && ok;
+    printf("  stale frames           : LED %s, last status 0x%02X\n",
+           (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) == cmd) ? "unchanged" : "CHANGED",
+           tlm[TLM_LAST_STS_POS]);
+    ok = (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) == cmd) &&
+         (STS_CMD_FAIL == tlm[TLM_LAST_STS_POS]) && ok;
+
+    if (check && !ok)
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
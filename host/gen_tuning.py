@@ -0,0 +1,327 @@
+#!/usr/bin/env python3
+################################################################################
+# \file gen_tuning.py
+# \version 1.0
+#
+# \brief
+# Generates the i2c_tuning.h header of a target from its design.modus: the
+# slave addresses, data rate and sub-address size of the CYBSP_I2C master and
+# the CYBSP_EZI2C slave, the fastest data rate the part supports, and the
+# largest stream payload its SRAM affords, which
+# source/I2CTuning.h feeds to the firmware. The header is written next to
+# design.modus, so it travels with the BSP.
+#
+#   gen_tuning.py                 -- regenerate every templates/TARGET_*
+#   gen_tuning.py design.modus    -- regenerate the given targets
+#   gen_tuning.py --check [...]   -- fail if a header is missing or stale
+#
+################################################################################
+# \copyright
+# Copyright 2018-2025, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import argparse
+import glob
+import os
+import sys
+import xml.etree.ElementTree as ET
+
+HEADER_NAME = "i2c_tuning.h"
+
+# Aliases of the blocks the example uses
+MASTER_ALIAS = "CYBSP_I2C"
+SLAVE_ALIAS = "CYBSP_EZI2C"
+MASTER_CLK_ALIAS = "CYBSP_I2C_CLK_DIV"
+SLAVE_CLK_ALIAS = "CYBSP_EZI2C_CLK_DIV"
+
+# Entries of the SCB FIFOs of PSoC 4 (CY_SCB_FIFO_SIZE)
+SCB_FIFO_DEPTH = 8
+
+# A byte on the wire: 8 data bits and ACK
+BITS_PER_BYTE = 9
+
+# Fractional dividers count in 1/32
+FRAC_DIVIDER_STEPS = 32
+
+# I2C bus speeds
+RATE_FAST_HZ = 400000
+RATE_FAST_PLUS_HZ = 1000000
+
+# Lowest SCB clocks of Fast-mode Plus (master, EZI2C slave) and the highest
+# master clock, as in the rate classes of source/I2CDataRate.c
+FAST_PLUS_MASTER_CLK_HZ = (14320000, 25800000)
+FAST_PLUS_SLAVE_CLK_MIN_HZ = 15840000
+
+# Parts whose I2C pins lack the 20 mA sink of Fast-mode Plus, by MPN prefix
+NO_FAST_PLUS_PARTS = (
+    "CY8C40",   # PSOC 4000S, PSOC 4000T
+)
+
+# SRAM of a PSOC 4 part by the flash size digit of its MPN (CY8C4xx5 has
+# 32 KB of flash and 4 KB of SRAM, and so on)
+SRAM_BYTES = {
+    "5": 4096,
+    "6": 8192,
+    "7": 16384,
+    "8": 32768,
+    "9": 32768,
+}
+MPN_FLASH_DIGIT = 7
+
+# The EZI2C slave buffers a whole stream payload; it may take at most this
+# share of the SRAM, and never more than the protocol limit
+STREAM_SRAM_SHARE = 16
+STREAM_MAX_SIZE = 1024
+
+SUB_ADDR_BYTES = {
+    "CY_SCB_EZI2C_SUB_ADDR8_BITS": 1,
+    "CY_SCB_EZI2C_SUB_ADDR16_BITS": 2,
+}
+
+EZI2C_ADDRESSES = {
+    "CY_SCB_EZI2C_ONE_ADDRESS": 1,
+    "CY_SCB_EZI2C_TWO_ADDRESSES": 2,
+}
+
+
+class ModusError(Exception):
+    """design.modus lacks a setting the example needs."""
+
+
+def local(tag):
+    """Returns an element tag without its XML namespace."""
+    return tag.rsplit("}", 1)[-1]
+
+
+def personalities(root):
+    """Yields (block, aliases, parameters) of every configured block.
+
+    design.modus comes in two layouts: older files nest the personality in the
+    block, newer ones nest the block in the personality.
+    """
+    for node in root.iter():
+        if local(node.tag) == "Block":
+            personality = [child for child in node if local(child.tag) == "Personality"]
+            if personality:
+                yield (node,
+                       [child.get("value") for child in node if local(child.tag) == "Alias"],
+                       {param.get("id"): param.get("value")
+                        for param in personality[0] if local(param.tag) == "Param"})
+        elif local(node.tag) == "Personality":
+            block = [child for child in node if local(child.tag) == "Block"]
+            if block:
+                yield (block[0],
+                       [alias.get("value") for alias in block[0].iter() if local(alias.tag) == "Alias"],
+                       {param.get("id"): param.get("value")
+                        for param in node.iter() if local(param.tag) == "Param"})
+
+
+def find_block(root, alias):
+    """Returns the parameters of the block with an alias."""
+    for _, aliases, params in personalities(root):
+        if alias in aliases:
+            return params
+    raise ModusError("no block with alias %s" % alias)
+
+
+def find_location(root, location):
+    """Returns the parameters of the block at a location."""
+    for block, _, params in personalities(root):
+        if block.get("location") == location:
+            return params
+    raise ModusError("no block at %s" % location)
+
+
+def find_hfclk(root):
+    """Returns the HFCLK frequency in Hz."""
+    hfclk = find_location(root, "srss[0].clock[0].hfclk[0]")
+    if hfclk.get("sourceClock") != "IMO":
+        raise ModusError("HFCLK is not sourced from the IMO")
+    imo = find_location(root, "srss[0].clock[0].imo[0]")
+    return int(float(param(imo, "frequency", "IMO"))) // int(hfclk.get("divider", "1"))
+
+
+def find_mpn(root):
+    """Returns the part number of the device."""
+    for node in root.iter():
+        if (local(node.tag) == "Device") and node.get("mpn"):
+            return node.get("mpn")
+    raise ModusError("no device part number")
+
+
+def max_rate_hz(mpn, hfclk_hz):
+    """Returns the fastest data rate of the part: Fast-mode Plus when its pins
+    sink 20 mA and HFCLK divides into the SCB clock range of 1 MHz, as
+    GetScbClockDivider() picks it, else Fast-mode.
+    """
+    if mpn.startswith(NO_FAST_PLUS_PARTS):
+        return RATE_FAST_HZ
+    master_clk_hz = hfclk_hz / (hfclk_hz // FAST_PLUS_MASTER_CLK_HZ[0])
+    if (hfclk_hz < FAST_PLUS_SLAVE_CLK_MIN_HZ) or (master_clk_hz > FAST_PLUS_MASTER_CLK_HZ[1]):
+        return RATE_FAST_HZ
+    return RATE_FAST_PLUS_HZ
+
+
+def stream_max_size(mpn):
+    """Returns the largest stream payload the slave buffers on the part."""
+    sram = SRAM_BYTES.get(mpn[MPN_FLASH_DIGIT:MPN_FLASH_DIGIT + 1])
+    if sram is None:
+        raise ModusError("unknown SRAM size of %s" % mpn)
+    return min(STREAM_MAX_SIZE, sram // STREAM_SRAM_SHARE)
+
+
+def param(params, name, alias):
+    """Returns a parameter of a block, which must be set."""
+    if name not in params:
+        raise ModusError("%s has no %s" % (alias, name))
+    return params[name]
+
+
+def scb_clock_hz(params, alias, hfclk_hz):
+    """Returns the output of a peripheral clock divider."""
+    divider = int(param(params, "intDivider", alias)) + \
+        (int(params.get("fracDivider", "0")) / FRAC_DIVIDER_STEPS)
+    return hfclk_hz / divider
+
+
+def read_tuning(path):
+    """Parses a design.modus into the values of the tuning header."""
+    root = ET.parse(path).getroot()
+    master = find_block(root, MASTER_ALIAS)
+    slave = find_block(root, SLAVE_ALIAS)
+    hfclk_hz = find_hfclk(root)
+
+    if param(master, "ModeUser", MASTER_ALIAS) != "CY_SCB_I2C_MASTER":
+        raise ModusError("%s is not an I2C master" % MASTER_ALIAS)
+
+    addresses = EZI2C_ADDRESSES.get(param(slave, "NumOfAddr", SLAVE_ALIAS))
+    sub_addr = SUB_ADDR_BYTES.get(param(slave, "SubAddrSize", SLAVE_ALIAS))
+    if (addresses is None) or (sub_addr is None):
+        raise ModusError("%s has an unknown address setting" % SLAVE_ALIAS)
+
+    tuning = {
+        "master_rate_hz": int(param(master, "DataRate", MASTER_ALIAS)) * 1000,
+        "slave_rate_hz": int(param(slave, "DataRate", SLAVE_ALIAS)) * 1000,
+        "slave_addr": int(param(slave, "SlaveAddress1", SLAVE_ALIAS), 0),
+        "telemetry_addr": int(slave.get("SlaveAddress2", "0"), 0),
+        "addresses": addresses,
+        "sub_addr_bytes": sub_addr,
+        "fifo_depth": SCB_FIFO_DEPTH if ((master.get("EnableTxFifo") == "true") and
+                                         (master.get("EnableRxFifo") == "true")) else 1,
+        "master_clk_hz": scb_clock_hz(find_block(root, MASTER_CLK_ALIAS), MASTER_CLK_ALIAS, hfclk_hz),
+        "slave_clk_hz": scb_clock_hz(find_block(root, SLAVE_CLK_ALIAS), SLAVE_CLK_ALIAS, hfclk_hz),
+        "max_rate_hz": max_rate_hz(find_mpn(root), hfclk_hz),
+        "stream_max_size": stream_max_size(find_mpn(root)),
+    }
+
+    # A slave clocked for a lower rate than the master misses its address
+    if tuning["slave_rate_hz"] < tuning["master_rate_hz"]:
+        raise ModusError("%s runs at %d Hz, below the %d Hz of %s" %
+                         (SLAVE_ALIAS, tuning["slave_rate_hz"], tuning["master_rate_hz"], MASTER_ALIAS))
+    if tuning["master_rate_hz"] > tuning["max_rate_hz"]:
+        raise ModusError("%s runs at %d Hz, above the %d Hz the part supports" %
+                         (MASTER_ALIAS, tuning["master_rate_hz"], tuning["max_rate_hz"]))
+    if addresses == 1:
+        tuning["telemetry_addr"] = tuning["slave_addr"]
+
+    return tuning
+
+
+def render(path, tuning):
+    """Returns the text of the tuning header of a target."""
+    target = os.path.basename(os.path.dirname(os.path.dirname(os.path.abspath(path))))
+    byte_ns = -(-BITS_PER_BYTE * 1000000000 // tuning["master_rate_hz"])
+    fifo_window_us = (byte_ns * tuning["fifo_depth"]) / 1000.0
+
+    return """\
+/******************************************************************************
+* File Name:   {name}
+*
+* Description: Bus configuration generated by host/gen_tuning.py from the
+*              design.modus of {target}. Do not edit; run
+*              the generator again after changing the CYBSP_I2C or
+*              CYBSP_EZI2C settings.
+*
+*              Timing at the master data rate:
+*                byte on the wire         : {byte_us:.1f} us
+*                bytes per master ISR     : {fifo_depth} ({fifo_state})
+*                master ISR latency budget: {fifo_window_us:.1f} us
+*                master SCB clock         : {master_clk_mhz:.3f} MHz
+*                EZI2C SCB clock          : {slave_clk_mhz:.3f} MHz
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+
+#ifndef I2C_TUNING_H_
+#define I2C_TUNING_H_
+
+#define I2C_TUNING_MASTER_DATA_RATE_HZ  ({master_rate_hz}UL)
+#define I2C_TUNING_MAX_DATA_RATE_HZ     ({max_rate_hz}UL)
+#define I2C_TUNING_SLAVE_ADDR           (0x{slave_addr:02X}U)
+#define I2C_TUNING_TELEMETRY_ADDR       (0x{telemetry_addr:02X}U)
+#define I2C_TUNING_EZI2C_ADDRESSES      ({addresses}UL)
+#define I2C_TUNING_SUB_ADDR_BYTES       ({sub_addr_bytes}UL)
+#define I2C_TUNING_STREAM_MAX_SIZE      ({stream_max_size}UL)
+
+#endif /* I2C_TUNING_H_ */
+""".format(name=HEADER_NAME, target=target,
+           byte_us=byte_ns / 1000.0,
+           fifo_state="FIFOs enabled" if tuning["fifo_depth"] > 1 else "FIFOs disabled",
+           fifo_window_us=fifo_window_us,
+           master_clk_mhz=tuning["master_clk_hz"] / 1e6,
+           slave_clk_mhz=tuning["slave_clk_hz"] / 1e6,
+           **tuning)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate i2c_tuning.h from design.modus.")
+    parser.add_argument("--check", action="store_true",
+                        help="fail if a header is missing or differs from design.modus")
+    parser.add_argument("modus", nargs="*",
+                        help="design.modus files (default: every templates/TARGET_*)")
+    args = parser.parse_args()
+
+    paths = args.modus
+    if not paths:
+        repo = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+        paths = sorted(glob.glob(os.path.join(repo, "templates", "TARGET_*", "config", "design.modus")))
+
+    failed = False
+    for path in paths:
+        out = os.path.join(os.path.dirname(path), HEADER_NAME)
+        try:
+            text = render(path, read_tuning(path))
+        except (ModusError, ET.ParseError, ValueError) as err:
+            print("%s: %s" % (path, err), file=sys.stderr)
+            failed = True
+            continue
+
+        if args.check:
+            current = open(out).read() if os.path.exists(out) else None
+            if current != text:
+                print("%s: out of date, run host/gen_tuning.py" % out, file=sys.stderr)
+                failed = True
+        else:
+            with open(out, "w") as header:
+                header.write(text)
+            print(out)
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
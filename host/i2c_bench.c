@@ -0,0 +1,441 @@
+/******************************************************************************
+* File Name:   i2c_bench.c
+*
+* Description: Host benchmark for the I2C master / EZI2C slave code example.
+*              Runs the serial command loop (write command packet, check
+*              the EZI2C buffer, read status packet) against the simulated
+*              bus and reports command throughput and per-command latency in
+*              virtual bus time, plus the host CPU cost per command. The
+*              master transfers can be recorded to a log for replay_bench.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "I2CDataRate.h"
+#include "sim.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define OFF                     CYBSP_LED_STATE_OFF
+#define ON                      CYBSP_LED_STATE_ON
+
+#define DEFAULT_COMMANDS        (10000UL)
+
+/* Granularity of the simulated application work done while a transfer runs */
+#define APP_WORK_SLICE_NS       (1000ULL)
+
+/* Times a command is sent before the bench gives up on it */
+#define MAX_SENDS               (3UL)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static volatile uint32_t callbacks;
+static uint32_t asyncTransfers = 0U;
+static FILE *recordFile = NULL;
+
+/*******************************************************************************
+* Function Name: bench_record
+****************************************************************************//**
+*
+* Summary:
+*   Sink of the master transfer recorder: appends to the log file.
+*
+*******************************************************************************/
+static void bench_record(uint8_t const *data, uint32_t size)
+{
+    (void)fwrite(data, 1U, size, recordFile);
+}
+
+/*******************************************************************************
+* Function Name: bench_counter
+****************************************************************************//**
+*
+* Summary:
+*   Decodes a little-endian 32-bit counter of the telemetry window.
+*
+*******************************************************************************/
+static uint32_t bench_counter(uint8_t const *tlm, uint32_t pos)
+{
+    return (uint32_t)tlm[pos] | ((uint32_t)tlm[pos + 1U] << 8U) |
+           ((uint32_t)tlm[pos + 2U] << 16U) | ((uint32_t)tlm[pos + 3U] << 24U);
+}
+
+/*******************************************************************************
+* Function Name: bench_on_complete
+****************************************************************************//**
+*
+* Summary:
+*   Completion callback of the asynchronous master transfers.
+*
+*******************************************************************************/
+static void bench_on_complete(uint8_t status)
+{
+    CY_UNUSED_PARAMETER(status);
+    callbacks++;
+}
+
+/*******************************************************************************
+* Function Name: bench_run_async
+****************************************************************************//**
+*
+* Summary:
+*   Waits for a started asynchronous transfer while doing application work in
+*   slices, then returns its status.
+*
+*******************************************************************************/
+static uint8_t bench_run_async(uint8_t startStatus)
+{
+    asyncTransfers++;
+    if (TRANSFER_PENDING != startStatus)
+    {
+        return startStatus;
+    }
+    while (TRANSFER_PENDING == GetMasterTransferStatus(&CYBSP_I2C_master))
+    {
+        sim_cpu_work_ns(APP_WORK_SLICE_NS);
+    }
+    return GetMasterTransferStatus(&CYBSP_I2C_master);
+}
+
+/*******************************************************************************
+* Function Name: bench_command
+****************************************************************************//**
+*
+* Summary:
+*   Sends one command, runs the slave main loop once and reads the status
+*   packet of the command.
+*
+* Return:
+*   TRANSFER_ERROR if the command was not delivered, TRANSFER_CMPLT if the
+*   slave acknowledged it, TRANSFER_STS_FAIL if the slave rejected it or
+*   has not acknowledged it.
+*
+*******************************************************************************/
+static uint8_t bench_command(uint8_t *buffer, uint32_t size, bool async)
+{
+    uint8_t status;
+
+    status = async ? bench_run_async(WritePacketToEzI2CAsync(&CYBSP_I2C_master, buffer, size,
+                                                             &bench_on_complete)) :
+                     WritePacketToEzI2C(&CYBSP_I2C_master, buffer, size);
+    if (TRANSFER_CMPLT != status)
+    {
+        return TRANSFER_ERROR;
+    }
+
+    CheckEzI2Cbuffer();
+    status = async ? bench_run_async(ReadStatusPacketFromEzI2CAsync(&CYBSP_I2C_master, &bench_on_complete)) :
+                     ReadStatusPacketFromEzI2C(&CYBSP_I2C_master);
+    return (TRANSFER_CMPLT == status) ? TRANSFER_CMPLT : TRANSFER_STS_FAIL;
+}
+
+/*******************************************************************************
+* Function Name: bench_combined
+****************************************************************************//**
+*
+* Summary:
+*   Sends one command in a status + command transaction, which acknowledges
+*   the command before, then runs the slave main loop once. When the slave
+*   rejected the command before, its intact packet is written again, with
+*   the same sequence number, and the transaction is repeated.
+*
+* Return:
+*   TRANSFER_CMPLT if the command before was acknowledged and this one was
+*   written, TRANSFER_ERROR otherwise.
+*
+*******************************************************************************/
+static uint8_t bench_combined(uint8_t *frame, uint8_t const *intact, uint32_t size, bool async, uint32_t *resent)
+{
+    static uint8_t before[WRITE_PACKET_SIZE];
+    static uint32_t beforeSize = 0U;
+    uint8_t status = TRANSFER_ERROR;
+    uint32_t sends;
+
+    for (sends = 0U; sends < MAX_SENDS; sends++)
+    {
+        status = async ? bench_run_async(WriteCommandReadStatusAsync(&CYBSP_I2C_master, frame, size,
+                                                                     &bench_on_complete)) :
+                         WriteCommandReadStatus(&CYBSP_I2C_master, frame, size);
+        CheckEzI2Cbuffer();
+        if (TRANSFER_STS_FAIL != status)
+        {
+            break;
+        }
+        (void)(async ? bench_run_async(WritePacketToEzI2CAsync(&CYBSP_I2C_master, before, beforeSize,
+                                                               &bench_on_complete)) :
+                       WritePacketToEzI2C(&CYBSP_I2C_master, before, beforeSize));
+        CheckEzI2Cbuffer();
+        (*resent)++;
+    }
+
+    memcpy(before, intact, size);
+    beforeSize = size;
+    return (TRANSFER_CMPLT == status) ? TRANSFER_CMPLT : TRANSFER_ERROR;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: i2c_bench [-n commands] [-r data_rate_hz] [-d delay_ms] [-a] [-s] [-t]
+*                    [-x corrupt_every] [-L log] [-c]
+*
+*   -a uses the asynchronous master API and does application work while the
+*      transfers are on the bus instead of waiting in the blocking functions.
+*   -s reads the status of each command in the transaction that writes the
+*      next one (repeated START); the last one gets a status read of its own.
+*   -t reads the telemetry window at the second slave address after every
+*      command, as a monitoring poller would.
+*   -x flips a bit of the command byte of every n-th frame after its CRC was
+*      computed; the slave must reject those frames and execute the intact
+*      frame sent again. Implies -t.
+*   -L records every master transfer phase to a log that replay_bench plays
+*      back.
+*   -c checks that every command was acknowledged and executed once, and
+*      exits non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t commands = DEFAULT_COMMANDS;
+    uint32_t dataRate = SIM_DEFAULT_DATA_RATE_HZ;
+    uint32_t delayMs = 0U;
+    bool check = false;
+    bool async = false;
+    bool combined = false;
+    bool monitor = false;
+    uint32_t corruptEvery = 0U;
+    uint32_t corrupted = 0U;
+    uint32_t resent = 0U;
+    uint32_t sends;
+    char const *recordName = NULL;
+    uint32_t size;
+    int opt;
+    uint8_t status;
+
+    uint8_t cmd = ON;
+    uint8_t buffer[WRITE_PACKET_SIZE];
+    uint8_t damaged[WRITE_PACKET_SIZE];
+    uint8_t *frame;
+    uint32_t writesOk = 0U;
+    uint32_t statusOk = 0U;
+    uint32_t tlmOk = 0U;
+    uint32_t tlmTorn = 0U;
+    uint8_t tlm[TLM_SIZE];
+    uint32_t i;
+    uint64_t *latency;
+    uint64_t t0;
+    uint64_t hostStart;
+    uint64_t hostNs;
+    sim_stats_t const *stats;
+
+    while ((opt = getopt(argc, argv, "n:r:d:astx:L:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': commands = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'r': dataRate = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'd': delayMs  = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'a': async    = true; break;
+            case 's': combined = true; break;
+            case 't': monitor  = true; break;
+            case 'x': corruptEvery = (uint32_t)strtoul(optarg, NULL, 0); monitor = true; break;
+            case 'L': recordName = optarg; break;
+            case 'c': check    = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n commands] [-r data_rate_hz] [-d delay_ms] [-a] [-s] [-t] [-x corrupt_every] [-L log] [-c]\n",
+                        argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if ((0U == commands) || (0U == dataRate))
+    {
+        fprintf(stderr, "commands and data rate must be non-zero\n");
+        return EXIT_FAILURE;
+    }
+
+    latency = calloc(commands, sizeof(*latency));
+    if (NULL == latency)
+    {
+        return EXIT_FAILURE;
+    }
+
+    /* Same bring-up sequence as main.c */
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initSlave()) || (I2C_SUCCESS != initMaster()))
+    {
+        fprintf(stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    dataRate = SwitchDataRate(dataRate);
+    if (0U == dataRate)
+    {
+        fprintf(stderr, "data rate not supported\n");
+        return EXIT_FAILURE;
+    }
+    if (NULL != recordName)
+    {
+        recordFile = fopen(recordName, "wb");
+        if (NULL == recordFile)
+        {
+            perror(recordName);
+            return EXIT_FAILURE;
+        }
+        SetMasterRecorder(&CYBSP_I2C_master, &bench_record);
+    }
+    __enable_irq();
+
+    hostStart = bench_host_ns();
+    for (i = 0U; i < commands; i++)
+    {
+        t0 = sim_now_ns();
+
+        size = PrepareCommandPacket(&CYBSP_I2C_master, buffer, cmd);
+        frame = buffer;
+        if ((0U != corruptEvery) && ((i % corruptEvery) == (corruptEvery - 1U)))
+        {
+            memcpy(damaged, buffer, size);
+            damaged[PACKET_CMD_POS] ^= 0x01U;
+            frame = damaged;
+            corrupted++;
+        }
+
+        /* A rejected frame is sent again intact, with the same sequence number */
+        status = combined ? bench_combined(frame, buffer, size, async, &resent) : TRANSFER_ERROR;
+        for (sends = 0U; !combined && (sends < MAX_SENDS); sends++)
+        {
+            status = bench_command(frame, size, async);
+            if (TRANSFER_STS_FAIL != status)
+            {
+                break;
+            }
+            frame = buffer;
+            resent++;
+        }
+
+        /* The status of the last command has no command after it to come
+         * with; a rejected last command is sent again intact.
+         */
+        if (combined && (TRANSFER_CMPLT == status) && ((i + 1U) == commands) &&
+            (TRANSFER_CMPLT != ReadStatusPacketFromEzI2C(&CYBSP_I2C_master)))
+        {
+            resent++;
+            status = bench_command(buffer, size, async);
+        }
+        if (TRANSFER_ERROR != status)
+        {
+            writesOk++;
+            if (TRANSFER_CMPLT == status)
+            {
+                statusOk++;
+                cmd = (cmd == ON) ? OFF : ON;
+            }
+            Cy_SysLib_Delay(delayMs);
+        }
+
+        if (monitor && (READ_CMPLT == ReadTelemetryFromEzI2C(&CYBSP_I2C_master, (uint8_t)TLM_SEQ_POS, tlm, TLM_SIZE)))
+        {
+            tlmOk++;
+            if (tlm[TLM_SEQ_POS] != tlm[TLM_SEQ_END_POS])
+            {
+                tlmTorn++;
+            }
+        }
+
+        latency[i] = sim_now_ns() - t0;
+    }
+    hostNs = bench_host_ns() - hostStart;
+    stats = sim_get_stats();
+    if (NULL != recordFile)
+    {
+        SetMasterRecorder(&CYBSP_I2C_master, NULL);
+        (void)fclose(recordFile);
+    }
+
+    printf("I2C master / EZI2C slave host benchmark\n");
+    printf("  data rate          : %lu Hz\n", (unsigned long)dataRate);
+    printf("  master API         : %s, %s\n", async ? "asynchronous (callbacks)" : "blocking",
+           combined ? "status + command in one transaction" : "separate write and read");
+    printf("  commands           : %lu (writes ok %lu, status ok %lu, corrupted %lu, resent %lu)\n",
+           (unsigned long)commands, (unsigned long)writesOk, (unsigned long)statusOk, (unsigned long)corrupted,
+           (unsigned long)resent);
+    bench_print_rate("commands/s", commands, sim_now_ns());
+    bench_print_latency("command latency", latency, commands);
+    bench_print_bus(stats, sim_now_ns());
+    printf("  host cost          : %.1f ns/command\n", (double)hostNs / commands);
+    if (monitor)
+    {
+        printf("  telemetry reads    : %lu ok, %lu torn; slave counted %lu commands, %lu writes, "
+               "%lu rejected, %lu bus errors\n",
+               (unsigned long)tlmOk, (unsigned long)tlmTorn,
+               (unsigned long)bench_counter(tlm, TLM_COMMANDS_POS), (unsigned long)bench_counter(tlm, TLM_WRITES_POS),
+               (unsigned long)bench_counter(tlm, TLM_REJECTED_POS), (unsigned long)bench_counter(tlm, TLM_BUS_ERRORS_POS));
+    }
+
+    /* Every command is acknowledged by its own status packet, and only the
+     * corrupted frames are sent twice: no command is lost or executed twice.
+     * With -s the status of a command comes with the command after it.
+     */
+    if (check && ((writesOk != commands) || (statusOk != commands) || (resent != corrupted) ||
+                  (async && (callbacks != asyncTransfers)) ||
+                  (monitor && ((tlmOk != commands) || (0U != tlmTorn) ||
+                               (bench_counter(tlm, TLM_COMMANDS_POS) != commands) ||
+                               (bench_counter(tlm, TLM_REJECTED_POS) != corrupted) ||
+                               (tlm[TLM_LED_STATE_POS] != buffer[PACKET_CMD_POS]))) ||
+                  (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) != buffer[PACKET_CMD_POS])))
+    {
+        fprintf(stderr, "check failed\n");
+        free(latency);
+        return EXIT_FAILURE;
+    }
+
+    free(latency);
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,306 @@
+/******************************************************************************
+* File Name:   instr_bench.c
+*
+* Description: Latency instrumentation benchmark, built with I2C_INSTRUMENT
+*              set. Runs command writes and status reads at 100 kHz,
+*              400 kHz and 1 MHz, reads the latency histograms back from the
+*              slave telemetry window over EZI2C and prints them. The host
+*              model does not account CPU time, so the ISR histograms only
+*              count entries.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "I2CDataRate.h"
+#include "I2CInstrument.h"
+#include "sim.h"
+#include "bench_util.h"
+
+#if !I2C_INSTRUMENT
+#error "instr_bench must be built with I2C_INSTRUMENT=1"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define OFF                     CYBSP_LED_STATE_OFF
+#define ON                      CYBSP_LED_STATE_ON
+
+#define DEFAULT_COMMANDS        (1000UL)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static const char *histNames[INSTR_HIST_COUNT] =
+{
+    "master wire", "master reply", "master ISR", "slave ISR"
+};
+
+static uint8_t tlm[TLM_SIZE];
+
+/*******************************************************************************
+* Function Name: get_count
+****************************************************************************//**
+*
+* Summary:
+*   Returns a 16-bit little-endian bucket counter of the exported histograms.
+*
+*******************************************************************************/
+static uint32_t get_count(uint8_t const *hist, uint32_t h, uint32_t b)
+{
+    uint32_t pos = ((h * INSTR_BUCKETS) + b) * 2U;
+
+    return ((uint32_t)hist[pos] | ((uint32_t)hist[pos + 1U] << 8U));
+}
+
+/*******************************************************************************
+* Function Name: bucket_low_us
+****************************************************************************//**
+*
+* Summary:
+*   Lower bound of a bucket in microseconds at SystemCoreClock.
+*
+*******************************************************************************/
+static double bucket_low_us(uint32_t b)
+{
+    return (0U == b) ? 0.0 : ((double)(1UL << (b + INSTR_BUCKET_SHIFT)) * 1e6 / SystemCoreClock);
+}
+
+/*******************************************************************************
+* Function Name: run_commands
+****************************************************************************//**
+*
+* Summary:
+*   Sends count commands, each followed by a status read.
+*
+* Return:
+*   Number of status reads that reported the command done.
+*
+*******************************************************************************/
+static uint32_t run_commands(uint32_t count)
+{
+    uint8_t packet[WRITE_PACKET_SIZE];
+    uint8_t cmd = ON;
+    uint32_t ok = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < count; i++)
+    {
+        cmd = (cmd == ON) ? OFF : ON;
+        if (TRANSFER_CMPLT != WritePacketToEzI2C(&CYBSP_I2C_master, packet,
+                                                 PrepareCommandPacket(&CYBSP_I2C_master, packet, cmd)))
+        {
+            continue;
+        }
+        CheckEzI2Cbuffer();
+        if (READ_CMPLT == ReadStatusPacketFromEzI2C(&CYBSP_I2C_master))
+        {
+            ok++;
+        }
+    }
+
+    return (ok);
+}
+
+/*******************************************************************************
+* Function Name: print_histograms
+****************************************************************************//**
+*
+* Summary:
+*   Prints the non-empty buckets of the histograms read over EZI2C.
+*
+*******************************************************************************/
+static void print_histograms(uint8_t const *hist)
+{
+    uint32_t h;
+    uint32_t b;
+    uint32_t first = INSTR_BUCKETS;
+    uint32_t last = 0U;
+
+    for (b = 0U; b < INSTR_BUCKETS; b++)
+    {
+        for (h = 0U; h < INSTR_HIST_COUNT; h++)
+        {
+            if (0U != get_count(hist, h, b))
+            {
+                first = (b < first) ? b : first;
+                last  = b;
+            }
+        }
+    }
+
+    printf("  %-10s", "from (us)");
+    for (h = 0U; h < INSTR_HIST_COUNT; h++)
+    {
+        printf("  %12s", histNames[h]);
+    }
+    printf("\n");
+
+    for (b = first; b <= last; b++)
+    {
+        printf("  %10.2f", bucket_low_us(b));
+        for (h = 0U; h < INSTR_HIST_COUNT; h++)
+        {
+            printf("  %12lu", (unsigned long)get_count(hist, h, b));
+        }
+        printf("\n");
+    }
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: instr_bench [-n commands_per_rate] [-c]
+*
+*   -c checks that the histograms read over EZI2C match the ones in RAM and
+*   hold one sample per transfer, and exits non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static const uint32_t rates[] = { 100000U, 400000U, 1000000U };
+    uint16_t local[INSTR_HIST_COUNT][INSTR_BUCKETS];
+    uint32_t totals[INSTR_HIST_COUNT];
+    uint32_t count = DEFAULT_COMMANDS;
+    uint32_t done = 0U;
+    uint32_t r;
+    uint32_t h;
+    uint32_t b;
+    bool check = false;
+    bool ok = true;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': count = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': check = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n commands_per_rate] [-c]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    /* Same bring-up sequence as main.c */
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initSlave()) || (I2C_SUCCESS != initMaster()))
+    {
+        fprintf(stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    __enable_irq();
+    ClearInstrHistograms();
+
+    for (r = 0U; r < (sizeof(rates) / sizeof(rates[0])); r++)
+    {
+        if (0U == SwitchDataRate(rates[r]))
+        {
+            fprintf(stderr, "data rate not supported\n");
+            return EXIT_FAILURE;
+        }
+        done += run_commands(count);
+    }
+
+    /* The last write was parsed before the last status read: publish again
+     * so the telemetry window holds the final histograms.
+     */
+    (void)WritePacketToEzI2C(&CYBSP_I2C_master, tlm, PrepareCommandPacket(&CYBSP_I2C_master, tlm, ON));
+    CheckEzI2Cbuffer();
+    for (h = 0U; h < INSTR_HIST_COUNT; h++)
+    {
+        memcpy(local[h], GetInstrHistogram(h), sizeof(local[h]));
+        totals[h] = 0U;
+        for (b = 0U; b < INSTR_BUCKETS; b++)
+        {
+            totals[h] += local[h][b];
+        }
+    }
+
+    if (READ_CMPLT != ReadTelemetryFromEzI2C(&CYBSP_I2C_master, (uint8_t)TLM_SEQ_POS, tlm, TLM_SIZE))
+    {
+        fprintf(stderr, "telemetry read failed\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("Latency instrumentation host benchmark (%lu commands per rate, CPU %lu MHz)\n",
+           (unsigned long)count, (unsigned long)(SystemCoreClock / 1000000UL));
+    printf("  telemetry window %lu bytes, histograms %lu bytes at offset %lu\n",
+           (unsigned long)TLM_SIZE, (unsigned long)INSTR_EXPORT_SIZE, (unsigned long)TLM_HIST_POS);
+    print_histograms(&tlm[TLM_HIST_POS]);
+    printf("  samples:");
+    for (h = 0U; h < INSTR_HIST_COUNT; h++)
+    {
+        printf(" %s %lu%s", histNames[h], (unsigned long)totals[h], (h < (INSTR_HIST_COUNT - 1U)) ? "," : "\n");
+    }
+
+    /* Every transfer ends in one wire sample; every status read that
+     * validated its reply in one reply sample. Both ISRs ran at least once
+     * per transfer.
+     */
+    ok = (tlm[TLM_SEQ_POS] == tlm[TLM_SEQ_END_POS]) && ok;
+    for (h = 0U; h < INSTR_HIST_COUNT; h++)
+    {
+        for (b = 0U; b < INSTR_BUCKETS; b++)
+        {
+            ok = (get_count(&tlm[TLM_HIST_POS], h, b) == local[h][b]) && ok;
+        }
+    }
+    ok = (totals[INSTR_H_MASTER_WIRE] == ((2U * count * (sizeof(rates) / sizeof(rates[0]))) + 1U)) && ok;
+    ok = (totals[INSTR_H_MASTER_REPLY] == done) && ok;
+    ok = (totals[INSTR_H_MASTER_ISR] >= totals[INSTR_H_MASTER_WIRE]) && ok;
+    ok = (totals[INSTR_H_SLAVE_ISR] >= totals[INSTR_H_MASTER_WIRE]) && ok;
+
+    if (check && !ok)
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
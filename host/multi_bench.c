@@ -0,0 +1,329 @@
+/******************************************************************************
+* File Name:   multi_bench.c
+*
+* Description: Multi-instance master benchmark. Drives two buses from one
+*              image with two handles of the master driver, CYBSP_I2C on
+*              bus 0 and a second master SCB on bus 1, each with an EZI2C
+*              node and a caller-owned RX buffer, and compares the command
+*              rate with both buses in flight against one after the other.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "sim.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DEFAULT_COMMANDS        (1000UL)
+#define BUS_COUNT               (2UL)
+
+/* EZI2C nodes at the command buffer address of the code example: the master
+ * writes the command frame, everything from the ring tail up is read-only.
+ * The node on bus 1 reports every command as a duplicate, so a reply that
+ * lands in the RX buffer of the wrong handle fails the check.
+ */
+#define NODE_ADDR               (0x08U)
+#define NODE_RW_BOUNDARY        (EZI2C_RING_TAIL_POS)
+
+/* Granularity of the simulated main loop */
+#define APP_WORK_SLICE_NS       (1000ULL)
+
+/* Running both buses at once must take at most this share of the time the
+ * same transactions take one bus after the other
+ */
+#define CHECK_TIME_FRACTION     (0.6)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Second master on bus 1, driven by the same driver code as CYBSP_I2C_master */
+static i2c_master_t CYBSP_I2C2_master;
+
+static void CYBSP_I2C2_Interrupt(void);
+
+static const i2c_master_hw_t CYBSP_I2C2_master_hw =
+{
+    /*.base =*/ CYBSP_I2C2_HW,
+    /*.config =*/ &CYBSP_I2C_config,
+    /*.irq =*/ CYBSP_I2C2_IRQ,
+    /*.isr =*/ &CYBSP_I2C2_Interrupt,
+    /*.clkDivType =*/ CYBSP_I2C2_CLK_DIV_HW,
+    /*.clkDivNum =*/ CYBSP_I2C2_CLK_DIV_NUM,
+    /*.pins =*/
+    {
+        CYBSP_I2C2_SCL_PORT, CYBSP_I2C2_SCL_NUM, CYBSP_I2C2_SCL_HSIOM,
+        CYBSP_I2C2_SDA_PORT, CYBSP_I2C2_SDA_NUM, CYBSP_I2C2_SDA_HSIOM
+    }
+};
+
+static i2c_master_t* const masters[BUS_COUNT] = { &CYBSP_I2C_master, &CYBSP_I2C2_master };
+
+/* Caller-owned RX buffer of bus 1; bus 0 uses the one initMaster() set up */
+static uint8_t bus1Rx[MASTER_RX_SIZE];
+
+static uint8_t nodeBuffer[BUS_COUNT][EZI2C_BUFFER_SIZE];
+static uint8_t packets[BUS_COUNT][WRITE_PACKET_SIZE];
+static uint8_t const replyStatus[BUS_COUNT] = { STS_CMD_DONE, STS_CMD_DUPLICATE };
+
+/* Per bus: transactions left to start, and those that failed or whose reply
+ * or command did not match
+ */
+static uint32_t remaining[BUS_COUNT];
+static uint32_t mismatches[BUS_COUNT];
+
+/* Per bus: the transaction in flight reads a status packet */
+static bool replyRead[BUS_COUNT];
+
+/*******************************************************************************
+* Function Name: CYBSP_I2C2_Interrupt
+****************************************************************************//**
+*
+* Summary:
+*   Interrupt handler of the second master SCB.
+*
+*******************************************************************************/
+static void CYBSP_I2C2_Interrupt(void)
+{
+    MasterInterrupt(&CYBSP_I2C2_master);
+}
+
+/*******************************************************************************
+* Function Name: start_command
+****************************************************************************//**
+*
+* Summary:
+*   Starts the next status + command transaction on a bus, which reads the
+*   status of the command before; the first one is a plain write. The
+*   command byte counts the transactions down so every write is distinct.
+*   The node is plain memory, so its reply is preset to acknowledge the
+*   frame before.
+*
+*******************************************************************************/
+static bool start_command(uint32_t bus)
+{
+    i2c_master_t* master = masters[bus];
+    uint32_t size = PrepareCommandPacket(master, packets[bus], (uint8_t)remaining[bus]);
+
+    nodeBuffer[bus][EZI2C_RPLY_SEQ_POS] = master->ackSeq;
+    replyRead[bus] = master->ackPending;
+    remaining[bus]--;
+    return (TRANSFER_PENDING == WriteCommandReadStatusAsync(master, packets[bus], size, NULL));
+}
+
+/*******************************************************************************
+* Function Name: check_command
+****************************************************************************//**
+*
+* Summary:
+*   Checks a completed transaction: the reply of the node of the bus in the
+*   RX buffer of the handle, without a copy, and the command in the node.
+*
+*******************************************************************************/
+static void check_command(uint32_t bus)
+{
+    i2c_master_t const* master = masters[bus];
+    if ((TRANSFER_CMPLT != GetMasterTransferStatus(master)) ||
+        (replyRead[bus] && (replyStatus[bus] != master->rxBuffer[MASTER_RX_POS(EZI2C_RPLY_STS_POS)])) ||
+        (0 != memcmp(nodeBuffer[bus], &packets[bus][PACKET_SOP_POS], COMMAND_FRAME_SIZE)))
+    {
+        mismatches[bus]++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_run
+****************************************************************************//**
+*
+* Summary:
+*   Runs count transactions on each bus, with both masters in flight at the
+*   same time, or bus 0 first and then bus 1, and prints one result row.
+*
+* Return:
+*   Time taken.
+*
+*******************************************************************************/
+static uint64_t bench_run(uint32_t count, bool concurrent)
+{
+    uint64_t t0 = sim_now_ns();
+    uint64_t elapsed;
+    bool active[BUS_COUNT] = { false, false };
+    uint32_t first = 0UL;
+    uint32_t last = concurrent ? (BUS_COUNT - 1UL) : 0UL;
+    uint32_t bus;
+
+    for (bus = 0UL; bus < BUS_COUNT; bus++)
+    {
+        remaining[bus]  = count;
+        mismatches[bus] = 0UL;
+    }
+
+    while (first < BUS_COUNT)
+    {
+        for (bus = first; bus <= last; bus++)
+        {
+            if (active[bus] && (TRANSFER_PENDING != GetMasterTransferStatus(masters[bus])))
+            {
+                check_command(bus);
+                active[bus] = false;
+            }
+            if (!active[bus] && (0UL != remaining[bus]))
+            {
+                active[bus] = start_command(bus);
+                if (!active[bus])
+                {
+                    mismatches[bus]++;
+                }
+            }
+        }
+        if (!active[first] && (0UL == remaining[first]))
+        {
+            /* Sequential run: on to the next bus once this one is done */
+            first++;
+            last = concurrent ? last : first;
+            continue;
+        }
+        sim_cpu_work_ns(APP_WORK_SLICE_NS);
+    }
+    elapsed = sim_now_ns() - t0;
+
+    printf("  %-10s  %8lu  %12.0f  %8lu  %8lu\n", concurrent ? "concurrent" : "one by one",
+           (unsigned long)(BUS_COUNT * count), (double)(BUS_COUNT * count) * SIM_NS_PER_SEC / elapsed,
+           (unsigned long)mismatches[0], (unsigned long)mismatches[1]);
+
+    return ((0UL == (mismatches[0] + mismatches[1])) ? elapsed : 0ULL);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: multi_bench [-n commands] [-r data_rate_hz] [-c]
+*
+*   Drives an EZI2C node on bus 0 through CYBSP_I2C_master and one on bus 1
+*   through a second handle on CYBSP_I2C2, and compares the command rate of
+*   both buses in flight at once against one bus after the other.
+*   -c checks that every reply landed in the RX buffer of its own handle and
+*   every command in its own node, and that the two buses overlapped, and
+*   exits non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t count = DEFAULT_COMMANDS;
+    uint32_t dataRate = SIM_DEFAULT_DATA_RATE_HZ;
+    uint64_t sequentialNs;
+    uint64_t concurrentNs;
+    bool check = false;
+    bool ok;
+    uint32_t bus;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:r:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': count    = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'r': dataRate = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': check    = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n commands] [-r data_rate_hz] [-c]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (0U == count)
+    {
+        fprintf(stderr, "commands must be non-zero\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Same bring-up sequence as main.c for bus 0, the second handle on bus 1 */
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initMaster()) ||
+        (I2C_SUCCESS != initMasterHandle(&CYBSP_I2C2_master, &CYBSP_I2C2_master_hw, bus1Rx)))
+    {
+        fprintf(stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    /* The slaves are EZI2C nodes without an SCB: only the masters are clocked */
+    for (bus = 0UL; bus < BUS_COUNT; bus++)
+    {
+        if (0U == ConfigureMasterDataRate(masters[bus], dataRate))
+        {
+            fprintf(stderr, "data rate not supported\n");
+            return EXIT_FAILURE;
+        }
+        memset(nodeBuffer[bus], 0, EZI2C_BUFFER_SIZE);
+        nodeBuffer[bus][EZI2C_RPLY_SOP_POS] = (uint8_t)PACKET_SOP;
+        nodeBuffer[bus][EZI2C_RPLY_STS_POS] = replyStatus[bus];
+        (void)sim_add_ezi2c_node(bus, NODE_ADDR, nodeBuffer[bus], EZI2C_BUFFER_SIZE, NODE_RW_BOUNDARY);
+    }
+    __enable_irq();
+
+    printf("Multi-instance master host benchmark\n");
+    printf("  data rate          : %lu Hz on both buses\n", (unsigned long)dataRate);
+    printf("  commands           : %lu per bus\n", (unsigned long)count);
+    printf("  %-10s  %8s  %12s  %8s  %8s\n", "run", "commands", "commands/s", "bad bus0", "bad bus1");
+
+    sequentialNs = bench_run(count, false);
+    concurrentNs = bench_run(count, true);
+
+    ok = (0ULL != sequentialNs) && (0ULL != concurrentNs) &&
+         ((double)concurrentNs <= (CHECK_TIME_FRACTION * (double)sequentialNs));
+    if ((0ULL != sequentialNs) && (0ULL != concurrentNs))
+    {
+        printf("  speedup            : %.2fx\n", (double)sequentialNs / concurrentNs);
+    }
+
+    if (check && !ok)
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,435 @@
+/******************************************************************************
+* File Name:   cy_pdl.h
+*
+* Description: Host stand-in for the PSOC 4 peripheral driver library. Provides
+*              the subset of the SCB I2C master, SCB EZI2C slave, SysInt,
+*              SysLib, SysClk, SysPm, WDT, GPIO and NVIC APIs used by this code example so that
+*              the application sources in ../source can be compiled and run
+*              unmodified on a Linux host against the bus model in sim_pdl.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef HOST_CY_PDL_H_
+#define HOST_CY_PDL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*******************************************************************************
+* Core / CMSIS
+*******************************************************************************/
+typedef uint32_t cy_rslt_t;
+#define CY_RSLT_SUCCESS                 ((cy_rslt_t)0x00000000U)
+
+#define CY_UNUSED_PARAMETER(x)          ((void)(x))
+#define __STATIC_INLINE                 static inline
+#define CY_ASSERT(x)                    do { if (!(x)) { sim_assert_failed(__FILE__, __LINE__); } } while (0)
+
+typedef enum
+{
+    srss_interrupt_wdt_IRQn = 6,
+    scb_0_interrupt_IRQn    = 8,
+    scb_1_interrupt_IRQn    = 9,
+    scb_2_interrupt_IRQn    = 10,
+    scb_3_interrupt_IRQn    = 11,
+    SIM_IRQn_COUNT          = 32
+} IRQn_Type;
+
+typedef void (* cy_israddress)(void);
+
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+void __enable_irq(void);
+void __disable_irq(void);
+
+void sim_assert_failed(const char *file, int line);
+
+/*******************************************************************************
+* SysInt
+*******************************************************************************/
+typedef enum
+{
+    CY_SYSINT_SUCCESS   = 0x00U,
+    CY_SYSINT_BAD_PARAM = 0x01U
+} cy_en_sysint_status_t;
+
+typedef struct
+{
+    IRQn_Type intrSrc;
+    uint32_t  intrPriority;
+} cy_stc_sysint_t;
+
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress userIsr);
+
+/*******************************************************************************
+* SysLib
+*******************************************************************************/
+void Cy_SysLib_Delay(uint32_t milliseconds);
+void Cy_SysLib_DelayUs(uint16_t microseconds);
+uint32_t Cy_SysLib_EnterCriticalSection(void);
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus);
+
+/*******************************************************************************
+* SysTick
+*******************************************************************************/
+/* CPU clock frequency (IMO in design.modus) */
+extern uint32_t SystemCoreClock;
+
+typedef enum
+{
+    CY_SYSTICK_CLOCK_SOURCE_CLK_LF  = 0U,
+    CY_SYSTICK_CLOCK_SOURCE_CLK_CPU = 4U
+} cy_en_systick_clock_source_t;
+
+void Cy_SysTick_Init(cy_en_systick_clock_source_t clockSource, uint32_t interval);
+uint32_t Cy_SysTick_GetValue(void);
+
+/*******************************************************************************
+* SysClk (peripheral clock dividers fed from HFCLK)
+*******************************************************************************/
+typedef enum
+{
+    CY_SYSCLK_SUCCESS   = 0x00U,
+    CY_SYSCLK_BAD_PARAM = 0x01U
+} cy_en_sysclk_status_t;
+
+typedef enum
+{
+    CY_SYSCLK_DIV_8_BIT    = 0U,
+    CY_SYSCLK_DIV_16_BIT   = 1U,
+    CY_SYSCLK_DIV_16_5_BIT = 2U,
+    CY_SYSCLK_DIV_24_5_BIT = 3U
+} cy_en_divider_types_t;
+
+uint32_t Cy_SysClk_ClkHfGetFrequency(void);
+cy_en_sysclk_status_t Cy_SysClk_PeriphSetDivider(cy_en_divider_types_t dividerType, uint32_t dividerNum,
+                                                 uint32_t dividerValue);
+uint32_t Cy_SysClk_PeriphGetDivider(cy_en_divider_types_t dividerType, uint32_t dividerNum);
+cy_en_sysclk_status_t Cy_SysClk_PeriphEnableDivider(cy_en_divider_types_t dividerType, uint32_t dividerNum);
+cy_en_sysclk_status_t Cy_SysClk_PeriphDisableDivider(cy_en_divider_types_t dividerType, uint32_t dividerNum);
+uint32_t Cy_SysClk_PeriphGetFrequency(cy_en_divider_types_t dividerType, uint32_t dividerNum);
+
+/*******************************************************************************
+* SysPm
+*******************************************************************************/
+typedef enum
+{
+    CY_SYSPM_SUCCESS       = 0x00U,
+    CY_SYSPM_BAD_PARAM     = 0x01U,
+    CY_SYSPM_TIMEOUT       = 0x02U,
+    CY_SYSPM_INVALID_STATE = 0x03U,
+    CY_SYSPM_CANCELED      = 0x04U,
+    CY_SYSPM_FAIL          = 0x05U
+} cy_en_syspm_status_t;
+
+typedef enum
+{
+    CY_SYSPM_SLEEP     = 0U,
+    CY_SYSPM_DEEPSLEEP = 1U
+} cy_en_syspm_callback_type_t;
+
+typedef enum
+{
+    CY_SYSPM_CHECK_READY       = 0x01U,
+    CY_SYSPM_CHECK_FAIL        = 0x02U,
+    CY_SYSPM_BEFORE_TRANSITION = 0x04U,
+    CY_SYSPM_AFTER_TRANSITION  = 0x08U
+} cy_en_syspm_callback_mode_t;
+
+typedef struct
+{
+    void *base;
+    void *context;
+} cy_stc_syspm_callback_params_t;
+
+typedef cy_en_syspm_status_t (*Cy_SysPmCallback)(cy_stc_syspm_callback_params_t *callbackParams,
+                                                 cy_en_syspm_callback_mode_t mode);
+
+typedef struct cy_stc_syspm_callback
+{
+    Cy_SysPmCallback               callback;
+    cy_en_syspm_callback_type_t    type;
+    uint32_t                       skipMode;
+    cy_stc_syspm_callback_params_t *callbackParams;
+    struct cy_stc_syspm_callback   *prevItm;
+    struct cy_stc_syspm_callback   *nextItm;
+    uint8_t                        order;
+} cy_stc_syspm_callback_t;
+
+bool Cy_SysPm_RegisterCallback(cy_stc_syspm_callback_t *handler);
+cy_en_syspm_status_t Cy_SysPm_CpuEnterSleep(void);
+cy_en_syspm_status_t Cy_SysPm_CpuEnterDeepSleep(void);
+
+/*******************************************************************************
+* WDT (16-bit counter clocked by the 40 kHz ILO)
+*******************************************************************************/
+void Cy_WDT_Enable(void);
+void Cy_WDT_Disable(void);
+void Cy_WDT_SetMatch(uint32_t match);
+uint32_t Cy_WDT_GetMatch(void);
+uint32_t Cy_WDT_GetCount(void);
+void Cy_WDT_MaskInterrupt(void);
+void Cy_WDT_UnmaskInterrupt(void);
+uint32_t Cy_WDT_GetInterruptStatus(void);
+void Cy_WDT_ClearInterrupt(void);
+
+/*******************************************************************************
+* GPIO
+*******************************************************************************/
+typedef struct sim_gpio_prt GPIO_PRT_Type;
+
+extern GPIO_PRT_Type sim_gpio_prt0, sim_gpio_prt1, sim_gpio_prt2, sim_gpio_prt3;
+#define GPIO_PRT0                       (&sim_gpio_prt0)
+#define GPIO_PRT1                       (&sim_gpio_prt1)
+#define GPIO_PRT2                       (&sim_gpio_prt2)
+#define GPIO_PRT3                       (&sim_gpio_prt3)
+
+/* Pin function select: software GPIO or a peripheral (SCB I2C pins) */
+typedef enum
+{
+    HSIOM_SEL_GPIO = 0U,
+    HSIOM_SEL_DS_2 = 14U
+} en_hsiom_sel_t;
+
+void Cy_GPIO_Write(GPIO_PRT_Type *base, uint32_t pinNum, uint32_t value);
+uint32_t Cy_GPIO_ReadOut(GPIO_PRT_Type const *base, uint32_t pinNum);
+uint32_t Cy_GPIO_Read(GPIO_PRT_Type const *base, uint32_t pinNum);
+void Cy_GPIO_SetHSIOM(GPIO_PRT_Type *base, uint32_t pinNum, en_hsiom_sel_t value);
+
+/*******************************************************************************
+* SCB common
+*******************************************************************************/
+typedef struct sim_scb CySCB_Type;
+
+extern CySCB_Type sim_scb0, sim_scb1, sim_scb2, sim_scb3;
+#define SCB0                            (&sim_scb0)
+#define SCB1                            (&sim_scb1)
+#define SCB2                            (&sim_scb2)
+#define SCB3                            (&sim_scb3)
+
+#define CY_SCB_WAIT_1_UNIT              (1U)
+
+/* SCB driver modelled, with the EZI2C context fields it keeps */
+#define CY_SCB_DRV_VERSION_MAJOR        4
+#define CY_SCB_DRV_VERSION_MINOR        0
+
+/*******************************************************************************
+* SCB I2C
+*******************************************************************************/
+typedef enum
+{
+    CY_SCB_I2C_SUCCESS                  = 0x00U,
+    CY_SCB_I2C_BAD_PARAM                = 0x01U,
+    CY_SCB_I2C_MASTER_NOT_READY         = 0x02U,
+    CY_SCB_I2C_MASTER_MANUAL_TIMEOUT    = 0x03U,
+    CY_SCB_I2C_MASTER_MANUAL_ADDR_NAK   = 0x04U,
+    CY_SCB_I2C_MASTER_MANUAL_NAK        = 0x05U,
+    CY_SCB_I2C_MASTER_MANUAL_ARB_LOST   = 0x06U,
+    CY_SCB_I2C_MASTER_MANUAL_BUS_ERR    = 0x07U,
+    CY_SCB_I2C_MASTER_MANUAL_ABORT_START = 0x08U
+} cy_en_scb_i2c_status_t;
+
+typedef enum
+{
+    CY_SCB_I2C_SLAVE        = 1U,
+    CY_SCB_I2C_MASTER       = 2U,
+    CY_SCB_I2C_MASTER_SLAVE = 3U
+} cy_en_scb_i2c_mode_t;
+
+typedef enum
+{
+    CY_SCB_I2C_WRITE_XFER = 0U,
+    CY_SCB_I2C_READ_XFER  = 1U
+} cy_en_scb_i2c_direction_t;
+
+typedef enum
+{
+    CY_SCB_I2C_ACK = 0U,
+    CY_SCB_I2C_NAK = 1U
+} cy_en_scb_i2c_command_t;
+
+/* Master status (Cy_SCB_I2C_MasterGetStatus) */
+#define CY_SCB_I2C_MASTER_DATA_NAK      (0x00000001UL)
+#define CY_SCB_I2C_MASTER_ADDR_NAK      (0x00000002UL)
+#define CY_SCB_I2C_MASTER_ARB_LOST      (0x00000004UL)
+#define CY_SCB_I2C_MASTER_ABORT_START   (0x00000008UL)
+#define CY_SCB_I2C_MASTER_BUS_ERR       (0x00000100UL)
+#define CY_SCB_I2C_MASTER_WR_IN_FIFO    (0x00000020UL)
+#define CY_SCB_I2C_MASTER_BUSY          (0x00010000UL)
+
+/* Master events (cy_cb_scb_i2c_handle_events_t) */
+#define CY_SCB_I2C_MASTER_WR_IN_FIFO_EVENT  (0x00010000UL)
+#define CY_SCB_I2C_MASTER_WR_CMPLT_EVENT    (0x00020000UL)
+#define CY_SCB_I2C_MASTER_RD_CMPLT_EVENT    (0x00040000UL)
+#define CY_SCB_I2C_MASTER_ERR_EVENT         (0x00080000UL)
+
+typedef void (* cy_cb_scb_i2c_handle_events_t)(uint32_t event);
+
+typedef struct
+{
+    cy_en_scb_i2c_mode_t i2cMode;
+    bool     useRxFifo;
+    bool     useTxFifo;
+    uint8_t  slaveAddress;
+    uint8_t  slaveAddressMask;
+    bool     acceptAddrInFifo;
+    bool     ackGeneralAddr;
+    bool     enableWakeFromSleep;
+    bool     enableDigitalFilter;
+    uint32_t lowPhaseDutyCycle;
+    uint32_t highPhaseDutyCycle;
+} cy_stc_scb_i2c_config_t;
+
+typedef struct
+{
+    uint8_t  slaveAddress;
+    uint8_t  *buffer;
+    uint32_t bufferSize;
+    bool     xferPending;
+} cy_stc_scb_i2c_master_xfer_config_t;
+
+typedef struct
+{
+    uint32_t state;
+    uint32_t masterStatus;
+    bool     masterPause;
+    bool     masterRdDir;
+    uint8_t  *masterBuffer;
+    uint32_t masterBufferSize;
+    uint32_t masterNumBytes;
+    cy_cb_scb_i2c_handle_events_t cbEvents;
+} cy_stc_scb_i2c_context_t;
+
+cy_en_scb_i2c_status_t Cy_SCB_I2C_Init(CySCB_Type *base, cy_stc_scb_i2c_config_t const *config,
+                                       cy_stc_scb_i2c_context_t *context);
+void Cy_SCB_I2C_Enable(CySCB_Type *base, cy_stc_scb_i2c_context_t const *context);
+void Cy_SCB_I2C_Disable(CySCB_Type *base, cy_stc_scb_i2c_context_t *context);
+uint32_t Cy_SCB_I2C_SetDataRate(CySCB_Type *base, uint32_t dataRateHz, uint32_t scbClockHz);
+uint32_t Cy_SCB_I2C_GetDataRate(CySCB_Type const *base, uint32_t scbClockHz);
+cy_en_scb_i2c_status_t Cy_SCB_I2C_MasterWrite(CySCB_Type *base, cy_stc_scb_i2c_master_xfer_config_t *xferConfig,
+                                              cy_stc_scb_i2c_context_t *context);
+cy_en_scb_i2c_status_t Cy_SCB_I2C_MasterRead(CySCB_Type *base, cy_stc_scb_i2c_master_xfer_config_t *xferConfig,
+                                             cy_stc_scb_i2c_context_t *context);
+uint32_t Cy_SCB_I2C_MasterGetStatus(CySCB_Type const *base, cy_stc_scb_i2c_context_t const *context);
+uint32_t Cy_SCB_I2C_MasterGetTransferCount(CySCB_Type const *base, cy_stc_scb_i2c_context_t const *context);
+void Cy_SCB_I2C_MasterInterrupt(CySCB_Type *base, cy_stc_scb_i2c_context_t *context);
+cy_en_syspm_status_t Cy_SCB_I2C_DeepSleepCallback(cy_stc_syspm_callback_params_t *callbackParams,
+                                                  cy_en_syspm_callback_mode_t mode);
+void Cy_SCB_I2C_RegisterEventCallback(CySCB_Type const *base, cy_cb_scb_i2c_handle_events_t callback,
+                                      cy_stc_scb_i2c_context_t *context);
+
+/*******************************************************************************
+* SCB EZI2C
+*******************************************************************************/
+typedef enum
+{
+    CY_SCB_EZI2C_SUCCESS   = 0x00U,
+    CY_SCB_EZI2C_BAD_PARAM = 0x01U
+} cy_en_scb_ezi2c_status_t;
+
+typedef enum
+{
+    CY_SCB_EZI2C_ONE_ADDRESS  = 0U,
+    CY_SCB_EZI2C_TWO_ADDRESSES = 1U
+} cy_en_scb_ezi2c_num_of_addr_t;
+
+typedef enum
+{
+    CY_SCB_EZI2C_SUB_ADDR8_BITS  = 0U,
+    CY_SCB_EZI2C_SUB_ADDR16_BITS = 1U
+} cy_en_scb_ezi2c_sub_addr_size_t;
+
+/* Slave activity (Cy_SCB_EZI2C_GetActivity) */
+#define CY_SCB_EZI2C_STATUS_READ1       (0x01UL)
+#define CY_SCB_EZI2C_STATUS_WRITE1      (0x02UL)
+#define CY_SCB_EZI2C_STATUS_READ2       (0x04UL)
+#define CY_SCB_EZI2C_STATUS_WRITE2      (0x08UL)
+#define CY_SCB_EZI2C_STATUS_BUSY        (0x10UL)
+#define CY_SCB_EZI2C_STATUS_ERR         (0x20UL)
+
+typedef struct
+{
+    cy_en_scb_ezi2c_num_of_addr_t   numberOfAddresses;
+    uint8_t                         slaveAddress1;
+    uint8_t                         slaveAddress2;
+    cy_en_scb_ezi2c_sub_addr_size_t subAddressSize;
+    bool                            enableWakeFromSleep;
+} cy_stc_scb_ezi2c_config_t;
+
+typedef struct
+{
+    uint32_t status;
+    uint32_t state;
+    uint8_t  address1;
+    uint8_t  address2;
+    cy_en_scb_ezi2c_sub_addr_size_t subAddrSize;
+
+    uint8_t  *curBuf;
+    uint32_t bufSize;
+    uint32_t bufRwBoundary;
+    uint32_t idx;
+    uint32_t writeCount;
+    bool     addrPhase;
+    bool     rdDir;
+    uint32_t activeAddr;
+
+    uint8_t  *buf1;
+    uint32_t buf1Size;
+    uint32_t buf1rwBondary;
+    uint32_t baseAddr1;
+
+    uint8_t  *buf2;
+    uint32_t buf2Size;
+    uint32_t buf2rwBondary;
+    uint32_t baseAddr2;
+} cy_stc_scb_ezi2c_context_t;
+
+cy_en_scb_ezi2c_status_t Cy_SCB_EZI2C_Init(CySCB_Type *base, cy_stc_scb_ezi2c_config_t const *config,
+                                           cy_stc_scb_ezi2c_context_t *context);
+void Cy_SCB_EZI2C_Enable(CySCB_Type *base);
+void Cy_SCB_EZI2C_Disable(CySCB_Type *base, cy_stc_scb_ezi2c_context_t *context);
+void Cy_SCB_EZI2C_SetBuffer1(CySCB_Type const *base, uint8_t *buffer, uint32_t size, uint32_t rwBoundary,
+                             cy_stc_scb_ezi2c_context_t *context);
+void Cy_SCB_EZI2C_SetBuffer2(CySCB_Type const *base, uint8_t *buffer, uint32_t size, uint32_t rwBoundary,
+                             cy_stc_scb_ezi2c_context_t *context);
+uint32_t Cy_SCB_EZI2C_GetActivity(CySCB_Type const *base, cy_stc_scb_ezi2c_context_t *context);
+void Cy_SCB_EZI2C_Interrupt(CySCB_Type *base, cy_stc_scb_ezi2c_context_t *context);
+cy_en_syspm_status_t Cy_SCB_EZI2C_DeepSleepCallback(cy_stc_syspm_callback_params_t *callbackParams,
+                                                    cy_en_syspm_callback_mode_t mode);
+
+#endif /* HOST_CY_PDL_H_ */
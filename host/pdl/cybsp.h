@@ -0,0 +1,96 @@
+/******************************************************************************
+* File Name:   cybsp.h
+*
+* Description: Host stand-in for the board support package. Maps the CYBSP_*
+*              aliases used by this code example onto the simulated SCB and
+*              GPIO instances provided by sim_pdl.c.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef HOST_CYBSP_H_
+#define HOST_CYBSP_H_
+
+#include "cy_pdl.h"
+
+/*******************************************************************************
+* Board aliases
+*******************************************************************************/
+#define CYBSP_EZI2C_HW                  SCB0
+#define CYBSP_EZI2C_IRQ                 scb_0_interrupt_IRQn
+#define CYBSP_I2C_HW                    SCB1
+#define CYBSP_I2C_IRQ                   scb_1_interrupt_IRQn
+
+/* Clock dividers of the two SCBs (design.modus: div_16[1] and div_16[2]) */
+#define CYBSP_I2C_CLK_DIV_HW            CY_SYSCLK_DIV_16_BIT
+#define CYBSP_I2C_CLK_DIV_NUM           (1U)
+#define CYBSP_EZI2C_CLK_DIV_HW          CY_SYSCLK_DIV_16_BIT
+#define CYBSP_EZI2C_CLK_DIV_NUM         (2U)
+
+/* Pins of the I2C master SCB (CY8CKIT-041-41XX: P1[0] SCL, P1[1] SDA) */
+#define CYBSP_I2C_SCL_PORT              GPIO_PRT1
+#define CYBSP_I2C_SCL_NUM               (0U)
+#define CYBSP_I2C_SCL_HSIOM             HSIOM_SEL_DS_2
+#define CYBSP_I2C_SDA_PORT              GPIO_PRT1
+#define CYBSP_I2C_SDA_NUM               (1U)
+#define CYBSP_I2C_SDA_HSIOM             HSIOM_SEL_DS_2
+
+/* Second I2C master SCB on bus 1 (P2[0] SCL, P2[1] SDA, div_16[3]), for
+ * boards that drive two buses from one image. Runs CYBSP_I2C_config.
+ */
+#define CYBSP_I2C2_HW                   SCB3
+#define CYBSP_I2C2_IRQ                  scb_3_interrupt_IRQn
+#define CYBSP_I2C2_CLK_DIV_HW           CY_SYSCLK_DIV_16_BIT
+#define CYBSP_I2C2_CLK_DIV_NUM          (3U)
+#define CYBSP_I2C2_SCL_PORT             GPIO_PRT2
+#define CYBSP_I2C2_SCL_NUM              (0U)
+#define CYBSP_I2C2_SCL_HSIOM            HSIOM_SEL_DS_2
+#define CYBSP_I2C2_SDA_PORT             GPIO_PRT2
+#define CYBSP_I2C2_SDA_NUM              (1U)
+#define CYBSP_I2C2_SDA_HSIOM            HSIOM_SEL_DS_2
+
+#define CYBSP_USER_LED1_PORT            GPIO_PRT3
+#define CYBSP_USER_LED1_NUM             (4U)
+
+#define CYBSP_LED_STATE_ON              (0U)
+#define CYBSP_LED_STATE_OFF             (1U)
+
+extern const cy_stc_scb_i2c_config_t CYBSP_I2C_config;
+extern const cy_stc_scb_ezi2c_config_t CYBSP_EZI2C_config;
+
+cy_rslt_t cybsp_init(void);
+
+#endif /* HOST_CYBSP_H_ */
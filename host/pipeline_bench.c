@@ -0,0 +1,484 @@
+/******************************************************************************
+* File Name:   pipeline_bench.c
+*
+* Description: Pipelined main loop benchmark. Sends back-to-back LED
+*              commands, with the command period set to zero, once with the
+*              serial loop main.c used to run (status + command transaction,
+*              then slave check, then the application builds the next
+*              command) and once with the pipeline of I2CPipeline.c, where
+*              the next command is on the bus while the slave executes the
+*              previous one and the application builds the one after. The
+*              application work per command is modeled as CPU time. A short
+*              run with a non-zero period then checks the command rate.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "I2CDataRate.h"
+#include "I2CPipeline.h"
+#include "LowPower.h"
+#include "sim.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define OFF                     CYBSP_LED_STATE_OFF
+#define ON                      CYBSP_LED_STATE_ON
+
+#define DEFAULT_COMMANDS        (10000UL)
+#define DEFAULT_WORK_US         (100UL)
+#define DEFAULT_PERIOD_MS       (2UL)
+#define PERIOD_COMMANDS         (50UL)
+
+/* Faulted run: commands, and the rate of flipped bits on the bus */
+#define FAULT_COMMANDS          (2000UL)
+#define FAULT_CORRUPT_PPM       (2000UL)
+#define FAULT_SEED              (1UL)
+#define BENCH_BUS               (0UL)
+
+/* Granularity of the main loop while a transfer runs */
+#define LOOP_SLICE_NS           (1000ULL)
+
+/* Check limits. The serial loop spends the wire time and the application
+ * work one after the other; the pipeline overlaps them, so a command may
+ * take no more than the longer of the two, plus this share and one loop
+ * slice. Each period of a paced run may be late by one ILO tick of the WDT
+ * that times it and the Deep Sleep exit.
+ */
+#define CHECK_OVERLAP_SLACK     (1.05)
+#define CHECK_PERIOD_SLACK_MS   (0.1)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* One run, from the start to the delivery of its last command */
+typedef struct
+{
+    uint32_t commands;
+    uint64_t elapsedNs;
+    uint64_t busNs;
+    uint64_t hostNs;
+} run_result_t;
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static uint8_t cmd = ON;
+static uint8_t lastCmd;
+static uint32_t produced;
+static uint32_t produceLimit;
+static uint64_t workNs;
+
+/*******************************************************************************
+* Function Name: produce
+****************************************************************************//**
+*
+* Summary:
+*   Application task: spends the modeled work time and builds the next LED
+*   command, until the run has built all of its commands.
+*
+*******************************************************************************/
+static uint32_t produce(i2c_master_t* master, uint8_t* frame)
+{
+    uint32_t size;
+
+    if (produced == produceLimit)
+    {
+        return 0U;
+    }
+    sim_cpu_work_ns(workNs);
+    size = PrepareCommandPacket(master, frame, cmd);
+    lastCmd = cmd;
+    cmd = (cmd == ON) ? OFF : ON;
+    produced++;
+
+    return size;
+}
+
+/*******************************************************************************
+* Function Name: run_begin
+****************************************************************************//**
+*
+* Summary:
+*   Starts a measured run of count commands.
+*
+*******************************************************************************/
+static void run_begin(run_result_t *run, uint32_t count)
+{
+    produced = 0U;
+    produceLimit = count;
+    run->commands = count;
+    run->elapsedNs = sim_now_ns();
+    run->busNs = sim_get_stats()->busActiveNs;
+    run->hostNs = bench_host_ns();
+}
+
+/*******************************************************************************
+* Function Name: run_end
+****************************************************************************//**
+*
+* Summary:
+*   Ends a measured run.
+*
+*******************************************************************************/
+static void run_end(run_result_t *run)
+{
+    run->elapsedNs = sim_now_ns() - run->elapsedNs;
+    run->busNs = sim_get_stats()->busActiveNs - run->busNs;
+    run->hostNs = bench_host_ns() - run->hostNs;
+}
+
+/*******************************************************************************
+* Function Name: run_serial
+****************************************************************************//**
+*
+* Summary:
+*   The serial loop: each command waits for its transaction, which also
+*   acknowledges the command before, then the slave check, then the work
+*   for the next command. The last command gets a status read of its own.
+*
+* Return:
+*   Commands delivered with a good status.
+*
+*******************************************************************************/
+static uint32_t run_serial(run_result_t *run, uint32_t count)
+{
+    uint8_t buffer[WRITE_PACKET_SIZE];
+    uint32_t size;
+    uint32_t sent = 0U;
+    uint32_t attempts = 0U;
+    uint8_t status;
+
+    run_begin(run, count);
+    size = produce(&CYBSP_I2C_master, buffer);
+    while ((0U != size) && (attempts++ < (2U * count)))
+    {
+        status = WriteCommandReadStatus(&CYBSP_I2C_master, buffer, size);
+        CheckEzI2Cbuffer();
+        if (TRANSFER_CMPLT == status)
+        {
+            /* The command before is acknowledged, this one is written */
+            sent++;
+            size = produce(&CYBSP_I2C_master, buffer);
+        }
+    }
+    if ((0U != sent) && (TRANSFER_CMPLT != ReadStatusPacketFromEzI2C(&CYBSP_I2C_master)))
+    {
+        sent--;
+    }
+    run_end(run);
+
+    return sent;
+}
+
+/*******************************************************************************
+* Function Name: run_pipeline
+****************************************************************************//**
+*
+* Summary:
+*   The pipelined loop of main.c. Slices of loop time pass while a transfer
+*   is on the bus; an idle pipeline waits for the next period in low-power
+*   idle. The run ends when the last command was delivered and executed.
+*
+* Return:
+*   false if a transfer failed.
+*
+*******************************************************************************/
+static bool run_pipeline(run_result_t *run, uint32_t count, uint32_t periodMs)
+{
+    pipeline_stats_t const *stats = GetPipelineStats();
+    uint32_t sent0 = stats->sent;
+    uint32_t status;
+    bool ok = true;
+
+    run_begin(run, count);
+    SetCommandPeriod(periodMs);
+    while ((stats->sent - sent0) < count)
+    {
+        status = RunPipeline();
+        if (PIPELINE_ERROR == status)
+        {
+            ok = false;
+            break;
+        }
+        if (PIPELINE_BUSY == status)
+        {
+            sim_cpu_work_ns(LOOP_SLICE_NS);
+        }
+        else if ((stats->sent - sent0) < count)
+        {
+            (void)EnterLowPowerIdle();
+        }
+    }
+    run_end(run);
+
+    /* The last command is executed by the slave task of the next step */
+    (void)RunPipeline();
+
+    return ok;
+}
+
+/*******************************************************************************
+* Function Name: slave_commands
+****************************************************************************//**
+*
+* Summary:
+*   Reads the count of executed commands from the telemetry window. Call it
+*   with the fault injection off.
+*
+*******************************************************************************/
+static uint32_t slave_commands(void)
+{
+    uint8_t tlm[TLM_SIZE];
+    uint32_t pos = TLM_COMMANDS_POS;
+
+    if (READ_CMPLT != ReadTelemetryFromEzI2C(&CYBSP_I2C_master, (uint8_t)TLM_SEQ_POS, tlm, TLM_SIZE))
+    {
+        return 0U;
+    }
+    return (uint32_t)tlm[pos] | ((uint32_t)tlm[pos + 1U] << 8U) |
+           ((uint32_t)tlm[pos + 2U] << 16U) | ((uint32_t)tlm[pos + 3U] << 24U);
+}
+
+/*******************************************************************************
+* Function Name: run_faulted
+****************************************************************************//**
+*
+* Summary:
+*   Runs count back-to-back commands through the pipeline while the bus
+*   flips bits of the frames and of the status packets, and carries on after
+*   PIPELINE_ERROR as main.c does.
+*
+* Return:
+*   Commands the slave executed during the run.
+*
+*******************************************************************************/
+static uint32_t run_faulted(uint32_t count)
+{
+    pipeline_stats_t const *stats = GetPipelineStats();
+    sim_fault_config_t config = { 0U };
+    uint32_t executed = slave_commands();
+    uint32_t sent0 = stats->sent;
+    uint32_t steps = 0U;
+
+    produced = 0U;
+    produceLimit = count;
+    config.seed = FAULT_SEED;
+    config.ppm[SIM_FAULT_CORRUPT] = FAULT_CORRUPT_PPM;
+    sim_set_faults(BENCH_BUS, &config);
+
+    SetCommandPeriod(0U);
+    while (((stats->sent - sent0) < count) && (steps++ < (1000U * count)))
+    {
+        if (PIPELINE_IDLE == RunPipeline())
+        {
+            (void)EnterLowPowerIdle();
+        }
+        else
+        {
+            sim_cpu_work_ns(LOOP_SLICE_NS);
+        }
+    }
+    (void)RunPipeline();
+
+    sim_set_faults(BENCH_BUS, NULL);
+    return slave_commands() - executed;
+}
+
+/*******************************************************************************
+* Function Name: print_run
+****************************************************************************//**
+*
+* Summary:
+*   Prints one result row.
+*
+*******************************************************************************/
+static void print_run(char const *name, run_result_t const *run)
+{
+    printf("  %-9s  %9lu  %10.1f  %11.1f  %6.1f%%  %9.1f\n", name, (unsigned long)run->commands,
+           (double)run->commands * SIM_NS_PER_SEC / run->elapsedNs,
+           (double)run->elapsedNs / SIM_NS_PER_US / run->commands,
+           100.0 * run->busNs / run->elapsedNs, (double)run->hostNs / run->commands);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: pipeline_bench [-n commands] [-r data_rate_hz] [-w work_us]
+*                         [-p period_ms] [-c]
+*
+*   -w is the application work per command (default 100 us).
+*   -p is the command period of the paced run (default 2 ms).
+*   -c checks that every command was delivered and executed, that the
+*      pipeline kept the bus busy and beat the serial loop, that the
+*      paced run held its period, and that a run over a bus that flips bits
+*      executes every command once, and exits non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t commands = DEFAULT_COMMANDS;
+    uint32_t dataRate = SIM_DEFAULT_DATA_RATE_HZ;
+    uint32_t workUs = DEFAULT_WORK_US;
+    uint32_t periodMs = DEFAULT_PERIOD_MS;
+    bool check = false;
+    bool ok = true;
+    int opt;
+    uint32_t serialSent;
+    run_result_t serial;
+    run_result_t piped;
+    run_result_t paced;
+    pipeline_stats_t const *stats;
+    pipeline_stats_t clean;
+    uint32_t faultExecuted;
+    double speedup;
+    double serialNs;
+    double pipedNs;
+    double boundNs;
+    double pacedMs;
+
+    while ((opt = getopt(argc, argv, "n:r:w:p:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': commands = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'r': dataRate = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'w': workUs   = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'p': periodMs = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': check    = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n commands] [-r data_rate_hz] [-w work_us] [-p period_ms] [-c]\n",
+                        argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if ((0U == commands) || (0U == dataRate) || (0U == periodMs))
+    {
+        fprintf(stderr, "commands, data rate and period must be non-zero\n");
+        return EXIT_FAILURE;
+    }
+    workNs = (uint64_t)workUs * SIM_NS_PER_US;
+
+    /* Same bring-up sequence as main.c */
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initSlave()) || (I2C_SUCCESS != initMaster()) ||
+        (I2C_SUCCESS != initLowPower()) || (I2C_SUCCESS != initPipeline(&CYBSP_I2C_master, &produce, 0U)))
+    {
+        fprintf(stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    dataRate = SwitchDataRate(dataRate);
+    if (0U == dataRate)
+    {
+        fprintf(stderr, "data rate not supported\n");
+        return EXIT_FAILURE;
+    }
+    __enable_irq();
+
+    serialSent = run_serial(&serial, commands);
+    ok = (serialSent == commands) && (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) == lastCmd);
+
+    ok = run_pipeline(&piped, commands, 0U) && ok;
+    ok = (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) == lastCmd) && ok;
+
+    ok = run_pipeline(&paced, PERIOD_COMMANDS, periodMs) && ok;
+    ok = (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) == lastCmd) && ok;
+
+    /* The runs above go over a clean bus; the faulted run is counted apart */
+    stats = GetPipelineStats();
+    clean = *stats;
+    faultExecuted = run_faulted(FAULT_COMMANDS);
+
+    serialNs = (double)serial.elapsedNs / serial.commands;
+    pipedNs  = (double)piped.elapsedNs / piped.commands;
+    speedup  = serialNs / pipedNs;
+    boundNs  = ((serialNs - workNs) > workNs) ? (serialNs - workNs) : (double)workNs;
+    /* The first command of the paced run goes out at once */
+    pacedMs = (double)paced.elapsedNs / SIM_NS_PER_MS / (paced.commands - 1U);
+
+    printf("Pipelined main loop host benchmark\n");
+    printf("  data rate          : %lu Hz\n", (unsigned long)dataRate);
+    printf("  application work   : %lu us per command\n", (unsigned long)workUs);
+    printf("  %-9s  %9s  %10s  %11s  %7s  %9s\n", "loop", "commands", "commands/s", "us/command", "bus",
+           "host ns");
+    print_run("serial", &serial);
+    print_run("pipelined", &piped);
+    printf("  speedup            : %.2fx back to back (bound: %.1f us/command)\n", speedup,
+           boundNs / SIM_NS_PER_US);
+    printf("  paced run          : %lu commands every %lu ms, %.3f ms apart on average\n",
+           (unsigned long)paced.commands, (unsigned long)periodMs, pacedMs);
+    printf("  pipeline           : %lu issued, %lu sent, %lu resent, %lu status reads, %lu errors, "
+           "%lu written with the status of the one before\n",
+           (unsigned long)clean.issued, (unsigned long)clean.sent, (unsigned long)clean.resent,
+           (unsigned long)clean.statusReads, (unsigned long)clean.errors, (unsigned long)clean.overlapped);
+    printf("  flipped bits       : %lu sent, %lu executed, %lu resent, %lu status reads, %lu errors "
+           "(%lu ppm)\n",
+           (unsigned long)(stats->sent - clean.sent), (unsigned long)faultExecuted,
+           (unsigned long)(stats->resent - clean.resent), (unsigned long)(stats->statusReads - clean.statusReads),
+           (unsigned long)(stats->errors - clean.errors), (unsigned long)FAULT_CORRUPT_PPM);
+
+    /* Only the first command of the pipeline sees an empty reply region and
+     * is resent; the serial run before it has set the reply. Back to back,
+     * every command after the first goes out in the transaction that
+     * acknowledges the one before. With flipped bits, every command must
+     * still be executed once: a rejected frame is sent again, and the one
+     * behind it waits.
+     */
+    if (check && (!ok || (clean.sent != (commands + PERIOD_COMMANDS)) || (0U != clean.errors) ||
+                  (clean.resent > 1U) || ((clean.overlapped + 1U) < commands) ||
+                  ((stats->sent - clean.sent) != FAULT_COMMANDS) || (faultExecuted != FAULT_COMMANDS) ||
+                  (stats->resent == clean.resent) ||
+                  (pipedNs > ((CHECK_OVERLAP_SLACK * boundNs) + LOOP_SLICE_NS)) ||
+                  (pacedMs < (double)periodMs) || (pacedMs > (periodMs + CHECK_PERIOD_SLACK_MS))))
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,297 @@
+/******************************************************************************
+* File Name:   power_bench.c
+*
+* Description: Low-power idle benchmark. Runs the command loop of main.c
+*              with the 1 s busy-wait between commands and with the WDT
+*              timed Deep Sleep idle, and reports the time spent in each
+*              power mode and an estimate of the average supply current.
+*              A master outside the device then writes a command while the
+*              slave is awake and while it is in Deep Sleep, and the wake to
+*              first byte latency of the address-match wakeup is reported.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "LowPower.h"
+#include "sim.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define OFF                     CYBSP_LED_STATE_OFF
+#define ON                      CYBSP_LED_STATE_ON
+
+#define DEFAULT_COMMANDS        (10UL)
+#define DEFAULT_DELAY_MS        (1000UL)
+
+/* Assumed supply currents at 48 MHz, for the estimate only */
+#define ACTIVE_CURRENT_UA       (5000.0)
+#define SLEEP_CURRENT_UA        (1700.0)
+#define DEEPSLEEP_CURRENT_UA    (3.0)
+
+/* Bus of the master and slave SCBs, and the EZI2C command address */
+#define BENCH_BUS               (0UL)
+#define SLAVE_ADDR              (0x08U)
+
+/* The external write starts this far into the idle period */
+#define EXT_WRITE_AT_MS         (300ULL)
+
+/* Modeled Deep Sleep exit time, and slack allowed on top of it */
+#define CHECK_WAKE_NS           (35ULL * SIM_NS_PER_US)
+#define CHECK_WAKE_MARGIN_NS    (5ULL * SIM_NS_PER_US)
+
+/* Share of the idle time the low-power loop must spend in Deep Sleep */
+#define CHECK_DEEPSLEEP_PCT     (95.0)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static uint8_t cmd = ON;
+
+/*******************************************************************************
+* Function Name: idle
+****************************************************************************//**
+*
+* Summary:
+*   Idle period between two commands, as in main.c or with the former
+*   busy-wait.
+*
+*******************************************************************************/
+static void idle(bool lowPower, uint32_t delayMs)
+{
+    if (lowPower)
+    {
+        StartIdleTimer(delayMs);
+        while (!IsIdleTimerExpired())
+        {
+            (void)EnterLowPowerIdle();
+            CheckEzI2Cbuffer();
+        }
+    }
+    else
+    {
+        Cy_SysLib_Delay(delayMs);
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_loop
+****************************************************************************//**
+*
+* Summary:
+*   Runs the command loop of main.c, with the command written and executed
+*   before each idle period, and prints one result row.
+*
+* Return:
+*   Percentage of the time spent in Deep Sleep, or a negative value if a
+*   command was not executed.
+*
+*******************************************************************************/
+static double bench_loop(bool lowPower, uint32_t commands, uint32_t delayMs)
+{
+    uint8_t buffer[WRITE_PACKET_SIZE];
+    sim_stats_t s0 = *sim_get_stats();
+    sim_stats_t const *s1 = sim_get_stats();
+    uint64_t t0 = sim_now_ns();
+    uint64_t elapsed;
+    uint64_t sleepNs;
+    uint64_t deepNs;
+    uint64_t activeNs;
+    double currentUa;
+    uint32_t executed = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < commands; i++)
+    {
+        if (TRANSFER_CMPLT == WritePacketToEzI2C(&CYBSP_I2C_master, buffer,
+                                                 PrepareCommandPacket(&CYBSP_I2C_master, buffer, cmd)))
+        {
+            CheckEzI2Cbuffer();
+            if (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) == cmd)
+            {
+                executed++;
+            }
+            cmd = (cmd == ON) ? OFF : ON;
+        }
+        idle(lowPower, delayMs);
+    }
+
+    elapsed   = sim_now_ns() - t0;
+    sleepNs   = s1->sleepNs - s0.sleepNs;
+    deepNs    = s1->deepSleepNs - s0.deepSleepNs;
+    activeNs  = elapsed - sleepNs - deepNs;
+    currentUa = ((activeNs * ACTIVE_CURRENT_UA) + (sleepNs * SLEEP_CURRENT_UA) +
+                 (deepNs * DEEPSLEEP_CURRENT_UA)) / elapsed;
+
+    printf("  %-10s  %8lu  %9.4f  %8.4f  %10.4f  %8lu  %9.1f  %10.1f\n",
+           lowPower ? "Deep Sleep" : "busy-wait", (unsigned long)executed,
+           100.0 * activeNs / elapsed, 100.0 * sleepNs / elapsed, 100.0 * deepNs / elapsed,
+           (unsigned long)(s1->wakeups - s0.wakeups), currentUa,
+           currentUa * ((double)elapsed / SIM_NS_PER_SEC) / commands);
+
+    return (executed == commands) ? (100.0 * deepNs / elapsed) : -1.0;
+}
+
+/*******************************************************************************
+* Function Name: bench_wake
+****************************************************************************//**
+*
+* Summary:
+*   Lets a master outside the device write a command to the slave during an
+*   idle period and prints the time from the address match to the first
+*   byte acknowledged.
+*
+* Return:
+*   Address match to first byte in ns, or 0 if the command was not executed.
+*
+*******************************************************************************/
+static uint64_t bench_wake(bool lowPower, uint32_t delayMs)
+{
+    uint8_t packet[WRITE_PACKET_SIZE];
+    sim_ext_xfer_t const *ext = sim_external_result();
+    uint32_t size;
+    uint64_t wakeNs;
+
+    cmd  = (cmd == ON) ? OFF : ON;
+    size = PrepareCommandPacket(&CYBSP_I2C_master, packet, cmd);
+    sim_external_write(BENCH_BUS, sim_now_ns() + (EXT_WRITE_AT_MS * SIM_NS_PER_MS), SLAVE_ADDR, packet, size);
+    idle(lowPower, delayMs);
+    CheckEzI2Cbuffer();
+
+    wakeNs = ext->firstByteNs - ext->addrNs;
+    printf("  %-10s  %14.1f  %16.1f  %s\n", lowPower ? "Deep Sleep" : "awake",
+           (double)wakeNs / SIM_NS_PER_US, (double)(ext->doneNs - ext->startNs) / SIM_NS_PER_US,
+           (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) == cmd) ? "yes" : "NO");
+
+    return ((0U != ext->doneNs) && (0U == ext->error) && (ext->delivered == size) &&
+            (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) == cmd)) ? wakeNs : 0U;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: power_bench [-n commands] [-d delay_ms] [-c]
+*
+*   -c checks that every command was executed in both modes, that the
+*   low-power loop spent nearly all the time in Deep Sleep and that the
+*   address-match wakeup costs no more than the Deep Sleep exit time, and
+*   exits non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t commands = DEFAULT_COMMANDS;
+    uint32_t delayMs = DEFAULT_DELAY_MS;
+    bool check = false;
+    bool ok = true;
+    low_power_stats_t const *lp;
+    uint64_t awakeNs;
+    uint64_t asleepNs;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:d:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': commands = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'd': delayMs  = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': check    = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n commands] [-d delay_ms] [-c]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if ((0U == commands) || (delayMs <= EXT_WRITE_AT_MS))
+    {
+        fprintf(stderr, "commands must be non-zero and the delay over %lu ms\n", (unsigned long)EXT_WRITE_AT_MS);
+        return EXIT_FAILURE;
+    }
+
+    /* Same bring-up sequence as main.c */
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initSlave()) || (I2C_SUCCESS != initMaster()) ||
+        (I2C_SUCCESS != initLowPower()))
+    {
+        fprintf(stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    __enable_irq();
+
+    printf("Low-power idle host benchmark\n");
+    printf("  commands           : %lu, %lu ms apart\n", (unsigned long)commands, (unsigned long)delayMs);
+    printf("  assumed currents   : active %.0f uA, Sleep %.0f uA, Deep Sleep %.1f uA\n",
+           ACTIVE_CURRENT_UA, SLEEP_CURRENT_UA, DEEPSLEEP_CURRENT_UA);
+    printf("  %-10s  %8s  %9s  %8s  %10s  %8s  %9s  %10s\n", "idle", "executed", "active %", "Sleep %",
+           "DeepSleep %", "wakeups", "avg (uA)", "uC/command");
+
+    ok = (bench_loop(false, commands, delayMs) >= 0.0) && ok;
+    ok = (bench_loop(true, commands, delayMs) >= CHECK_DEEPSLEEP_PCT) && ok;
+
+    printf("\n  External master writes a command during the idle period\n");
+    printf("  %-10s  %14s  %16s  %s\n", "slave", "addr->byte (us)", "transfer (us)", "executed");
+    awakeNs  = bench_wake(false, delayMs);
+    asleepNs = bench_wake(true, delayMs);
+    printf("  wake to first byte : %.1f us added by the Deep Sleep wakeup\n",
+           ((double)asleepNs - (double)awakeNs) / SIM_NS_PER_US);
+
+    lp = GetLowPowerStats();
+    printf("  low-power idle     : %lu Deep Sleep, %lu Sleep (Deep Sleep refused), %lu WDT wakeups\n",
+           (unsigned long)lp->deepSleeps, (unsigned long)lp->sleeps, (unsigned long)lp->timerWakeups);
+
+    ok = ok && (0U != awakeNs) && (asleepNs >= awakeNs) &&
+         ((asleepNs - awakeNs) <= (CHECK_WAKE_NS + CHECK_WAKE_MARGIN_NS));
+
+    if (check && !ok)
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
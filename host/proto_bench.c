@@ -0,0 +1,450 @@
+/******************************************************************************
+* File Name:   proto_bench.c
+*
+* Description: Protocol codec benchmark. Prints the message layouts derived
+*              from the single protocol description in I2CPacket.h, checks
+*              them against the wire layout, round-trips every field
+*              through PROTO_PUT()/PROTO_GET() against hand-written byte
+*              code, and compares the host time of the generated codec
+*              with the hand-written one and with a telemetry layout that
+*              has an extra field.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "I2CPacket.h"
+#include "I2CSlave.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DEFAULT_ITERATIONS      (2000000UL)
+#define TIMING_RUNS             (9UL)
+
+/* Codecs timed */
+#define CODEC_HAND              (0UL)
+#define CODEC_PROTO             (1UL)
+#define CODEC_PROTO_EXT         (2UL)
+#define CODECS                  (3UL)
+
+/* Messages the timed loops cycle through, so stores are not folded away */
+#define BENCH_MESSAGES          (64UL)
+
+/* The generated codec must run within this factor of the hand-written one */
+#define CHECK_TIME_FACTOR       (1.25)
+
+/* Telemetry with a field added at the end: encoding the existing fields
+ * must cost the same
+ */
+#define PROTO_TELEMETRY_EXT(X)  \
+    PROTO_TELEMETRY(X)          \
+    X(extra,        4)
+typedef struct { PROTO_TELEMETRY_EXT(PROTO_LAYOUT_FIELD) } proto_telemetry_ext_t;
+PROTO_ASSERT_PACKED(proto_telemetry_ext_t, PROTO_TELEMETRY_EXT);
+
+/* Wire layout of the opcode command set. Master and slave firmware must be
+ * updated together when one of these changes.
+ */
+PROTO_ASSERT(EZI2C_RING_TAIL_POS == 0x09UL, "ring tail moved");
+PROTO_ASSERT(EZI2C_RPLY_SOP_POS == 0x0AUL, "reply moved");
+PROTO_ASSERT(EZI2C_RPLY_SEQ_POS == 0x0BUL, "reply moved");
+PROTO_ASSERT(EZI2C_RPLY_STS_POS == 0x0CUL, "reply moved");
+PROTO_ASSERT(EZI2C_RESULT_POS == 0x0DUL, "result moved");
+PROTO_ASSERT(EZI2C_STREAM_ACK_POS == 0x11UL, "stream status moved");
+PROTO_ASSERT(EZI2C_STREAM_STS_POS == 0x13UL, "stream status moved");
+PROTO_ASSERT(EZI2C_RING_BASE_POS == 0x14UL, "ring moved");
+PROTO_ASSERT(EZI2C_STREAM_BASE_POS == 132UL, "stream slots moved");
+PROTO_ASSERT(EZI2C_BUFFER_SIZE == 256UL, "buffer size changed");
+PROTO_ASSERT(COMMAND_FRAME_SIZE == 7UL, "command frame changed");
+PROTO_ASSERT(TLM_COMMANDS_POS == 4UL, "telemetry moved");
+PROTO_ASSERT(TLM_BUS_ERRORS_POS == 16UL, "telemetry moved");
+PROTO_ASSERT(TLM_HIST_POS == 20UL, "telemetry moved");
+
+/* Prints one field of msg */
+#define PRINT_FIELD(field, bytes) \
+    printf("    %-14s %4lu  %5lu\n", #field, (unsigned long)PROTO_OFS(BENCH_MSG, field), (unsigned long)(bytes));
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static uint8_t messages[BENCH_MESSAGES][PROTO_SIZE(proto_telemetry_ext_t)];
+static uint8_t handMessages[BENCH_MESSAGES][PROTO_SIZE(proto_telemetry_ext_t)];
+static volatile uint32_t sink;
+
+/*******************************************************************************
+* Function Name: print_layouts
+****************************************************************************//**
+*
+* Summary:
+*   Prints every message of the protocol description with the offset and
+*   width of its fields.
+*
+*******************************************************************************/
+static void print_layouts(void)
+{
+    printf("  %-18s %4s  %5s\n", "message/field", "ofs", "bytes");
+#define BENCH_MSG proto_frame_hdr_t
+    printf("  frame header (%lu bytes)\n", (unsigned long)PROTO_SIZE(BENCH_MSG));
+    PROTO_FRAME_HDR(PRINT_FIELD)
+#undef BENCH_MSG
+#define BENCH_MSG proto_command_t
+    printf("  command payload (%lu bytes)\n", (unsigned long)PROTO_SIZE(BENCH_MSG));
+    PROTO_COMMAND(PRINT_FIELD)
+#undef BENCH_MSG
+#define BENCH_MSG proto_op_ping_t
+    printf("  ping operands (%lu bytes)\n", (unsigned long)PROTO_SIZE(BENCH_MSG));
+    PROTO_OP_PING(PRINT_FIELD)
+#undef BENCH_MSG
+#define BENCH_MSG proto_op_led_t
+    printf("  LED operands (%lu bytes)\n", (unsigned long)PROTO_SIZE(BENCH_MSG));
+    PROTO_OP_LED(PRINT_FIELD)
+#undef BENCH_MSG
+#define BENCH_MSG proto_op_select_t
+    printf("  GPIO/register/counter select operands (%lu bytes)\n", (unsigned long)PROTO_SIZE(BENCH_MSG));
+    PROTO_OP_SELECT(PRINT_FIELD)
+#undef BENCH_MSG
+#define BENCH_MSG proto_op_gpio_write_t
+    printf("  GPIO write operands (%lu bytes)\n", (unsigned long)PROTO_SIZE(BENCH_MSG));
+    PROTO_OP_GPIO_WRITE(PRINT_FIELD)
+#undef BENCH_MSG
+#define BENCH_MSG proto_op_reg_write_t
+    printf("  register write operands (%lu bytes)\n", (unsigned long)PROTO_SIZE(BENCH_MSG));
+    PROTO_OP_REG_WRITE(PRINT_FIELD)
+#undef BENCH_MSG
+#define BENCH_MSG proto_stream_open_t
+    printf("  stream open operands (%lu bytes)\n", (unsigned long)PROTO_SIZE(BENCH_MSG));
+    PROTO_STREAM_OPEN(PRINT_FIELD)
+#undef BENCH_MSG
+#define BENCH_MSG proto_stream_chunk_t
+    printf("  stream chunk header (%lu bytes)\n", (unsigned long)PROTO_SIZE(BENCH_MSG));
+    PROTO_STREAM_CHUNK(PRINT_FIELD)
+#undef BENCH_MSG
+#define BENCH_MSG proto_reply_t
+    printf("  reply (%lu bytes)\n", (unsigned long)PROTO_SIZE(BENCH_MSG));
+    PROTO_REPLY(PRINT_FIELD)
+#undef BENCH_MSG
+#define BENCH_MSG proto_result_t
+    printf("  result (%lu bytes)\n", (unsigned long)PROTO_SIZE(BENCH_MSG));
+    PROTO_RESULT(PRINT_FIELD)
+#undef BENCH_MSG
+#define BENCH_MSG proto_stream_status_t
+    printf("  stream status (%lu bytes)\n", (unsigned long)PROTO_SIZE(BENCH_MSG));
+    PROTO_STREAM_STATUS(PRINT_FIELD)
+#undef BENCH_MSG
+#define BENCH_MSG proto_telemetry_t
+    printf("  telemetry (%lu bytes + histograms + end sequence)\n", (unsigned long)PROTO_SIZE(BENCH_MSG));
+    PROTO_TELEMETRY(PRINT_FIELD)
+#undef BENCH_MSG
+#define BENCH_MSG proto_ezi2c_buffer_t
+    printf("  EZI2C buffer (%lu bytes)\n", (unsigned long)PROTO_SIZE(BENCH_MSG));
+    PROTO_EZI2C_BUFFER(PRINT_FIELD)
+#undef BENCH_MSG
+}
+
+/*******************************************************************************
+* Function Name: round_trip
+****************************************************************************//**
+*
+* Summary:
+*   Encodes pseudo-random field values with PROTO_PUT(), and checks that the
+*   bytes match hand-written little-endian stores at the wire positions and
+*   that PROTO_GET() returns the values.
+*
+* Return:
+*   Number of mismatches.
+*
+*******************************************************************************/
+static uint32_t round_trip(uint32_t count)
+{
+    uint8_t msg[PROTO_SIZE(proto_telemetry_t)];
+    uint8_t ref[PROTO_SIZE(proto_telemetry_t)];
+    uint32_t value = 0x12345678UL;
+    uint32_t errors = 0UL;
+    uint32_t i;
+
+    for (i = 0UL; i < count; i++)
+    {
+        value = (value * 1664525UL) + 1013904223UL;
+
+        memset(msg, 0, sizeof(msg));
+        memset(ref, 0, sizeof(ref));
+        PROTO_PUT(proto_telemetry_t, last_sts, msg, value);
+        PROTO_PUT(proto_telemetry_t, writes, msg, value);
+        ref[2] = (uint8_t)value;
+        ref[8] = (uint8_t)value;
+        ref[9] = (uint8_t)(value >> 8U);
+        ref[10] = (uint8_t)(value >> 16U);
+        ref[11] = (uint8_t)(value >> 24U);
+        errors += (0 != memcmp(msg, ref, sizeof(msg))) ? 1UL : 0UL;
+        errors += (PROTO_GET(proto_telemetry_t, writes, msg) != value) ? 1UL : 0UL;
+        errors += (PROTO_GET(proto_telemetry_t, last_sts, msg) != (value & 0xFFUL)) ? 1UL : 0UL;
+
+        memset(msg, 0, sizeof(msg));
+        PROTO_PUT(proto_stream_open_t, id, msg, value >> 24U);
+        PROTO_PUT(proto_stream_open_t, size, msg, value);
+        errors += ((msg[0] != (uint8_t)(value >> 24U)) || (msg[1] != (uint8_t)value) ||
+                   (msg[2] != (uint8_t)(value >> 8U)) || (msg[3] != 0U)) ? 1UL : 0UL;
+        errors += (PROTO_GET(proto_stream_open_t, size, msg) != (value & 0xFFFFUL)) ? 1UL : 0UL;
+
+        memset(msg, 0, sizeof(msg));
+        PROTO_PUT(proto_op_reg_write_t, reg, msg, value >> 24U);
+        PROTO_PUT(proto_op_reg_write_t, value, msg, value);
+        errors += ((msg[0] != (uint8_t)(value >> 24U)) || (msg[1] != (uint8_t)value) ||
+                   (msg[2] != (uint8_t)(value >> 8U)) || (msg[3] != 0U)) ? 1UL : 0UL;
+        errors += (PROTO_GET(proto_op_reg_write_t, value, msg) != (value & 0xFFFFUL)) ? 1UL : 0UL;
+
+        PROTO_PUT(proto_stream_chunk_t, offset, msg, value);
+        errors += (PROTO_GET(proto_stream_chunk_t, offset, msg) != (value & 0xFFFFUL)) ? 1UL : 0UL;
+    }
+
+    return (errors);
+}
+
+/*******************************************************************************
+* Function Name: encode_hand
+****************************************************************************//**
+*
+* Summary:
+*   Telemetry encode and reply decode as written before the protocol
+*   description: byte stores and loads at literal positions.
+*
+*******************************************************************************/
+static __attribute__((noinline)) uint32_t encode_hand(uint32_t iterations)
+{
+    uint32_t sum = 0UL;
+    uint32_t i;
+    uint8_t* m;
+
+    for (i = 0UL; i < iterations; i++)
+    {
+        m = messages[i % BENCH_MESSAGES];
+        m[1]  = (uint8_t)i;
+        m[2]  = (uint8_t)(i >> 3U);
+        m[4]  = (uint8_t)i;
+        m[5]  = (uint8_t)(i >> 8U);
+        m[6]  = (uint8_t)(i >> 16U);
+        m[7]  = (uint8_t)(i >> 24U);
+        m[8]  = (uint8_t)(i * 3U);
+        m[9]  = (uint8_t)((i * 3U) >> 8U);
+        m[10] = (uint8_t)((i * 3U) >> 16U);
+        m[11] = (uint8_t)((i * 3U) >> 24U);
+        m[0]  = (uint8_t)i;
+        sum  += ((uint32_t)m[9] << 8U) | m[8];
+    }
+
+    return (sum);
+}
+
+/*******************************************************************************
+* Function Name: encode_proto
+****************************************************************************//**
+*
+* Summary:
+*   The same work as encode_hand() through PROTO_PUT()/PROTO_GET().
+*
+*******************************************************************************/
+static __attribute__((noinline)) uint32_t encode_proto(uint32_t iterations)
+{
+    uint32_t sum = 0UL;
+    uint32_t i;
+    uint8_t* m;
+
+    for (i = 0UL; i < iterations; i++)
+    {
+        m = messages[i % BENCH_MESSAGES];
+        PROTO_PUT(proto_telemetry_t, led_state, m, i);
+        PROTO_PUT(proto_telemetry_t, last_sts, m, i >> 3U);
+        PROTO_PUT(proto_telemetry_t, commands, m, i);
+        PROTO_PUT(proto_telemetry_t, writes, m, i * 3U);
+        PROTO_PUT(proto_telemetry_t, seq, m, i);
+        sum += PROTO_GET(proto_stream_chunk_t, offset, &m[PROTO_OFS(proto_telemetry_t, writes)]);
+    }
+
+    return (sum);
+}
+
+/*******************************************************************************
+* Function Name: encode_proto_ext
+****************************************************************************//**
+*
+* Summary:
+*   encode_proto() on the telemetry layout with an extra field.
+*
+*******************************************************************************/
+static __attribute__((noinline)) uint32_t encode_proto_ext(uint32_t iterations)
+{
+    uint32_t sum = 0UL;
+    uint32_t i;
+    uint8_t* m;
+
+    for (i = 0UL; i < iterations; i++)
+    {
+        m = messages[i % BENCH_MESSAGES];
+        PROTO_PUT(proto_telemetry_ext_t, led_state, m, i);
+        PROTO_PUT(proto_telemetry_ext_t, last_sts, m, i >> 3U);
+        PROTO_PUT(proto_telemetry_ext_t, commands, m, i);
+        PROTO_PUT(proto_telemetry_ext_t, writes, m, i * 3U);
+        PROTO_PUT(proto_telemetry_ext_t, seq, m, i);
+        sum += PROTO_GET(proto_stream_chunk_t, offset, &m[PROTO_OFS(proto_telemetry_ext_t, writes)]);
+    }
+
+    return (sum);
+}
+
+/*******************************************************************************
+* Function Name: time_codecs
+****************************************************************************//**
+*
+* Summary:
+*   Runs each codec loop TIMING_RUNS times, taking turns so that a slow
+*   phase of the host hits every codec alike, and prints the best time per
+*   message of each.
+*
+* Parameters:
+*   names: Name of each codec
+*   codecs: Codec loops
+*   best: Set to the best time per message of each codec, in nanoseconds
+*   count: Number of codecs
+*   iterations: Messages per run
+*
+*******************************************************************************/
+static void time_codecs(char const* const* names, uint32_t (* const *codecs)(uint32_t), double *best,
+                        uint32_t count, uint32_t iterations)
+{
+    double ns;
+    uint64_t t0;
+    uint32_t run;
+    uint32_t i;
+
+    for (run = 0UL; run < TIMING_RUNS; run++)
+    {
+        for (i = 0UL; i < count; i++)
+        {
+            t0   = bench_host_ns();
+            sink = codecs[i](iterations);
+            ns   = (double)(bench_host_ns() - t0) / iterations;
+            if ((0UL == run) || (ns < best[i]))
+            {
+                best[i] = ns;
+            }
+        }
+    }
+    for (i = 0UL; i < count; i++)
+    {
+        printf("  %-34s %8.2f ns/message\n", names[i], best[i]);
+    }
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: proto_bench [-n iterations] [-c]
+*
+*   -c checks that every field round-trips, that the generated codec writes
+*   the same bytes as the hand-written one, and that it runs within
+*   CHECK_TIME_FACTOR of it with and without an extra field, and exits
+*   non-zero otherwise. The layout itself is checked at compile time.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    static char const* const names[CODECS] =
+    {
+        "hand-written byte code", "PROTO_PUT/PROTO_GET", "PROTO_PUT/PROTO_GET, extra field"
+    };
+    static uint32_t (* const codecs[CODECS])(uint32_t) = { encode_hand, encode_proto, encode_proto_ext };
+    uint32_t errors;
+    double best[CODECS];
+    bool check = false;
+    bool ok;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': iterations = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': check      = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n iterations] [-c]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (0U == iterations)
+    {
+        fprintf(stderr, "iterations must be non-zero\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("Protocol codec host benchmark\n");
+    print_layouts();
+
+    errors = round_trip(iterations / 100U + 1U);
+    printf("  round trips        : %lu mismatches\n", (unsigned long)errors);
+
+    time_codecs(names, codecs, best, CODECS, iterations);
+
+    /* Both codecs leave the same bytes behind */
+    memset(messages, 0, sizeof(messages));
+    (void)encode_hand(BENCH_MESSAGES);
+    memcpy(handMessages, messages, sizeof(messages));
+    memset(messages, 0, sizeof(messages));
+    (void)encode_proto(BENCH_MESSAGES);
+    ok = (0UL == errors) && (0 == memcmp(handMessages, messages, sizeof(messages)));
+
+    ok = ok && (best[CODEC_PROTO] <= (CHECK_TIME_FACTOR * best[CODEC_HAND])) &&
+         (best[CODEC_PROTO_EXT] <= (CHECK_TIME_FACTOR * best[CODEC_HAND]));
+
+    if (check && !ok)
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,353 @@
+/******************************************************************************
+* File Name:   rate_bench.c
+*
+* Description: Data rate switching benchmark. Runs the command/status loop of
+*              main.c at 100 kHz, 400 kHz and 1 MHz, shows that the master
+*              alone cannot go to Fast-mode Plus without the EZI2C clock,
+*              and probes buses whose wiring only carries a lower rate:
+*              ProbeDataRate() must settle on the fastest clean rate, and
+*              a bus that degrades while in use must be stepped down after
+*              the first failed command.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "I2CDataRate.h"
+#include "sim.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define OFF                     CYBSP_LED_STATE_OFF
+#define ON                      CYBSP_LED_STATE_ON
+
+#define DEFAULT_COMMANDS        (2000UL)
+
+/* Bus of the jumper-wired master and slave */
+#define BUS_IDX                 (0UL)
+
+/* Marginal wiring loses every MARGINAL_EVERY-th address above its limit, so
+ * the retries hide the errors from the commands; broken wiring loses all.
+ */
+#define MARGINAL_EVERY          (3UL)
+#define BROKEN_EVERY            (1UL)
+
+/* Fast-mode Plus must move the commands at least this much faster than
+ * Fast mode
+ */
+#define CHECK_FMP_SPEEDUP       (1.5)
+
+/*******************************************************************************
+* Function Name: bring_up
+****************************************************************************//**
+*
+* Summary:
+*   Resets the device and runs the bring-up sequence of main.c.
+*
+*******************************************************************************/
+static bool bring_up(void)
+{
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initSlave()) || (I2C_SUCCESS != initMaster()))
+    {
+        fprintf(stderr, "initialization failed\n");
+        return false;
+    }
+    __enable_irq();
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: run_commands
+****************************************************************************//**
+*
+* Summary:
+*   Runs the command/status loop of main.c without the idle time. Each
+*   transaction acknowledges the command before and writes the next one; a
+*   command held back because the status of the one before is not there
+*   yet is sent again after the slave has run. With
+*   reprobe, a failed transfer probes the bus again from the current rate,
+*   as main.c does.
+*
+* Return:
+*   Number of transfers that failed.
+*
+*******************************************************************************/
+static uint32_t run_commands(uint32_t count, bool reprobe)
+{
+    uint8_t packet[WRITE_PACKET_SIZE];
+    uint8_t cmd = ON;
+    uint32_t size = PrepareCommandPacket(&CYBSP_I2C_master, packet, cmd);
+    uint32_t failed = 0U;
+    uint8_t status;
+    uint32_t i;
+
+    for (i = 0U; i < count; i++)
+    {
+        status = WriteCommandReadStatus(&CYBSP_I2C_master, packet, size);
+        if (TRANSFER_CMPLT == status)
+        {
+            cmd = (cmd == ON) ? OFF : ON;
+            size = PrepareCommandPacket(&CYBSP_I2C_master, packet, cmd);
+        }
+        else if (TRANSFER_ERROR == status)
+        {
+            failed++;
+            if (reprobe)
+            {
+                (void)ProbeDataRate(GetDataRate());
+            }
+        }
+        CheckEzI2Cbuffer();
+    }
+
+    return failed;
+}
+
+/*******************************************************************************
+* Function Name: bench_rates
+****************************************************************************//**
+*
+* Summary:
+*   Switches to each data rate and times the command loop.
+*
+* Return:
+*   true if every command went through and Fast-mode Plus beat Fast mode.
+*
+*******************************************************************************/
+static bool bench_rates(uint32_t count)
+{
+    static const uint32_t rates[] = { I2C_RATE_STANDARD_HZ, I2C_RATE_FAST_HZ, I2C_RATE_FAST_PLUS_HZ };
+    double perSec[sizeof(rates) / sizeof(rates[0])];
+    uint64_t t0;
+    uint64_t elapsed;
+    uint32_t actual;
+    uint32_t failed;
+    bool ok = true;
+    uint32_t r;
+
+    printf("  %9s  %9s  %8s  %8s  %12s\n", "rate", "actual", "commands", "failed", "commands/s");
+    for (r = 0U; r < (sizeof(rates) / sizeof(rates[0])); r++)
+    {
+        actual = SwitchDataRate(rates[r]);
+        t0 = sim_now_ns();
+        failed = (0U != actual) ? run_commands(count, false) : count;
+        elapsed = sim_now_ns() - t0;
+        perSec[r] = (elapsed > 0U) ? ((double)(count - failed) * SIM_NS_PER_SEC / elapsed) : 0.0;
+
+        printf("  %9lu  %9lu  %8lu  %8lu  %12.0f\n", (unsigned long)rates[r], (unsigned long)actual,
+               (unsigned long)count, (unsigned long)failed, perSec[r]);
+        ok = (actual == rates[r]) && (0U == failed) && ok;
+    }
+
+    return ok && (perSec[2] >= (CHECK_FMP_SPEEDUP * perSec[1]));
+}
+
+/*******************************************************************************
+* Function Name: bench_master_only
+****************************************************************************//**
+*
+* Summary:
+*   Moves only the master to Fast-mode Plus: the EZI2C SCB, still clocked
+*   for Fast mode, cannot follow and the command must fail.
+*
+* Return:
+*   true if the command failed.
+*
+*******************************************************************************/
+static bool bench_master_only(void)
+{
+    uint8_t packet[WRITE_PACKET_SIZE];
+    uint32_t actual = ConfigureMasterDataRate(&CYBSP_I2C_master, I2C_RATE_FAST_PLUS_HZ);
+    uint8_t status = WriteCommandReadStatus(&CYBSP_I2C_master, packet,
+                                            PrepareCommandPacket(&CYBSP_I2C_master, packet, ON));
+
+    printf("  master only at %lu Hz: command %s\n", (unsigned long)actual,
+           (TRANSFER_ERROR == status) ? "failed (EZI2C clock too slow)" : "went through");
+
+    return (I2C_RATE_FAST_PLUS_HZ == actual) && (TRANSFER_ERROR == status);
+}
+
+/*******************************************************************************
+* Function Name: bench_probe
+****************************************************************************//**
+*
+* Summary:
+*   Probes a bus whose wiring loses addresses above limitHz and runs the
+*   command loop at the rate found.
+*
+* Return:
+*   true if the probe settled on expectHz and the commands went through.
+*
+*******************************************************************************/
+static bool bench_probe(uint32_t limitHz, uint32_t errorEvery, uint32_t expectHz, uint32_t count)
+{
+    i2c_data_rate_stats_t before = *GetDataRateStats();
+    i2c_data_rate_stats_t const *after;
+    uint64_t t0;
+    uint64_t probeNs;
+    uint32_t rate;
+    uint32_t failed;
+
+    if (!bring_up())
+    {
+        return false;
+    }
+    sim_set_bus_limit(BUS_IDX, limitHz, errorEvery);
+
+    t0 = sim_now_ns();
+    rate = ProbeDataRate(I2C_DATA_RATE_MAX_HZ);
+    probeNs = sim_now_ns() - t0;
+    after = GetDataRateStats();
+    failed = run_commands(count, false);
+
+    printf("  %9lu  %6lu  %9lu  %6lu  %9lu  %11lu  %10.1f  %6lu\n",
+           (unsigned long)limitHz, (unsigned long)errorEvery, (unsigned long)rate,
+           (unsigned long)(after->probes - before.probes), (unsigned long)(after->fallbacks - before.fallbacks),
+           (unsigned long)after->lastErrors, (double)probeNs / SIM_NS_PER_US, (unsigned long)failed);
+
+    return (expectHz == rate) && (0U == failed);
+}
+
+/*******************************************************************************
+* Function Name: bench_degrade
+****************************************************************************//**
+*
+* Summary:
+*   Starts on a clean bus at the probed rate, then breaks the wiring above
+*   Fast mode while commands run.
+*
+* Return:
+*   true if the bus was stepped down to Fast mode after one failed command
+*   and the remaining commands went through.
+*
+*******************************************************************************/
+static bool bench_degrade(uint32_t count)
+{
+    uint32_t start;
+    uint32_t failed;
+
+    if (!bring_up())
+    {
+        return false;
+    }
+    start = ProbeDataRate(I2C_DATA_RATE_MAX_HZ);
+    sim_set_bus_limit(BUS_IDX, I2C_RATE_FAST_HZ, BROKEN_EVERY);
+    failed = run_commands(count, true);
+
+    printf("  degraded bus: %lu Hz -> %lu Hz, %lu of %lu commands failed\n",
+           (unsigned long)start, (unsigned long)GetDataRate(), (unsigned long)failed, (unsigned long)count);
+
+    return (I2C_RATE_FAST_PLUS_HZ == start) && (I2C_RATE_FAST_HZ == GetDataRate()) && (1U == failed);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: rate_bench [-n commands] [-c]
+*
+*   -c checks that every rate runs the commands, that the probe settles on
+*   the fastest rate the wiring carries and that a degraded bus is stepped
+*   down, and exits non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t count = DEFAULT_COMMANDS;
+    bool check = false;
+    bool ok = true;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': count = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': check = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n commands] [-c]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (0U == count)
+    {
+        fprintf(stderr, "usage: %s [-n commands] [-c]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("Data rate switching host benchmark\n");
+    if (!bring_up())
+    {
+        return EXIT_FAILURE;
+    }
+    ok = bench_rates(count) && ok;
+    if (!bring_up())
+    {
+        return EXIT_FAILURE;
+    }
+    ok = bench_master_only() && ok;
+
+    printf("\n  %9s  %6s  %9s  %6s  %9s  %11s  %10s  %6s\n",
+           "bus limit", "1 in", "probed", "probes", "fallbacks", "last errors", "probe (us)", "failed");
+    ok = bench_probe(0U, 0U, I2C_RATE_FAST_PLUS_HZ, count) && ok;
+    ok = bench_probe(I2C_RATE_FAST_HZ, MARGINAL_EVERY, I2C_RATE_FAST_HZ, count) && ok;
+    ok = bench_probe(I2C_RATE_FAST_HZ, BROKEN_EVERY, I2C_RATE_FAST_HZ, count) && ok;
+    ok = bench_probe(I2C_RATE_STANDARD_HZ, MARGINAL_EVERY, I2C_RATE_STANDARD_HZ, count) && ok;
+
+    printf("\n");
+    ok = bench_degrade(count) && ok;
+
+    if (check && !ok)
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,363 @@
+/******************************************************************************
+* File Name:   recovery_bench.c
+*
+* Description: Bus recovery benchmark. Injects address NAKs, arbitration
+*              loss, a bus error, a slave holding SDA low and a wedged slave
+*              into the simulated bus, and reports for each whether a
+*              blocking command write still went through, the retries it
+*              took and the time it took. After each scenario the fault is
+*              removed and a command must go through again.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "I2CDataRate.h"
+#include "I2CTrace.h"
+#include "sim.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define OFF                     CYBSP_LED_STATE_OFF
+#define ON                      CYBSP_LED_STATE_ON
+
+/* Bus of the master and slave SCBs */
+#define BENCH_BUS               (0UL)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef enum
+{
+    FAULT_ADDR_NAK,
+    FAULT_ARB_LOST,
+    FAULT_BUS_ERR,
+    FAULT_STUCK_SDA,
+    FAULT_SLAVE_WEDGED
+} bench_fault_t;
+
+typedef struct
+{
+    const char    *name;
+    bench_fault_t fault;
+    uint32_t      count;      /* Faulty transfers, or SCL clocks to free SDA */
+    bool          delivered;  /* Expected outcome */
+} bench_scenario_t;
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static uint8_t cmd = ON;
+
+static const bench_scenario_t scenarios[] =
+{
+    { "address NAK x1",       FAULT_ADDR_NAK,     1U,  true  },
+    { "address NAK x3",       FAULT_ADDR_NAK,     NAK_RETRY_MAX, true  },
+    { "address NAK x8",       FAULT_ADDR_NAK,     8U,  false },
+    { "arbitration lost x1",  FAULT_ARB_LOST,     1U,  true  },
+    { "arbitration lost x4",  FAULT_ARB_LOST,     ARB_RETRY_MAX, true  },
+    { "bus error x1",         FAULT_BUS_ERR,      1U,  true  },
+    { "SDA stuck, 3 clocks",  FAULT_STUCK_SDA,    3U,  true  },
+    { "SDA stuck, 9 clocks",  FAULT_STUCK_SDA,    BUS_CLEAR_CLOCKS, true  },
+    { "SDA stuck, 20 clocks", FAULT_STUCK_SDA,    20U, false },
+    { "slave wedged",         FAULT_SLAVE_WEDGED, 0U,  false },
+};
+
+/*******************************************************************************
+* Function Name: inject
+****************************************************************************//**
+*
+* Summary:
+*   Applies (count != 0) or removes (count == 0) a fault.
+*
+*******************************************************************************/
+static void inject(bench_fault_t fault, uint32_t count)
+{
+    switch (fault)
+    {
+        case FAULT_ADDR_NAK:
+            sim_inject_master_error(CYBSP_I2C_HW, CY_SCB_I2C_MASTER_ADDR_NAK, count);
+            break;
+        case FAULT_ARB_LOST:
+            sim_inject_master_error(CYBSP_I2C_HW, CY_SCB_I2C_MASTER_ARB_LOST, count);
+            break;
+        case FAULT_BUS_ERR:
+            sim_inject_master_error(CYBSP_I2C_HW, CY_SCB_I2C_MASTER_BUS_ERR, count);
+            break;
+        case FAULT_STUCK_SDA:
+            sim_hold_sda(BENCH_BUS, count);
+            break;
+        case FAULT_SLAVE_WEDGED:
+        default:
+            if (0U != count)
+            {
+                NVIC_DisableIRQ(CYBSP_EZI2C_IRQ);
+            }
+            else
+            {
+                NVIC_EnableIRQ(CYBSP_EZI2C_IRQ);
+            }
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: traced
+****************************************************************************//**
+*
+* Summary:
+*   Checks that the trace holds the failure cause of a fault among the
+*   records written since start: the master status bit of an injected error,
+*   a bus recovery for a stuck SDA or a timeout for a wedged slave.
+*
+*******************************************************************************/
+static bool traced(bench_fault_t fault, uint32_t start)
+{
+    i2c_trace_t const *trace = GetTrace();
+    uint32_t event = TRACE_M_ERR;
+    uint32_t bits = 0U;
+    uint32_t i;
+
+    switch (fault)
+    {
+        case FAULT_ADDR_NAK:  bits  = CY_SCB_I2C_MASTER_ADDR_NAK; break;
+        case FAULT_ARB_LOST:  bits  = CY_SCB_I2C_MASTER_ARB_LOST; break;
+        case FAULT_BUS_ERR:   bits  = CY_SCB_I2C_MASTER_BUS_ERR;  break;
+        case FAULT_STUCK_SDA: event = TRACE_M_RECOVER;            break;
+        case FAULT_SLAVE_WEDGED:
+        default:              event = TRACE_M_TIMEOUT;            break;
+    }
+
+    if ((trace->head - start) > TRACE_RECORDS)
+    {
+        start = trace->head - TRACE_RECORDS;
+    }
+    for (i = start; i != trace->head; i++)
+    {
+        i2c_trace_record_t const *record = &trace->ring[i & TRACE_INDEX_MASK];
+
+        if (((record->eventStamp >> TRACE_EVENT_SHIFT) == event) && ((record->statusCount & bits) == bits))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: executed
+****************************************************************************//**
+*
+* Summary:
+*   Lets the slave parse its buffer and checks that the last command sent was
+*   executed and reported as such.
+*
+*******************************************************************************/
+static bool executed(void)
+{
+    CheckEzI2Cbuffer();
+    return ((READ_CMPLT == ReadStatusPacketFromEzI2C(&CYBSP_I2C_master)) &&
+            (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) == cmd));
+}
+
+/*******************************************************************************
+* Function Name: send
+****************************************************************************//**
+*
+* Summary:
+*   Sends the next command with the blocking master API.
+*
+*******************************************************************************/
+static uint8_t send(void)
+{
+    uint8_t packet[WRITE_PACKET_SIZE];
+
+    cmd = (cmd == ON) ? OFF : ON;
+    return (WritePacketToEzI2C(&CYBSP_I2C_master, packet, PrepareCommandPacket(&CYBSP_I2C_master, packet, cmd)));
+}
+
+/*******************************************************************************
+* Function Name: bench_scenario
+****************************************************************************//**
+*
+* Summary:
+*   Runs one scenario and prints one result row.
+*
+* Return:
+*   true if the command had the expected outcome, the trace recorded the
+*   cause and the bus works after the fault was removed.
+*
+*******************************************************************************/
+static bool bench_scenario(bench_scenario_t const *sc)
+{
+    uint32_t retries = GetRecoveryStats(&CYBSP_I2C_master)->retries;
+    uint32_t traceStart = GetTrace()->head;
+    uint64_t t0;
+    uint64_t elapsed;
+    bool delivered;
+    bool cause;
+    bool recovered;
+
+    inject(sc->fault, (FAULT_SLAVE_WEDGED == sc->fault) ? 1U : sc->count);
+    t0 = sim_now_ns();
+    delivered = (TRANSFER_CMPLT == send());
+    elapsed = sim_now_ns() - t0;
+    cause = traced(sc->fault, traceStart);
+    inject(sc->fault, 0U);
+
+    /* A delivered command must have been executed; after a failure the
+     * next command must go through.
+     */
+    recovered = delivered ? executed() : ((TRANSFER_CMPLT == send()) && executed());
+
+    printf("  %-22s  %-9s  %7lu  %10.1f  %-6s  %s\n", sc->name, delivered ? "delivered" : "failed",
+           (unsigned long)(GetRecoveryStats(&CYBSP_I2C_master)->retries - retries),
+           (double)elapsed / SIM_NS_PER_US, cause ? "yes" : "NO", recovered ? "yes" : "NO");
+
+    return ((delivered == sc->delivered) && cause && recovered);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: recovery_bench [-r data_rate_hz] [-T trace_file] [-c]
+*
+*   -T writes the bus event trace to trace_file at the end, for
+*   trace_decode. -c checks every scenario against its expected outcome and
+*   the failure counters against each other, and exits non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t dataRate = SIM_DEFAULT_DATA_RATE_HZ;
+    const char *traceFile = NULL;
+    i2c_recovery_stats_t const *stats;
+    bool check = false;
+    bool ok = true;
+    uint32_t i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:T:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'r': dataRate  = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'T': traceFile = optarg; break;
+            case 'c': check     = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-r data_rate_hz] [-T trace_file] [-c]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (0U == dataRate)
+    {
+        fprintf(stderr, "data rate must be non-zero\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Same bring-up sequence as main.c */
+    TRACE_INIT();
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initSlave()) || (I2C_SUCCESS != initMaster()))
+    {
+        fprintf(stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    dataRate = SwitchDataRate(dataRate);
+    if (0U == dataRate)
+    {
+        fprintf(stderr, "data rate not supported\n");
+        return EXIT_FAILURE;
+    }
+    __enable_irq();
+
+    printf("Bus recovery host benchmark\n");
+    printf("  data rate          : %lu Hz\n", (unsigned long)dataRate);
+    printf("  %-22s  %-9s  %7s  %10s  %-6s  %s\n", "scenario", "command", "retries", "time (us)", "traced",
+           "bus ok after");
+
+    for (i = 0U; i < (sizeof(scenarios) / sizeof(scenarios[0])); i++)
+    {
+        ok = bench_scenario(&scenarios[i]) && ok;
+    }
+
+    stats = GetRecoveryStats(&CYBSP_I2C_master);
+    printf("  failures %lu: NAK %lu, arbitration lost %lu, bus error %lu, timeout %lu\n",
+           (unsigned long)stats->failures, (unsigned long)stats->naks, (unsigned long)stats->arbLost,
+           (unsigned long)stats->busErrors, (unsigned long)stats->timeouts);
+    printf("  SDA stuck %lu, cleared by clock-out %lu; retries %lu, recovered %lu, given up %lu\n",
+           (unsigned long)stats->stuckBus, (unsigned long)stats->clockOuts, (unsigned long)stats->retries,
+           (unsigned long)stats->recovered, (unsigned long)stats->unrecovered);
+
+    ok = ok && (stats->failures == (stats->naks + stats->arbLost + stats->busErrors + stats->timeouts)) &&
+         (stats->failures == (stats->retries + stats->unrecovered));
+
+    if (NULL != traceFile)
+    {
+        FILE *file = fopen(traceFile, "wb");
+
+        if ((NULL == file) || (1U != fwrite(GetTrace(), sizeof(i2c_trace_t), 1U, file)))
+        {
+            perror(traceFile);
+            ok = false;
+        }
+        if (NULL != file)
+        {
+            fclose(file);
+        }
+    }
+
+    if (check && !ok)
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
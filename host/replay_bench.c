@@ -0,0 +1,491 @@
+/******************************************************************************
+* File Name:   replay_bench.c
+*
+* Description: Transaction replay benchmark. Plays a log written by the master
+*              transfer recorder (SetMasterRecorder(), i2c_bench -L) back
+*              against the simulated EZI2C slave, which runs the real
+*              CheckEzI2Cbuffer() after every phase that ends with a STOP.
+*              Each phase is issued with the transfer configuration, data
+*              and gap of its record. The log is streamed one record at a
+*              time, so memory use does not depend on its length. Reports
+*              per-transaction latency against the recorded one, throughput,
+*              and the phases whose outcome or read data differ from the log.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "I2CDataRate.h"
+#include "I2CRecord.h"
+#include "sim.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Master status bits that make a phase fail (MASTER_ERROR_MASK of I2CMaster.c) */
+#define REPLAY_ERROR_MASK       (CY_SCB_I2C_MASTER_DATA_NAK | CY_SCB_I2C_MASTER_ADDR_NAK   | \
+                                 CY_SCB_I2C_MASTER_ARB_LOST | CY_SCB_I2C_MASTER_ABORT_START | \
+                                 CY_SCB_I2C_MASTER_BUS_ERR)
+
+/* Completion is polled at this step of virtual time */
+#define REPLAY_POLL_NS          (100ULL)
+
+/* A phase is abandoned after this many times its recorded duration */
+#define REPLAY_TIMEOUT_FACTOR   (4ULL)
+#define REPLAY_TIMEOUT_MIN_NS   (10ULL * SIM_NS_PER_MS)
+
+/* Latency histograms: 1 us bins, longer phases count in the last one */
+#define HIST_BINS               (4096UL)
+
+/* Result of read_record() */
+#define RECORD_OK               (0)
+#define RECORD_EOF              (1)
+#define RECORD_BAD              (2)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* One record of the log, decoded */
+typedef struct
+{
+    uint32_t flags;
+    uint8_t  address;
+    uint32_t gapUs;
+    uint32_t durationUs;
+    uint32_t status;
+    uint32_t size;
+    uint32_t count;
+    uint32_t dataSize;
+    uint8_t  data[RECORD_DATA_MAX];
+} replay_record_t;
+
+/* Outcome of a phase: whether it failed or timed out, and the bytes moved */
+typedef struct
+{
+    bool     failed;
+    bool     timeout;
+    uint32_t count;
+} replay_outcome_t;
+
+typedef struct
+{
+    uint32_t bins[HIST_BINS];
+    uint32_t samples;
+    uint64_t sumNs;
+    uint64_t maxNs;
+} replay_hist_t;
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static replay_record_t record;
+static uint8_t readBuffer[RECORD_DATA_MAX];
+static replay_hist_t replayedHist;
+static replay_hist_t recordedHist;
+
+/*******************************************************************************
+* Function Name: read_word
+****************************************************************************//**
+*
+* Summary:
+*   Decodes a little-endian 32-bit word of the log header.
+*
+*******************************************************************************/
+static uint32_t read_word(uint8_t const *in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8U) | ((uint32_t)in[2] << 16U) | ((uint32_t)in[3] << 24U);
+}
+
+/*******************************************************************************
+* Function Name: read_varint
+****************************************************************************//**
+*
+* Summary:
+*   Reads one varint of a record.
+*
+* Return:
+*   false at the end of the file or on a varint longer than 32 bits.
+*
+*******************************************************************************/
+static bool read_varint(FILE *log, uint32_t *value)
+{
+    uint32_t shift = 0U;
+    int byte;
+
+    *value = 0U;
+    do
+    {
+        byte = fgetc(log);
+        if ((EOF == byte) || (shift >= (RECORD_VARINT_MAX * 7U)))
+        {
+            return false;
+        }
+        *value |= ((uint32_t)byte & 0x7FU) << shift;
+        shift  += 7U;
+    } while (0 != (byte & 0x80));
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: read_record
+****************************************************************************//**
+*
+* Summary:
+*   Reads the next record of the log into rec.
+*
+* Return:
+*   RECORD_OK, RECORD_EOF at a clean end of the log, or RECORD_BAD if the log
+*   ends inside a record or a record does not decode.
+*
+*******************************************************************************/
+static int read_record(FILE *log, replay_record_t *rec)
+{
+    int flags = fgetc(log);
+    int address;
+
+    if (EOF == flags)
+    {
+        return RECORD_EOF;
+    }
+    address = fgetc(log);
+    if ((EOF == address) ||
+        !read_varint(log, &rec->gapUs) || !read_varint(log, &rec->durationUs) ||
+        !read_varint(log, &rec->status) || !read_varint(log, &rec->size) || !read_varint(log, &rec->count))
+    {
+        return RECORD_BAD;
+    }
+
+    rec->flags    = (uint32_t)flags;
+    rec->address  = (uint8_t)address;
+    rec->dataSize = (0U != (rec->flags & RECORD_F_READ)) ? rec->count : rec->size;
+    if (rec->dataSize > RECORD_DATA_MAX)
+    {
+        rec->dataSize = RECORD_DATA_MAX;
+    }
+    if (rec->dataSize != fread(rec->data, 1U, rec->dataSize, log))
+    {
+        return RECORD_BAD;
+    }
+
+    return RECORD_OK;
+}
+
+/*******************************************************************************
+* Function Name: hist_add
+****************************************************************************//**
+*
+* Summary:
+*   Counts one latency sample.
+*
+*******************************************************************************/
+static void hist_add(replay_hist_t *hist, uint64_t ns)
+{
+    uint64_t bin = ns / SIM_NS_PER_US;
+
+    hist->bins[(bin < HIST_BINS) ? bin : (HIST_BINS - 1U)]++;
+    hist->samples++;
+    hist->sumNs += ns;
+    if (ns > hist->maxNs)
+    {
+        hist->maxNs = ns;
+    }
+}
+
+/*******************************************************************************
+* Function Name: hist_percentile
+****************************************************************************//**
+*
+* Summary:
+*   Returns the upper edge of the bin holding the given percentile, in us.
+*
+*******************************************************************************/
+static uint32_t hist_percentile(replay_hist_t const *hist, uint32_t percent)
+{
+    uint64_t rank = ((uint64_t)hist->samples * percent) / 100U;
+    uint64_t seen = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < HIST_BINS; i++)
+    {
+        seen += hist->bins[i];
+        if (seen > rank)
+        {
+            break;
+        }
+    }
+
+    return (i + 1U);
+}
+
+/*******************************************************************************
+* Function Name: print_hist
+****************************************************************************//**
+*
+* Summary:
+*   Prints avg/p50/p99/max of a latency histogram.
+*
+*******************************************************************************/
+static void print_hist(const char *what, replay_hist_t const *hist)
+{
+    if (0U == hist->samples)
+    {
+        return;
+    }
+    printf("  %-19s: avg %.1f  p50 <%lu  p99 <%lu  max %.1f us\n", what,
+           (double)hist->sumNs / hist->samples / SIM_NS_PER_US,
+           (unsigned long)hist_percentile(hist, 50U), (unsigned long)hist_percentile(hist, 99U),
+           (double)hist->maxNs / SIM_NS_PER_US);
+}
+
+/*******************************************************************************
+* Function Name: replay_phase
+****************************************************************************//**
+*
+* Summary:
+*   Issues the phase of a record on the master SCB with the same transfer
+*   configuration and waits for it to end.
+*
+* Return:
+*   Time from the start of the phase to its end.
+*
+*******************************************************************************/
+static uint64_t replay_phase(replay_record_t const *rec, replay_outcome_t *outcome)
+{
+    CySCB_Type *base = CYBSP_I2C_master.hw->base;
+    cy_stc_scb_i2c_context_t *context = &CYBSP_I2C_master.context;
+    cy_stc_scb_i2c_master_xfer_config_t xfer;
+    uint64_t timeoutNs = REPLAY_TIMEOUT_FACTOR * rec->durationUs * SIM_NS_PER_US;
+    uint64_t t0 = sim_now_ns();
+    bool read = (0U != (rec->flags & RECORD_F_READ));
+    cy_en_scb_i2c_status_t started;
+
+    if (timeoutNs < REPLAY_TIMEOUT_MIN_NS)
+    {
+        timeoutNs = REPLAY_TIMEOUT_MIN_NS;
+    }
+
+    xfer.slaveAddress = rec->address;
+    xfer.buffer       = read ? readBuffer : (uint8_t *)rec->data;
+    xfer.bufferSize   = read ? rec->size : rec->dataSize;
+    xfer.xferPending  = (0U != (rec->flags & RECORD_F_PENDING));
+    if (xfer.bufferSize > RECORD_DATA_MAX)
+    {
+        xfer.bufferSize = RECORD_DATA_MAX;
+    }
+
+    started = read ? Cy_SCB_I2C_MasterRead(base, &xfer, context) : Cy_SCB_I2C_MasterWrite(base, &xfer, context);
+    while ((CY_SCB_I2C_SUCCESS == started) && (0U != (Cy_SCB_I2C_MasterGetStatus(base, context) & CY_SCB_I2C_MASTER_BUSY)) &&
+           ((sim_now_ns() - t0) < timeoutNs))
+    {
+        sim_advance_ns(REPLAY_POLL_NS);
+    }
+
+    outcome->timeout = (CY_SCB_I2C_SUCCESS == started) &&
+                       (0U != (Cy_SCB_I2C_MasterGetStatus(base, context) & CY_SCB_I2C_MASTER_BUSY));
+    outcome->failed  = (CY_SCB_I2C_SUCCESS != started) || outcome->timeout ||
+                       (0U != (Cy_SCB_I2C_MasterGetStatus(base, context) & REPLAY_ERROR_MASK));
+    outcome->count   = (CY_SCB_I2C_SUCCESS == started) ? Cy_SCB_I2C_MasterGetTransferCount(base, context) : 0U;
+
+    /* Release the bus after a failure, as AbortMasterTransfer() does */
+    if (outcome->failed)
+    {
+        Cy_SCB_I2C_Disable(base, context);
+        Cy_SCB_I2C_Enable(base, context);
+    }
+
+    return sim_now_ns() - t0;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: replay_bench [-f] [-c] log
+*
+*   The phases keep the gaps of the log unless -f plays them back to back.
+*   -c checks that the log decoded to its end and that every phase had the
+*   outcome of its record (failed or not, bytes transferred), and exits
+*   non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint8_t header[RECORD_HEADER_SIZE];
+    replay_outcome_t outcome;
+    FILE *log;
+    uint32_t dataRate;
+    uint32_t version;
+    bool fast = false;
+    bool check = false;
+    uint32_t phases = 0U;
+    uint32_t reads = 0U;
+    uint64_t bytes = 0U;
+    uint32_t outcomeMismatch = 0U;
+    uint32_t dataMismatch = 0U;
+    uint64_t t0;
+    uint64_t elapsedNs;
+    uint64_t phaseNs;
+    int result = RECORD_OK;
+    bool recordedFailed;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "fc")) != -1)
+    {
+        switch (opt)
+        {
+            case 'f': fast  = true; break;
+            case 'c': check = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-f] [-c] log\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (optind != (argc - 1))
+    {
+        fprintf(stderr, "usage: %s [-f] [-c] log\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    log = fopen(argv[optind], "rb");
+    if (NULL == log)
+    {
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+    }
+    version = (RECORD_HEADER_SIZE == fread(header, 1U, RECORD_HEADER_SIZE, log)) ? read_word(&header[4]) : 0U;
+    if ((RECORD_MAGIC != read_word(&header[0])) || (RECORD_VERSION != (version & 0xFFFFU)))
+    {
+        fprintf(stderr, "%s: not a transfer log of version %lu\n", argv[optind], (unsigned long)RECORD_VERSION);
+        (void)fclose(log);
+        return EXIT_FAILURE;
+    }
+    dataRate = read_word(&header[8]);
+
+    /* Same bring-up sequence as main.c, at the data rate of the log */
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initSlave()) || (I2C_SUCCESS != initMaster()))
+    {
+        fprintf(stderr, "initialization failed\n");
+        (void)fclose(log);
+        return EXIT_FAILURE;
+    }
+    if (0U == SwitchDataRate(dataRate))
+    {
+        fprintf(stderr, "data rate %lu Hz not supported\n", (unsigned long)dataRate);
+        (void)fclose(log);
+        return EXIT_FAILURE;
+    }
+    __enable_irq();
+
+    t0 = sim_now_ns();
+    for (;;)
+    {
+        result = read_record(log, &record);
+        if (RECORD_OK != result)
+        {
+            break;
+        }
+
+        if (!fast)
+        {
+            sim_advance_ns((uint64_t)record.gapUs * SIM_NS_PER_US);
+        }
+        memset(readBuffer, 0, sizeof(readBuffer));
+        phaseNs = replay_phase(&record, &outcome);
+
+        phases++;
+        bytes += outcome.count;
+        hist_add(&replayedHist, phaseNs);
+        hist_add(&recordedHist, (uint64_t)record.durationUs * SIM_NS_PER_US);
+
+        recordedFailed = (0U != (record.flags & RECORD_F_TIMEOUT)) || (0U != (record.status & REPLAY_ERROR_MASK));
+        if ((recordedFailed != outcome.failed) || (record.count != outcome.count))
+        {
+            outcomeMismatch++;
+        }
+        if (0U != (record.flags & RECORD_F_READ))
+        {
+            reads++;
+            if (0 != memcmp(readBuffer, record.data, record.dataSize))
+            {
+                dataMismatch++;
+            }
+        }
+
+        /* The slave main loop runs once the master has let go of the bus */
+        if (0U == (record.flags & RECORD_F_PENDING))
+        {
+            CheckEzI2Cbuffer();
+        }
+    }
+    elapsedNs = sim_now_ns() - t0;
+    (void)fclose(log);
+
+    printf("Transaction replay host benchmark\n");
+    printf("  log                : %s, %lu Hz%s\n", argv[optind], (unsigned long)dataRate,
+           (RECORD_BAD == result) ? ", ends inside a record" : "");
+    printf("  timing             : %s\n", fast ? "back to back" : "gaps of the log");
+    printf("  phases             : %lu (%lu writes, %lu reads), %llu bytes\n", (unsigned long)phases,
+           (unsigned long)(phases - reads), (unsigned long)reads, (unsigned long long)bytes);
+    bench_print_rate("phases/s", phases, elapsedNs);
+    printf("  %-19s: %.1f kB/s\n", "throughput",
+           (0U != elapsedNs) ? ((double)bytes * SIM_NS_PER_SEC / elapsedNs / 1000.0) : 0.0);
+    print_hist("replayed latency", &replayedHist);
+    print_hist("recorded latency", &recordedHist);
+    printf("  mismatches         : %lu outcome, %lu read data\n",
+           (unsigned long)outcomeMismatch, (unsigned long)dataMismatch);
+
+    if (check && ((RECORD_EOF != result) || (0U == phases) || (0U != outcomeMismatch)))
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,303 @@
+/******************************************************************************
+* File Name:   ring_bench.c
+*
+* Description: Host benchmark of the command ring in the EZI2C slave buffer.
+*              Pushes commands in batches of increasing size, lets the slave
+*              drain the ring once per batch and reads the ring status back,
+*              and reports command throughput against batch size in virtual
+*              bus time.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "I2CDataRate.h"
+#include "sim.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define OFF                     CYBSP_LED_STATE_OFF
+#define ON                      CYBSP_LED_STATE_ON
+
+#define DEFAULT_COMMANDS        (10000UL)
+
+/* Cut slot case: commands sent after the cut frame, enough to wrap the ring
+ * back to its slot twice. Small batches alternate between the two slave
+ * buffers and one of them starts at the cut slot on every pass.
+ */
+#define CUT_COMMANDS            ((2UL * COMMAND_RING_SLOTS) + 5UL)
+#define CUT_BATCH               (2UL)
+
+/*******************************************************************************
+* Function Name: bench_batch
+****************************************************************************//**
+*
+* Summary:
+*   Sends commands in batches of batchSize and prints one result row.
+*
+* Return:
+*   true if every batch was queued and every status read reported success.
+*
+*******************************************************************************/
+static bool bench_batch(uint32_t commands, uint32_t batchSize, uint8_t *lastCmd)
+{
+    uint8_t batch[COMMAND_RING_MAX_BATCH];
+    uint8_t cmd = ON;
+    uint32_t sent = 0U;
+    uint32_t failures = 0U;
+    uint32_t n;
+    uint32_t i;
+    uint64_t t0 = sim_now_ns();
+    sim_stats_t before = *sim_get_stats();
+    sim_stats_t const *after;
+    uint64_t elapsed;
+
+    while (sent < commands)
+    {
+        n = ((commands - sent) < batchSize) ? (commands - sent) : batchSize;
+        for (i = 0U; i < n; i++)
+        {
+            batch[i] = cmd;
+            cmd = (cmd == ON) ? OFF : ON;
+        }
+
+        if (TRANSFER_CMPLT != PushCommandsToEzI2C(&CYBSP_I2C_master, batch, n))
+        {
+            failures++;
+            break;
+        }
+        CheckEzI2Cbuffer();
+        if (TRANSFER_CMPLT != ReadCommandRingStatus(&CYBSP_I2C_master))
+        {
+            failures++;
+        }
+
+        *lastCmd = batch[n - 1U];
+        sent += n;
+    }
+
+    elapsed = sim_now_ns() - t0;
+    after = sim_get_stats();
+    printf("  %5lu  %12.0f  %10.1f  %10.2f  %9.1f%%\n",
+           (unsigned long)batchSize,
+           (elapsed > 0U) ? ((double)sent * SIM_NS_PER_SEC / elapsed) : 0.0,
+           (sent > 0U) ? ((double)elapsed / SIM_NS_PER_US / sent) : 0.0,
+           (sent > 0U) ? ((double)(after->bytes - before.bytes) / sent) : 0.0,
+           (elapsed > 0U) ? (100.0 * (after->busActiveNs - before.busActiveNs) / elapsed) : 0.0);
+
+    return ((sent == commands) && (0U == failures));
+}
+
+/*******************************************************************************
+* Function Name: slave_counter
+****************************************************************************//**
+*
+* Summary:
+*   Reads a counter of the telemetry window, 0 if the read fails.
+*
+*******************************************************************************/
+static uint32_t slave_counter(uint32_t pos)
+{
+    uint8_t tlm[TLM_SIZE];
+
+    if (READ_CMPLT != ReadTelemetryFromEzI2C(&CYBSP_I2C_master, (uint8_t)TLM_SEQ_POS, tlm, TLM_SIZE))
+    {
+        return 0U;
+    }
+    return (uint32_t)tlm[pos] | ((uint32_t)tlm[pos + 1U] << 8U) |
+           ((uint32_t)tlm[pos + 2U] << 16U) | ((uint32_t)tlm[pos + 3U] << 24U);
+}
+
+/*******************************************************************************
+* Function Name: bench_cut_slot
+****************************************************************************//**
+*
+* Summary:
+*   Writes only the header of a frame into the ring slot at the tail, as a
+*   write cut short by a bus fault leaves it, then sends CUT_COMMANDS
+*   commands in batches, which wrap the ring back to that slot. The slave
+*   must reject the cut frame once and execute every command after it.
+*
+* Return:
+*   true if every batch was acknowledged and executed, and only the cut
+*   frame was rejected.
+*
+*******************************************************************************/
+static bool bench_cut_slot(uint8_t *lastCmd)
+{
+    uint8_t packet[WRITE_PACKET_SIZE];
+    uint8_t batch[CUT_BATCH];
+    uint8_t cmd = ON;
+    uint32_t rejected = slave_counter(TLM_REJECTED_POS);
+    uint32_t executed = slave_counter(TLM_COMMANDS_POS);
+    uint32_t failures = 0U;
+    uint32_t sent = 0U;
+    uint32_t n;
+    uint32_t i;
+
+    (void)PrepareCommandPacket(&CYBSP_I2C_master, packet, cmd);
+    packet[PACKET_ADDR_POS] = (uint8_t)(EZI2C_RING_BASE_POS + (CYBSP_I2C_master.ringHead * EZI2C_RING_SLOT_SIZE));
+    if (TRANSFER_CMPLT != WritePacketToEzI2C(&CYBSP_I2C_master, packet, PACKET_SOP_POS + FRAME_PAYLOAD_OFS))
+    {
+        failures++;
+    }
+    CheckEzI2Cbuffer();
+
+    while (sent < CUT_COMMANDS)
+    {
+        n = ((CUT_COMMANDS - sent) < CUT_BATCH) ? (CUT_COMMANDS - sent) : CUT_BATCH;
+        for (i = 0U; i < n; i++)
+        {
+            batch[i] = cmd;
+            cmd = (cmd == ON) ? OFF : ON;
+        }
+        if ((TRANSFER_CMPLT != PushCommandsToEzI2C(&CYBSP_I2C_master, batch, n)))
+        {
+            failures++;
+            break;
+        }
+        CheckEzI2Cbuffer();
+        if (TRANSFER_CMPLT != ReadCommandRingStatus(&CYBSP_I2C_master))
+        {
+            failures++;
+        }
+        *lastCmd = batch[n - 1U];
+        sent += n;
+    }
+
+    rejected = slave_counter(TLM_REJECTED_POS) - rejected;
+    executed = slave_counter(TLM_COMMANDS_POS) - executed;
+    printf("  cut ring slot      : %lu of %lu commands executed, %lu frames rejected\n",
+           (unsigned long)executed, (unsigned long)CUT_COMMANDS, (unsigned long)rejected);
+
+    return ((0U == failures) && (CUT_COMMANDS == executed) && (1U == rejected));
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: ring_bench [-n commands] [-r data_rate_hz] [-b batch] [-c]
+*
+*   Without -b the batch size is swept from 1 to COMMAND_RING_MAX_BATCH.
+*   A ring slot holding a cut frame is then passed over more than once.
+*   -c checks that every batch was executed and exits non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static const uint32_t sweep[] = { 1U, 2U, 4U, 8U, COMMAND_RING_MAX_BATCH };
+    uint32_t commands = DEFAULT_COMMANDS;
+    uint32_t dataRate = SIM_DEFAULT_DATA_RATE_HZ;
+    uint32_t batchSize = 0U;
+    bool check = false;
+    bool ok = true;
+    uint8_t lastCmd = ON;
+    uint32_t i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:r:b:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': commands  = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'r': dataRate  = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'b': batchSize = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': check     = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n commands] [-r data_rate_hz] [-b batch] [-c]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if ((0U == commands) || (0U == dataRate) || (batchSize > COMMAND_RING_MAX_BATCH))
+    {
+        fprintf(stderr, "commands and data rate must be non-zero, batch at most %lu\n",
+                (unsigned long)COMMAND_RING_MAX_BATCH);
+        return EXIT_FAILURE;
+    }
+
+    /* Same bring-up sequence as main.c */
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initSlave()) || (I2C_SUCCESS != initMaster()))
+    {
+        fprintf(stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    dataRate = SwitchDataRate(dataRate);
+    if (0U == dataRate)
+    {
+        fprintf(stderr, "data rate not supported\n");
+        return EXIT_FAILURE;
+    }
+    __enable_irq();
+
+    printf("EZI2C command ring host benchmark\n");
+    printf("  data rate          : %lu Hz\n", (unsigned long)dataRate);
+    printf("  commands per size  : %lu\n", (unsigned long)commands);
+    printf("  %5s  %12s  %10s  %10s  %10s\n", "batch", "commands/s", "us/command", "bytes/cmd", "bus busy");
+
+    if (0U != batchSize)
+    {
+        ok = bench_batch(commands, batchSize, &lastCmd);
+    }
+    else
+    {
+        for (i = 0U; i < (sizeof(sweep) / sizeof(sweep[0])); i++)
+        {
+            ok = bench_batch(commands, sweep[i], &lastCmd) && ok;
+        }
+    }
+    ok = bench_cut_slot(&lastCmd) && ok;
+
+    if (check && (!ok || (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) != lastCmd)))
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
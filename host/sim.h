@@ -0,0 +1,154 @@
+/******************************************************************************
+* File Name:   sim.h
+*
+* Description: Control and observation interface of the host-side I2C bus
+*              model. The model advances a virtual clock only when the code
+*              under test waits (Cy_SysLib_Delay*) or when the host harness
+*              calls sim_advance_ns(), so all bus timing is deterministic and
+*              independent of the speed of the host.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef HOST_SIM_H_
+#define HOST_SIM_H_
+
+#include "cy_pdl.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SIM_NS_PER_US               (1000ULL)
+#define SIM_NS_PER_MS               (1000000ULL)
+#define SIM_NS_PER_SEC              (1000000000ULL)
+
+/* Data rate every SCB comes out of reset with (matches design.modus) */
+#define SIM_DEFAULT_DATA_RATE_HZ    (400000UL)
+
+/* Fault classes of the injector (sim_set_faults()), with the opportunity
+ * each rate is counted against. SIM_FAULT_CORRUPT leaves the EZI2C
+ * sub-address alone: a write moved to another offset lands outside any frame
+ * or in the wrong one, which the frame CRC does not cover.
+ */
+#define SIM_FAULT_ABORT_START       (0UL)   /* START refused; per START */
+#define SIM_FAULT_ADDR_NAK          (1UL)   /* Address not acknowledged; per address byte */
+#define SIM_FAULT_DATA_NAK          (2UL)   /* Written byte not acknowledged; per byte written */
+#define SIM_FAULT_ARB_LOST          (3UL)   /* Arbitration lost; per byte */
+#define SIM_FAULT_BUS_ERR           (4UL)   /* Misplaced START or STOP; per byte */
+#define SIM_FAULT_STRETCH           (5UL)   /* Slave holds SCL before a data byte; per data byte */
+#define SIM_FAULT_STUCK_SDA         (6UL)   /* A device holds SDA low; per data byte */
+#define SIM_FAULT_CORRUPT           (7UL)   /* One bit flipped; per data byte but the sub-address */
+#define SIM_FAULT_COUNT             (8UL)
+
+/* Fault rates are given per million opportunities */
+#define SIM_FAULT_PPM               (1000000UL)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Bus and CPU counters accumulated since the last sim_reset() */
+typedef struct
+{
+    uint64_t busActiveNs;   /* Time between START and STOP on any bus */
+    uint64_t stretchNs;     /* Time SCL was held low waiting for a slave ISR */
+    uint64_t cpuDelayNs;    /* Time the CPU spent inside Cy_SysLib_Delay*() */
+    uint64_t cpuWorkNs;     /* Time the CPU spent in sim_cpu_work_ns() */
+    uint32_t starts;
+    uint32_t restarts;
+    uint32_t stops;
+    uint32_t bytes;         /* Address and data bytes clocked on the wire */
+    uint32_t naks;
+    uint32_t gpioWrites;    /* Cy_GPIO_Write() calls to pins not wired to a bus */
+    uint64_t sleepNs;       /* Time the CPU spent in Sleep */
+    uint64_t deepSleepNs;   /* Time the device spent in Deep Sleep, wakeup excluded */
+    uint32_t wakeups;
+} sim_stats_t;
+
+/* Timestamps of a transfer started with sim_external_write() */
+typedef struct
+{
+    uint64_t startNs;       /* START */
+    uint64_t addrNs;        /* Address byte clocked, slave address match */
+    uint64_t firstByteNs;   /* First byte after the address acknowledged */
+    uint64_t doneNs;        /* STOP */
+    uint32_t error;         /* CY_SCB_I2C_MASTER_* status bits */
+    uint32_t delivered;     /* Bytes acknowledged */
+} sim_ext_xfer_t;
+
+/* Called for every fault injected, with its class and the time */
+typedef void (*sim_fault_hook_t)(uint32_t fault, uint64_t atNs);
+
+/* Fault injector settings. The faults are drawn from a pseudo-random
+ * sequence started at seed, so a run with the same settings injects the
+ * same faults at the same points.
+ */
+typedef struct
+{
+    uint32_t         seed;                      /* Non-zero */
+    uint32_t         ppm[SIM_FAULT_COUNT];      /* Rate of each class */
+    uint64_t         stretchMaxNs;              /* Longest SIM_FAULT_STRETCH hold */
+    uint32_t         stuckClocks;               /* SCL clocks that release a stuck SDA */
+    sim_fault_hook_t hook;                      /* Can be NULL */
+} sim_fault_config_t;
+
+/* Faults injected since the injector was configured */
+typedef struct
+{
+    uint32_t injected[SIM_FAULT_COUNT];
+    uint64_t stretchNs;     /* Total SIM_FAULT_STRETCH hold time */
+} sim_fault_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void sim_reset(void);
+uint64_t sim_now_ns(void);
+void sim_advance_ns(uint64_t ns);
+void sim_cpu_work_ns(uint64_t ns);
+void sim_set_data_rate(CySCB_Type *base, uint32_t dataRateHz);
+uint32_t sim_get_data_rate(CySCB_Type const *base);
+sim_stats_t const *sim_get_stats(void);
+void sim_set_bus_limit(uint32_t busIdx, uint32_t maxRateHz, uint32_t errorEvery);
+void sim_hold_sda(uint32_t busIdx, uint32_t clocks);
+void sim_inject_master_error(CySCB_Type *base, uint32_t masterStatus, uint32_t count);
+void sim_set_faults(uint32_t busIdx, sim_fault_config_t const *config);
+sim_fault_stats_t const *sim_get_fault_stats(void);
+uint32_t sim_add_ezi2c_node(uint32_t busIdx, uint8_t address, uint8_t *buffer, uint32_t size, uint32_t rwBoundary);
+uint32_t sim_node_get_activity(uint32_t node);
+void sim_external_write(uint32_t busIdx, uint64_t atNs, uint8_t address, uint8_t const *data, uint32_t size);
+sim_ext_xfer_t const *sim_external_result(void);
+
+#endif /* HOST_SIM_H_ */
@@ -0,0 +1,2213 @@
+/******************************************************************************
+* File Name:   sim_pdl.c
+*
+* Description: Host-side implementation of the PDL stand-in declared in
+*              pdl/cy_pdl.h. Models an I2C bus at byte granularity: the SCB
+*              I2C master clocks START, address, data and STOP phases at its
+*              configured data rate, and every EZI2C slave event (address
+*              match, byte received, byte to transmit) is handed to the slave
+*              ISR through the simulated NVIC. While a slave event is waiting
+*              for its ISR the bus is stretched, exactly as the SCB hardware
+*              holds SCL low on the real part. Sleep and Deep Sleep run the
+*              clock until an interrupt is pending; the WDT and an address
+*              match of a slave armed for wakeup end Deep Sleep. A seedable
+*              fault injector can make the bus fail in every way the master
+*              reports, stretch, stick or corrupt bytes at given rates.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "sim.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SIM_SCB_COUNT           (4UL)
+#define SIM_BUS_COUNT           (2UL)
+#define SIM_SLV_EVT_DEPTH       (4UL)
+#define SIM_NODE_COUNT          (8UL)
+
+/* 8 data bits plus the ACK/NAK bit */
+#define SIM_BITS_PER_BYTE       (9UL)
+
+/* START, repeated START, STOP and bus free time are modeled as one bit time */
+#define SIM_BITS_PER_COND       (1UL)
+
+/* EZI2C returns this value when the master reads past the end of a buffer */
+#define SIM_EZI2C_DEFAULT_TX    (0xFFU)
+
+/* CPU clock: IMO at 48 MHz in design.modus */
+#define SIM_CPU_CLOCK_HZ        (48000000UL)
+
+/* Peripheral clock dividers: 16-bit dividers of HFCLK (= CPU clock). Out of
+ * reset the I2C master SCB runs from div_16[1] set to 5 and the EZI2C SCB
+ * from div_16[2] set to 4, as in design.modus.
+ */
+#define SIM_DIV16_COUNT         (4UL)
+#define SIM_I2C_CLK_DIVIDER     (5UL)
+#define SIM_EZI2C_CLK_DIVIDER   (4UL)
+
+/* SCB clock oversampling of one SCL period the master can time */
+#define SIM_I2C_OVS_MIN         (12UL)
+#define SIM_I2C_OVS_MAX         (32UL)
+
+/* WDT: 16-bit counter clocked by the 40 kHz ILO */
+#define SIM_WDT_TICK_NS         (25000ULL)
+#define SIM_WDT_COUNT_MASK      (0xFFFFUL)
+
+/* Deep Sleep to Active transition time (PSOC 4 datasheet) */
+#define SIM_DEEPSLEEP_WAKE_NS   (35000ULL)
+
+#define SIM_PM_CALLBACKS        (8UL)
+
+/* Clock events other than the bus index */
+#define SIM_EVT_WDT             (SIM_BUS_COUNT)
+#define SIM_EVT_EXT             (SIM_BUS_COUNT + 1UL)
+#define SIM_EVT_NONE            (SIM_BUS_COUNT + 2UL)
+#define SIM_EXT_MAX_SIZE        (64UL)
+
+/* GPIO pins per port */
+#define SIM_GPIO_PINS           (8UL)
+
+/* Driver state kept in cy_stc_scb_i2c_context_t.state */
+#define SIM_I2C_IDLE            (0UL)
+#define SIM_I2C_MASTER_ACTIVE   (1UL)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef enum
+{
+    SIM_SCB_UNUSED,
+    SIM_SCB_I2C_MASTER,
+    SIM_SCB_EZI2C
+} sim_scb_mode_t;
+
+typedef enum
+{
+    SIM_SLV_EVT_ADDR,           /* Address matched, byte carries R/W bit */
+    SIM_SLV_EVT_RX,             /* Data byte received, ACK/NAK pending */
+    SIM_SLV_EVT_TX,             /* Master reads, next byte to be provided */
+    SIM_SLV_EVT_STOP            /* STOP or repeated START ended the access */
+} sim_slv_evt_type_t;
+
+typedef struct
+{
+    sim_slv_evt_type_t type;
+    uint8_t            data;
+} sim_slv_evt_t;
+
+typedef enum
+{
+    SIM_BUS_IDLE,
+    SIM_BUS_START,
+    SIM_BUS_ADDR,
+    SIM_BUS_WRITE,
+    SIM_BUS_READ,
+    SIM_BUS_STOP,
+    SIM_BUS_HELD                /* Master kept the bus (xferPending) */
+} sim_bus_phase_t;
+
+typedef enum
+{
+    SIM_PWR_ACTIVE,
+    SIM_PWR_SLEEP,
+    SIM_PWR_DEEPSLEEP
+} sim_pwr_mode_t;
+
+typedef struct
+{
+    sim_bus_phase_t phase;
+    uint64_t        phaseEnd;
+    uint64_t        activeStart;
+    uint64_t        freeAt;
+    bool            stretched;
+    uint64_t        stretchStart;
+    CySCB_Type      *master;
+    CySCB_Type      *slave;
+    struct sim_node *node;
+    uint8_t         address;
+    bool            rdDir;
+    bool            pending;
+    uint8_t         *buffer;
+    uint32_t        size;
+    uint32_t        idx;
+    uint32_t        error;
+    uint8_t         rdByte;
+    uint32_t        sdaHold;    /* SCL clocks until a stuck device releases SDA */
+    uint32_t        maxRateHz;  /* Fastest rate the wiring carries cleanly, 0 for any */
+    uint32_t        errorEvery; /* Above maxRateHz, every errorEvery-th address is lost */
+    uint32_t        errorCount;
+} sim_bus_t;
+
+struct sim_scb
+{
+    uint32_t                   bus;
+    IRQn_Type                  irq;
+    sim_scb_mode_t             mode;
+    bool                       enabled;
+    uint32_t                   dataRateHz;
+    uint32_t                   clockDiv;       /* 16-bit divider clocking the SCB */
+
+    /* I2C master */
+    cy_stc_scb_i2c_context_t   *i2cContext;
+    bool                       mstDone;
+    uint32_t                   mstError;
+    uint32_t                   mstCount;
+    uint32_t                   injectError;    /* Status forced on the next transfers */
+    uint32_t                   injectCount;
+
+    /* EZI2C slave */
+    cy_stc_scb_ezi2c_context_t *ezContext;
+    uint8_t                    slaveAddress1;
+    uint8_t                    slaveAddress2;
+    bool                       twoAddresses;
+    bool                       wakeEnabled;    /* Address match wakes from Deep Sleep */
+    bool                       wakeArmed;      /* Device is in Deep Sleep with wake enabled */
+    sim_slv_evt_t              evt[SIM_SLV_EVT_DEPTH];
+    uint32_t                   evtHead;
+    uint32_t                   evtCount;
+};
+
+struct sim_gpio_prt
+{
+    uint32_t       out;
+    en_hsiom_sel_t hsiom[SIM_GPIO_PINS];
+};
+
+/* EZI2C device without an SCB or ISR in this model, served as the bytes
+ * arrive so it never stretches the bus
+ */
+typedef struct sim_node
+{
+    uint32_t                   bus;
+    cy_stc_scb_ezi2c_context_t context;
+} sim_node_t;
+
+/* Peripheral clock divider */
+typedef struct
+{
+    uint32_t value;     /* Divide ratio minus one */
+    bool     enabled;
+} sim_div_t;
+
+/* SCB clock ranges of an I2C data rate class (PDL SCB I2C chapter) */
+typedef struct
+{
+    uint32_t maxRateHz;
+    uint32_t masterClkMinHz;
+    uint32_t masterClkMaxHz;
+    uint32_t slaveClkMinHz;
+} sim_rate_class_t;
+
+/* Port pin wired to a bus line */
+typedef struct
+{
+    GPIO_PRT_Type *port;
+    uint32_t      pin;
+    uint32_t      bus;
+    bool          sda;
+} sim_bus_pin_t;
+
+/* WDT counter: counts from start while enabled; lastTick is the last tick
+ * whose match was evaluated
+ */
+typedef struct
+{
+    bool     enabled;
+    uint64_t start;
+    uint32_t frozen;
+    uint64_t lastTick;
+    uint32_t match;
+    bool     intr;
+    bool     masked;
+} sim_wdt_t;
+
+/* Write transfer of a master outside the device */
+typedef struct
+{
+    bool           armed;
+    uint32_t       bus;
+    uint64_t       startAt;
+    uint8_t        address;
+    uint8_t        data[SIM_EXT_MAX_SIZE];
+    uint32_t       size;
+    sim_ext_xfer_t result;
+} sim_ext_t;
+
+/* Fault injector on one bus */
+typedef struct
+{
+    bool               enabled;
+    uint32_t           bus;
+    sim_fault_config_t config;
+    uint32_t           random;      /* xorshift32 state */
+    sim_fault_stats_t  stats;
+} sim_fault_t;
+
+typedef struct
+{
+    cy_israddress isr[SIM_IRQn_COUNT];
+    uint32_t      priority[SIM_IRQn_COUNT];
+    bool          enabled[SIM_IRQn_COUNT];
+    bool          pending[SIM_IRQn_COUNT];
+    bool          globalEnabled;
+    bool          inIsr;
+} sim_nvic_t;
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+CySCB_Type sim_scb0, sim_scb1, sim_scb2, sim_scb3;
+GPIO_PRT_Type sim_gpio_prt0, sim_gpio_prt1, sim_gpio_prt2, sim_gpio_prt3;
+
+const cy_stc_scb_i2c_config_t CYBSP_I2C_config =
+{
+    .i2cMode             = CY_SCB_I2C_MASTER,
+    .useRxFifo           = true,
+    .useTxFifo           = true,
+    .slaveAddress        = 16U,
+    .slaveAddressMask    = 254U,
+    .acceptAddrInFifo    = false,
+    .ackGeneralAddr      = false,
+    .enableWakeFromSleep = false,
+    .enableDigitalFilter = true,
+    .lowPhaseDutyCycle   = 16U,
+    .highPhaseDutyCycle  = 9U,
+};
+
+const cy_stc_scb_ezi2c_config_t CYBSP_EZI2C_config =
+{
+    .numberOfAddresses   = CY_SCB_EZI2C_TWO_ADDRESSES,
+    .slaveAddress1       = 8U,
+    .slaveAddress2       = 9U,
+    .subAddressSize      = CY_SCB_EZI2C_SUB_ADDR8_BITS,
+    .enableWakeFromSleep = true,
+};
+
+static CySCB_Type * const simScbs[SIM_SCB_COUNT] = { &sim_scb0, &sim_scb1, &sim_scb2, &sim_scb3 };
+static GPIO_PRT_Type * const simPorts[] = { &sim_gpio_prt0, &sim_gpio_prt1, &sim_gpio_prt2, &sim_gpio_prt3 };
+
+static uint64_t simNow;
+static sim_stats_t simStats;
+static sim_nvic_t simNvic;
+static sim_bus_t simBus[SIM_BUS_COUNT];
+static sim_node_t simNodes[SIM_NODE_COUNT];
+static uint32_t simNodeCount;
+static sim_pwr_mode_t simPower;
+static cy_stc_syspm_callback_t *simPmCallbacks[SIM_PM_CALLBACKS];
+static uint32_t simPmCallbackCount;
+static sim_wdt_t simWdt;
+static CySCB_Type simExtScb;
+static sim_ext_t simExt;
+static sim_fault_t simFault;
+static sim_div_t simDiv16[SIM_DIV16_COUNT];
+
+static const sim_rate_class_t simRateClasses[] =
+{
+    {  100000UL,  1550000UL,  3200000UL,  1550000UL },
+    {  400000UL,  7820000UL, 10000000UL,  7820000UL },
+    { 1000000UL, 14320000UL, 25800000UL, 15840000UL },
+};
+
+/* Pins of the master SCBs on bus 0 and bus 1, used to bit-bang the bus */
+static const sim_bus_pin_t simBusPins[] =
+{
+    { CYBSP_I2C_SCL_PORT,  CYBSP_I2C_SCL_NUM,  0U, false },
+    { CYBSP_I2C_SDA_PORT,  CYBSP_I2C_SDA_NUM,  0U, true  },
+    { CYBSP_I2C2_SCL_PORT, CYBSP_I2C2_SCL_NUM, 1U, false },
+    { CYBSP_I2C2_SDA_PORT, CYBSP_I2C2_SDA_NUM, 1U, true  },
+};
+
+/* SysTick: counts down from reload at SystemCoreClock from simSysTickStart */
+static bool simSysTickEnabled;
+static uint32_t simSysTickReload;
+static uint64_t simSysTickStart;
+
+uint32_t SystemCoreClock = SIM_CPU_CLOCK_HZ;
+
+/*******************************************************************************
+* Function Declaration
+*******************************************************************************/
+static void sim_irq_pend(IRQn_Type irq);
+static void sim_irq_dispatch(void);
+static void sim_bus_continue(sim_bus_t *bus);
+static void sim_ezi2c_on_address(cy_stc_scb_ezi2c_context_t *context, uint8_t addrByte);
+static bool sim_ezi2c_on_rx(cy_stc_scb_ezi2c_context_t *context, uint8_t data);
+static uint8_t sim_ezi2c_on_tx(cy_stc_scb_ezi2c_context_t *context);
+static void sim_ezi2c_on_stop(cy_stc_scb_ezi2c_context_t *context);
+
+/*******************************************************************************
+* Function Name: sim_assert_failed
+****************************************************************************//**
+*
+* Summary:
+*   CY_ASSERT() handler. Reports the failing location and aborts the process.
+*
+*******************************************************************************/
+void sim_assert_failed(const char *file, int line)
+{
+    fprintf(stderr, "CY_ASSERT failed at %s:%d\n", file, line);
+    abort();
+}
+
+/*******************************************************************************
+* Function Name: sim_reset
+****************************************************************************//**
+*
+* Summary:
+*   Returns the virtual clock, NVIC, buses, SCBs and GPIO ports to their
+*   power-on state. SCB0 and SCB1 share bus 0 (the jumper-wired pair of the
+*   code example), SCB2 and SCB3 share bus 1.
+*
+*******************************************************************************/
+void sim_reset(void)
+{
+    uint32_t i;
+
+    simNow = 0U;
+    simSysTickEnabled = false;
+    memset(&simStats, 0, sizeof(simStats));
+    memset(&simNvic, 0, sizeof(simNvic));
+    memset(simBus, 0, sizeof(simBus));
+    memset(simNodes, 0, sizeof(simNodes));
+    simNodeCount = 0U;
+    simPower = SIM_PWR_ACTIVE;
+    simPmCallbackCount = 0U;
+    memset(&simWdt, 0, sizeof(simWdt));
+    simWdt.masked = true;
+    memset(&simExt, 0, sizeof(simExt));
+    memset(&simFault, 0, sizeof(simFault));
+    memset(&simExtScb, 0, sizeof(simExtScb));
+    simExtScb.irq        = (IRQn_Type)(SIM_IRQn_COUNT - 1);
+    simExtScb.mode       = SIM_SCB_I2C_MASTER;
+    simExtScb.enabled    = true;
+    simExtScb.dataRateHz = SIM_DEFAULT_DATA_RATE_HZ;
+    memset(simDiv16, 0, sizeof(simDiv16));
+    simDiv16[CYBSP_I2C_CLK_DIV_NUM].value     = SIM_I2C_CLK_DIVIDER - 1U;
+    simDiv16[CYBSP_I2C_CLK_DIV_NUM].enabled   = true;
+    simDiv16[CYBSP_EZI2C_CLK_DIV_NUM].value   = SIM_EZI2C_CLK_DIVIDER - 1U;
+    simDiv16[CYBSP_EZI2C_CLK_DIV_NUM].enabled = true;
+    simDiv16[CYBSP_I2C2_CLK_DIV_NUM].value    = SIM_I2C_CLK_DIVIDER - 1U;
+    simDiv16[CYBSP_I2C2_CLK_DIV_NUM].enabled  = true;
+
+    /* Even SCBs are clocked like the EZI2C SCB, odd ones like the master;
+     * the second master has a divider of its own
+     */
+    for (i = 0U; i < SIM_SCB_COUNT; i++)
+    {
+        memset(simScbs[i], 0, sizeof(CySCB_Type));
+        simScbs[i]->bus        = i / 2U;
+        simScbs[i]->irq        = (IRQn_Type)(scb_0_interrupt_IRQn + i);
+        simScbs[i]->dataRateHz = SIM_DEFAULT_DATA_RATE_HZ;
+        simScbs[i]->clockDiv   = (0U == (i % 2U)) ? CYBSP_EZI2C_CLK_DIV_NUM : CYBSP_I2C_CLK_DIV_NUM;
+    }
+    CYBSP_I2C2_HW->clockDiv = CYBSP_I2C2_CLK_DIV_NUM;
+    for (i = 0U; i < (sizeof(simPorts) / sizeof(simPorts[0])); i++)
+    {
+        simPorts[i]->out = 0U;
+        memset(simPorts[i]->hsiom, 0, sizeof(simPorts[i]->hsiom));
+    }
+    /* Bus pins come up connected to the SCB with the output latch high */
+    for (i = 0U; i < (sizeof(simBusPins) / sizeof(simBusPins[0])); i++)
+    {
+        simBusPins[i].port->out |= (1UL << simBusPins[i].pin);
+        simBusPins[i].port->hsiom[simBusPins[i].pin] = HSIOM_SEL_DS_2;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_now_ns
+****************************************************************************//**
+*
+* Summary:
+*   Returns the virtual time in nanoseconds since the last sim_reset().
+*
+*******************************************************************************/
+uint64_t sim_now_ns(void)
+{
+    return simNow;
+}
+
+/*******************************************************************************
+* Function Name: sim_get_stats
+****************************************************************************//**
+*
+* Summary:
+*   Returns the bus and CPU counters accumulated since the last sim_reset().
+*
+*******************************************************************************/
+sim_stats_t const *sim_get_stats(void)
+{
+    return &simStats;
+}
+
+/*******************************************************************************
+* Function Name: sim_set_data_rate
+****************************************************************************//**
+*
+* Summary:
+*   Sets the SCL rate a master SCB drives the bus at.
+*
+*******************************************************************************/
+void sim_set_data_rate(CySCB_Type *base, uint32_t dataRateHz)
+{
+    base->dataRateHz = dataRateHz;
+}
+
+/*******************************************************************************
+* Function Name: sim_get_data_rate
+****************************************************************************//**
+*
+* Summary:
+*   Returns the SCL rate a master SCB drives the bus at.
+*
+*******************************************************************************/
+uint32_t sim_get_data_rate(CySCB_Type const *base)
+{
+    return base->dataRateHz;
+}
+
+/*******************************************************************************
+* Function Name: sim_set_bus_limit
+****************************************************************************//**
+*
+* Summary:
+*   Models the wiring of a bus: above maxRateHz the edges are too slow and
+*   every errorEvery-th address byte is lost, so the slave does not
+*   acknowledge it. maxRateHz 0 makes the bus clean at any rate.
+*
+*******************************************************************************/
+void sim_set_bus_limit(uint32_t busIdx, uint32_t maxRateHz, uint32_t errorEvery)
+{
+    simBus[busIdx].maxRateHz  = maxRateHz;
+    simBus[busIdx].errorEvery = errorEvery;
+    simBus[busIdx].errorCount = 0U;
+}
+
+/*******************************************************************************
+* Function Name: sim_hold_sda
+****************************************************************************//**
+*
+* Summary:
+*   Makes a device on the bus hold SDA low, as a slave does when it lost
+*   track of a read in the middle of a byte. The bus makes no progress until
+*   SDA is released, which happens after the given number of SCL clocks are
+*   bit-banged on the bus pins. A running transfer is frozen.
+*
+*******************************************************************************/
+void sim_hold_sda(uint32_t busIdx, uint32_t clocks)
+{
+    simBus[busIdx].sdaHold = clocks;
+}
+
+/*******************************************************************************
+* Function Name: sim_inject_master_error
+****************************************************************************//**
+*
+* Summary:
+*   Makes the next count transfers started by a master SCB fail after the
+*   address byte with the given master status (for example
+*   CY_SCB_I2C_MASTER_ARB_LOST), as if another master or noise took the bus.
+*
+*******************************************************************************/
+void sim_inject_master_error(CySCB_Type *base, uint32_t masterStatus, uint32_t count)
+{
+    base->injectError = masterStatus;
+    base->injectCount = count;
+}
+
+/*******************************************************************************
+* Function Name: sim_set_faults
+****************************************************************************//**
+*
+* Summary:
+*   Starts injecting faults on the transfers the SCB masters run on a bus,
+*   at the rates of config, and clears the fault counters. NULL stops the
+*   injection. Transfers of a master outside the device are left alone.
+*
+*******************************************************************************/
+void sim_set_faults(uint32_t busIdx, sim_fault_config_t const *config)
+{
+    memset(&simFault, 0, sizeof(simFault));
+    if (NULL != config)
+    {
+        CY_ASSERT(0U != config->seed);
+        simFault.enabled = true;
+        simFault.bus     = busIdx;
+        simFault.config  = *config;
+        simFault.random  = config->seed;
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_get_fault_stats
+****************************************************************************//**
+*
+* Summary:
+*   Returns the faults injected since the last sim_set_faults().
+*
+*******************************************************************************/
+sim_fault_stats_t const *sim_get_fault_stats(void)
+{
+    return &simFault.stats;
+}
+
+/*******************************************************************************
+* Function Name: sim_add_ezi2c_node
+****************************************************************************//**
+*
+* Summary:
+*   Connects another EZI2C slave to a bus, exposing buffer at address. The
+*   node has no firmware: it acknowledges and serves bytes as they arrive,
+*   like an EZI2C slave whose ISR always keeps up.
+*
+* Return:
+*   Node index for sim_node_get_activity().
+*
+*******************************************************************************/
+uint32_t sim_add_ezi2c_node(uint32_t busIdx, uint8_t address, uint8_t *buffer, uint32_t size, uint32_t rwBoundary)
+{
+    sim_node_t *node;
+
+    CY_ASSERT(simNodeCount < SIM_NODE_COUNT);
+    node = &simNodes[simNodeCount];
+    node->bus                   = busIdx;
+    node->context.address1      = address;
+    node->context.buf1          = buffer;
+    node->context.buf1Size      = size;
+    node->context.buf1rwBondary = rwBoundary;
+
+    return simNodeCount++;
+}
+
+/*******************************************************************************
+* Function Name: sim_node_get_activity
+****************************************************************************//**
+*
+* Summary:
+*   Same as Cy_SCB_EZI2C_GetActivity() for a node added with
+*   sim_add_ezi2c_node().
+*
+*******************************************************************************/
+uint32_t sim_node_get_activity(uint32_t node)
+{
+    return Cy_SCB_EZI2C_GetActivity(NULL, &simNodes[node].context);
+}
+
+/*******************************************************************************
+* Function Name: sim_external_write
+****************************************************************************//**
+*
+* Summary:
+*   Makes a master outside the device write size bytes to address on a bus,
+*   starting at atNs (or as soon as the bus is free after it). The transfer
+*   runs whatever the CPU does, including Deep Sleep; its progress is read
+*   with sim_external_result().
+*
+*******************************************************************************/
+void sim_external_write(uint32_t busIdx, uint64_t atNs, uint8_t address, uint8_t const *data, uint32_t size)
+{
+    CY_ASSERT(size <= SIM_EXT_MAX_SIZE);
+    memset(&simExt, 0, sizeof(simExt));
+    memcpy(simExt.data, data, size);
+    simExt.armed   = true;
+    simExt.bus     = busIdx;
+    simExt.startAt = atNs;
+    simExt.address = address;
+    simExt.size    = size;
+    simExtScb.bus  = busIdx;
+}
+
+/*******************************************************************************
+* Function Name: sim_external_result
+****************************************************************************//**
+*
+* Summary:
+*   Returns the timestamps of the last sim_external_write() transfer. The
+*   fields are zero until the transfer has got that far.
+*
+*******************************************************************************/
+sim_ext_xfer_t const *sim_external_result(void)
+{
+    return &simExt.result;
+}
+
+/*******************************************************************************
+* Simulated NVIC
+*******************************************************************************/
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, cy_israddress userIsr)
+{
+    if ((NULL == config) || (NULL == userIsr) || ((uint32_t)config->intrSrc >= SIM_IRQn_COUNT))
+    {
+        return CY_SYSINT_BAD_PARAM;
+    }
+    simNvic.isr[config->intrSrc]      = userIsr;
+    simNvic.priority[config->intrSrc] = config->intrPriority;
+    return CY_SYSINT_SUCCESS;
+}
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    simNvic.enabled[IRQn] = true;
+    sim_irq_dispatch();
+}
+
+void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    simNvic.enabled[IRQn] = false;
+}
+
+void __enable_irq(void)
+{
+    simNvic.globalEnabled = true;
+    sim_irq_dispatch();
+}
+
+void __disable_irq(void)
+{
+    simNvic.globalEnabled = false;
+}
+
+/* Returns PRIMASK as the PDL does: 1 if interrupts were already masked */
+uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    uint32_t saved = simNvic.globalEnabled ? 0U : 1U;
+
+    simNvic.globalEnabled = false;
+    return saved;
+}
+
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    if (0U == savedIntrStatus)
+    {
+        __enable_irq();
+    }
+}
+
+static void sim_irq_pend(IRQn_Type irq)
+{
+    simNvic.pending[irq] = true;
+}
+
+/*******************************************************************************
+* Function Name: sim_irq_dispatch
+****************************************************************************//**
+*
+* Summary:
+*   Runs every pending and enabled ISR, highest priority (lowest number) first.
+*   ISRs do not nest: interrupts raised while an ISR runs are taken after it
+*   returns, as on a Cortex-M0+ with all SCB interrupts at the same priority.
+*
+*******************************************************************************/
+static void sim_irq_dispatch(void)
+{
+    uint32_t i;
+    uint32_t sel;
+
+    /* In Sleep and Deep Sleep the CPU waits in WFI; pending interrupts are
+     * taken once the SysPm call has woken up.
+     */
+    if (simNvic.inIsr || !simNvic.globalEnabled || (SIM_PWR_ACTIVE != simPower))
+    {
+        return;
+    }
+
+    for (;;)
+    {
+        sel = SIM_IRQn_COUNT;
+        for (i = 0U; i < SIM_IRQn_COUNT; i++)
+        {
+            if (simNvic.pending[i] && simNvic.enabled[i] && (NULL != simNvic.isr[i]) &&
+                ((SIM_IRQn_COUNT == sel) || (simNvic.priority[i] < simNvic.priority[sel])))
+            {
+                sel = i;
+            }
+        }
+        if (SIM_IRQn_COUNT == sel)
+        {
+            break;
+        }
+
+        simNvic.pending[sel] = false;
+        simNvic.inIsr = true;
+        simNvic.isr[sel]();
+        simNvic.inIsr = false;
+    }
+}
+
+/*******************************************************************************
+* Bus model
+*******************************************************************************/
+static uint64_t sim_bit_ns(sim_bus_t const *bus)
+{
+    uint32_t rate = (NULL != bus->master) ? bus->master->dataRateHz : SIM_DEFAULT_DATA_RATE_HZ;
+    return (SIM_NS_PER_SEC + (rate / 2U)) / rate;
+}
+
+static void sim_bus_stretch(sim_bus_t *bus)
+{
+    bus->stretched    = true;
+    bus->stretchStart = simNow;
+}
+
+/* Next number of the fault sequence (xorshift32) */
+static uint32_t sim_fault_random(void)
+{
+    uint32_t x = simFault.random;
+
+    x ^= x << 13U;
+    x ^= x >> 17U;
+    x ^= x << 5U;
+    simFault.random = x;
+    return x;
+}
+
+/* Draws whether a fault of a class hits this opportunity on a bus */
+static bool sim_fault_hit(sim_bus_t const *bus, uint32_t fault)
+{
+    uint32_t ppm;
+
+    if (!simFault.enabled || (bus != &simBus[simFault.bus]) || (&simExtScb == bus->master))
+    {
+        return false;
+    }
+    ppm = simFault.config.ppm[fault];
+    if ((0U == ppm) || ((sim_fault_random() % SIM_FAULT_PPM) >= ppm))
+    {
+        return false;
+    }
+
+    simFault.stats.injected[fault]++;
+    if (NULL != simFault.config.hook)
+    {
+        simFault.config.hook(fault, simNow);
+    }
+    return true;
+}
+
+/* Master status of a bus fault that hits a byte, 0 for none */
+static uint32_t sim_fault_byte_error(sim_bus_t const *bus)
+{
+    if (sim_fault_hit(bus, SIM_FAULT_ARB_LOST))
+    {
+        return CY_SCB_I2C_MASTER_ARB_LOST;
+    }
+    if (sim_fault_hit(bus, SIM_FAULT_BUS_ERR))
+    {
+        return CY_SCB_I2C_MASTER_BUS_ERR;
+    }
+    return 0U;
+}
+
+/* Byte as it arrives: one random bit flipped by a corruption fault */
+static uint8_t sim_fault_corrupt(sim_bus_t const *bus, uint8_t data)
+{
+    if (sim_fault_hit(bus, SIM_FAULT_CORRUPT))
+    {
+        data ^= (uint8_t)(1U << (sim_fault_random() % 8U));
+    }
+    return data;
+}
+
+/* A data byte may be delayed by a slave holding SCL, or frozen by a device
+ * holding SDA until the bus is clocked out
+ */
+static void sim_bus_schedule(sim_bus_t *bus, sim_bus_phase_t phase, uint32_t bits)
+{
+    uint64_t holdNs;
+
+    bus->phase    = phase;
+    bus->phaseEnd = simNow + (bits * sim_bit_ns(bus));
+
+    if ((SIM_BUS_WRITE == phase) || (SIM_BUS_READ == phase))
+    {
+        if (sim_fault_hit(bus, SIM_FAULT_STRETCH))
+        {
+            holdNs = 1U + (sim_fault_random() % simFault.config.stretchMaxNs);
+            bus->phaseEnd += holdNs;
+            simFault.stats.stretchNs += holdNs;
+        }
+        if (sim_fault_hit(bus, SIM_FAULT_STUCK_SDA))
+        {
+            bus->sdaHold = simFault.config.stuckClocks;
+        }
+    }
+}
+
+static void sim_slave_post(CySCB_Type *slave, sim_slv_evt_type_t type, uint8_t data)
+{
+    uint32_t pos;
+
+    CY_ASSERT(slave->evtCount < SIM_SLV_EVT_DEPTH);
+    pos = (slave->evtHead + slave->evtCount) % SIM_SLV_EVT_DEPTH;
+    slave->evt[pos].type = type;
+    slave->evt[pos].data = data;
+    slave->evtCount++;
+    sim_irq_pend(slave->irq);
+}
+
+static CySCB_Type *sim_bus_find_slave(uint32_t busIdx, uint8_t address)
+{
+    uint32_t i;
+    CySCB_Type *scb;
+
+    for (i = 0U; i < SIM_SCB_COUNT; i++)
+    {
+        scb = simScbs[i];
+        /* In Deep Sleep only a slave with wakeup armed answers its address */
+        if ((scb->bus == busIdx) && (SIM_SCB_EZI2C == scb->mode) && scb->enabled &&
+            ((SIM_PWR_DEEPSLEEP != simPower) || scb->wakeArmed) &&
+            ((address == scb->slaveAddress1) || (scb->twoAddresses && (address == scb->slaveAddress2))))
+        {
+            return scb;
+        }
+    }
+    return NULL;
+}
+
+static sim_node_t *sim_bus_find_node(uint32_t busIdx, uint8_t address)
+{
+    uint32_t i;
+
+    for (i = 0U; i < simNodeCount; i++)
+    {
+        if ((simNodes[i].bus == busIdx) && (simNodes[i].context.address1 == address))
+        {
+            return &simNodes[i];
+        }
+    }
+    return NULL;
+}
+
+/* The addressed slave sees the end of its access (STOP or repeated START) */
+static void sim_bus_end_access(sim_bus_t *bus)
+{
+    if (NULL != bus->slave)
+    {
+        sim_slave_post(bus->slave, SIM_SLV_EVT_STOP, 0U);
+    }
+    if (NULL != bus->node)
+    {
+        sim_ezi2c_on_stop(&bus->node->context);
+    }
+    bus->slave = NULL;
+    bus->node  = NULL;
+}
+
+/* Master side of a transfer is finished: report it through the master ISR */
+static void sim_bus_master_done(sim_bus_t *bus)
+{
+    CySCB_Type *master = bus->master;
+
+    if (&simExtScb == master)
+    {
+        simExt.armed            = false;
+        simExt.result.doneNs    = simNow;
+        simExt.result.error     = bus->error;
+        simExt.result.delivered = bus->idx;
+        return;
+    }
+
+    master->mstDone  = true;
+    master->mstError = bus->error;
+    master->mstCount = bus->idx;
+    sim_irq_pend(master->irq);
+}
+
+static void sim_bus_begin(sim_bus_t *bus)
+{
+    uint64_t start;
+
+    if (SIM_BUS_HELD == bus->phase)
+    {
+        sim_bus_end_access(bus);
+        simStats.restarts++;
+        sim_bus_schedule(bus, SIM_BUS_START, SIM_BITS_PER_COND);
+    }
+    else
+    {
+        start = (bus->freeAt > simNow) ? bus->freeAt : simNow;
+        bus->phase       = SIM_BUS_START;
+        bus->phaseEnd    = start + (SIM_BITS_PER_COND * sim_bit_ns(bus));
+        bus->activeStart = start;
+        simStats.starts++;
+    }
+    bus->slave = NULL;
+    bus->node  = NULL;
+}
+
+/* Decide the next bus phase once the previous one has been acknowledged */
+static void sim_bus_continue(sim_bus_t *bus)
+{
+    if ((&simExtScb == bus->master) && (1U == bus->idx) && (0U == simExt.result.firstByteNs))
+    {
+        simExt.result.firstByteNs = simNow;
+    }
+
+    if ((0U == bus->error) && (bus->idx < bus->size))
+    {
+        if (bus->rdDir && (NULL != bus->node))
+        {
+            bus->rdByte = sim_ezi2c_on_tx(&bus->node->context);
+            sim_bus_schedule(bus, SIM_BUS_READ, SIM_BITS_PER_BYTE);
+        }
+        else if (bus->rdDir)
+        {
+            /* The slave ISR has to provide the byte before it can be clocked */
+            sim_slave_post(bus->slave, SIM_SLV_EVT_TX, 0U);
+            sim_bus_stretch(bus);
+        }
+        else
+        {
+            sim_bus_schedule(bus, SIM_BUS_WRITE, SIM_BITS_PER_BYTE);
+        }
+    }
+    else if (bus->pending && (0U == bus->error))
+    {
+        bus->phase = SIM_BUS_HELD;
+        sim_bus_master_done(bus);
+    }
+    else
+    {
+        sim_bus_schedule(bus, SIM_BUS_STOP, SIM_BITS_PER_COND);
+    }
+}
+
+/* A slave ISR consumed its event; release SCL and carry on */
+static void sim_bus_release(sim_bus_t *bus, sim_slv_evt_type_t type, bool ack, uint8_t txByte)
+{
+    simStats.stretchNs += simNow - bus->stretchStart;
+    bus->stretched = false;
+
+    switch (type)
+    {
+        case SIM_SLV_EVT_ADDR:
+            sim_bus_continue(bus);
+            break;
+
+        case SIM_SLV_EVT_RX:
+            if (ack)
+            {
+                bus->idx++;
+            }
+            else
+            {
+                simStats.naks++;
+                bus->error |= CY_SCB_I2C_MASTER_DATA_NAK;
+            }
+            sim_bus_continue(bus);
+            break;
+
+        case SIM_SLV_EVT_TX:
+            bus->rdByte = txByte;
+            sim_bus_schedule(bus, SIM_BUS_READ, SIM_BITS_PER_BYTE);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* Rate class of a data rate, NULL above Fast-mode Plus */
+static sim_rate_class_t const *sim_rate_class(uint32_t dataRateHz)
+{
+    uint32_t i;
+
+    for (i = 0U; i < (sizeof(simRateClasses) / sizeof(simRateClasses[0])); i++)
+    {
+        if (dataRateHz <= simRateClasses[i].maxRateHz)
+        {
+            return &simRateClasses[i];
+        }
+    }
+    return NULL;
+}
+
+/* Clock of an SCB, 0 while its divider is disabled */
+static uint32_t sim_scb_clock_hz(CySCB_Type const *base)
+{
+    sim_div_t const *div = &simDiv16[base->clockDiv];
+
+    return div->enabled ? (SIM_CPU_CLOCK_HZ / (div->value + 1U)) : 0U;
+}
+
+/* Address byte lost on the wire: the bus runs above the limit of its wiring,
+ * or the addressed EZI2C SCB is clocked too slowly to sample the bus
+ */
+static bool sim_bus_address_lost(sim_bus_t *bus)
+{
+    uint32_t rate = bus->master->dataRateHz;
+    sim_rate_class_t const *rc = sim_rate_class(rate);
+
+    if ((0U != bus->maxRateHz) && (rate > bus->maxRateHz) && (0U != bus->errorEvery) &&
+        (++bus->errorCount >= bus->errorEvery))
+    {
+        bus->errorCount = 0U;
+        return true;
+    }
+    return ((NULL != bus->slave) && ((NULL == rc) || (sim_scb_clock_hz(bus->slave) < rc->slaveClkMinHz)));
+}
+
+/* Current phase of the bus has completed on the wire */
+static void sim_bus_step(sim_bus_t *bus, uint32_t busIdx)
+{
+    uint32_t error;
+    uint8_t data;
+
+    switch (bus->phase)
+    {
+        case SIM_BUS_START:
+            if (sim_fault_hit(bus, SIM_FAULT_ABORT_START))
+            {
+                bus->error |= CY_SCB_I2C_MASTER_ABORT_START;
+                sim_bus_schedule(bus, SIM_BUS_STOP, SIM_BITS_PER_COND);
+                break;
+            }
+            sim_bus_schedule(bus, SIM_BUS_ADDR, SIM_BITS_PER_BYTE);
+            break;
+
+        case SIM_BUS_ADDR:
+            simStats.bytes++;
+            if (&simExtScb == bus->master)
+            {
+                simExt.result.addrNs = simNow;
+            }
+            bus->slave = sim_bus_find_slave(busIdx, bus->address);
+            bus->node  = (NULL == bus->slave) ? sim_bus_find_node(busIdx, bus->address) : NULL;
+            if (((NULL != bus->slave) || (NULL != bus->node)) &&
+                (sim_bus_address_lost(bus) || sim_fault_hit(bus, SIM_FAULT_ADDR_NAK)))
+            {
+                bus->slave = NULL;
+                bus->node  = NULL;
+            }
+            error = sim_fault_byte_error(bus);
+            if ((0U != bus->master->injectCount) || (0U != error))
+            {
+                if (0U != bus->master->injectCount)
+                {
+                    bus->master->injectCount--;
+                    error |= bus->master->injectError;
+                }
+                bus->error |= error;
+                bus->slave  = NULL;
+                bus->node   = NULL;
+                if (0U != (bus->error & CY_SCB_I2C_MASTER_ADDR_NAK))
+                {
+                    simStats.naks++;
+                }
+                sim_bus_schedule(bus, SIM_BUS_STOP, SIM_BITS_PER_COND);
+            }
+            else if (NULL != bus->node)
+            {
+                sim_ezi2c_on_address(&bus->node->context,
+                                     (uint8_t)((bus->address << 1U) | (bus->rdDir ? 1U : 0U)));
+                sim_bus_continue(bus);
+            }
+            else if (NULL == bus->slave)
+            {
+                simStats.naks++;
+                bus->error |= CY_SCB_I2C_MASTER_ADDR_NAK;
+                sim_bus_schedule(bus, SIM_BUS_STOP, SIM_BITS_PER_COND);
+            }
+            else
+            {
+                sim_slave_post(bus->slave, SIM_SLV_EVT_ADDR, (uint8_t)((bus->address << 1U) | (bus->rdDir ? 1U : 0U)));
+                sim_bus_stretch(bus);
+            }
+            break;
+
+        case SIM_BUS_WRITE:
+            simStats.bytes++;
+            error = sim_fault_byte_error(bus);
+            if (0U != error)
+            {
+                bus->error |= error;
+                sim_bus_schedule(bus, SIM_BUS_STOP, SIM_BITS_PER_COND);
+                break;
+            }
+            if (sim_fault_hit(bus, SIM_FAULT_DATA_NAK))
+            {
+                simStats.naks++;
+                bus->error |= CY_SCB_I2C_MASTER_DATA_NAK;
+                sim_bus_continue(bus);
+                break;
+            }
+            /* The EZI2C sub-address is not corrupted (see SIM_FAULT_CORRUPT) */
+            data = (0U == bus->idx) ? bus->buffer[0] : sim_fault_corrupt(bus, bus->buffer[bus->idx]);
+            if (NULL != bus->node)
+            {
+                if (sim_ezi2c_on_rx(&bus->node->context, data))
+                {
+                    bus->idx++;
+                }
+                else
+                {
+                    simStats.naks++;
+                    bus->error |= CY_SCB_I2C_MASTER_DATA_NAK;
+                }
+                sim_bus_continue(bus);
+                break;
+            }
+            sim_slave_post(bus->slave, SIM_SLV_EVT_RX, data);
+            sim_bus_stretch(bus);
+            break;
+
+        case SIM_BUS_READ:
+            simStats.bytes++;
+            error = sim_fault_byte_error(bus);
+            if (0U != error)
+            {
+                bus->error |= error;
+                sim_bus_schedule(bus, SIM_BUS_STOP, SIM_BITS_PER_COND);
+                break;
+            }
+            bus->buffer[bus->idx++] = sim_fault_corrupt(bus, bus->rdByte);
+            sim_bus_continue(bus);
+            break;
+
+        case SIM_BUS_STOP:
+            simStats.stops++;
+            simStats.busActiveNs += simNow - bus->activeStart;
+            sim_bus_end_access(bus);
+            bus->phase  = SIM_BUS_IDLE;
+            bus->freeAt = simNow + (SIM_BITS_PER_COND * sim_bit_ns(bus));
+            sim_bus_master_done(bus);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*******************************************************************************
+* WDT model
+*******************************************************************************/
+static uint64_t sim_wdt_tick(void)
+{
+    return (simNow - simWdt.start) / SIM_WDT_TICK_NS;
+}
+
+/* Time of the next tick at which the counter equals the match value */
+static uint64_t sim_wdt_next_match_ns(void)
+{
+    uint64_t tick = simWdt.lastTick + 1U;
+
+    tick += (simWdt.match - (uint32_t)tick) & SIM_WDT_COUNT_MASK;
+    return simWdt.start + (tick * SIM_WDT_TICK_NS);
+}
+
+static void sim_wdt_on_match(void)
+{
+    simWdt.lastTick = sim_wdt_tick();
+    simWdt.intr     = true;
+    if (!simWdt.masked)
+    {
+        sim_irq_pend(srss_interrupt_wdt_IRQn);
+    }
+}
+
+/* External master starts its transfer */
+static void sim_ext_start(void)
+{
+    sim_bus_t *bus = &simBus[simExt.bus];
+
+    simExt.result.startNs = simNow;
+    bus->master  = &simExtScb;
+    bus->address = simExt.address;
+    bus->rdDir   = false;
+    bus->pending = false;
+    bus->buffer  = simExt.data;
+    bus->size    = simExt.size;
+    bus->idx     = 0U;
+    bus->error   = 0U;
+    sim_bus_begin(bus);
+}
+
+/*******************************************************************************
+* Function Name: sim_next_event
+****************************************************************************//**
+*
+* Summary:
+*   Finds the earliest bus phase end, WDT match or external transfer start
+*   at or before limit.
+*
+* Return:
+*   Index of the bus, SIM_EVT_WDT, SIM_EVT_EXT or SIM_EVT_NONE.
+*
+*******************************************************************************/
+static uint32_t sim_next_event(uint64_t limit, uint64_t *at)
+{
+    uint32_t sel = SIM_EVT_NONE;
+    uint64_t next = limit;
+    uint64_t t;
+    uint32_t i;
+
+    for (i = 0U; i < SIM_BUS_COUNT; i++)
+    {
+        if ((SIM_BUS_IDLE != simBus[i].phase) && (SIM_BUS_HELD != simBus[i].phase) &&
+            !simBus[i].stretched && (0U == simBus[i].sdaHold) && (simBus[i].phaseEnd <= next))
+        {
+            sel  = i;
+            next = simBus[i].phaseEnd;
+        }
+    }
+    if (simWdt.enabled)
+    {
+        t = sim_wdt_next_match_ns();
+        if (t <= next)
+        {
+            sel  = SIM_EVT_WDT;
+            next = t;
+        }
+    }
+    if (simExt.armed && (0U == simExt.result.startNs) && (SIM_BUS_IDLE == simBus[simExt.bus].phase))
+    {
+        t = (simExt.startAt > simBus[simExt.bus].freeAt) ? simExt.startAt : simBus[simExt.bus].freeAt;
+        t = (t > simNow) ? t : simNow;
+        if (t <= next)
+        {
+            sel  = SIM_EVT_EXT;
+            next = t;
+        }
+    }
+
+    *at = next;
+    return sel;
+}
+
+/*******************************************************************************
+* Function Name: sim_advance_ns
+****************************************************************************//**
+*
+* Summary:
+*   Advances the virtual clock, completing every bus phase and WDT match that
+*   falls within the interval and running the ISRs they raise in between.
+*
+*******************************************************************************/
+void sim_advance_ns(uint64_t ns)
+{
+    uint64_t target = simNow + ns;
+    uint64_t next;
+    uint32_t sel;
+
+    sim_irq_dispatch();
+
+    for (;;)
+    {
+        sel = sim_next_event(target, &next);
+        if (SIM_EVT_NONE == sel)
+        {
+            break;
+        }
+
+        simNow = next;
+        if (SIM_EVT_WDT == sel)
+        {
+            sim_wdt_on_match();
+        }
+        else if (SIM_EVT_EXT == sel)
+        {
+            sim_ext_start();
+        }
+        else
+        {
+            sim_bus_step(&simBus[sel], sel);
+        }
+        sim_irq_dispatch();
+    }
+
+    simNow = target;
+}
+
+/*******************************************************************************
+* SysLib
+*******************************************************************************/
+/*******************************************************************************
+* Function Name: sim_cpu_work_ns
+****************************************************************************//**
+*
+* Summary:
+*   Advances the virtual clock on behalf of application code, accounting the
+*   interval as useful CPU work rather than as time spent in a delay loop.
+*
+*******************************************************************************/
+void sim_cpu_work_ns(uint64_t ns)
+{
+    simStats.cpuWorkNs += ns;
+    sim_advance_ns(ns);
+}
+
+void Cy_SysLib_Delay(uint32_t milliseconds)
+{
+    simStats.cpuDelayNs += milliseconds * SIM_NS_PER_MS;
+    sim_advance_ns(milliseconds * SIM_NS_PER_MS);
+}
+
+void Cy_SysLib_DelayUs(uint16_t microseconds)
+{
+    simStats.cpuDelayNs += microseconds * SIM_NS_PER_US;
+    sim_advance_ns(microseconds * SIM_NS_PER_US);
+}
+
+/*******************************************************************************
+* SysTick
+*******************************************************************************/
+void Cy_SysTick_Init(cy_en_systick_clock_source_t clockSource, uint32_t interval)
+{
+    CY_ASSERT(CY_SYSTICK_CLOCK_SOURCE_CLK_CPU == clockSource);
+    (void)clockSource;
+
+    simSysTickEnabled = true;
+    simSysTickReload  = interval & 0xFFFFFFUL;
+    simSysTickStart   = simNow;
+}
+
+uint32_t Cy_SysTick_GetValue(void)
+{
+    uint64_t ns;
+    uint64_t ticks;
+
+    if (!simSysTickEnabled)
+    {
+        return 0UL;
+    }
+
+    /* Split to keep ns * SystemCoreClock within 64 bits */
+    ns    = simNow - simSysTickStart;
+    ticks = ((ns / SIM_NS_PER_SEC) * SystemCoreClock) +
+            (((ns % SIM_NS_PER_SEC) * SystemCoreClock) / SIM_NS_PER_SEC);
+
+    return simSysTickReload - (uint32_t)(ticks % ((uint64_t)simSysTickReload + 1U));
+}
+
+/*******************************************************************************
+* SysClk
+*******************************************************************************/
+uint32_t Cy_SysClk_ClkHfGetFrequency(void)
+{
+    return SIM_CPU_CLOCK_HZ;
+}
+
+cy_en_sysclk_status_t Cy_SysClk_PeriphSetDivider(cy_en_divider_types_t dividerType, uint32_t dividerNum,
+                                                 uint32_t dividerValue)
+{
+    if ((CY_SYSCLK_DIV_16_BIT != dividerType) || (dividerNum >= SIM_DIV16_COUNT) || (dividerValue > 0xFFFFU))
+    {
+        return CY_SYSCLK_BAD_PARAM;
+    }
+    simDiv16[dividerNum].value = dividerValue;
+    return CY_SYSCLK_SUCCESS;
+}
+
+uint32_t Cy_SysClk_PeriphGetDivider(cy_en_divider_types_t dividerType, uint32_t dividerNum)
+{
+    CY_ASSERT((CY_SYSCLK_DIV_16_BIT == dividerType) && (dividerNum < SIM_DIV16_COUNT));
+    return simDiv16[dividerNum].value;
+}
+
+cy_en_sysclk_status_t Cy_SysClk_PeriphEnableDivider(cy_en_divider_types_t dividerType, uint32_t dividerNum)
+{
+    if ((CY_SYSCLK_DIV_16_BIT != dividerType) || (dividerNum >= SIM_DIV16_COUNT))
+    {
+        return CY_SYSCLK_BAD_PARAM;
+    }
+    simDiv16[dividerNum].enabled = true;
+    return CY_SYSCLK_SUCCESS;
+}
+
+cy_en_sysclk_status_t Cy_SysClk_PeriphDisableDivider(cy_en_divider_types_t dividerType, uint32_t dividerNum)
+{
+    if ((CY_SYSCLK_DIV_16_BIT != dividerType) || (dividerNum >= SIM_DIV16_COUNT))
+    {
+        return CY_SYSCLK_BAD_PARAM;
+    }
+    simDiv16[dividerNum].enabled = false;
+    return CY_SYSCLK_SUCCESS;
+}
+
+uint32_t Cy_SysClk_PeriphGetFrequency(cy_en_divider_types_t dividerType, uint32_t dividerNum)
+{
+    CY_ASSERT((CY_SYSCLK_DIV_16_BIT == dividerType) && (dividerNum < SIM_DIV16_COUNT));
+    return SIM_CPU_CLOCK_HZ / (simDiv16[dividerNum].value + 1U);
+}
+
+/*******************************************************************************
+* SysPm
+*******************************************************************************/
+bool Cy_SysPm_RegisterCallback(cy_stc_syspm_callback_t *handler)
+{
+    uint32_t i;
+
+    if ((NULL == handler) || (NULL == handler->callback) || (SIM_PM_CALLBACKS == simPmCallbackCount))
+    {
+        return false;
+    }
+    for (i = 0U; i < simPmCallbackCount; i++)
+    {
+        if (simPmCallbacks[i] == handler)
+        {
+            return false;
+        }
+    }
+    simPmCallbacks[simPmCallbackCount++] = handler;
+    return true;
+}
+
+/* Runs the callbacks of a type: CHECK_READY and BEFORE_TRANSITION in
+ * registration order, CHECK_FAIL and AFTER_TRANSITION in reverse. For
+ * CHECK_READY, returns false after undoing the callbacks that agreed.
+ */
+static bool sim_pm_callbacks(cy_en_syspm_callback_type_t type, cy_en_syspm_callback_mode_t mode)
+{
+    cy_stc_syspm_callback_t *cb;
+    uint32_t i;
+    uint32_t j;
+
+    if ((CY_SYSPM_CHECK_READY == mode) || (CY_SYSPM_BEFORE_TRANSITION == mode))
+    {
+        for (i = 0U; i < simPmCallbackCount; i++)
+        {
+            cb = simPmCallbacks[i];
+            if ((cb->type != type) || (0U != (cb->skipMode & (uint32_t)mode)))
+            {
+                continue;
+            }
+            if ((CY_SYSPM_SUCCESS != cb->callback(cb->callbackParams, mode)) && (CY_SYSPM_CHECK_READY == mode))
+            {
+                for (j = i; j > 0U; j--)
+                {
+                    cb = simPmCallbacks[j - 1U];
+                    if ((cb->type == type) && (0U == (cb->skipMode & (uint32_t)CY_SYSPM_CHECK_FAIL)))
+                    {
+                        (void)cb->callback(cb->callbackParams, CY_SYSPM_CHECK_FAIL);
+                    }
+                }
+                return false;
+            }
+        }
+    }
+    else
+    {
+        for (i = simPmCallbackCount; i > 0U; i--)
+        {
+            cb = simPmCallbacks[i - 1U];
+            if ((cb->type == type) && (0U == (cb->skipMode & (uint32_t)mode)))
+            {
+                (void)cb->callback(cb->callbackParams, mode);
+            }
+        }
+    }
+    return true;
+}
+
+static bool sim_irq_wakeup_pending(void)
+{
+    uint32_t i;
+
+    for (i = 0U; i < SIM_IRQn_COUNT; i++)
+    {
+        if (simNvic.pending[i] && simNvic.enabled[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* WFI: runs the clock until an enabled interrupt is pending */
+static void sim_wait_for_interrupt(void)
+{
+    uint64_t at;
+    uint32_t sel;
+
+    while (!sim_irq_wakeup_pending())
+    {
+        /* Nothing left that could wake the CPU: it would sleep forever */
+        sel = sim_next_event(UINT64_MAX, &at);
+        CY_ASSERT(SIM_EVT_NONE != sel);
+        sim_advance_ns(at - simNow);
+    }
+}
+
+cy_en_syspm_status_t Cy_SysPm_CpuEnterSleep(void)
+{
+    uint64_t t0;
+
+    if (!sim_pm_callbacks(CY_SYSPM_SLEEP, CY_SYSPM_CHECK_READY))
+    {
+        return CY_SYSPM_FAIL;
+    }
+    (void)sim_pm_callbacks(CY_SYSPM_SLEEP, CY_SYSPM_BEFORE_TRANSITION);
+
+    t0 = simNow;
+    simPower = SIM_PWR_SLEEP;
+    sim_wait_for_interrupt();
+    simPower = SIM_PWR_ACTIVE;
+    simStats.sleepNs += simNow - t0;
+    simStats.wakeups++;
+
+    (void)sim_pm_callbacks(CY_SYSPM_SLEEP, CY_SYSPM_AFTER_TRANSITION);
+    sim_irq_dispatch();
+    return CY_SYSPM_SUCCESS;
+}
+
+cy_en_syspm_status_t Cy_SysPm_CpuEnterDeepSleep(void)
+{
+    uint32_t i;
+    uint64_t t0;
+
+    /* The master clock stops in Deep Sleep: a transfer in flight is lost */
+    for (i = 0U; i < SIM_BUS_COUNT; i++)
+    {
+        CY_ASSERT((NULL == simBus[i].master) || (&simExtScb == simBus[i].master) ||
+                  (SIM_BUS_IDLE == simBus[i].phase));
+    }
+
+    if (!sim_pm_callbacks(CY_SYSPM_DEEPSLEEP, CY_SYSPM_CHECK_READY))
+    {
+        return CY_SYSPM_FAIL;
+    }
+    (void)sim_pm_callbacks(CY_SYSPM_DEEPSLEEP, CY_SYSPM_BEFORE_TRANSITION);
+
+    t0 = simNow;
+    simPower = SIM_PWR_DEEPSLEEP;
+    sim_wait_for_interrupt();
+    simStats.deepSleepNs += simNow - t0;
+    simStats.wakeups++;
+
+    /* Clocks restart; a slave that woke the device keeps SCL low meanwhile */
+    simPower = SIM_PWR_SLEEP;
+    sim_advance_ns(SIM_DEEPSLEEP_WAKE_NS);
+    simPower = SIM_PWR_ACTIVE;
+
+    (void)sim_pm_callbacks(CY_SYSPM_DEEPSLEEP, CY_SYSPM_AFTER_TRANSITION);
+    sim_irq_dispatch();
+    return CY_SYSPM_SUCCESS;
+}
+
+/*******************************************************************************
+* WDT
+*******************************************************************************/
+void Cy_WDT_Enable(void)
+{
+    if (!simWdt.enabled)
+    {
+        simWdt.enabled  = true;
+        simWdt.start    = simNow - ((uint64_t)simWdt.frozen * SIM_WDT_TICK_NS);
+        simWdt.lastTick = sim_wdt_tick();
+    }
+}
+
+void Cy_WDT_Disable(void)
+{
+    if (simWdt.enabled)
+    {
+        simWdt.frozen  = Cy_WDT_GetCount();
+        simWdt.enabled = false;
+    }
+}
+
+void Cy_WDT_SetMatch(uint32_t match)
+{
+    simWdt.match = match & SIM_WDT_COUNT_MASK;
+    if (simWdt.enabled)
+    {
+        simWdt.lastTick = sim_wdt_tick();
+    }
+}
+
+uint32_t Cy_WDT_GetMatch(void)
+{
+    return simWdt.match;
+}
+
+uint32_t Cy_WDT_GetCount(void)
+{
+    return simWdt.enabled ? ((uint32_t)sim_wdt_tick() & SIM_WDT_COUNT_MASK) : simWdt.frozen;
+}
+
+void Cy_WDT_MaskInterrupt(void)
+{
+    simWdt.masked = true;
+}
+
+void Cy_WDT_UnmaskInterrupt(void)
+{
+    simWdt.masked = false;
+    if (simWdt.intr)
+    {
+        sim_irq_pend(srss_interrupt_wdt_IRQn);
+    }
+}
+
+uint32_t Cy_WDT_GetInterruptStatus(void)
+{
+    return simWdt.intr ? 1UL : 0UL;
+}
+
+void Cy_WDT_ClearInterrupt(void)
+{
+    simWdt.intr = false;
+    simNvic.pending[srss_interrupt_wdt_IRQn] = false;
+}
+
+/*******************************************************************************
+* GPIO
+*******************************************************************************/
+static sim_bus_pin_t const *sim_bus_pin(GPIO_PRT_Type const *base, uint32_t pinNum)
+{
+    uint32_t i;
+
+    for (i = 0U; i < (sizeof(simBusPins) / sizeof(simBusPins[0])); i++)
+    {
+        if ((simBusPins[i].port == base) && (simBusPins[i].pin == pinNum))
+        {
+            return &simBusPins[i];
+        }
+    }
+    return NULL;
+}
+
+/* Level of a bus line: open drain, low while anything pulls it low */
+static uint32_t sim_bus_line(uint32_t busIdx, bool sda)
+{
+    sim_bus_t const *bus = &simBus[busIdx];
+    uint32_t i;
+
+    if (sda ? (0U != bus->sdaHold) : bus->stretched)
+    {
+        return 0U;
+    }
+    for (i = 0U; i < (sizeof(simBusPins) / sizeof(simBusPins[0])); i++)
+    {
+        if ((simBusPins[i].bus == busIdx) && (simBusPins[i].sda == sda) &&
+            (HSIOM_SEL_GPIO == simBusPins[i].port->hsiom[simBusPins[i].pin]) &&
+            (0U == ((simBusPins[i].port->out >> simBusPins[i].pin) & 1UL)))
+        {
+            return 0U;
+        }
+    }
+    return 1U;
+}
+
+/* Bus lines driven by software: count SCL clocks and detect a STOP */
+static void sim_bus_pin_changed(uint32_t busIdx, uint32_t scl, uint32_t sda)
+{
+    sim_bus_t *bus = &simBus[busIdx];
+    uint32_t nowScl = sim_bus_line(busIdx, false);
+    uint32_t nowSda = sim_bus_line(busIdx, true);
+
+    if ((1U == scl) && (0U == nowScl) && (0U != bus->sdaHold))
+    {
+        bus->sdaHold--;
+    }
+    if ((1U == scl) && (1U == nowScl) && (0U == sda) && (1U == nowSda))
+    {
+        /* STOP: an addressed slave sees the end of its access */
+        sim_bus_end_access(bus);
+        simStats.stops++;
+    }
+}
+
+void Cy_GPIO_Write(GPIO_PRT_Type *base, uint32_t pinNum, uint32_t value)
+{
+    sim_bus_pin_t const *pin = sim_bus_pin(base, pinNum);
+    uint32_t scl = 1U;
+    uint32_t sda = 1U;
+
+    if (NULL != pin)
+    {
+        scl = sim_bus_line(pin->bus, false);
+        sda = sim_bus_line(pin->bus, true);
+    }
+
+    base->out = (base->out & ~(1UL << pinNum)) | ((value & 1UL) << pinNum);
+
+    if (NULL != pin)
+    {
+        sim_bus_pin_changed(pin->bus, scl, sda);
+    }
+    else
+    {
+        simStats.gpioWrites++;
+    }
+}
+
+uint32_t Cy_GPIO_ReadOut(GPIO_PRT_Type const *base, uint32_t pinNum)
+{
+    return (base->out >> pinNum) & 1UL;
+}
+
+uint32_t Cy_GPIO_Read(GPIO_PRT_Type const *base, uint32_t pinNum)
+{
+    sim_bus_pin_t const *pin = sim_bus_pin(base, pinNum);
+
+    return (NULL != pin) ? sim_bus_line(pin->bus, pin->sda) : ((base->out >> pinNum) & 1UL);
+}
+
+void Cy_GPIO_SetHSIOM(GPIO_PRT_Type *base, uint32_t pinNum, en_hsiom_sel_t value)
+{
+    sim_bus_pin_t const *pin = sim_bus_pin(base, pinNum);
+    uint32_t scl = 1U;
+    uint32_t sda = 1U;
+
+    if (NULL != pin)
+    {
+        scl = sim_bus_line(pin->bus, false);
+        sda = sim_bus_line(pin->bus, true);
+    }
+
+    base->hsiom[pinNum] = value;
+
+    if (NULL != pin)
+    {
+        sim_bus_pin_changed(pin->bus, scl, sda);
+    }
+}
+
+/*******************************************************************************
+* BSP
+*******************************************************************************/
+cy_rslt_t cybsp_init(void)
+{
+    sim_reset();
+    Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM, CYBSP_LED_STATE_OFF);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+* SCB I2C master
+*******************************************************************************/
+cy_en_scb_i2c_status_t Cy_SCB_I2C_Init(CySCB_Type *base, cy_stc_scb_i2c_config_t const *config,
+                                       cy_stc_scb_i2c_context_t *context)
+{
+    if ((NULL == base) || (NULL == config) || (NULL == context) || (CY_SCB_I2C_MASTER != config->i2cMode))
+    {
+        return CY_SCB_I2C_BAD_PARAM;
+    }
+
+    memset(context, 0, sizeof(*context));
+    base->mode       = SIM_SCB_I2C_MASTER;
+    base->i2cContext = context;
+    base->enabled    = false;
+    return CY_SCB_I2C_SUCCESS;
+}
+
+void Cy_SCB_I2C_Enable(CySCB_Type *base, cy_stc_scb_i2c_context_t const *context)
+{
+    CY_UNUSED_PARAMETER(context);
+    base->enabled = true;
+}
+
+void Cy_SCB_I2C_Disable(CySCB_Type *base, cy_stc_scb_i2c_context_t *context)
+{
+    sim_bus_t *bus = &simBus[base->bus];
+
+    /* Disabling the block abandons the transfer and releases the bus */
+    if (bus->master == base)
+    {
+        if ((SIM_BUS_IDLE != bus->phase) && (SIM_BUS_HELD != bus->phase) && bus->stretched)
+        {
+            simStats.stretchNs += simNow - bus->stretchStart;
+        }
+        if (SIM_BUS_IDLE != bus->phase)
+        {
+            simStats.busActiveNs += simNow - bus->activeStart;
+        }
+        bus->phase     = SIM_BUS_IDLE;
+        bus->stretched = false;
+        bus->freeAt    = simNow;
+        bus->master    = NULL;
+    }
+
+    base->enabled = false;
+    base->mstDone = false;
+    context->state        = SIM_I2C_IDLE;
+    context->masterStatus = 0U;
+}
+
+/* Oversampling: the SCB clock must be in the range of the rate class, and
+ * one SCL period a whole number of SCB clocks
+ */
+uint32_t Cy_SCB_I2C_SetDataRate(CySCB_Type *base, uint32_t dataRateHz, uint32_t scbClockHz)
+{
+    sim_rate_class_t const *rc = sim_rate_class(dataRateHz);
+    uint32_t ovs;
+
+    CY_ASSERT(!base->enabled);
+    if ((0U == dataRateHz) || (NULL == rc) ||
+        (scbClockHz < rc->masterClkMinHz) || (scbClockHz > rc->masterClkMaxHz))
+    {
+        return 0U;
+    }
+    ovs = (scbClockHz + dataRateHz - 1U) / dataRateHz;
+    if ((ovs < SIM_I2C_OVS_MIN) || (ovs > SIM_I2C_OVS_MAX))
+    {
+        return 0U;
+    }
+
+    base->dataRateHz = scbClockHz / ovs;
+    return base->dataRateHz;
+}
+
+uint32_t Cy_SCB_I2C_GetDataRate(CySCB_Type const *base, uint32_t scbClockHz)
+{
+    CY_UNUSED_PARAMETER(scbClockHz);
+    return base->dataRateHz;
+}
+
+static cy_en_scb_i2c_status_t sim_i2c_master_xfer(CySCB_Type *base, cy_stc_scb_i2c_master_xfer_config_t *xferConfig,
+                                                  cy_stc_scb_i2c_context_t *context, bool rdDir)
+{
+    sim_bus_t *bus = &simBus[base->bus];
+
+    if ((NULL == xferConfig) || ((NULL == xferConfig->buffer) && (0U != xferConfig->bufferSize)))
+    {
+        return CY_SCB_I2C_BAD_PARAM;
+    }
+    if (!base->enabled || (SIM_I2C_IDLE != context->state) ||
+        ((SIM_BUS_IDLE != bus->phase) && !((SIM_BUS_HELD == bus->phase) && (bus->master == base))))
+    {
+        return CY_SCB_I2C_MASTER_NOT_READY;
+    }
+
+    context->state            = SIM_I2C_MASTER_ACTIVE;
+    context->masterStatus     = CY_SCB_I2C_MASTER_BUSY;
+    context->masterPause      = xferConfig->xferPending;
+    context->masterRdDir      = rdDir;
+    context->masterBuffer     = xferConfig->buffer;
+    context->masterBufferSize = xferConfig->bufferSize;
+    context->masterNumBytes   = 0U;
+
+    bus->master  = base;
+    bus->address = xferConfig->slaveAddress;
+    bus->rdDir   = rdDir;
+    bus->pending = xferConfig->xferPending;
+    bus->buffer  = xferConfig->buffer;
+    bus->size    = xferConfig->bufferSize;
+    bus->idx     = 0U;
+    bus->error   = 0U;
+    sim_bus_begin(bus);
+
+    return CY_SCB_I2C_SUCCESS;
+}
+
+cy_en_scb_i2c_status_t Cy_SCB_I2C_MasterWrite(CySCB_Type *base, cy_stc_scb_i2c_master_xfer_config_t *xferConfig,
+                                              cy_stc_scb_i2c_context_t *context)
+{
+    return sim_i2c_master_xfer(base, xferConfig, context, false);
+}
+
+cy_en_scb_i2c_status_t Cy_SCB_I2C_MasterRead(CySCB_Type *base, cy_stc_scb_i2c_master_xfer_config_t *xferConfig,
+                                             cy_stc_scb_i2c_context_t *context)
+{
+    return sim_i2c_master_xfer(base, xferConfig, context, true);
+}
+
+uint32_t Cy_SCB_I2C_MasterGetStatus(CySCB_Type const *base, cy_stc_scb_i2c_context_t const *context)
+{
+    CY_UNUSED_PARAMETER(base);
+    return context->masterStatus;
+}
+
+uint32_t Cy_SCB_I2C_MasterGetTransferCount(CySCB_Type const *base, cy_stc_scb_i2c_context_t const *context)
+{
+    CY_UNUSED_PARAMETER(base);
+    return context->masterNumBytes;
+}
+
+void Cy_SCB_I2C_MasterInterrupt(CySCB_Type *base, cy_stc_scb_i2c_context_t *context)
+{
+    uint32_t events;
+
+    if (base->mstDone)
+    {
+        base->mstDone = false;
+        context->masterNumBytes = base->mstCount;
+        context->masterStatus   = base->mstError;
+        context->state          = SIM_I2C_IDLE;
+
+        events = context->masterRdDir ? CY_SCB_I2C_MASTER_RD_CMPLT_EVENT : CY_SCB_I2C_MASTER_WR_CMPLT_EVENT;
+        if (0U != base->mstError)
+        {
+            events |= CY_SCB_I2C_MASTER_ERR_EVENT;
+        }
+        if (NULL != context->cbEvents)
+        {
+            context->cbEvents(events);
+        }
+    }
+}
+
+/* Deep Sleep is refused while a transfer is in progress */
+cy_en_syspm_status_t Cy_SCB_I2C_DeepSleepCallback(cy_stc_syspm_callback_params_t *callbackParams,
+                                                  cy_en_syspm_callback_mode_t mode)
+{
+    cy_stc_scb_i2c_context_t const *context = (cy_stc_scb_i2c_context_t const *)callbackParams->context;
+
+    if ((CY_SYSPM_CHECK_READY == mode) && (SIM_I2C_IDLE != context->state))
+    {
+        return CY_SYSPM_FAIL;
+    }
+    return CY_SYSPM_SUCCESS;
+}
+
+void Cy_SCB_I2C_RegisterEventCallback(CySCB_Type const *base, cy_cb_scb_i2c_handle_events_t callback,
+                                      cy_stc_scb_i2c_context_t *context)
+{
+    CY_UNUSED_PARAMETER(base);
+    context->cbEvents = callback;
+}
+
+/*******************************************************************************
+* SCB EZI2C slave
+*******************************************************************************/
+cy_en_scb_ezi2c_status_t Cy_SCB_EZI2C_Init(CySCB_Type *base, cy_stc_scb_ezi2c_config_t const *config,
+                                           cy_stc_scb_ezi2c_context_t *context)
+{
+    if ((NULL == base) || (NULL == config) || (NULL == context))
+    {
+        return CY_SCB_EZI2C_BAD_PARAM;
+    }
+
+    memset(context, 0, sizeof(*context));
+    context->address1    = config->slaveAddress1;
+    context->address2    = config->slaveAddress2;
+    context->subAddrSize = config->subAddressSize;
+
+    base->mode          = SIM_SCB_EZI2C;
+    base->ezContext     = context;
+    base->slaveAddress1 = config->slaveAddress1;
+    base->slaveAddress2 = config->slaveAddress2;
+    base->twoAddresses  = (CY_SCB_EZI2C_TWO_ADDRESSES == config->numberOfAddresses);
+    base->wakeEnabled   = config->enableWakeFromSleep;
+    base->enabled       = false;
+    return CY_SCB_EZI2C_SUCCESS;
+}
+
+void Cy_SCB_EZI2C_Enable(CySCB_Type *base)
+{
+    base->enabled = true;
+}
+
+void Cy_SCB_EZI2C_Disable(CySCB_Type *base, cy_stc_scb_ezi2c_context_t *context)
+{
+    base->enabled  = false;
+    base->evtCount = 0U;
+    context->status = 0U;
+}
+
+void Cy_SCB_EZI2C_SetBuffer1(CySCB_Type const *base, uint8_t *buffer, uint32_t size, uint32_t rwBoundary,
+                             cy_stc_scb_ezi2c_context_t *context)
+{
+    CY_UNUSED_PARAMETER(base);
+
+    /* The PDL does not allow the buffer to change during an access */
+    CY_ASSERT(0U == (context->status & CY_SCB_EZI2C_STATUS_BUSY));
+    context->buf1          = buffer;
+    context->buf1Size      = size;
+    context->buf1rwBondary = rwBoundary;
+    context->baseAddr1     = 0U;
+}
+
+void Cy_SCB_EZI2C_SetBuffer2(CySCB_Type const *base, uint8_t *buffer, uint32_t size, uint32_t rwBoundary,
+                             cy_stc_scb_ezi2c_context_t *context)
+{
+    CY_UNUSED_PARAMETER(base);
+    context->buf2          = buffer;
+    context->buf2Size      = size;
+    context->buf2rwBondary = rwBoundary;
+    context->baseAddr2     = 0U;
+}
+
+uint32_t Cy_SCB_EZI2C_GetActivity(CySCB_Type const *base, cy_stc_scb_ezi2c_context_t *context)
+{
+    uint32_t status = context->status;
+
+    CY_UNUSED_PARAMETER(base);
+    context->status &= CY_SCB_EZI2C_STATUS_BUSY;
+    return status;
+}
+
+/* Select the buffer of the address that matched and rewind to its base */
+static void sim_ezi2c_on_address(cy_stc_scb_ezi2c_context_t *context, uint8_t addrByte)
+{
+    bool second = ((addrByte >> 1U) != context->address1);
+
+    context->activeAddr    = second ? 2U : 1U;
+    context->curBuf        = second ? context->buf2 : context->buf1;
+    context->bufSize       = second ? context->buf2Size : context->buf1Size;
+    context->bufRwBoundary = second ? context->buf2rwBondary : context->buf1rwBondary;
+    context->idx           = second ? context->baseAddr2 : context->baseAddr1;
+    context->rdDir         = (0U != (addrByte & 1U));
+    context->addrPhase     = !context->rdDir;
+    context->writeCount    = 0U;
+    context->status       |= CY_SCB_EZI2C_STATUS_BUSY;
+}
+
+/* Returns true to ACK the byte */
+static bool sim_ezi2c_on_rx(cy_stc_scb_ezi2c_context_t *context, uint8_t data)
+{
+    uint32_t *baseAddr = (2U == context->activeAddr) ? &context->baseAddr2 : &context->baseAddr1;
+
+    if (context->addrPhase)
+    {
+        /* Only 8-bit sub-addresses are modeled */
+        if (data >= context->bufSize)
+        {
+            context->status |= CY_SCB_EZI2C_STATUS_ERR;
+            return false;
+        }
+        *baseAddr          = data;
+        context->idx       = data;
+        context->addrPhase = false;
+        return true;
+    }
+
+    if (context->idx >= context->bufRwBoundary)
+    {
+        return false;
+    }
+    context->curBuf[context->idx++] = data;
+    context->writeCount++;
+    return true;
+}
+
+static uint8_t sim_ezi2c_on_tx(cy_stc_scb_ezi2c_context_t *context)
+{
+    if (context->idx < context->bufSize)
+    {
+        return context->curBuf[context->idx++];
+    }
+    return SIM_EZI2C_DEFAULT_TX;
+}
+
+static void sim_ezi2c_on_stop(cy_stc_scb_ezi2c_context_t *context)
+{
+    if (context->rdDir)
+    {
+        context->status |= (2U == context->activeAddr) ? CY_SCB_EZI2C_STATUS_READ2 : CY_SCB_EZI2C_STATUS_READ1;
+    }
+    else if (0U != context->writeCount)
+    {
+        context->status |= (2U == context->activeAddr) ? CY_SCB_EZI2C_STATUS_WRITE2 : CY_SCB_EZI2C_STATUS_WRITE1;
+    }
+    else
+    {
+        /* Sub-address only write */
+    }
+    context->status &= ~CY_SCB_EZI2C_STATUS_BUSY;
+}
+
+void Cy_SCB_EZI2C_Interrupt(CySCB_Type *base, cy_stc_scb_ezi2c_context_t *context)
+{
+    sim_bus_t *bus = &simBus[base->bus];
+    sim_slv_evt_t evt;
+    bool ack;
+    uint8_t txByte;
+
+    while (0U != base->evtCount)
+    {
+        evt = base->evt[base->evtHead];
+        base->evtHead = (base->evtHead + 1U) % SIM_SLV_EVT_DEPTH;
+        base->evtCount--;
+
+        ack    = true;
+        txByte = 0U;
+        switch (evt.type)
+        {
+            case SIM_SLV_EVT_ADDR:
+                sim_ezi2c_on_address(context, evt.data);
+                break;
+            case SIM_SLV_EVT_RX:
+                ack = sim_ezi2c_on_rx(context, evt.data);
+                break;
+            case SIM_SLV_EVT_TX:
+                txByte = sim_ezi2c_on_tx(context);
+                break;
+            case SIM_SLV_EVT_STOP:
+            default:
+                sim_ezi2c_on_stop(context);
+                break;
+        }
+
+        if ((SIM_SLV_EVT_STOP != evt.type) && bus->stretched && (bus->slave == base))
+        {
+            sim_bus_release(bus, evt.type, ack, txByte);
+        }
+    }
+}
+
+/* Deep Sleep is refused while the slave is addressed or has events the ISR
+ * did not take yet. In Deep Sleep an address match wakes the device if the
+ * slave was configured for it, and SCL is stretched until the ISR runs.
+ */
+cy_en_syspm_status_t Cy_SCB_EZI2C_DeepSleepCallback(cy_stc_syspm_callback_params_t *callbackParams,
+                                                    cy_en_syspm_callback_mode_t mode)
+{
+    CySCB_Type *base = (CySCB_Type *)callbackParams->base;
+    cy_stc_scb_ezi2c_context_t const *context = (cy_stc_scb_ezi2c_context_t const *)callbackParams->context;
+    cy_en_syspm_status_t status = CY_SYSPM_SUCCESS;
+
+    switch (mode)
+    {
+        case CY_SYSPM_CHECK_READY:
+            if ((0U != (context->status & CY_SCB_EZI2C_STATUS_BUSY)) || (0U != base->evtCount))
+            {
+                status = CY_SYSPM_FAIL;
+            }
+            break;
+        case CY_SYSPM_BEFORE_TRANSITION:
+            base->wakeArmed = base->wakeEnabled;
+            break;
+        case CY_SYSPM_CHECK_FAIL:
+        case CY_SYSPM_AFTER_TRANSITION:
+        default:
+            base->wakeArmed = false;
+            break;
+    }
+    return status;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,435 @@
+/******************************************************************************
+* File Name:   soak_bench.c
+*
+* Description: Fault soak benchmark. Sends LED commands through the blocking
+*              master functions (write the command packet, check the EZI2C
+*              buffer, read the status packet) while the seedable fault
+*              injector of the simulated bus makes the transfers fail: each
+*              master error condition, slave clock stretching, a stuck SDA
+*              line and corrupted bytes, one class at a time and then all
+*              together. Reports goodput, error rate, the retries the master
+*              and the application needed, and time-to-recover percentiles,
+*              and checks that every command was executed exactly once.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "I2CRecovery.h"
+#include "sim.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define OFF                     CYBSP_LED_STATE_OFF
+#define ON                      CYBSP_LED_STATE_ON
+
+/* Bus of CYBSP_I2C_master and the EZI2C slave */
+#define BENCH_BUS               (0UL)
+
+#define DEFAULT_COMMANDS        (5000UL)
+#define DEFAULT_PPM             (2000UL)
+#define DEFAULT_SEED            (1UL)
+
+/* Fault shape: longest slave hold of SCL, clocks until a stuck SDA is let go */
+#define STRETCH_MAX_NS          (200ULL * SIM_NS_PER_US)
+#define STUCK_CLOCKS            (5UL)
+
+/* Times the application sends a command again after the master gave up */
+#define APP_ATTEMPTS_MAX        (8UL)
+
+/* Rows of the soak: no faults, each class alone, all classes */
+#define ROW_CLEAN               (SIM_FAULT_COUNT)
+#define ROW_ALL                 (SIM_FAULT_COUNT + 1UL)
+#define ROW_COUNT               (SIM_FAULT_COUNT + 2UL)
+
+/* No command may take longer than this to recover from its first fault */
+#define CHECK_RECOVER_MAX_NS    (10ULL * SIM_NS_PER_MS)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t confirmed;     /* Commands with a good status */
+    uint32_t executed;      /* Commands the slave counted */
+    uint32_t calls;         /* Master write and read calls */
+    uint32_t callErrors;    /* Calls that returned an error */
+    uint32_t appResends;    /* Commands sent again by the application */
+    uint32_t faults;
+    uint32_t hit;           /* Commands a fault hit */
+    uint64_t elapsedNs;
+    i2c_recovery_stats_t recovery;
+} row_result_t;
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static const char * const faultNames[SIM_FAULT_COUNT] =
+{
+    "ABORT_START", "ADDR_NAK", "DATA_NAK", "ARB_LOST", "BUS_ERR", "stretch", "stuck SDA", "corrupt"
+};
+
+static uint8_t cmd = ON;
+
+/* Time of the first fault injected since the last command completed, 0 for none */
+static uint64_t firstFaultNs;
+
+/*******************************************************************************
+* Function Name: on_fault
+****************************************************************************//**
+*
+* Summary:
+*   Fault injector hook: notes when the command in flight was first hit.
+*
+*******************************************************************************/
+static void on_fault(uint32_t fault, uint64_t atNs)
+{
+    CY_UNUSED_PARAMETER(fault);
+    if (0U == firstFaultNs)
+    {
+        firstFaultNs = atNs;
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_counter
+****************************************************************************//**
+*
+* Summary:
+*   Decodes a little-endian 32-bit counter of the telemetry window.
+*
+*******************************************************************************/
+static uint32_t bench_counter(uint8_t const *tlm, uint32_t pos)
+{
+    return (uint32_t)tlm[pos] | ((uint32_t)tlm[pos + 1U] << 8U) |
+           ((uint32_t)tlm[pos + 2U] << 16U) | ((uint32_t)tlm[pos + 3U] << 24U);
+}
+
+/*******************************************************************************
+* Function Name: slave_commands
+****************************************************************************//**
+*
+* Summary:
+*   Reads the count of executed commands from the telemetry window. Call it
+*   with the fault injection off.
+*
+*******************************************************************************/
+static uint32_t slave_commands(void)
+{
+    uint8_t tlm[TLM_SIZE];
+
+    if (READ_CMPLT != ReadTelemetryFromEzI2C(&CYBSP_I2C_master, (uint8_t)TLM_SEQ_POS, tlm, TLM_SIZE))
+    {
+        return 0U;
+    }
+    return bench_counter(tlm, TLM_COMMANDS_POS);
+}
+
+/*******************************************************************************
+* Function Name: send_command
+****************************************************************************//**
+*
+* Summary:
+*   Sends one command until its status packet is good, sending the same
+*   frame again when the master gives up. The slave drops a frame it has
+*   executed already.
+*
+* Return:
+*   true if the command was confirmed within APP_ATTEMPTS_MAX attempts.
+*
+*******************************************************************************/
+static bool send_command(row_result_t *row, uint8_t *buffer, uint32_t size)
+{
+    uint32_t attempt;
+
+    for (attempt = 0U; attempt < APP_ATTEMPTS_MAX; attempt++)
+    {
+        if (0U != attempt)
+        {
+            row->appResends++;
+        }
+
+        row->calls++;
+        if (TRANSFER_CMPLT != WritePacketToEzI2C(&CYBSP_I2C_master, buffer, size))
+        {
+            row->callErrors++;
+            CheckEzI2Cbuffer();
+            continue;
+        }
+        CheckEzI2Cbuffer();
+
+        row->calls++;
+        if (READ_CMPLT == ReadStatusPacketFromEzI2C(&CYBSP_I2C_master))
+        {
+            return true;
+        }
+        row->callErrors++;
+    }
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: run_row
+****************************************************************************//**
+*
+* Summary:
+*   Sends count commands with the faults of one row injected.
+*
+* Return:
+*   false if a command was not confirmed, the slave did not execute every
+*   command exactly once or the LED is in the wrong state.
+*
+*******************************************************************************/
+static bool run_row(row_result_t *row, uint32_t r, uint32_t count, uint32_t seed, uint32_t ppm,
+                    uint64_t *recoverNs)
+{
+    sim_fault_config_t config = { 0U };
+    i2c_recovery_stats_t const *rs = GetRecoveryStats(&CYBSP_I2C_master);
+    i2c_recovery_stats_t rs0 = *rs;
+    uint8_t buffer[WRITE_PACKET_SIZE];
+    uint32_t executed0 = slave_commands();
+    uint32_t size;
+    uint32_t i;
+    uint32_t f;
+    uint64_t t0;
+    bool ok = true;
+
+    *row = (row_result_t){ 0U };
+
+    config.seed         = seed + r;
+    config.stretchMaxNs = STRETCH_MAX_NS;
+    config.stuckClocks  = STUCK_CLOCKS;
+    config.hook         = &on_fault;
+    for (f = 0U; f < SIM_FAULT_COUNT; f++)
+    {
+        config.ppm[f] = ((ROW_ALL == r) || (f == r)) ? ppm : 0U;
+    }
+    sim_set_faults(BENCH_BUS, &config);
+
+    t0 = sim_now_ns();
+    for (i = 0U; i < count; i++)
+    {
+        size = PrepareCommandPacket(&CYBSP_I2C_master, buffer, cmd);
+        firstFaultNs = 0U;
+        if (!send_command(row, buffer, size))
+        {
+            ok = false;
+            break;
+        }
+        row->confirmed++;
+        cmd = (cmd == ON) ? OFF : ON;
+
+        if (0U != firstFaultNs)
+        {
+            recoverNs[row->hit++] = sim_now_ns() - firstFaultNs;
+        }
+    }
+    row->elapsedNs = sim_now_ns() - t0;
+
+    for (f = 0U; f < SIM_FAULT_COUNT; f++)
+    {
+        row->faults += sim_get_fault_stats()->injected[f];
+    }
+    sim_set_faults(BENCH_BUS, NULL);
+
+    row->executed             = slave_commands() - executed0;
+    row->recovery.failures    = rs->failures - rs0.failures;
+    row->recovery.timeouts    = rs->timeouts - rs0.timeouts;
+    row->recovery.clockOuts   = rs->clockOuts - rs0.clockOuts;
+    row->recovery.retries     = rs->retries - rs0.retries;
+    row->recovery.recovered   = rs->recovered - rs0.recovered;
+    row->recovery.unrecovered = rs->unrecovered - rs0.unrecovered;
+
+    return (ok && (row->executed == row->confirmed) &&
+            (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) == buffer[PACKET_CMD_POS]));
+}
+
+/*******************************************************************************
+* Function Name: bench_percentile
+****************************************************************************//**
+*
+* Summary:
+*   Percentile of sorted samples in microseconds, 0 without samples.
+*
+*******************************************************************************/
+static double bench_percentile(uint64_t const *samplesNs, uint32_t count, uint32_t pct)
+{
+    if (0U == count)
+    {
+        return 0.0;
+    }
+    return (double)samplesNs[((uint64_t)(count - 1U) * pct) / 100U] / SIM_NS_PER_US;
+}
+
+/*******************************************************************************
+* Function Name: bench_cmp_u64
+****************************************************************************//**
+*
+* Summary:
+*   qsort() comparison of two 64-bit samples.
+*
+*******************************************************************************/
+static int bench_cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: soak_bench [-n commands] [-p ppm] [-s seed] [-c]
+*
+*   -n is the number of commands per row.
+*   -p is the rate of each fault class, per million opportunities (START,
+*      address byte or data byte, see sim.h).
+*   -s seeds the fault sequence; the same seed gives the same run.
+*   -c checks that every command was confirmed and executed exactly once,
+*      that every fault class was injected and that no command took longer
+*      than 10 ms to recover, and exits non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t commands = DEFAULT_COMMANDS;
+    uint32_t ppm = DEFAULT_PPM;
+    uint32_t seed = DEFAULT_SEED;
+    bool check = false;
+    bool ok = true;
+    int opt;
+    uint32_t r;
+    uint64_t *recoverNs;
+    row_result_t row;
+    double cleanRate = 0.0;
+    double rate;
+
+    while ((opt = getopt(argc, argv, "n:p:s:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': commands = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'p': ppm      = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 's': seed     = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': check    = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n commands] [-p ppm] [-s seed] [-c]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if ((0U == commands) || (0U == ppm) || (ppm > SIM_FAULT_PPM) || (0U == seed))
+    {
+        fprintf(stderr, "commands and seed must be non-zero, ppm 1 to %lu\n", (unsigned long)SIM_FAULT_PPM);
+        return EXIT_FAILURE;
+    }
+
+    recoverNs = calloc(commands, sizeof(*recoverNs));
+    if (NULL == recoverNs)
+    {
+        return EXIT_FAILURE;
+    }
+
+    /* Same bring-up sequence as main.c */
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initSlave()) || (I2C_SUCCESS != initMaster()))
+    {
+        fprintf(stderr, "initialization failed\n");
+        free(recoverNs);
+        return EXIT_FAILURE;
+    }
+    __enable_irq();
+
+    printf("Fault soak host benchmark\n");
+    printf("  commands per row   : %lu, fault rate %lu ppm, seed %lu\n", (unsigned long)commands,
+           (unsigned long)ppm, (unsigned long)seed);
+    printf("  %-11s  %6s  %9s  %6s  %8s  %7s  %6s  %6s  %9s  %9s  %9s\n", "faults", "count", "commands/s", "goodput",
+           "errors/1k", "retries", "lost", "resend", "p50 (us)", "p99 (us)", "max (us)");
+
+    for (r = 0U; r < ROW_COUNT; r++)
+    {
+        uint32_t row_r = (0U == r) ? ROW_CLEAN : ((r <= SIM_FAULT_COUNT) ? (r - 1U) : ROW_ALL);
+        bool rowOk = run_row(&row, row_r, commands, seed, ppm, recoverNs);
+
+        qsort(recoverNs, row.hit, sizeof(*recoverNs), bench_cmp_u64);
+        rate = (double)row.confirmed * SIM_NS_PER_SEC / row.elapsedNs;
+        if (ROW_CLEAN == row_r)
+        {
+            cleanRate = rate;
+        }
+
+        printf("  %-11s  %6lu  %9.1f  %6.1f%%  %8.2f  %7lu  %6lu  %6lu  %9.1f  %9.1f  %9.1f%s\n",
+               (ROW_CLEAN == row_r) ? "none" : ((ROW_ALL == row_r) ? "all" : faultNames[row_r]),
+               (unsigned long)row.faults, rate, 100.0 * rate / cleanRate,
+               1000.0 * row.callErrors / row.calls, (unsigned long)row.recovery.retries,
+               (unsigned long)row.recovery.unrecovered, (unsigned long)row.appResends,
+               bench_percentile(recoverNs, row.hit, 50U), bench_percentile(recoverNs, row.hit, 99U),
+               bench_percentile(recoverNs, row.hit, 100U), rowOk ? "" : "  FAILED");
+
+        ok = rowOk && ok;
+        if ((ROW_CLEAN == row_r) ? (0U != row.faults) : (0U == row.faults))
+        {
+            ok = false;
+        }
+        if ((0U != row.hit) && (recoverNs[row.hit - 1U] > CHECK_RECOVER_MAX_NS))
+        {
+            ok = false;
+        }
+    }
+    printf("  errors/1k: failed master calls; retries: master retries; lost: transfers the master\n");
+    printf("  gave up on; resend: commands the application sent again; pNN: first fault to good status\n");
+
+    free(recoverNs);
+    if (check && !ok)
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
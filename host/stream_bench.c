@@ -0,0 +1,335 @@
+/******************************************************************************
+* File Name:   stream_bench.c
+*
+* Description: Bulk streaming benchmark. Payloads of up to STREAM_MAX_SIZE
+*              bytes are streamed from the master to the EZI2C slave with
+*              OpenStreamToEzI2C(&CYBSP_I2C_master)/PumpStreamToEzI2C(&CYBSP_I2C_master) while the slave main
+*              loop runs in between, and the payload throughput is compared
+*              with the line rate of the bus. A second run injects bus
+*              faults while the chunks are in flight and checks that every
+*              stream resumes from the acknowledged chunk and arrives intact.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "I2CDataRate.h"
+#include "sim.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DEFAULT_STREAMS         (200UL)
+
+/* Bus of the jumper-wired master and slave */
+#define BUS_IDX                 (0UL)
+
+/* Bits on the wire per data byte (8 data bits and the acknowledge) */
+#define BITS_PER_BYTE           (9UL)
+
+/* A stream that does not complete within this many pumps is lost */
+#define MAX_PUMPS               (1000UL)
+
+/* Fault run: one fault every FAULT_EVERY pumps on average. An arbitration
+ * loss that outlasts the retries fails the write, SDA held for a few
+ * clocks is cleared by the recovery and the write retried.
+ */
+#define FAULT_EVERY             (4UL)
+#define FAULT_SDA_CLOCKS        (3UL)
+#define FAULT_SEED              (0x5EEDUL)
+
+/* A clean stream must move payload at least at this fraction of the line
+ * rate
+ */
+#define CHECK_LINE_FRACTION     (0.65)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static uint8_t payload[STREAM_MAX_SIZE];
+static uint32_t faultState = FAULT_SEED;
+
+/*******************************************************************************
+* Function Name: bring_up
+****************************************************************************//**
+*
+* Summary:
+*   Resets the device, runs the bring-up sequence of main.c and switches
+*   the bus to the given data rate.
+*
+* Return:
+*   Data rate applied, 0 on failure.
+*
+*******************************************************************************/
+static uint32_t bring_up(uint32_t dataRate)
+{
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initSlave()) || (I2C_SUCCESS != initMaster()))
+    {
+        fprintf(stderr, "initialization failed\n");
+        return 0U;
+    }
+    __enable_irq();
+    return SwitchDataRate(dataRate);
+}
+
+/*******************************************************************************
+* Function Name: next_random
+****************************************************************************//**
+*
+* Summary:
+*   Deterministic pseudo-random numbers for the payload and the faults.
+*
+*******************************************************************************/
+static uint32_t next_random(uint32_t *state)
+{
+    *state = (*state * 1103515245UL) + 12345UL;
+    return (*state >> 16U);
+}
+
+/*******************************************************************************
+* Function Name: inject_fault
+****************************************************************************//**
+*
+* Summary:
+*   Injects a fault before a pump, on average every FAULT_EVERY pumps.
+*
+* Return:
+*   true if a fault was injected.
+*
+*******************************************************************************/
+static bool inject_fault(void)
+{
+    uint32_t r = next_random(&faultState);
+
+    if (0U != (r % FAULT_EVERY))
+    {
+        return false;
+    }
+    if (0U != ((r / FAULT_EVERY) & 1U))
+    {
+        sim_inject_master_error(CYBSP_I2C_HW, CY_SCB_I2C_MASTER_ARB_LOST, ARB_RETRY_MAX + 1U);
+    }
+    else
+    {
+        sim_hold_sda(BUS_IDX, FAULT_SDA_CLOCKS);
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: stream
+****************************************************************************//**
+*
+* Summary:
+*   Streams size bytes of fresh payload to the slave, running the slave
+*   main loop after every transfer, and checks what the slave received.
+*
+* Return:
+*   true if the stream completed and the slave holds the same bytes.
+*
+*******************************************************************************/
+static bool stream(uint32_t size, uint32_t seed, bool faults, uint32_t *errors, uint32_t *injected)
+{
+    uint8_t const *received;
+    uint32_t receivedSize = 0U;
+    uint32_t pumps = 0U;
+    uint8_t status;
+    uint32_t i;
+
+    for (i = 0U; i < size; i++)
+    {
+        payload[i] = (uint8_t)next_random(&seed);
+    }
+
+    if (faults && inject_fault())
+    {
+        (*injected)++;
+    }
+    status = OpenStreamToEzI2C(&CYBSP_I2C_master, payload, size);
+    CheckEzI2Cbuffer();
+    do
+    {
+        if (TRANSFER_ERROR == status)
+        {
+            (*errors)++;
+        }
+        if (faults && inject_fault())
+        {
+            (*injected)++;
+        }
+        status = PumpStreamToEzI2C(&CYBSP_I2C_master);
+        CheckEzI2Cbuffer();
+        pumps++;
+    } while ((TRANSFER_CMPLT != status) && (pumps < MAX_PUMPS));
+    sim_inject_master_error(CYBSP_I2C_HW, 0U, 0U);
+    sim_hold_sda(BUS_IDX, 0U);
+
+    received = GetStreamData(&receivedSize);
+    return ((TRANSFER_CMPLT == status) && (NULL != received) && (receivedSize == size) &&
+            (0 == memcmp(received, payload, size)));
+}
+
+/*******************************************************************************
+* Function Name: bench_rate
+****************************************************************************//**
+*
+* Summary:
+*   Streams count payloads at one data rate and prints one result row.
+*
+* Return:
+*   true if every stream arrived intact and, without faults, the payload
+*   throughput reached CHECK_LINE_FRACTION of the line rate.
+*
+*******************************************************************************/
+static bool bench_rate(uint32_t dataRate, uint32_t count, uint32_t size, bool faults)
+{
+    uint32_t actual = bring_up(dataRate);
+    uint32_t resends = GetStreamResends(&CYBSP_I2C_master);
+    uint32_t errors = 0U;
+    uint32_t injected = 0U;
+    uint32_t intact = 0U;
+    uint64_t t0;
+    uint64_t elapsed;
+    double bytesPerSec;
+    double line;
+    uint32_t i;
+
+    if (0U == actual)
+    {
+        fprintf(stderr, "data rate not supported\n");
+        return false;
+    }
+
+    t0 = sim_now_ns();
+    for (i = 0U; i < count; i++)
+    {
+        if (stream(size, i, faults, &errors, &injected))
+        {
+            intact++;
+        }
+    }
+    elapsed = sim_now_ns() - t0;
+
+    bytesPerSec = (elapsed > 0U) ? ((double)intact * size * SIM_NS_PER_SEC / elapsed) : 0.0;
+    line = (double)actual / BITS_PER_BYTE;
+    printf("  %7lu  %-6s  %7lu  %7lu  %11.0f  %6.1f%%  %6lu  %7lu  %7lu\n",
+           (unsigned long)actual, faults ? "faults" : "clean", (unsigned long)count, (unsigned long)intact,
+           bytesPerSec, 100.0 * bytesPerSec / line, (unsigned long)injected, (unsigned long)errors,
+           (unsigned long)(GetStreamResends(&CYBSP_I2C_master) - resends));
+
+    return (intact == count) && (faults || (bytesPerSec >= (CHECK_LINE_FRACTION * line)));
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: stream_bench [-n streams] [-s size] [-r data_rate_hz] [-c]
+*
+*   Without -r the data rate is swept over 100 kHz, 400 kHz and 1 MHz, and
+*   each rate is run clean and with faults. -c checks that every stream
+*   arrived intact and that clean streams came close to the line rate, and
+*   exits non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static const uint32_t rates[] = { I2C_RATE_STANDARD_HZ, I2C_RATE_FAST_HZ, I2C_RATE_FAST_PLUS_HZ };
+    uint32_t count = DEFAULT_STREAMS;
+    uint32_t size = STREAM_MAX_SIZE;
+    uint32_t dataRate = 0U;
+    bool check = false;
+    bool ok = true;
+    uint32_t r;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:s:r:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': count    = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 's': size     = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'r': dataRate = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': check    = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n streams] [-s size] [-r data_rate_hz] [-c]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if ((0U == size) || (size > STREAM_MAX_SIZE))
+    {
+        fprintf(stderr, "size must be 1 to %lu bytes\n", (unsigned long)STREAM_MAX_SIZE);
+        return EXIT_FAILURE;
+    }
+
+    printf("Bulk streaming host benchmark\n");
+    printf("  stream size        : %lu bytes in %lu-byte chunks, window of %lu\n", (unsigned long)size,
+           (unsigned long)STREAM_CHUNK_SIZE, (unsigned long)EZI2C_STREAM_SLOTS);
+    printf("  %7s  %-6s  %7s  %7s  %11s  %7s  %6s  %7s  %7s\n", "rate", "run", "streams", "intact",
+           "payload B/s", "of line", "faults", "errors", "resends");
+
+    for (r = 0U; r < (sizeof(rates) / sizeof(rates[0])); r++)
+    {
+        uint32_t rate = (0U != dataRate) ? dataRate : rates[r];
+
+        ok = bench_rate(rate, count, size, false) && ok;
+        ok = bench_rate(rate, count, size, true) && ok;
+        if (0U != dataRate)
+        {
+            break;
+        }
+    }
+
+    if (check && !ok)
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
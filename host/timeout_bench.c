@@ -0,0 +1,283 @@
+/******************************************************************************
+* File Name:   timeout_bench.c
+*
+* Description: Transfer timeout benchmark. The slave ISR is masked so the
+*              EZI2C slave stretches SCL forever, and the benchmark measures
+*              how long the blocking master functions take to give up on
+*              the wedged transfer (deadline, recovery and one retry),
+*              against the wire time of the transfer and the former fixed
+*              1 s timeout. After each failure
+*              the ISR is unmasked and a command must go through again.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "I2CDataRate.h"
+#include "sim.h"
+#include "bench_util.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define OFF                     CYBSP_LED_STATE_OFF
+#define ON                      CYBSP_LED_STATE_ON
+
+/* Timeout of the master functions before the budget was computed */
+#define FIXED_TIMEOUT_US        (1000000UL)
+
+/* Per-call deadline exercised through WaitMasterTransfer(&CYBSP_I2C_master) */
+#define OVERRIDE_TIMEOUT_US     (5000UL)
+
+/* Each attempt must not take longer than this many times the wire time */
+#define CHECK_WIRE_FACTOR       (4ULL)
+#define CHECK_ATTEMPTS          (1ULL + BUS_RETRY_MAX)
+#define CHECK_MARGIN_NS         (500ULL * SIM_NS_PER_US)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static uint8_t writeBuffer[1UL + (COMMAND_RING_SLOTS * EZI2C_RING_SLOT_SIZE)];
+static uint8_t cmd = ON;
+
+/*******************************************************************************
+* Function Name: wire_ns
+****************************************************************************//**
+*
+* Summary:
+*   Wire time of a single-phase write of size bytes (plus the address byte).
+*
+*******************************************************************************/
+static uint64_t wire_ns(uint32_t size, uint32_t dataRate)
+{
+    return ((((uint64_t)(size + 1U) * 9U) + 2U) * SIM_NS_PER_SEC) / dataRate;
+}
+
+/*******************************************************************************
+* Function Name: recover
+****************************************************************************//**
+*
+* Summary:
+*   Unmasks the slave ISR and checks that the next command is executed.
+*
+*******************************************************************************/
+static bool recover(void)
+{
+    uint8_t packet[WRITE_PACKET_SIZE];
+    uint32_t size;
+
+    NVIC_EnableIRQ(CYBSP_EZI2C_IRQ);
+    CheckEzI2Cbuffer();
+
+    cmd = (cmd == ON) ? OFF : ON;
+    size = PrepareCommandPacket(&CYBSP_I2C_master, packet, cmd);
+    if (TRANSFER_CMPLT != WritePacketToEzI2C(&CYBSP_I2C_master, packet, size))
+    {
+        return false;
+    }
+    CheckEzI2Cbuffer();
+
+    return ((READ_CMPLT == ReadStatusPacketFromEzI2C(&CYBSP_I2C_master)) &&
+            (Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM) == cmd));
+}
+
+/*******************************************************************************
+* Function Name: bench_size
+****************************************************************************//**
+*
+* Summary:
+*   Sends one write of size bytes to the wedged slave and prints one result
+*   row. The data goes to the command ring with no SOP, so nothing executes
+*   if part of it lands.
+*
+* Return:
+*   true if the failure was detected in time and the bus recovered.
+*
+*******************************************************************************/
+static bool bench_size(uint32_t size, uint32_t dataRate)
+{
+    uint64_t t0;
+    uint64_t detectNs;
+    uint64_t wireNs = wire_ns(size, dataRate);
+    uint8_t status;
+    bool recovered;
+
+    memset(writeBuffer, 0, sizeof(writeBuffer));
+    writeBuffer[PACKET_ADDR_POS] = (uint8_t)EZI2C_RING_BASE_POS;
+
+    NVIC_DisableIRQ(CYBSP_EZI2C_IRQ);
+    t0 = sim_now_ns();
+    status = WritePacketToEzI2C(&CYBSP_I2C_master, writeBuffer, size);
+    detectNs = sim_now_ns() - t0;
+    recovered = recover();
+
+    printf("  %7lu  %5lu  %10.1f  %12.1f  %9.0fx  %s\n",
+           (unsigned long)dataRate, (unsigned long)size,
+           (double)wireNs / SIM_NS_PER_US, (double)detectNs / SIM_NS_PER_US,
+           (double)FIXED_TIMEOUT_US * SIM_NS_PER_US / detectNs,
+           recovered ? "yes" : "NO");
+
+    return ((TRANSFER_ERROR == status) && recovered &&
+            (detectNs <= (CHECK_ATTEMPTS * ((CHECK_WIRE_FACTOR * wireNs) + CHECK_MARGIN_NS))));
+}
+
+/*******************************************************************************
+* Function Name: bench_override
+****************************************************************************//**
+*
+* Summary:
+*   Waits for a wedged write with a per-call deadline instead of the
+*   computed budget and prints the time to detection.
+*
+* Return:
+*   true if the deadline was honoured and the bus recovered.
+*
+*******************************************************************************/
+static bool bench_override(void)
+{
+    uint8_t packet[WRITE_PACKET_SIZE];
+    uint64_t t0;
+    uint64_t detectNs;
+    uint8_t status = TRANSFER_ERROR;
+    bool recovered;
+
+    NVIC_DisableIRQ(CYBSP_EZI2C_IRQ);
+    t0 = sim_now_ns();
+    if (TRANSFER_PENDING == WritePacketToEzI2CAsync(&CYBSP_I2C_master, packet,
+                                                    PrepareCommandPacket(&CYBSP_I2C_master, packet, cmd), NULL))
+    {
+        status = WaitMasterTransfer(&CYBSP_I2C_master, OVERRIDE_TIMEOUT_US);
+    }
+    detectNs = sim_now_ns() - t0;
+    recovered = recover();
+
+    printf("  override %lu us: detected after %.1f us, recovered %s\n",
+           (unsigned long)OVERRIDE_TIMEOUT_US, (double)detectNs / SIM_NS_PER_US, recovered ? "yes" : "NO");
+
+    return ((TRANSFER_ERROR == status) && recovered &&
+            (detectNs >= (OVERRIDE_TIMEOUT_US * SIM_NS_PER_US)) &&
+            (detectNs <= ((OVERRIDE_TIMEOUT_US * SIM_NS_PER_US) + CHECK_MARGIN_NS)));
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: timeout_bench [-r data_rate_hz] [-c]
+*
+*   Without -r the data rate is swept over 100 kHz, 400 kHz and 1 MHz.
+*   -c checks that every wedged transfer was detected within a small multiple
+*   of its wire time and that the bus recovered, and exits non-zero otherwise.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static const uint32_t rates[] = { 100000U, 400000U, 1000000U };
+    static const uint32_t sizes[] =
+    {
+        WRITE_PACKET_SIZE,
+        1U + (4U * EZI2C_RING_SLOT_SIZE),
+        1U + (COMMAND_RING_SLOTS * EZI2C_RING_SLOT_SIZE)
+    };
+    uint32_t dataRate = 0U;
+    bool check = false;
+    bool ok = true;
+    uint32_t r;
+    uint32_t i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 'r': dataRate = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': check    = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-r data_rate_hz] [-c]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    /* Same bring-up sequence as main.c */
+    if ((CY_RSLT_SUCCESS != cybsp_init()) || (I2C_SUCCESS != initSlave()) || (I2C_SUCCESS != initMaster()))
+    {
+        fprintf(stderr, "initialization failed\n");
+        return EXIT_FAILURE;
+    }
+    __enable_irq();
+
+    printf("Transfer timeout host benchmark (slave ISR masked)\n");
+    printf("  %7s  %5s  %10s  %12s  %10s  %s\n", "rate", "bytes", "wire (us)", "give up (us)", "vs 1 s", "recovered");
+
+    for (r = 0U; r < (sizeof(rates) / sizeof(rates[0])); r++)
+    {
+        uint32_t rate = SwitchDataRate((0U != dataRate) ? dataRate : rates[r]);
+
+        if (0U == rate)
+        {
+            fprintf(stderr, "data rate not supported\n");
+            return EXIT_FAILURE;
+        }
+        for (i = 0U; i < (sizeof(sizes) / sizeof(sizes[0])); i++)
+        {
+            ok = bench_size(sizes[i], rate) && ok;
+        }
+        if (0U != dataRate)
+        {
+            break;
+        }
+    }
+    ok = bench_override() && ok;
+
+    if (check && !ok)
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
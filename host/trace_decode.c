@@ -0,0 +1,503 @@
+/******************************************************************************
+* File Name:   trace_decode.c
+*
+* Description: Decoder of bus event trace dumps. Reads the raw bytes of the
+*              i2c_trace_t of I2CTrace.c, dumped from the device with the
+*              debugger or written by a host benchmark, and prints a timeline
+*              and summary statistics.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <unistd.h>
+#include "I2CMaster.h"
+#include "I2CPacket.h"
+#include "I2CRecovery.h"
+#include "I2CTrace.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Dump layout: header, then the ring, all little-endian */
+#define DUMP_HEADER_SIZE        (16U)
+#define DUMP_RECORD_SIZE        (8U)
+#define DUMP_MAX_RECORDS        (4096U)
+
+#define EVENT_CODES             (0x20U)
+#define STATUS_TEXT_SIZE        (64U)
+
+_Static_assert(offsetof(i2c_trace_t, ring) == DUMP_HEADER_SIZE, "dump header layout");
+_Static_assert(sizeof(i2c_trace_record_t) == DUMP_RECORD_SIZE, "dump record layout");
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t event;
+    uint32_t stamp;
+    uint32_t status;
+    uint32_t count;
+} trace_entry_t;
+
+typedef struct
+{
+    uint32_t    bit;
+    const char *name;
+} bit_name_t;
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static const char *eventNames[EVENT_CODES] =
+{
+    [TRACE_M_WRITE]    = "M_WRITE",
+    [TRACE_M_READ]     = "M_READ",
+    [TRACE_M_WR_CMPLT] = "M_WR_CMPLT",
+    [TRACE_M_RD_CMPLT] = "M_RD_CMPLT",
+    [TRACE_M_ERR]      = "M_ERR",
+    [TRACE_M_TIMEOUT]  = "M_TIMEOUT",
+    [TRACE_M_DONE]     = "M_DONE",
+    [TRACE_M_RETRY]    = "M_RETRY",
+    [TRACE_M_RECOVER]  = "M_RECOVER",
+    [TRACE_S_ACCESS]   = "S_ACCESS",
+    [TRACE_S_FRAME]    = "S_FRAME",
+};
+
+static const bit_name_t masterBits[] =
+{
+    { CY_SCB_I2C_MASTER_DATA_NAK,    "DATA_NAK"    },
+    { CY_SCB_I2C_MASTER_ADDR_NAK,    "ADDR_NAK"    },
+    { CY_SCB_I2C_MASTER_ARB_LOST,    "ARB_LOST"    },
+    { CY_SCB_I2C_MASTER_ABORT_START, "ABORT_START" },
+    { CY_SCB_I2C_MASTER_BUS_ERR,     "BUS_ERR"     },
+    { CY_SCB_I2C_MASTER_WR_IN_FIFO,  "WR_IN_FIFO"  },
+};
+
+static const bit_name_t ezi2cBits[] =
+{
+    { CY_SCB_EZI2C_STATUS_READ1,  "READ1"  },
+    { CY_SCB_EZI2C_STATUS_WRITE1, "WRITE1" },
+    { CY_SCB_EZI2C_STATUS_READ2,  "READ2"  },
+    { CY_SCB_EZI2C_STATUS_WRITE2, "WRITE2" },
+    { CY_SCB_EZI2C_STATUS_BUSY,   "BUSY"   },
+    { CY_SCB_EZI2C_STATUS_ERR,    "ERR"    },
+};
+
+static const char *faultNames[] = { "none", "NAK", "ARB_LOST", "BUS_ERR", "TIMEOUT" };
+
+static trace_entry_t entries[DUMP_MAX_RECORDS];
+
+/*******************************************************************************
+* Function Name: get_le
+****************************************************************************//**
+*
+* Summary:
+*   Reads a little-endian value of size bytes.
+*
+*******************************************************************************/
+static uint32_t get_le(uint8_t const *p, uint32_t size)
+{
+    uint32_t value = 0U;
+
+    while (size-- > 0U)
+    {
+        value = (value << 8U) | p[size];
+    }
+    return value;
+}
+
+/*******************************************************************************
+* Function Name: format_bits
+****************************************************************************//**
+*
+* Summary:
+*   Writes the names of the bits set in status, separated by '|', or "-".
+*
+*******************************************************************************/
+static void format_bits(char *text, uint32_t status, bit_name_t const *names, uint32_t count)
+{
+    uint32_t i;
+
+    text[0] = '\0';
+    for (i = 0U; i < count; i++)
+    {
+        if (0U != (status & names[i].bit))
+        {
+            if ('\0' != text[0])
+            {
+                strcat(text, "|");
+            }
+            strcat(text, names[i].name);
+        }
+    }
+    if ('\0' == text[0])
+    {
+        strcpy(text, "-");
+    }
+}
+
+/*******************************************************************************
+* Function Name: transfer_name
+****************************************************************************//**
+*
+* Summary:
+*   Name of a TRANSFER_* status.
+*
+*******************************************************************************/
+static const char *transfer_name(uint32_t status)
+{
+    switch (status)
+    {
+        case TRANSFER_CMPLT:    return "CMPLT";
+        case TRANSFER_PENDING:  return "PENDING";
+        case TRANSFER_STS_FAIL: return "STS_FAIL";
+        case TRANSFER_ERROR:    return "ERROR";
+        default:                return "?";
+    }
+}
+
+/*******************************************************************************
+* Function Name: frame_name
+****************************************************************************//**
+*
+* Summary:
+*   Name of a STS_* frame status.
+*
+*******************************************************************************/
+static const char *frame_name(uint32_t status)
+{
+    switch (status)
+    {
+        case STS_CMD_DONE:      return "DONE";
+        case STS_CMD_BAD_LEN:   return "BAD_LEN";
+        case STS_CMD_BAD_CRC:   return "BAD_CRC";
+        case STS_CMD_DUPLICATE: return "DUPLICATE";
+        case STS_CMD_BAD_OP:    return "BAD_OP";
+        case STS_CMD_BAD_ARG:   return "BAD_ARG";
+        case STS_CMD_FAIL:      return "FAIL";
+        default:                return "?";
+    }
+}
+
+/*******************************************************************************
+* Function Name: format_entry
+****************************************************************************//**
+*
+* Summary:
+*   Writes the status and count of a record as text.
+*
+*******************************************************************************/
+static void format_entry(char *text, trace_entry_t const *e)
+{
+    char bits[STATUS_TEXT_SIZE];
+
+    switch (e->event)
+    {
+        case TRACE_M_WRITE:
+        case TRACE_M_READ:
+            sprintf(text, "addr 0x%02lx, %lu bytes", (unsigned long)e->status, (unsigned long)e->count);
+            break;
+        case TRACE_M_WR_CMPLT:
+        case TRACE_M_RD_CMPLT:
+        case TRACE_M_ERR:
+        case TRACE_M_TIMEOUT:
+            format_bits(bits, e->status, masterBits, sizeof(masterBits) / sizeof(masterBits[0]));
+            sprintf(text, "%s, %lu bytes", bits, (unsigned long)e->count);
+            break;
+        case TRACE_M_DONE:
+            sprintf(text, "%s", transfer_name(e->status));
+            break;
+        case TRACE_M_RETRY:
+            sprintf(text, "%s, attempt %lu",
+                    (e->status < (sizeof(faultNames) / sizeof(faultNames[0]))) ? faultNames[e->status] : "?",
+                    (unsigned long)e->count);
+            break;
+        case TRACE_M_RECOVER:
+            sprintf(text, "%s", (I2C_BUS_FREE == e->status) ? "bus free" : "bus stuck");
+            break;
+        case TRACE_S_ACCESS:
+            format_bits(bits, e->status, ezi2cBits, sizeof(ezi2cBits) / sizeof(ezi2cBits[0]));
+            sprintf(text, "%s, write %lu", bits, (unsigned long)e->count);
+            break;
+        case TRACE_S_FRAME:
+            sprintf(text, "%s, seq %lu", frame_name(e->status), (unsigned long)e->count);
+            break;
+        default:
+            sprintf(text, "status 0x%04lx, count %lu", (unsigned long)e->status, (unsigned long)e->count);
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: print_summary
+****************************************************************************//**
+*
+* Summary:
+*   Prints event counts, master outcomes and failure causes, transfer times
+*   and slave statistics.
+*
+*******************************************************************************/
+static void print_summary(trace_entry_t const *e, uint32_t count, double const *timeUs)
+{
+    uint32_t events[EVENT_CODES] = { 0U };
+    uint32_t outcomes[4] = { 0U };
+    uint32_t causes[sizeof(masterBits) / sizeof(masterBits[0])] = { 0U };
+    uint32_t frames[4] = { 0U };
+    uint32_t framesOther = 0U;
+    uint32_t slaveErrors = 0U;
+    uint32_t stuck = 0U;
+    uint32_t xfers = 0U;
+    double xferStart = -1.0;
+    double xferMin = 0.0;
+    double xferMax = 0.0;
+    double xferSum = 0.0;
+    uint32_t i;
+    uint32_t b;
+
+    for (i = 0U; i < count; i++)
+    {
+        events[e[i].event]++;
+        switch (e[i].event)
+        {
+            case TRACE_M_WRITE:
+            case TRACE_M_READ:
+                /* The first phase starts the transfer, chained phases follow */
+                if (xferStart < 0.0)
+                {
+                    xferStart = timeUs[i];
+                }
+                break;
+            case TRACE_M_ERR:
+                for (b = 0U; b < (sizeof(masterBits) / sizeof(masterBits[0])); b++)
+                {
+                    causes[b] += (0U != (e[i].status & masterBits[b].bit)) ? 1U : 0U;
+                }
+                break;
+            case TRACE_M_DONE:
+                outcomes[(TRANSFER_CMPLT == e[i].status)    ? 0U :
+                         (TRANSFER_STS_FAIL == e[i].status) ? 1U :
+                         (TRANSFER_ERROR == e[i].status)    ? 2U : 3U]++;
+                if (xferStart >= 0.0)
+                {
+                    double t = timeUs[i] - xferStart;
+
+                    xferMin = ((0U == xfers) || (t < xferMin)) ? t : xferMin;
+                    xferMax = (t > xferMax) ? t : xferMax;
+                    xferSum += t;
+                    xfers++;
+                }
+                xferStart = -1.0;
+                break;
+            case TRACE_M_RECOVER:
+                stuck += (I2C_BUS_FREE != e[i].status) ? 1U : 0U;
+                break;
+            case TRACE_S_ACCESS:
+                slaveErrors += (0U != (e[i].status & CY_SCB_EZI2C_STATUS_ERR)) ? 1U : 0U;
+                break;
+            case TRACE_S_FRAME:
+                if (e[i].status <= STS_CMD_DUPLICATE)
+                {
+                    frames[e[i].status]++;
+                }
+                else
+                {
+                    framesOther++;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    printf("Summary\n");
+    printf("  events             :");
+    for (i = 0U; i < EVENT_CODES; i++)
+    {
+        if (0U != events[i])
+        {
+            printf(" %s %lu", (NULL != eventNames[i]) ? eventNames[i] : "?", (unsigned long)events[i]);
+        }
+    }
+    printf("\n");
+    printf("  master transfers   : %lu ended: CMPLT %lu, STS_FAIL %lu, ERROR %lu, other %lu\n",
+           (unsigned long)events[TRACE_M_DONE], (unsigned long)outcomes[0], (unsigned long)outcomes[1],
+           (unsigned long)outcomes[2], (unsigned long)outcomes[3]);
+    printf("  master faults      : %lu errors (", (unsigned long)events[TRACE_M_ERR]);
+    for (b = 0U; b < (sizeof(masterBits) / sizeof(masterBits[0])); b++)
+    {
+        printf("%s%s %lu", (0U == b) ? "" : ", ", masterBits[b].name, (unsigned long)causes[b]);
+    }
+    printf("), %lu timeouts\n", (unsigned long)events[TRACE_M_TIMEOUT]);
+    printf("  master recovery    : %lu retries, %lu bus recoveries (%lu left stuck)\n",
+           (unsigned long)events[TRACE_M_RETRY], (unsigned long)events[TRACE_M_RECOVER], (unsigned long)stuck);
+    if (0U != xfers)
+    {
+        printf("  transfer time (us) : min %.1f, avg %.1f, max %.1f over %lu transfers\n",
+               xferMin, xferSum / xfers, xferMax, (unsigned long)xfers);
+    }
+    printf("  slave              : %lu accesses, %lu errors; frames DONE %lu, BAD_LEN %lu, BAD_CRC %lu, "
+           "DUPLICATE %lu, other %lu\n",
+           (unsigned long)events[TRACE_S_ACCESS], (unsigned long)slaveErrors, (unsigned long)frames[STS_CMD_DONE],
+           (unsigned long)frames[STS_CMD_BAD_LEN], (unsigned long)frames[STS_CMD_BAD_CRC],
+           (unsigned long)frames[STS_CMD_DUPLICATE], (unsigned long)framesOther);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*   Usage: trace_decode [-s] [-c] dump_file
+*
+*   -s prints the summary only. -c exits non-zero if the dump is malformed,
+*   empty or holds an unknown event code.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static uint8_t dump[DUMP_HEADER_SIZE + (DUMP_MAX_RECORDS * DUMP_RECORD_SIZE) + 1U];
+    static double timeUs[DUMP_MAX_RECORDS];
+    bool summaryOnly = false;
+    bool check = false;
+    bool known = true;
+    FILE *file;
+    size_t size;
+    uint32_t records;
+    uint32_t clockHz;
+    uint32_t head;
+    uint32_t count;
+    uint32_t first;
+    uint32_t i;
+    uint64_t cycles = 0U;
+    char text[2U * STATUS_TEXT_SIZE];
+    int opt;
+
+    while ((opt = getopt(argc, argv, "sc")) != -1)
+    {
+        switch (opt)
+        {
+            case 's': summaryOnly = true; break;
+            case 'c': check       = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-s] [-c] dump_file\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc)
+    {
+        fprintf(stderr, "usage: %s [-s] [-c] dump_file\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    file = fopen(argv[optind], "rb");
+    if (NULL == file)
+    {
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+    }
+    size = fread(dump, 1U, sizeof(dump), file);
+    fclose(file);
+
+    records = (size >= DUMP_HEADER_SIZE) ? get_le(&dump[6], 2U) : 0U;
+    if ((size < DUMP_HEADER_SIZE) || (TRACE_MAGIC != get_le(&dump[0], 4U)) ||
+        (TRACE_VERSION != get_le(&dump[4], 2U)) || (0U == records) || (records > DUMP_MAX_RECORDS) ||
+        (0U != (records & (records - 1U))) || (size != (DUMP_HEADER_SIZE + (records * DUMP_RECORD_SIZE))))
+    {
+        fprintf(stderr, "%s: not a version %lu trace dump\n", argv[optind], (unsigned long)TRACE_VERSION);
+        return EXIT_FAILURE;
+    }
+    clockHz = get_le(&dump[8], 4U);
+    head    = get_le(&dump[12], 4U);
+    count   = (head < records) ? head : records;
+    first   = head - count;
+
+    /* Oldest record first; SysTick counts down and wraps at 24 bits, so
+     * records must be less than one SysTick period apart.
+     */
+    for (i = 0U; i < count; i++)
+    {
+        uint8_t const *p = &dump[DUMP_HEADER_SIZE + (((first + i) & (records - 1U)) * DUMP_RECORD_SIZE)];
+        uint32_t eventStamp  = get_le(p, 4U);
+        uint32_t statusCount = get_le(p + 4U, 4U);
+
+        entries[i].event  = eventStamp >> TRACE_EVENT_SHIFT;
+        entries[i].stamp  = eventStamp & TRACE_STAMP_MASK;
+        entries[i].status = statusCount & TRACE_STATUS_MASK;
+        entries[i].count  = statusCount >> TRACE_COUNT_SHIFT;
+        if (0U != i)
+        {
+            cycles += (entries[i - 1U].stamp - entries[i].stamp) & TRACE_STAMP_MASK;
+        }
+        timeUs[i] = (0U != clockHz) ? ((double)cycles * 1e6 / clockHz) : 0.0;
+        if ((entries[i].event >= EVENT_CODES) || (NULL == eventNames[entries[i].event]))
+        {
+            entries[i].event = 0U;
+            known = false;
+        }
+    }
+
+    printf("Trace %s: %lu records of %lu written (%lu overwritten), clock %lu Hz\n", argv[optind],
+           (unsigned long)count, (unsigned long)head, (unsigned long)first, (unsigned long)clockHz);
+    if (!summaryOnly)
+    {
+        printf("  %8s  %11s  %10s  %-10s  %s\n", "record", "time (us)", "delta (us)", "event", "status");
+        for (i = 0U; i < count; i++)
+        {
+            format_entry(text, &entries[i]);
+            printf("  %8lu  %11.2f  %10.2f  %-10s  %s\n", (unsigned long)(first + i), timeUs[i],
+                   (0U != i) ? (timeUs[i] - timeUs[i - 1U]) : 0.0,
+                   (0U != entries[i].event) ? eventNames[entries[i].event] : "?", text);
+        }
+    }
+    print_summary(entries, count, timeUs);
+
+    if (check && ((0U == count) || !known))
+    {
+        fprintf(stderr, "check failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
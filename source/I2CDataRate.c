@@ -0,0 +1,272 @@
+/******************************************************************************
+* File Name:   I2CDataRate.c
+*
+* Description: This file contains the runtime data rate switching of the I2C
+*              master and the EZI2C slave, and the probe that steps the bus
+*              down to a lower rate when it shows errors. It drives the
+*              CYBSP_I2C master and the EZI2C slave of this image.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include "I2CDataRate.h"
+#include "I2CMaster.h"
+#include "I2CSlave.h"
+#include "I2CTuning.h"
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* SCB clock ranges of one data rate class, from the SCB I2C chapter of the
+ * PDL documentation
+ */
+typedef struct
+{
+    uint32_t maxRateHz;
+    uint32_t masterClkMinHz;
+    uint32_t masterClkMaxHz;
+    uint32_t slaveClkMinHz;
+    uint32_t slaveClkMaxHz;
+} i2c_rate_class_t;
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static const i2c_rate_class_t rateClasses[] =
+{
+    { I2C_RATE_STANDARD_HZ,   1550000UL,  3200000UL,  1550000UL, 12800000UL },
+    { I2C_RATE_FAST_HZ,       7820000UL, 10000000UL,  7820000UL, 15380000UL },
+    { I2C_RATE_FAST_PLUS_HZ, 14320000UL, 25800000UL, 15840000UL, 48000000UL },
+};
+
+/* Rates tried by ProbeDataRate(), fastest first */
+static const uint32_t probeRates[] =
+{
+    I2C_RATE_FAST_PLUS_HZ,
+    I2C_RATE_FAST_HZ,
+    I2C_RATE_STANDARD_HZ
+};
+
+/* Rate the bus runs at; design.modus configures both SCBs for it */
+static uint32_t busDataRateHz = I2C_TUNING_MASTER_DATA_RATE_HZ;
+static i2c_data_rate_stats_t dataRateStats;
+
+/*******************************************************************************
+* Function Declaration
+*******************************************************************************/
+static uint32_t CountProbeErrors(void);
+
+/*******************************************************************************
+* Function Name: GetScbClockDivider
+****************************************************************************//**
+*
+* Summary:
+*   Picks the divider of HFCLK that clocks an SCB for the given data rate:
+*   the largest one whose output is still within the range of the data rate
+*   class, which keeps the oversampling of the master low.
+*
+* Parameters:
+*   dataRateHz: SCL rate in Hz
+*   master: true for the I2C master SCB, false for the EZI2C slave SCB
+*
+* Return:
+*   Divide ratio (1 or more), or 0 if the rate is above Fast-mode Plus or no
+*   integer divider of HFCLK lands in the range.
+*
+*******************************************************************************/
+uint32_t GetScbClockDivider(uint32_t dataRateHz, bool master)
+{
+    uint32_t hfClkHz = Cy_SysClk_ClkHfGetFrequency();
+    uint32_t divider = 0UL;
+    uint32_t minHz;
+    uint32_t maxHz;
+    uint32_t i;
+
+    for (i = 0UL; i < (sizeof(rateClasses) / sizeof(rateClasses[0])); i++)
+    {
+        if ((0UL != dataRateHz) && (dataRateHz <= rateClasses[i].maxRateHz))
+        {
+            minHz = master ? rateClasses[i].masterClkMinHz : rateClasses[i].slaveClkMinHz;
+            maxHz = master ? rateClasses[i].masterClkMaxHz : rateClasses[i].slaveClkMaxHz;
+            divider = hfClkHz / minHz;
+            if ((0UL == divider) || ((hfClkHz / divider) > maxHz))
+            {
+                divider = 0UL;
+            }
+            break;
+        }
+    }
+
+    return (divider);
+}
+
+/*******************************************************************************
+* Function Name: SwitchDataRate
+****************************************************************************//**
+*
+* Summary:
+*   Moves the bus to a new data rate: the clock divider of the EZI2C slave
+*   first, then the clock divider and oversampling of the master. If the
+*   master cannot run at the rate, the slave is put back to the current one.
+*   Call it with no transfer in flight.
+*
+* Parameters:
+*   dataRateHz: SCL rate in Hz, at most I2C_DATA_RATE_MAX_HZ
+*
+* Return:
+*   Data rate the master runs at, which can be slightly below the requested
+*   one, or 0 if the rate is not supported and nothing was changed.
+*
+*******************************************************************************/
+uint32_t SwitchDataRate(uint32_t dataRateHz)
+{
+    uint32_t actualHz = 0UL;
+
+    if ((dataRateHz <= I2C_DATA_RATE_MAX_HZ) && (I2C_SUCCESS == ConfigureSlaveDataRate(dataRateHz)))
+    {
+        actualHz = ConfigureMasterDataRate(&CYBSP_I2C_master, dataRateHz);
+        if (0UL != actualHz)
+        {
+            busDataRateHz = actualHz;
+            dataRateStats.switches++;
+        }
+        else
+        {
+            (void)ConfigureSlaveDataRate(busDataRateHz);
+        }
+    }
+
+    return (actualHz);
+}
+
+/*******************************************************************************
+* Function Name: CountProbeErrors
+****************************************************************************//**
+*
+* Summary:
+*   Reads the telemetry window of the slave DATA_RATE_PROBE_READS times and
+*   counts the errors: every failed attempt, including those that went
+*   through on a retry, and every read whose sequence bytes disagree.
+*
+*******************************************************************************/
+static uint32_t CountProbeErrors(void)
+{
+    uint8_t tlm[TLM_SIZE];
+    uint32_t failures = GetRecoveryStats(&CYBSP_I2C_master)->failures;
+    uint32_t errors = 0UL;
+    uint32_t i;
+
+    for (i = 0UL; i < DATA_RATE_PROBE_READS; i++)
+    {
+        if ((READ_CMPLT == ReadTelemetryFromEzI2C(&CYBSP_I2C_master, (uint8_t)TLM_SEQ_POS, tlm, TLM_SIZE)) &&
+            (tlm[TLM_SEQ_POS] != tlm[TLM_SEQ_END_POS]))
+        {
+            errors++;
+        }
+    }
+
+    return (errors + (GetRecoveryStats(&CYBSP_I2C_master)->failures - failures));
+}
+
+/*******************************************************************************
+* Function Name: ProbeDataRate
+****************************************************************************//**
+*
+* Summary:
+*   Finds the fastest data rate the bus runs at without errors. Starting at
+*   maxRateHz, each rate is switched to and probed with reads of the slave;
+*   when the errors exceed DATA_RATE_MAX_ERRORS the next lower rate is
+*   tried. Call it at startup to go as fast as the bus allows, and after a
+*   transfer failed to step down instead of failing again.
+*
+* Parameters:
+*   maxRateHz: Fastest rate to try, for example GetDataRate() to keep the
+*              bus at or below the current rate
+*
+* Return:
+*   Data rate the bus runs at, or 0 if even the lowest rate failed the probe
+*   (the bus is left at that rate).
+*
+*******************************************************************************/
+uint32_t ProbeDataRate(uint32_t maxRateHz)
+{
+    uint32_t i;
+
+    for (i = 0UL; i < (sizeof(probeRates) / sizeof(probeRates[0])); i++)
+    {
+        if ((probeRates[i] <= maxRateHz) && (0UL != SwitchDataRate(probeRates[i])))
+        {
+            dataRateStats.probes++;
+            dataRateStats.lastErrors = CountProbeErrors();
+            if (dataRateStats.lastErrors <= DATA_RATE_MAX_ERRORS)
+            {
+                return (busDataRateHz);
+            }
+            dataRateStats.fallbacks++;
+        }
+    }
+
+    return (0UL);
+}
+
+/*******************************************************************************
+* Function Name: GetDataRate
+****************************************************************************//**
+*
+* Summary:
+*   Returns the data rate the bus runs at.
+*
+*******************************************************************************/
+uint32_t GetDataRate(void)
+{
+    return (busDataRateHz);
+}
+
+/*******************************************************************************
+* Function Name: GetDataRateStats
+****************************************************************************//**
+*
+* Summary:
+*   Returns the rate switching and probe counters.
+*
+*******************************************************************************/
+i2c_data_rate_stats_t const* GetDataRateStats(void)
+{
+    return (&dataRateStats);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,92 @@
+/******************************************************************************
+* File Name:   I2CDataRate.h
+*
+* Description: This file provides the constants and prototypes of the
+*              runtime data rate switching and probing.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SOURCE_I2CDATARATE_H_
+#define SOURCE_I2CDATARATE_H_
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CTuning.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* I2C bus speeds */
+#define I2C_RATE_STANDARD_HZ    (100000UL)
+#define I2C_RATE_FAST_HZ        (400000UL)
+#define I2C_RATE_FAST_PLUS_HZ   (1000000UL)
+
+/* Fastest rate ProbeDataRate() tries: the fastest rate of the part, from the
+ * i2c_tuning.h of the target. Set I2C_DATA_RATE_MAX_HZ=400000 in DEFINES for
+ * a board whose bus is too long for Fast-mode Plus.
+ */
+#ifndef I2C_DATA_RATE_MAX_HZ
+#define I2C_DATA_RATE_MAX_HZ    (I2C_TUNING_MAX_DATA_RATE_HZ)
+#endif
+
+/* Probe: reads at each rate, and the bus faults (including those recovered
+ * by a retry) tolerated before falling back to the next lower rate
+ */
+#define DATA_RATE_PROBE_READS   (16UL)
+#define DATA_RATE_MAX_ERRORS    (1UL)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t switches;      /* Successful rate changes */
+    uint32_t probes;        /* Rates probed */
+    uint32_t fallbacks;     /* Rates given up for too many errors */
+    uint32_t lastErrors;    /* Errors seen by the last probe */
+} i2c_data_rate_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint32_t GetScbClockDivider(uint32_t dataRateHz, bool master);
+uint32_t SwitchDataRate(uint32_t dataRateHz);
+uint32_t ProbeDataRate(uint32_t maxRateHz);
+uint32_t GetDataRate(void);
+i2c_data_rate_stats_t const* GetDataRateStats(void);
+
+#endif /* SOURCE_I2CDATARATE_H_ */
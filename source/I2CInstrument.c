@@ -0,0 +1,160 @@
+/******************************************************************************
+* File Name:   I2CInstrument.c
+*
+* Description: This file contains the transfer latency instrumentation. Each
+*              measured interval is added to a log2-bucket histogram in RAM,
+*              and the slave exports the histograms in its telemetry window.
+*              The file is empty unless I2C_INSTRUMENT is set.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include "I2CInstrument.h"
+
+#if I2C_INSTRUMENT
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* SysTick is a 24-bit down counter, started by initMaster() */
+#define SYSTICK_COUNT_MASK      (0xFFFFFFUL)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Updated from both ISRs and the application. The counters are not
+ * protected: an update that races another one on the same counter loses a
+ * sample, which is acceptable for statistics.
+ */
+static volatile uint16_t instrHist[INSTR_HIST_COUNT][INSTR_BUCKETS];
+
+/*******************************************************************************
+* Function Name: RecordInstrInterval
+****************************************************************************//**
+*
+* Summary:
+*   Adds the interval between two SysTick stamps to a histogram. Intervals
+*   longer than one SysTick period (about 350 ms at 48 MHz) wrap.
+*
+* Parameters:
+*   hist: INSTR_H_* histogram
+*   from: SysTick value at the start of the interval
+*   to: SysTick value at the end of the interval
+*
+*******************************************************************************/
+void RecordInstrInterval(uint32_t hist, uint32_t from, uint32_t to)
+{
+    /* SysTick counts down */
+    uint32_t value = ((from - to) & SYSTICK_COUNT_MASK) >> INSTR_BUCKET_SHIFT;
+    uint32_t bucket = 0UL;
+
+    while ((value > 1UL) && (bucket < (INSTR_BUCKETS - 1UL)))
+    {
+        value >>= 1U;
+        bucket++;
+    }
+
+    if (instrHist[hist][bucket] < INSTR_COUNTER_MAX)
+    {
+        instrHist[hist][bucket]++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: ExportInstrHistograms
+****************************************************************************//**
+*
+* Summary:
+*   Copies the histograms to INSTR_EXPORT_SIZE bytes at dst, 16-bit
+*   little-endian counters in INSTR_H_* order.
+*
+*******************************************************************************/
+void ExportInstrHistograms(uint8_t* dst)
+{
+    uint32_t h;
+    uint32_t b;
+    uint16_t count;
+
+    for (h = 0UL; h < INSTR_HIST_COUNT; h++)
+    {
+        for (b = 0UL; b < INSTR_BUCKETS; b++)
+        {
+            count  = instrHist[h][b];
+            *dst++ = (uint8_t)count;
+            *dst++ = (uint8_t)(count >> 8U);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: GetInstrHistogram
+****************************************************************************//**
+*
+* Summary:
+*   Returns the INSTR_BUCKETS counters of a histogram.
+*
+*******************************************************************************/
+uint16_t const* GetInstrHistogram(uint32_t hist)
+{
+    return ((uint16_t const*)instrHist[hist]);
+}
+
+/*******************************************************************************
+* Function Name: ClearInstrHistograms
+****************************************************************************//**
+*
+* Summary:
+*   Resets all histograms.
+*
+*******************************************************************************/
+void ClearInstrHistograms(void)
+{
+    uint32_t h;
+    uint32_t b;
+
+    for (h = 0UL; h < INSTR_HIST_COUNT; h++)
+    {
+        for (b = 0UL; b < INSTR_BUCKETS; b++)
+        {
+            instrHist[h][b] = 0U;
+        }
+    }
+}
+
+#endif /* I2C_INSTRUMENT */
+
+/* [] END OF FILE */
@@ -0,0 +1,109 @@
+/******************************************************************************
+* File Name:   I2CInstrument.h
+*
+* Description: This file provides the compile-time switch, macros and
+*              prototypes of the transfer latency instrumentation.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SOURCE_I2CINSTRUMENT_H_
+#define SOURCE_I2CINSTRUMENT_H_
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Set I2C_INSTRUMENT=1 in DEFINES to build the instrumentation in. Without it
+ * the INSTR_* macros expand to nothing and no code or RAM is used.
+ */
+#ifndef I2C_INSTRUMENT
+#define I2C_INSTRUMENT          (0)
+#endif
+
+/* Histograms. Intervals are measured in CPU cycles with SysTick. */
+#define INSTR_H_MASTER_WIRE     (0UL)   /* First MasterWrite to completion seen */
+#define INSTR_H_MASTER_REPLY    (1UL)   /* Completion seen to reply validated */
+#define INSTR_H_MASTER_ISR      (2UL)   /* MasterInterrupt entry to exit */
+#define INSTR_H_SLAVE_ISR       (3UL)   /* SEzI2C_InterruptHandler entry to exit */
+#define INSTR_HIST_COUNT        (4UL)
+
+/* Bucket 0 counts intervals below 2^(INSTR_BUCKET_SHIFT + 1) cycles, bucket
+ * k counts [2^(k + INSTR_BUCKET_SHIFT), 2^(k + INSTR_BUCKET_SHIFT + 1)) and
+ * the last bucket everything longer. Counters are 16-bit and saturate.
+ */
+#define INSTR_BUCKETS           (16UL)
+#define INSTR_BUCKET_SHIFT      (5UL)
+#define INSTR_COUNTER_MAX       (0xFFFFUL)
+
+/* Bytes of the histograms in the telemetry window: 16-bit little-endian
+ * counters, histogram after histogram.
+ */
+#if I2C_INSTRUMENT
+#define INSTR_EXPORT_SIZE       (INSTR_HIST_COUNT * INSTR_BUCKETS * 2UL)
+#else
+#define INSTR_EXPORT_SIZE       (0UL)
+#endif
+
+#if I2C_INSTRUMENT
+/* Local timestamp taken on declaration */
+#define INSTR_ENTER(name)       uint32_t const name = Cy_SysTick_GetValue()
+#define INSTR_STAMP(name)       ((name) = Cy_SysTick_GetValue())
+/* Adds the time from the stamp to now, or between two stamps */
+#define INSTR_SINCE(hist, name) RecordInstrInterval((hist), (name), Cy_SysTick_GetValue())
+#define INSTR_SPAN(hist, from, to) RecordInstrInterval((hist), (from), (to))
+#define INSTR_EXPORT(dst)       ExportInstrHistograms(dst)
+#else
+#define INSTR_ENTER(name)
+#define INSTR_STAMP(name)       ((void)0)
+#define INSTR_SINCE(hist, name) ((void)0)
+#define INSTR_SPAN(hist, from, to) ((void)0)
+#define INSTR_EXPORT(dst)       ((void)0)
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#if I2C_INSTRUMENT
+void RecordInstrInterval(uint32_t hist, uint32_t from, uint32_t to);
+void ExportInstrHistograms(uint8_t* dst);
+uint16_t const* GetInstrHistogram(uint32_t hist);
+void ClearInstrHistograms(void);
+#endif
+
+#endif /* SOURCE_I2CINSTRUMENT_H_ */
@@ -42,6 +42,11 @@
 
 /* Header file includes */
 #include "I2CMaster.h"
+#include "I2CDataRate.h"
+#include "I2CInstrument.h"
+#include "I2CTime.h"
+#include "I2CTrace.h"
+#include "I2CTuning.h"
 
 /*******************************************************************************
 * Macros
@@ -50,237 +55,1945 @@
 #define I2C_INTR_NUM        CYBSP_I2C_IRQ
 #define I2C_INTR_PRIORITY   (3UL)
 
-/* I2C slave address to communicate with */
-#define I2C_SLAVE_ADDR      (0x08)
+/* I2C slave address to communicate with out of reset */
+#define I2C_SLAVE_ADDR      (I2C_TUNING_SLAVE_ADDR)
+/* Second EZI2C address, the read-only telemetry window, relative to the first */
+#define TELEMETRY_ADDR_OFS  (I2C_TUNING_TELEMETRY_ADDR - I2C_TUNING_SLAVE_ADDR)
 
 /* Buffer and packet size */
-#define READ_PACKET_SIZE    (0x08UL)
-#define PACKET_SIZE         (3UL)
-#define RX_PACKET_SIZE      (3UL)
-#define BUFFER_SIZE         (PACKET_SIZE)
+#define RX_PACKET_SIZE      (PROTO_SIZE(proto_reply_t))
+/* Status packet and the command result behind it, read in one access */
+#define RESULT_PACKET_SIZE  (RX_PACKET_SIZE + PROTO_SIZE(proto_result_t))
 
-/* Command valid status */
-#define STS_CMD_DONE        (0x00UL)
-#define STS_CMD_FAIL        (0xFFUL)
+/* Timeout */
+#define LOOP_FOREVER        (0UL)
+
+/* Master data rate out of reset (DataRate in design.modus) */
+#define I2C_DATA_RATE_HZ    (I2C_TUNING_MASTER_DATA_RATE_HZ)
+
+/* Transfer timeout budget: the wire time of the transaction times
+ * TIMEOUT_WIRE_FACTOR, plus TIMEOUT_STRETCH_US per byte for the slave to
+ * stretch SCL while its ISR runs, plus TIMEOUT_MARGIN_US for interrupt
+ * latency. A byte is 8 data bits and ACK; each phase adds START (or
+ * repeated START) and STOP.
+ */
+#define TIMEOUT_WIRE_FACTOR (2UL)
+#define TIMEOUT_STRETCH_US  (20UL)
+#define TIMEOUT_MARGIN_US   (200UL)
+#define BITS_PER_BYTE       (9UL)
+#define BITS_PER_PHASE      (2UL)
+#define US_PER_SEC          (1000000UL)
+
+/* Ring tail published by the slave, read together with the reply packet */
+#define RING_STATUS_SIZE    (1UL + RX_PACKET_SIZE)
+
+/* Stream chunks are resent after this many status reads without progress */
+#define STREAM_STALL_READS  (2UL)
+
+/* Combine master error statuses in single mask  */
+#define MASTER_ERROR_MASK   (CY_SCB_I2C_MASTER_DATA_NAK | CY_SCB_I2C_MASTER_ADDR_NAK   | \
+                            CY_SCB_I2C_MASTER_ARB_LOST | CY_SCB_I2C_MASTER_ABORT_START | \
+                            CY_SCB_I2C_MASTER_BUS_ERR)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Master on the CYBSP_I2C SCB and its RX buffer */
+i2c_master_t CYBSP_I2C_master;
+static uint8_t masterRxBuffer[MASTER_RX_SIZE];
+
+static const i2c_master_hw_t CYBSP_I2C_master_hw =
+{
+    /*.base =*/ CYBSP_I2C_HW,
+    /*.config =*/ &CYBSP_I2C_config,
+    /*.irq =*/ CYBSP_I2C_IRQ,
+    /*.isr =*/ &CYBSP_I2C_Interrupt,
+    /*.clkDivType =*/ CYBSP_I2C_CLK_DIV_HW,
+    /*.clkDivNum =*/ CYBSP_I2C_CLK_DIV_NUM,
+    /*.pins =*/
+    {
+        CYBSP_I2C_SCL_PORT, CYBSP_I2C_SCL_NUM, CYBSP_I2C_SCL_HSIOM,
+        CYBSP_I2C_SDA_PORT, CYBSP_I2C_SDA_NUM, CYBSP_I2C_SDA_HSIOM
+    }
+};
+
+/* Handle of the master whose interrupt is being serviced. The PDL event
+ * callback has no context argument, so MasterInterrupt() sets it around the
+ * driver call; a nested interrupt of another master restores it on return.
+ */
+static i2c_master_t* isrMaster = NULL;
+
+/*******************************************************************************
+* Function Declaration
+*******************************************************************************/
+static void MasterEventCallback(uint32_t events);
+static void CompleteMasterTransfer(i2c_master_t* master, uint8_t status);
+static cy_en_scb_i2c_status_t StartMasterTransfer(i2c_master_t* master, uint8_t* buffer, uint32_t size,
+                                                  bool read, bool pending);
+static uint8_t StartEzI2CRead(i2c_master_t* master, uint8_t slaveAddress, uint8_t offset,
+                              uint8_t* readbuffer, uint32_t size,
+                              uint8_t const* reply, i2c_master_callback_t callback);
+static uint8_t CheckStatusPacket(uint8_t const* reply, uint8_t seq);
+static void ExpectStatusOf(i2c_master_t* master, uint8_t const* writebuffer, uint32_t bufferSize);
+static uint8_t StartEzI2CWrite(i2c_master_t* master, uint8_t* writebuffer, uint32_t bufferSize,
+                               i2c_master_callback_t callback);
+static uint32_t TransferTimeoutUs(i2c_master_t const* master, uint32_t bytes, uint32_t phases);
+static bool RetryMasterTransfer(i2c_master_t* master, uint32_t* attempt, bool idempotent);
+static uint8_t WriteEzI2C(i2c_master_t* master, uint8_t* writebuffer, uint32_t bufferSize, bool idempotent);
+static uint8_t WriteRingSlots(i2c_master_t* master, uint8_t const* commands, uint32_t count);
+static uint8_t WriteStreamOpen(i2c_master_t* master);
+static uint8_t WriteStreamChunks(i2c_master_t* master, uint32_t count);
+
+/*******************************************************************************
+* Function Name: MasterInterrupt
+****************************************************************************//**
+*
+* Summary:
+*   Invokes the Cy_SCB_I2C_MasterInterrupt() PDL driver function for the SCB
+*   of a handle. Call it from the interrupt handler of that SCB.
+*
+* Parameters:
+*   master: Master handle
+*
+*******************************************************************************/
+void MasterInterrupt(i2c_master_t* master)
+{
+    i2c_master_t* outer = isrMaster;
+    INSTR_ENTER(instrIsrEntry);
+
+    isrMaster = master;
+    Cy_SCB_I2C_MasterInterrupt(master->hw->base, &master->context);
+    isrMaster = outer;
+    INSTR_SINCE(INSTR_H_MASTER_ISR, instrIsrEntry);
+}
+
+/*******************************************************************************
+* Function Name: CYBSP_I2C_Interrupt
+****************************************************************************//**
+*
+* Summary:
+*   Interrupt handler of the CYBSP_I2C SCB.
+*
+*******************************************************************************/
+void CYBSP_I2C_Interrupt(void)
+{
+    MasterInterrupt(&CYBSP_I2C_master);
+}
+
+/*******************************************************************************
+* Function Name: CompleteMasterTransfer
+****************************************************************************//**
+*
+* Summary:
+*   Publishes the result of the transfer in flight and notifies its owner.
+*
+* Parameters:
+*   master: Master handle
+*   status: TRANSFER_CMPLT, TRANSFER_STS_FAIL or TRANSFER_ERROR
+*
+*******************************************************************************/
+static void CompleteMasterTransfer(i2c_master_t* master, uint8_t status)
+{
+    i2c_master_callback_t callback = master->xferCallback;
+
+    master->xferCallback = NULL;
+    master->xferChained  = false;
+    master->xferStatus   = status;
+    TRACE_EVENT(TRACE_M_DONE, status, 0UL);
+
+    if (NULL != callback)
+    {
+        callback(status);
+    }
+}
+
+/*******************************************************************************
+* Function Name: StartMasterTransfer
+****************************************************************************//**
+*
+* Summary:
+*   Programs master->xferConfig and initiates a read or write transaction.
+*
+* Parameters:
+*   master: Master handle
+*   buffer: Data to write or storage for the data read
+*   size: Number of bytes to transfer
+*   read: true for a read transaction
+*   pending: true to keep the bus (no STOP) so the next transfer starts with
+*            a repeated START
+*
+* Return:
+*   Status of the transfer initiation.
+*
+*******************************************************************************/
+static cy_en_scb_i2c_status_t StartMasterTransfer(i2c_master_t* master, uint8_t* buffer, uint32_t size,
+                                                  bool read, bool pending)
+{
+    /* Setup transfer specific parameters */
+    master->xferConfig.buffer      = buffer;
+    master->xferConfig.bufferSize  = size;
+    master->xferConfig.xferPending = pending;
+    master->xferSize = size;
+    TRACE_EVENT(read ? TRACE_M_READ : TRACE_M_WRITE, master->xferConfig.slaveAddress, size);
+    RECORD_START(&master->record, read);
+
+    /* Initiate read or write transaction */
+    return (read ? Cy_SCB_I2C_MasterRead(master->hw->base, &master->xferConfig, &master->context) :
+                   Cy_SCB_I2C_MasterWrite(master->hw->base, &master->xferConfig, &master->context));
+}
+
+/*******************************************************************************
+* Function Name: TransferTimeoutUs
+****************************************************************************//**
+*
+* Summary:
+*   Computes the timeout budget of a transaction from the master data rate,
+*   the number of bytes on the wire and the clock-stretch allowance.
+*
+* Parameters:
+*   master: Master handle
+*   bytes: Data bytes of all phases
+*   phases: Number of START/repeated START phases, one address byte each
+*
+* Return:
+*   Timeout in microseconds.
+*
+*******************************************************************************/
+static uint32_t TransferTimeoutUs(i2c_master_t const* master, uint32_t bytes, uint32_t phases)
+{
+    uint64_t bits = ((uint64_t)(bytes + phases) * BITS_PER_BYTE) + ((uint64_t)phases * BITS_PER_PHASE);
+    uint32_t wireUs = (uint32_t)(((bits * US_PER_SEC) + master->dataRateHz - 1UL) / master->dataRateHz);
+
+    return ((wireUs * TIMEOUT_WIRE_FACTOR) + ((bytes + phases) * TIMEOUT_STRETCH_US) + TIMEOUT_MARGIN_US);
+}
+
+/*******************************************************************************
+* Function Name: CheckStatusPacket
+****************************************************************************//**
+*
+* Summary:
+*   Checks the status packet structure, the frame it names and the status
+*   it reports.
+*
+* Parameters:
+*   reply: Start of the reply region (status packet SOP)
+*   seq: Sequence number of the frame the packet must acknowledge
+*
+* Return:
+*   TRANSFER_CMPLT if the packet acknowledges the frame with STS_CMD_DONE,
+*   or STS_CMD_DUPLICATE: a resent frame the slave had already executed.
+*   TRANSFER_STS_FAIL if the slave rejected the frame.
+*   TRANSFER_STS_STALE if the packet names another frame.
+*   TRANSFER_ERROR if the packet is malformed.
+*
+*******************************************************************************/
+static uint8_t CheckStatusPacket(uint8_t const* reply, uint8_t seq)
+{
+    uint32_t status = PROTO_GET(proto_reply_t, sts, reply);
+
+    if (PACKET_SOP != PROTO_GET(proto_reply_t, sop, reply))
+    {
+        return (TRANSFER_ERROR);
+    }
+    if (seq != PROTO_GET(proto_reply_t, seq, reply))
+    {
+        return (TRANSFER_STS_STALE);
+    }
+
+    return (((STS_CMD_DONE == status) || (STS_CMD_DUPLICATE == status)) ? TRANSFER_CMPLT : TRANSFER_STS_FAIL);
+}
+
+/*******************************************************************************
+* Function Name: ExpectStatusOf
+****************************************************************************//**
+*
+* Summary:
+*   Makes the command packet about to be written the frame the following
+*   status packets must acknowledge, and marks it not acknowledged yet.
+*
+* Parameters:
+*   master: Master handle
+*   writebuffer: Command packet, see PrepareOpcodePacket()
+*   bufferSize: Size of the packet; a write too short to hold a frame
+*               header leaves the expected frame as it is
+*
+*******************************************************************************/
+static void ExpectStatusOf(i2c_master_t* master, uint8_t const* writebuffer, uint32_t bufferSize)
+{
+    if (bufferSize > PACKET_SEQ_POS)
+    {
+        master->ackSeq     = writebuffer[PACKET_SEQ_POS];
+        master->ackPending = true;
+    }
+}
+
+/*******************************************************************************
+* Function Name: MasterEventCallback
+****************************************************************************//**
+*
+* Summary:
+*   Master event handler registered with Cy_SCB_I2C_RegisterEventCallback().
+*   Runs from MasterInterrupt() when a transfer ends, checks the transfer
+*   and, for a status read, the status packet. The read chained to a
+*   sub-address write, and the command write of a status + command
+*   transaction, are issued right after the phase before, so they go out
+*   with a repeated START instead of STOP + START.
+*
+* Parameters:
+*   events: CY_SCB_I2C_MASTER_*_EVENT flags reported by the driver
+*
+*******************************************************************************/
+static void MasterEventCallback(uint32_t events)
+{
+    INSTR_ENTER(instrSeen);
+    i2c_master_t* master = isrMaster;
+    uint8_t status = TRANSFER_ERROR;
+
+    TRACE_EVENT(((0UL != (events & CY_SCB_I2C_MASTER_ERR_EVENT))      ? TRACE_M_ERR :
+                 (0UL != (events & CY_SCB_I2C_MASTER_WR_CMPLT_EVENT)) ? TRACE_M_WR_CMPLT : TRACE_M_RD_CMPLT),
+                Cy_SCB_I2C_MasterGetStatus(master->hw->base, &master->context),
+                Cy_SCB_I2C_MasterGetTransferCount(master->hw->base, &master->context));
+
+    /* Log the phase before a chained one reuses the transfer configuration */
+    if (0UL != (events & (CY_SCB_I2C_MASTER_ERR_EVENT | CY_SCB_I2C_MASTER_WR_CMPLT_EVENT |
+                          CY_SCB_I2C_MASTER_RD_CMPLT_EVENT)))
+    {
+        RECORD_END(&master->record, &master->xferConfig, 0UL,
+                   Cy_SCB_I2C_MasterGetStatus(master->hw->base, &master->context),
+                   Cy_SCB_I2C_MasterGetTransferCount(master->hw->base, &master->context));
+    }
+
+    if (0UL != (events & CY_SCB_I2C_MASTER_ERR_EVENT))
+    {
+        /* NAK, arbitration lost or bus error: status stays TRANSFER_ERROR,
+         * the cause is kept for the recovery.
+         */
+        master->xferFault = Cy_SCB_I2C_MasterGetStatus(master->hw->base, &master->context) & MASTER_ERROR_MASK;
+    }
+    else if (0UL != (events & CY_SCB_I2C_MASTER_WR_CMPLT_EVENT))
+    {
+        if (master->xferSize == Cy_SCB_I2C_MasterGetTransferCount(master->hw->base, &master->context))
+        {
+            if (!master->xferChained)
+            {
+                status = TRANSFER_CMPLT;
+                if (master->xferCombined)
+                {
+                    /* Last phase of a status + command transaction */
+                    status = master->commandAck;
+                    if (TRANSFER_CMPLT == status)
+                    {
+                        ExpectStatusOf(master, master->commandBuffer, master->commandSize);
+                    }
+                }
+            }
+            else if (CY_SCB_I2C_SUCCESS == StartMasterTransfer(master, master->chainBuffer, master->chainSize,
+                                                               true, master->xferCombined))
+            {
+                /* Read is on the bus, completion follows on RD_CMPLT */
+                master->xferChained = false;
+                return;
+            }
+            else
+            {
+                /* Bus is still held from the write: release it */
+                Cy_SCB_I2C_Disable(master->hw->base, &master->context);
+                Cy_SCB_I2C_Enable(master->hw->base, &master->context);
+            }
+        }
+    }
+    else if (0UL != (events & CY_SCB_I2C_MASTER_RD_CMPLT_EVENT))
+    {
+        if (master->xferSize != Cy_SCB_I2C_MasterGetTransferCount(master->hw->base, &master->context))
+        {
+            /* Short read: status stays READ_ERROR */
+        }
+        else if (NULL == master->xferReply)
+        {
+            status = READ_CMPLT;
+        }
+        else
+        {
+            status = CheckStatusPacket(master->xferReply, master->ackSeq);
+            if (READ_CMPLT == status)
+            {
+                master->ackPending = false;
+                INSTR_SINCE(INSTR_H_MASTER_REPLY, instrSeen);
+            }
+
+            if (master->xferCombined)
+            {
+                /* Write the command only once the frame before is
+                 * acknowledged; otherwise write its sub-address alone, which
+                 * leaves the command buffer as it is, to end the transaction
+                 * with a STOP.
+                 */
+                master->commandAck = status;
+                if (CY_SCB_I2C_SUCCESS == StartMasterTransfer(master, master->commandBuffer,
+                                                              (READ_CMPLT == status) ? master->commandSize : 1UL,
+                                                              false, false))
+                {
+                    return;
+                }
+                status = TRANSFER_ERROR;
+                Cy_SCB_I2C_Disable(master->hw->base, &master->context);
+                Cy_SCB_I2C_Enable(master->hw->base, &master->context);
+            }
+        }
+    }
+    else
+    {
+        /* Not a completion event */
+        return;
+    }
+
+    INSTR_SPAN(INSTR_H_MASTER_WIRE, master->instrXferStart, instrSeen);
+    CompleteMasterTransfer(master, status);
+}
+
+/*******************************************************************************
+* Function Name: WritePacketToEzI2CAsync
+****************************************************************************//**
+*
+* Summary:
+*   Starts sending a command packet to the EzI2C slave and returns without
+*   waiting for the bus. Completion is reported from the I2C master ISR
+*   through the callback and through GetMasterTransferStatus(). The status
+*   packets read after it must acknowledge the frame of the packet.
+*
+* Parameters:
+*   master: Master handle
+*   writebuffer: Command packet buffer pointer, must stay valid until the
+*                transfer completes
+*   bufferSize: Size of the packet buffer
+*   callback: Called on completion, can be NULL
+*
+* Return:
+*   TRANSFER_PENDING if the transfer was started.
+*   TRANSFER_ERROR if the master is busy or the transfer could not start.
+*
+*******************************************************************************/
+uint8_t WritePacketToEzI2CAsync(i2c_master_t* master, uint8_t* writebuffer, uint32_t bufferSize,
+                                i2c_master_callback_t callback)
+{
+    if (TRANSFER_PENDING == master->xferStatus)
+    {
+        return (TRANSFER_ERROR);
+    }
+
+    ExpectStatusOf(master, writebuffer, bufferSize);
+    return (StartEzI2CWrite(master, writebuffer, bufferSize, callback));
+}
+
+/*******************************************************************************
+* Function Name: StartEzI2CWrite
+****************************************************************************//**
+*
+* Summary:
+*   Starts writing a buffer to the EzI2C slave: a command packet, ring slots
+*   or stream chunks. Completion is reported from the I2C master ISR.
+*
+* Parameters:
+*   master: Master handle
+*   writebuffer: EZI2C sub-address followed by the data, must stay valid
+*                until the transfer completes
+*   bufferSize: Size of the buffer
+*   callback: Called on completion, can be NULL
+*
+* Return:
+*   TRANSFER_PENDING if the transfer was started.
+*   TRANSFER_ERROR if the master is busy or the transfer could not start.
+*
+*******************************************************************************/
+static uint8_t StartEzI2CWrite(i2c_master_t* master, uint8_t* writebuffer, uint32_t bufferSize,
+                               i2c_master_callback_t callback)
+{
+    if (TRANSFER_PENDING == master->xferStatus)
+    {
+        return (TRANSFER_ERROR);
+    }
+
+    master->xferConfig.slaveAddress = master->slaveAddress;
+    master->xferCallback  = callback;
+    master->xferChained   = false;
+    master->xferCombined  = false;
+    master->xferTimeoutUs = TransferTimeoutUs(master, bufferSize, 1UL);
+    master->xferFault     = 0UL;
+    master->xferStatus    = TRANSFER_PENDING;
+
+    INSTR_STAMP(master->instrXferStart);
+    if (CY_SCB_I2C_SUCCESS != StartMasterTransfer(master, writebuffer, bufferSize, false, false))
+    {
+        master->xferCallback = NULL;
+        master->xferStatus   = TRANSFER_ERROR;
+    }
+
+    return (master->xferStatus);
+}
+
+/*******************************************************************************
+* Function Name: StartEzI2CRead
+****************************************************************************//**
+*
+* Summary:
+*   Starts an offset read: the EZI2C sub-address is written without a STOP and
+*   the data is read after a repeated START, in one bus transaction.
+*
+* Parameters:
+*   master: Master handle
+*   slaveAddress: EZI2C address to read from
+*   offset: EZI2C sub-address of the first byte to read
+*   readbuffer: Storage for the data read
+*   size: Number of bytes to read
+*   reply: Status packet to check on completion, NULL for a plain read
+*   callback: Called on completion, can be NULL
+*
+* Return:
+*   TRANSFER_PENDING if the transfer was started.
+*   TRANSFER_ERROR if the master is busy or the transfer could not start.
+*
+*******************************************************************************/
+static uint8_t StartEzI2CRead(i2c_master_t* master, uint8_t slaveAddress, uint8_t offset,
+                              uint8_t* readbuffer, uint32_t size,
+                              uint8_t const* reply, i2c_master_callback_t callback)
+{
+    if (TRANSFER_PENDING == master->xferStatus)
+    {
+        return (TRANSFER_ERROR);
+    }
+
+    master->xferConfig.slaveAddress = slaveAddress;
+    master->subAddress    = offset;
+    master->chainBuffer   = readbuffer;
+    master->chainSize     = size;
+    master->xferReply     = reply;
+    master->xferCallback  = callback;
+    master->xferChained   = true;
+    master->xferCombined  = false;
+    master->xferTimeoutUs = TransferTimeoutUs(master, sizeof(master->subAddress) + size, 2UL);
+    master->xferFault     = 0UL;
+    master->xferStatus    = TRANSFER_PENDING;
+
+    INSTR_STAMP(master->instrXferStart);
+    if (CY_SCB_I2C_SUCCESS != StartMasterTransfer(master, &master->subAddress, sizeof(master->subAddress), false, true))
+    {
+        master->xferCallback = NULL;
+        master->xferChained  = false;
+        master->xferStatus   = TRANSFER_ERROR;
+    }
+
+    return (master->xferStatus);
+}
+
+/*******************************************************************************
+* Function Name: ReadEzI2CAsync
+****************************************************************************//**
+*
+* Summary:
+*   Starts reading size bytes from the EzI2C buffer at the given offset and
+*   returns without waiting for the bus. Only the requested bytes are
+*   clocked. Completion is reported through the callback and
+*   GetMasterTransferStatus().
+*
+* Parameters:
+*   master: Master handle
+*   offset: EZI2C sub-address of the first byte to read
+*   readbuffer: Storage for the data read, must stay valid until the
+*               transfer completes
+*   size: Number of bytes to read
+*   callback: Called on completion, can be NULL
+*
+* Return:
+*   TRANSFER_PENDING if the transfer was started.
+*   TRANSFER_ERROR if the master is busy or the transfer could not start.
+*
+*******************************************************************************/
+uint8_t ReadEzI2CAsync(i2c_master_t* master, uint8_t offset, uint8_t* readbuffer, uint32_t size,
+                       i2c_master_callback_t callback)
+{
+    return (StartEzI2CRead(master, master->slaveAddress, offset, readbuffer, size, NULL, callback));
+}
+
+/*******************************************************************************
+* Function Name: ReadTelemetryFromEzI2CAsync
+****************************************************************************//**
+*
+* Summary:
+*   Starts reading size bytes at the given offset of the read-only telemetry
+*   window at the second EZI2C address. The command buffer is not touched.
+*   Completion is reported through the callback and GetMasterTransferStatus().
+*
+* Parameters:
+*   master: Master handle
+*   offset: Offset in the telemetry window (TLM_*_POS)
+*   readbuffer: Storage for the data read, must stay valid until the
+*               transfer completes
+*   size: Number of bytes to read
+*   callback: Called on completion, can be NULL
+*
+* Return:
+*   TRANSFER_PENDING if the transfer was started.
+*   TRANSFER_ERROR if the master is busy or the transfer could not start.
+*
+*******************************************************************************/
+uint8_t ReadTelemetryFromEzI2CAsync(i2c_master_t* master, uint8_t offset, uint8_t* readbuffer, uint32_t size,
+                                    i2c_master_callback_t callback)
+{
+    return (StartEzI2CRead(master, (uint8_t)(master->slaveAddress + TELEMETRY_ADDR_OFS), offset, readbuffer, size, NULL,
+                           callback));
+}
+
+/*******************************************************************************
+* Function Name: ReadStatusPacketFromEzI2CAsync
+****************************************************************************//**
+*
+* Summary:
+*   Starts reading the status packet from the reply region of the EzI2C buffer
+*   and returns without waiting for the bus. Only the status packet is read.
+*   The packet is checked in the I2C master ISR against the last command
+*   written and the result is reported through the callback and
+*   GetMasterTransferStatus().
+*
+* Parameters:
+*   master: Master handle
+*   callback: Called on completion, can be NULL
+*
+* Return:
+*   TRANSFER_PENDING if the transfer was started.
+*   TRANSFER_ERROR if the master is busy or the transfer could not start.
+*
+*******************************************************************************/
+uint8_t ReadStatusPacketFromEzI2CAsync(i2c_master_t* master, i2c_master_callback_t callback)
+{
+    uint8_t* reply = &master->rxBuffer[MASTER_RX_POS(EZI2C_RPLY_SOP_POS)];
+
+    return (StartEzI2CRead(master, master->slaveAddress, (uint8_t)EZI2C_RPLY_SOP_POS,
+                           reply, RX_PACKET_SIZE, reply, callback));
+}
+
+/*******************************************************************************
+* Function Name: WriteCommandReadStatusAsync
+****************************************************************************//**
+*
+* Summary:
+*   Starts a status + command transaction that acknowledges the frame
+*   written before and writes the next one: the EZI2C sub-address is moved to
+*   the reply region, the status packet is read without a STOP and checked
+*   against the frame before, and the command packet is written after a
+*   repeated START only if that frame was acknowledged, in a single bus
+*   transaction. The slave parses its buffer in its main loop, so the status
+*   of a command is read with the command after it. When no frame awaits its
+*   status, the command packet is written alone. Returns without waiting for
+*   the bus.
+*
+*   Completion reports:
+*   TRANSFER_CMPLT: the frame before was acknowledged (or none awaited its
+*   status) and the command was written; its status is read by the next
+*   call or by ReadStatusPacketFromEzI2C().
+*   TRANSFER_STS_STALE: the slave has not handled the frame before yet; the
+*   command was not written. Call again once the slave has run.
+*   TRANSFER_STS_FAIL: the slave rejected the frame before; the command was
+*   not written. Write the frame before again, then call again.
+*   TRANSFER_ERROR: the transaction failed on the bus or the status packet
+*   is malformed. Calling again is safe: the slave drops a frame it
+*   already executed.
+*
+* Parameters:
+*   master: Master handle
+*   writebuffer: Command packet buffer pointer, must stay valid until the
+*                transfer completes
+*   bufferSize: Size of the packet buffer
+*   callback: Called on completion, can be NULL
+*
+* Return:
+*   TRANSFER_PENDING if the transaction was started.
+*   TRANSFER_ERROR if the master is busy or the transaction could not start.
+*
+*******************************************************************************/
+uint8_t WriteCommandReadStatusAsync(i2c_master_t* master, uint8_t* writebuffer, uint32_t bufferSize,
+                                    i2c_master_callback_t callback)
+{
+    if (TRANSFER_PENDING == master->xferStatus)
+    {
+        return (TRANSFER_ERROR);
+    }
+
+    if (!master->ackPending || (bufferSize <= PACKET_SEQ_POS))
+    {
+        ExpectStatusOf(master, writebuffer, bufferSize);
+        return (StartEzI2CWrite(master, writebuffer, bufferSize, callback));
+    }
+
+    master->xferConfig.slaveAddress = master->slaveAddress;
+    master->subAddress    = (uint8_t)EZI2C_RPLY_SOP_POS;
+    master->chainBuffer   = &master->rxBuffer[MASTER_RX_POS(EZI2C_RPLY_SOP_POS)];
+    master->chainSize     = RX_PACKET_SIZE;
+    master->xferReply     = master->chainBuffer;
+    master->commandBuffer = writebuffer;
+    master->commandSize   = bufferSize;
+    master->commandAck    = TRANSFER_ERROR;
+    master->xferCallback  = callback;
+    master->xferChained   = true;
+    master->xferCombined  = true;
+    master->xferTimeoutUs = TransferTimeoutUs(master, sizeof(master->subAddress) + RX_PACKET_SIZE + bufferSize, 3UL);
+    master->xferFault     = 0UL;
+    master->xferStatus    = TRANSFER_PENDING;
+
+    INSTR_STAMP(master->instrXferStart);
+    if (CY_SCB_I2C_SUCCESS != StartMasterTransfer(master, &master->subAddress, sizeof(master->subAddress),
+                                                  false, true))
+    {
+        master->xferCallback = NULL;
+        master->xferChained  = false;
+        master->xferStatus   = TRANSFER_ERROR;
+    }
+
+    return (master->xferStatus);
+}
+
+/*******************************************************************************
+* Function Name: SelectEzI2CSlave
+****************************************************************************//**
+*
+* Summary:
+*   Selects the EzI2C slave the following transfers are addressed to. The
+*   telemetry window is read at the next address. Switching to another slave
+*   makes the next PushCommandsToEzI2C() read the ring tail of that slave.
+*   Each slave keeps its own sequence counter, so the command packets of a
+*   slave must be prepared while it is selected.
+*
+* Parameters:
+*   master: Master handle
+*   slaveAddress: 7-bit address of the EzI2C command buffer
+*
+* Return:
+*   TRANSFER_CMPLT, or TRANSFER_ERROR if a transfer is in flight or the
+*   handle already keeps the counters of MASTER_SEQ_SLAVES other slaves.
+*
+*******************************************************************************/
+uint8_t SelectEzI2CSlave(i2c_master_t* master, uint8_t slaveAddress)
+{
+    i2c_master_seq_t parked;
+    uint32_t slot = MASTER_SEQ_SLAVES;
+    uint32_t i;
+
+    if (TRANSFER_PENDING == master->xferStatus)
+    {
+        return (TRANSFER_ERROR);
+    }
+
+    if (slaveAddress != master->slaveAddress)
+    {
+        /* The entry of the new slave, or else the first free one */
+        for (i = 0UL; i < MASTER_SEQ_SLAVES; i++)
+        {
+            if (slaveAddress == master->seqSlaves[i].address)
+            {
+                slot = i;
+                break;
+            }
+            if ((0U == master->seqSlaves[i].address) && (MASTER_SEQ_SLAVES == slot))
+            {
+                slot = i;
+            }
+        }
+        if (MASTER_SEQ_SLAVES == slot)
+        {
+            return (TRANSFER_ERROR);
+        }
+
+        /* Park the counters of the current slave in the entry and take those
+         * of the new one. A slave not seen before starts from 0, as after a
+         * reset.
+         */
+        parked.address = master->slaveAddress;
+        parked.txSeq   = master->txSeq;
+        parked.ackSeq  = master->ackSeq;
+        parked.ackPending = master->ackPending;
+        if (slaveAddress == master->seqSlaves[slot].address)
+        {
+            master->txSeq  = master->seqSlaves[slot].txSeq;
+            master->ackSeq = master->seqSlaves[slot].ackSeq;
+            master->ackPending = master->seqSlaves[slot].ackPending;
+        }
+        else
+        {
+            master->txSeq  = 0U;
+            master->ackSeq = 0U;
+            master->ackPending = false;
+        }
+        master->seqSlaves[slot] = parked;
+        master->slaveAddress = slaveAddress;
+        master->ringResync = true;
+    }
+
+    return (TRANSFER_CMPLT);
+}
+
+/*******************************************************************************
+* Function Name: GetMasterTransferTimeoutUs
+****************************************************************************//**
+*
+* Summary:
+*   Returns the timeout budget computed for the last transfer started, for
+*   callers of the Async functions that enforce their own deadline.
+*
+* Parameters:
+*   master: Master handle
+*
+*******************************************************************************/
+uint32_t GetMasterTransferTimeoutUs(i2c_master_t const* master)
+{
+    return (master->xferTimeoutUs);
+}
+
+/*******************************************************************************
+* Function Name: GetMasterTransferStatus
+****************************************************************************//**
+*
+* Summary:
+*   Returns the state of the last transfer started by one of the Async
+*   functions.
+*
+* Parameters:
+*   master: Master handle
+*
+* Return:
+*   TRANSFER_PENDING while the transfer is on the bus, then TRANSFER_CMPLT,
+*   TRANSFER_STS_FAIL or TRANSFER_ERROR.
+*
+*******************************************************************************/
+uint8_t GetMasterTransferStatus(i2c_master_t const* master)
+{
+    return (master->xferStatus);
+}
+
+/*******************************************************************************
+* Function Name: AbortMasterTransfer
+****************************************************************************//**
+*
+* Summary:
+*   Abandons the transfer in flight, if any, by resetting the master SCB. The
+*   owner's callback is called with TRANSFER_ERROR, and the phase on the bus
+*   is recorded as timed out.
+*
+* Parameters:
+*   master: Master handle
+*
+*******************************************************************************/
+void AbortMasterTransfer(i2c_master_t* master)
+{
+    if (TRANSFER_PENDING == master->xferStatus)
+    {
+        RECORD_END(&master->record, &master->xferConfig, RECORD_F_TIMEOUT,
+                   Cy_SCB_I2C_MasterGetStatus(master->hw->base, &master->context),
+                   Cy_SCB_I2C_MasterGetTransferCount(master->hw->base, &master->context));
+    }
+
+    /* Timeout recovery */
+    Cy_SCB_I2C_Disable(master->hw->base, &master->context);
+    Cy_SCB_I2C_Enable(master->hw->base, &master->context);
+
+    if (TRANSFER_PENDING == master->xferStatus)
+    {
+        CompleteMasterTransfer(master, TRANSFER_ERROR);
+    }
+}
+
+/*******************************************************************************
+* Function Name: SetMasterDataRate
+****************************************************************************//**
+*
+* Summary:
+*   Sets the data rate the transfer timeouts are computed for. Call it when
+*   the SCB data rate is changed from the design.modus setting.
+*
+* Parameters:
+*   master: Master handle
+*   dataRateHz: SCL rate of the master in Hz
+*
+*******************************************************************************/
+void SetMasterDataRate(i2c_master_t* master, uint32_t dataRateHz)
+{
+    if (0UL != dataRateHz)
+    {
+        master->dataRateHz = dataRateHz;
+    }
+}
+
+#if I2C_RECORD
+/*******************************************************************************
+* Function Name: SetMasterRecorder
+****************************************************************************//**
+*
+* Summary:
+*   Records every transfer phase of a handle to a sink: the log header is
+*   sent at once, then one record per phase with its transfer configuration,
+*   data, status and timing. Logs are replayed on the host by
+*   host/replay_bench. Call it with no transfer in flight.
+*
+* Parameters:
+*   master: Master handle
+*   sink: Receives the log, or NULL to stop recording
+*
+*******************************************************************************/
+void SetMasterRecorder(i2c_master_t* master, i2c_record_sink_t sink)
+{
+    initRecord(&master->record, sink, master->dataRateHz);
+}
+#endif
+
+/*******************************************************************************
+* Function Name: ConfigureMasterDataRate
+****************************************************************************//**
+*
+* Summary:
+*   Reprograms the clock divider and the oversampling of the master SCB for
+*   a new data rate, and the transfer timeouts with it. The SCB is disabled
+*   while it is reconfigured. If the SCB cannot run at the rate, the clock
+*   divider is put back.
+*
+* Parameters:
+*   master: Master handle
+*   dataRateHz: SCL rate in Hz
+*
+* Return:
+*   Data rate the master runs at, or 0 if a transfer is in flight or the
+*   rate is not supported.
+*
+*******************************************************************************/
+uint32_t ConfigureMasterDataRate(i2c_master_t* master, uint32_t dataRateHz)
+{
+    uint32_t divider = GetScbClockDivider(dataRateHz, true);
+    uint32_t oldDivider;
+    uint32_t actualHz = 0UL;
+
+    if ((0UL == divider) || (TRANSFER_PENDING == master->xferStatus))
+    {
+        return (0UL);
+    }
+
+    Cy_SCB_I2C_Disable(master->hw->base, &master->context);
+    oldDivider = Cy_SysClk_PeriphGetDivider(master->hw->clkDivType, master->hw->clkDivNum);
+    (void)Cy_SysClk_PeriphDisableDivider(master->hw->clkDivType, master->hw->clkDivNum);
+    (void)Cy_SysClk_PeriphSetDivider(master->hw->clkDivType, master->hw->clkDivNum, divider - 1UL);
+    (void)Cy_SysClk_PeriphEnableDivider(master->hw->clkDivType, master->hw->clkDivNum);
+
+    actualHz = Cy_SCB_I2C_SetDataRate(master->hw->base, dataRateHz,
+                                      Cy_SysClk_PeriphGetFrequency(master->hw->clkDivType, master->hw->clkDivNum));
+    if (0UL == actualHz)
+    {
+        (void)Cy_SysClk_PeriphDisableDivider(master->hw->clkDivType, master->hw->clkDivNum);
+        (void)Cy_SysClk_PeriphSetDivider(master->hw->clkDivType, master->hw->clkDivNum, oldDivider);
+        (void)Cy_SysClk_PeriphEnableDivider(master->hw->clkDivType, master->hw->clkDivNum);
+    }
+    Cy_SCB_I2C_Enable(master->hw->base, &master->context);
+
+    SetMasterDataRate(master, actualHz);
+    return (actualHz);
+}
+
+/*******************************************************************************
+* Function Name: WaitMasterTransfer
+****************************************************************************//**
+*
+* Summary:
+*   Waits until the transfer in flight completes or its deadline passes. The
+*   deadline is measured on the microsecond clock (GetTimeUs()), so time
+*   spent in interrupts counts. On time out the master is reset.
+*
+* Parameters:
+*   master: Master handle
+*   timeoutUs: Deadline in microseconds, or TRANSFER_TIMEOUT_AUTO for the
+*              budget computed from the data rate and size of the transfer
+*
+* Return:
+*   TRANSFER_CMPLT, TRANSFER_STS_FAIL or TRANSFER_ERROR.
+*
+*******************************************************************************/
+uint8_t WaitMasterTransfer(i2c_master_t* master, uint32_t timeoutUs)
+{
+    uint32_t startUs = GetTimeUs();
+
+    if (TRANSFER_TIMEOUT_AUTO == timeoutUs)
+    {
+        timeoutUs = master->xferTimeoutUs;
+    }
+
+    while ((TRANSFER_PENDING == master->xferStatus) && ((GetTimeUs() - startUs) < timeoutUs))
+    {
+        Cy_SysLib_DelayUs(CY_SCB_WAIT_1_UNIT);
+    }
+
+    if (TRANSFER_PENDING == master->xferStatus)
+    {
+        TRACE_EVENT(TRACE_M_TIMEOUT, Cy_SCB_I2C_MasterGetStatus(master->hw->base, &master->context),
+                    Cy_SCB_I2C_MasterGetTransferCount(master->hw->base, &master->context));
+        master->xferFault = I2C_MASTER_TIMEOUT;
+        AbortMasterTransfer(master);
+    }
+
+    return (master->xferStatus);
+}
+
+/*******************************************************************************
+* Function Name: RecoverMasterBus
+****************************************************************************//**
+*
+* Summary:
+*   Resets the master SCB and, if a slave holds SDA low, clocks the bus free
+*   and generates a STOP. Call it with no transfer in flight, for example
+*   after an Async transfer reported TRANSFER_ERROR.
+*
+* Parameters:
+*   master: Master handle
+*
+* Return:
+*   I2C_BUS_FREE if the bus is usable, I2C_BUS_STUCK otherwise.
+*
+*******************************************************************************/
+uint32_t RecoverMasterBus(i2c_master_t* master)
+{
+    uint32_t busState;
+
+    Cy_SCB_I2C_Disable(master->hw->base, &master->context);
+    busState = ClearStuckBus(&master->recoveryStats, &master->hw->pins, master->dataRateHz);
+    Cy_SCB_I2C_Enable(master->hw->base, &master->context);
+    TRACE_EVENT(TRACE_M_RECOVER, busState, 0UL);
+
+    return (busState);
+}
+
+/*******************************************************************************
+* Function Name: RetryMasterTransfer
+****************************************************************************//**
+*
+* Summary:
+*   Handles the end of a blocking transfer: classifies the failure, if any,
+*   recovers the bus for a bus error or a timeout and waits out the retry
+*   delay of the failure class.
+*
+* Parameters:
+*   master: Master handle
+*   attempt: Retries made so far, incremented on retry
+*   idempotent: true if the transfer can be repeated even when part of it
+*               went through. A transfer NAKed at the address is always
+*               repeatable.
+*
+* Return:
+*   true if the transfer should be started again.
+*
+*******************************************************************************/
+static bool RetryMasterTransfer(i2c_master_t* master, uint32_t* attempt, bool idempotent)
+{
+    uint32_t masterStatus = master->xferFault;
+    uint32_t fault = ClassifyMasterFault(masterStatus);
+    bool retryable = idempotent || (0UL != (masterStatus & CY_SCB_I2C_MASTER_ADDR_NAK));
+    uint32_t delayUs;
+
+    master->xferFault = 0UL;
+    if (I2C_FAULT_NONE == fault)
+    {
+        if (0UL != *attempt)
+        {
+            RecordMasterRecovery(&master->recoveryStats);
+        }
+        return (false);
+    }
+
+    if (((I2C_FAULT_BUS_ERR == fault) || (I2C_FAULT_TIMEOUT == fault)) && (I2C_BUS_FREE != RecoverMasterBus(master)))
+    {
+        retryable = false;
+    }
+    if (!NextMasterRetry(&master->recoveryStats, fault, *attempt, retryable, &delayUs))
+    {
+        return (false);
+    }
+
+    (*attempt)++;
+    TRACE_EVENT(TRACE_M_RETRY, fault, *attempt);
+    Cy_SysLib_DelayUs((uint16_t)((delayUs < UINT16_MAX) ? delayUs : UINT16_MAX));
+    return (true);
+}
+
+/*******************************************************************************
+* Function Name: WritePacketToEzI2C
+****************************************************************************//**
+*
+* Summary:
+*   Buffer is assigned with data to be sent to slave.
+*   high level PDL library function is used to control I2C SCB to send data to
+*   EzI2C slave. Errors are handled depend on the return value from the
+*   appropriate function. Blocking wrapper of WritePacketToEzI2CAsync().
+*   A failed write is recovered and retried; a command frame written twice
+*   is dropped by the slave as a duplicate.
+*
+* Parameters:
+*   master: Master handle
+*   writebuffer: Command packet buffer pointer
+*   bufferSize: Size of the packet buffer
+*
+* Return:
+*   Status after command is written to slave.
+*   TRANSFER_ERROR is returned if any error occurs.
+*   TRANSFER_CMPLT is returned if write is successful.
+*
+*******************************************************************************/
+uint8_t WritePacketToEzI2C(i2c_master_t* master, uint8_t* writebuffer, uint32_t bufferSize)
+{
+    if (TRANSFER_PENDING == master->xferStatus)
+    {
+        return (TRANSFER_ERROR);
+    }
+
+    ExpectStatusOf(master, writebuffer, bufferSize);
+    return (WriteEzI2C(master, writebuffer, bufferSize, true));
+}
+
+/*******************************************************************************
+* Function Name: WriteEzI2C
+****************************************************************************//**
+*
+* Summary:
+*   Writes a buffer to the EzI2C slave, recovering from bus failures.
+*
+* Parameters:
+*   master: Master handle
+*   writebuffer: EZI2C sub-address followed by the data
+*   bufferSize: Size of the buffer
+*   idempotent: true if the data may be written again after a failure that
+*               happened part way through the write
+*
+* Return:
+*   TRANSFER_CMPLT or TRANSFER_ERROR.
+*
+*******************************************************************************/
+static uint8_t WriteEzI2C(i2c_master_t* master, uint8_t* writebuffer, uint32_t bufferSize, bool idempotent)
+{
+    uint8_t status;
+    uint32_t attempt = 0UL;
+
+    do
+    {
+        status = StartEzI2CWrite(master, writebuffer, bufferSize, NULL);
+        if (TRANSFER_PENDING == status)
+        {
+            status = WaitMasterTransfer(master, TRANSFER_TIMEOUT_AUTO);
+        }
+    } while (RetryMasterTransfer(master, &attempt, idempotent));
+
+    return (status);
+}
+
+/*******************************************************************************
+* Function Name: ReadEzI2C
+****************************************************************************//**
+*
+* Summary:
+*   Reads size bytes from the EzI2C buffer at the given offset. Blocking
+*   wrapper of ReadEzI2CAsync(). A failed read is recovered and retried.
+*
+* Parameters:
+*   master: Master handle
+*   offset: EZI2C sub-address of the first byte to read
+*   readbuffer: Storage for the data read
+*   size: Number of bytes to read
+*
+* Return:
+*   READ_CMPLT if all bytes were read, READ_ERROR otherwise.
+*
+*******************************************************************************/
+uint8_t ReadEzI2C(i2c_master_t* master, uint8_t offset, uint8_t* readbuffer, uint32_t size)
+{
+    uint8_t status;
+    uint32_t attempt = 0UL;
+
+    do
+    {
+        status = ReadEzI2CAsync(master, offset, readbuffer, size, NULL);
+        if (TRANSFER_PENDING == status)
+        {
+            status = WaitMasterTransfer(master, TRANSFER_TIMEOUT_AUTO);
+        }
+    } while (RetryMasterTransfer(master, &attempt, true));
+
+    return (status);
+}
+
+/*******************************************************************************
+* Function Name: ReadTelemetryFromEzI2C
+****************************************************************************//**
+*
+* Summary:
+*   Reads size bytes from the telemetry window at the given offset. Blocking
+*   wrapper of ReadTelemetryFromEzI2CAsync(). A failed read is recovered
+*   and retried.
+*
+* Parameters:
+*   master: Master handle
+*   offset: Offset in the telemetry window (TLM_*_POS)
+*   readbuffer: Storage for the data read
+*   size: Number of bytes to read
+*
+* Return:
+*   READ_CMPLT if all bytes were read, READ_ERROR otherwise.
+*
+*******************************************************************************/
+uint8_t ReadTelemetryFromEzI2C(i2c_master_t* master, uint8_t offset, uint8_t* readbuffer, uint32_t size)
+{
+    uint8_t status;
+    uint32_t attempt = 0UL;
+
+    do
+    {
+        status = ReadTelemetryFromEzI2CAsync(master, offset, readbuffer, size, NULL);
+        if (TRANSFER_PENDING == status)
+        {
+            status = WaitMasterTransfer(master, TRANSFER_TIMEOUT_AUTO);
+        }
+    } while (RetryMasterTransfer(master, &attempt, true));
+
+    return (status);
+}
+
+/*******************************************************************************
+* Function Name: ReadStatusPacketFromEzI2C
+****************************************************************************//**
+*
+* Summary:
+*   Master reads the status packet from the reply region of the EzI2C buffer.
+*   The status of the transfer is returned by comparing the data read.
+*   Blocking wrapper of ReadStatusPacketFromEzI2CAsync(). A failed read is
+*   recovered and retried.
+*
+* Parameters:
+*   master: Master handle
+*
+* Return:
+*   Status of the transfer by checking packets read.
+*   Note that if the status packet read is correct function returns TRANSFER_CMPLT,
+*   if the slave rejected the frame it returns TRANSFER_STS_FAIL and if the
+*   read failed or the status packet is malformed it returns TRANSFER_ERROR.
+*   TRANSFER_STS_STALE is returned if the status packet still names an
+*   earlier frame than the last command written.
+*
+*******************************************************************************/
+uint8_t ReadStatusPacketFromEzI2C(i2c_master_t* master)
+{
+    uint8_t status;
+    uint32_t attempt = 0UL;
+
+    do
+    {
+        status = ReadStatusPacketFromEzI2CAsync(master, NULL);
+        if (TRANSFER_PENDING == status)
+        {
+            status = WaitMasterTransfer(master, TRANSFER_TIMEOUT_AUTO);
+        }
+    } while (RetryMasterTransfer(master, &attempt, true));
+
+    return (status);
+}
+
+/*******************************************************************************
+* Function Name: ReadCommandResult
+****************************************************************************//**
+*
+* Summary:
+*   Reads the status packet and the result of the last command executed by
+*   the slave in one read. A failed read is recovered and retried.
+*
+* Parameters:
+*   master: Master handle
+*   result: Set to the result if the status packet reports success
+*
+* Return:
+*   TRANSFER_CMPLT, TRANSFER_STS_FAIL if the slave rejected the command, or
+*   TRANSFER_ERROR if the read failed. TRANSFER_STS_STALE if the slave has not handled
+*   the last command written yet. The status byte read is at
+*   MASTER_RX_POS(EZI2C_RPLY_STS_POS) in the RX buffer.
+*
+*******************************************************************************/
+uint8_t ReadCommandResult(i2c_master_t* master, uint32_t* result)
+{
+    uint8_t* reply = &master->rxBuffer[MASTER_RX_POS(EZI2C_RPLY_SOP_POS)];
+    uint8_t status;
+    uint32_t attempt = 0UL;
+
+    do
+    {
+        status = StartEzI2CRead(master, master->slaveAddress, (uint8_t)EZI2C_RPLY_SOP_POS,
+                                reply, RESULT_PACKET_SIZE, reply, NULL);
+        if (TRANSFER_PENDING == status)
+        {
+            status = WaitMasterTransfer(master, TRANSFER_TIMEOUT_AUTO);
+        }
+    } while (RetryMasterTransfer(master, &attempt, true));
 
-/* Command valid status */
-#define TRANSFER_ERROR      (0xFFUL)
-#define READ_ERROR          (TRANSFER_ERROR)
+    if (TRANSFER_CMPLT == status)
+    {
+        *result = PROTO_GET(proto_result_t, value, &master->rxBuffer[MASTER_RX_POS(EZI2C_RESULT_POS)]);
+    }
 
-/* Timeout */
-#define LOOP_FOREVER        (0UL)
+    return (status);
+}
+
+/*******************************************************************************
+* Function Name: WriteCommandReadStatus
+****************************************************************************//**
+*
+* Summary:
+*   Reads the status packet of the frame written before and writes a command
+*   packet in one bus transaction using a repeated START. Blocking wrapper
+*   of WriteCommandReadStatusAsync(). A failed transaction is recovered and
+*   retried.
+*
+* Parameters:
+*   master: Master handle
+*   writebuffer: Command packet buffer pointer
+*   bufferSize: Size of the packet buffer
+*
+* Return:
+*   TRANSFER_CMPLT if the frame before was acknowledged, or none awaited
+*   its status, and the command was written.
+*   TRANSFER_STS_STALE if the slave has not handled the frame before yet;
+*   the command was not written.
+*   TRANSFER_STS_FAIL if the slave rejected the frame before; the command
+*   was not written and the frame before must be written again.
+*   TRANSFER_ERROR if the transaction failed on the bus or the status
+*   packet is malformed.
+*
+*******************************************************************************/
+uint8_t WriteCommandReadStatus(i2c_master_t* master, uint8_t* writebuffer, uint32_t bufferSize)
+{
+    uint8_t status;
+    uint32_t attempt = 0UL;
 
-/* Packet positions */
-#define EZI2C_RPLY_SOP_POS  (5UL)
-#define EZI2C_RPLY_STS_POS  (6UL)
-#define EZI2C_RPLY_EOP_POS  (7UL)
+    do
+    {
+        status = WriteCommandReadStatusAsync(master, writebuffer, bufferSize, NULL);
+        if (TRANSFER_PENDING == status)
+        {
+            status = WaitMasterTransfer(master, TRANSFER_TIMEOUT_AUTO);
+        }
+    } while (RetryMasterTransfer(master, &attempt, true));
 
-/* Combine master error statuses in single mask  */
-#define MASTER_ERROR_MASK   (CY_SCB_I2C_MASTER_DATA_NAK | CY_SCB_I2C_MASTER_ADDR_NAK   | \
-                            CY_SCB_I2C_MASTER_ARB_LOST | CY_SCB_I2C_MASTER_ABORT_START | \
-                            CY_SCB_I2C_MASTER_BUS_ERR)
+    return (status);
+}
 
 /*******************************************************************************
-* Global variables
+* Function Name: PrepareOpcodePacket
+****************************************************************************//**
+*
+* Summary:
+*   Builds the command packet for WritePacketToEzI2C() and
+*   WriteCommandReadStatus(): the EZI2C sub-address of the command frame
+*   followed by a frame carrying the opcode and its operands with the next
+*   sequence number. Resending the same packet lets the slave drop it as a
+*   duplicate.
+*
+* Parameters:
+*   master: Master handle
+*   writebuffer: Storage for WRITE_PACKET_SIZE bytes
+*   opcode: CMD_OP_* opcode
+*   operands: Operands as described for the opcode in I2CPacket.h
+*   count: Number of operand bytes, up to CMD_OPERANDS_MAX
+*
+* Return:
+*   Size of the packet in bytes, or 0 if there are too many operands.
+*
 *******************************************************************************/
-/* Structure for master transfer configuration */
-cy_stc_scb_i2c_master_xfer_config_t masterTransferCfg =
+uint32_t PrepareOpcodePacket(i2c_master_t* master, uint8_t* writebuffer, uint8_t opcode,
+                             uint8_t const* operands, uint32_t count)
 {
-    .slaveAddress = I2C_SLAVE_ADDR,
-    .buffer       = NULL,
-    .bufferSize   = 0U,
-    .xferPending  = false
-};
+    uint8_t payload[PROTO_SIZE(proto_command_t)];
+    uint32_t i;
 
-/** The instance-specific context structure.
- * It is used by the driver for internal configuration and
- * data keeping for the I2C. Do not modify anything in this structure.
- */
-cy_stc_scb_i2c_context_t CYBSP_I2C_context;
+    if (count > CMD_OPERANDS_MAX)
+    {
+        return (0UL);
+    }
+
+    PROTO_PUT(proto_command_t, opcode, payload, opcode);
+    for (i = 0UL; i < count; i++)
+    {
+        payload[PROTO_OFS(proto_command_t, operands) + i] = operands[i];
+    }
+
+    writebuffer[PACKET_ADDR_POS] = (uint8_t)EZI2C_CMD_FRAME_POS;
+    return (1UL + BuildFrame(&writebuffer[PACKET_SOP_POS], master->txSeq++, payload, CMD_PAYLOAD_SIZE(count)));
+}
 
 /*******************************************************************************
-* Function Declaration
+* Function Name: PrepareCommandPacket
+****************************************************************************//**
+*
+* Summary:
+*   Builds the packet of a CMD_OP_LED command, see PrepareOpcodePacket().
+*
+* Parameters:
+*   master: Master handle
+*   writebuffer: Storage for WRITE_PACKET_SIZE bytes
+*   cmd: LED state
+*
+* Return:
+*   Size of the packet in bytes.
+*
 *******************************************************************************/
-void CYBSP_I2C_Interrupt(void);
+uint32_t PrepareCommandPacket(i2c_master_t* master, uint8_t* writebuffer, uint8_t cmd)
+{
+    uint8_t operands[PROTO_SIZE(proto_op_led_t)];
+
+    PROTO_PUT(proto_op_led_t, state, operands, cmd);
+    return (PrepareOpcodePacket(master, writebuffer, (uint8_t)CMD_OP_LED, operands, sizeof(operands)));
+}
+
 /*******************************************************************************
-* Function Name: CYBSP_I2C_Interrupt
+* Function Name: WriteRingSlots
 ****************************************************************************//**
 *
 * Summary:
-*   Invokes the Cy_SCB_I2C_MasterInterrupt() PDL driver function.
+*   Writes count CMD_OP_LED frames into consecutive ring slots starting at
+*   master->ringHead in one write transaction. The slots must not wrap past the end
+*   of the ring.
+*
+* Parameters:
+*   master: Master handle
+*
+* Return:
+*   TRANSFER_CMPLT if the slots were written, TRANSFER_ERROR otherwise.
 *
 *******************************************************************************/
-void CYBSP_I2C_Interrupt(void)
+static uint8_t WriteRingSlots(i2c_master_t* master, uint8_t const* commands, uint32_t count)
 {
-    Cy_SCB_I2C_MasterInterrupt(CYBSP_I2C_HW, &CYBSP_I2C_context);
+    uint32_t i;
+    uint8_t* slot = &master->txBuffer[1];
+    uint8_t payload[COMMAND_PAYLOAD_SIZE];
+    uint8_t* operands = &payload[PROTO_OFS(proto_command_t, operands)];
+
+    master->txBuffer[PACKET_ADDR_POS] = (uint8_t)(EZI2C_RING_BASE_POS + (master->ringHead * EZI2C_RING_SLOT_SIZE));
+    PROTO_PUT(proto_command_t, opcode, payload, CMD_OP_LED);
+    for (i = 0UL; i < count; i++)
+    {
+        PROTO_PUT(proto_op_led_t, state, operands, commands[i]);
+        slot += BuildFrame(slot, master->txSeq++, payload, COMMAND_PAYLOAD_SIZE);
+    }
+    master->ackSeq = (uint8_t)(master->txSeq - 1U);
+    master->ackPending = true;
+
+    /* Slots the slave has already executed must not be written again */
+    if (TRANSFER_CMPLT != WriteEzI2C(master, master->txBuffer, 1UL + (count * EZI2C_RING_SLOT_SIZE), false))
+    {
+        return (TRANSFER_ERROR);
+    }
+
+    master->ringHead = (master->ringHead + count) % COMMAND_RING_SLOTS;
+    return (TRANSFER_CMPLT);
 }
 
 /*******************************************************************************
-* Function Name: WritePacketToEzI2C
+* Function Name: PushCommandsToEzI2C
 ****************************************************************************//**
 *
 * Summary:
-*   Buffer is assigned with data to be sent to slave.
-*   high level PDL library function is used to control I2C SCB to send data to
-*   EzI2C slave. Errors are handled depend on the return value from the
-*   appropriate function.
+*   Queues a batch of commands in the command ring of the EzI2C slave. The
+*   batch goes out in a single write transaction, or two when it wraps past
+*   the end of the ring. The slave executes all queued commands in one pass
+*   of CheckEzI2Cbuffer(). The slave tail is read back only when the cached
+*   one does not leave room for the batch.
 *
 * Parameters:
-*   writebuffer: Command packet buffer pointer
-*   bufferSize: Size of the packet buffer
+*   master: Master handle
+*   commands: Command bytes, one per slot
+*   count: Number of commands, 1 to COMMAND_RING_MAX_BATCH
 *
 * Return:
-*   Status after command is written to slave.
-*   TRANSFER_ERROR is returned if any error occurs.
-*   TRANSFER_CMPLT is returned if write is successful.
+*   TRANSFER_CMPLT if the batch was written.
+*   TRANSFER_ERROR if the ring has no room for the batch or a write failed.
+*   After a failed write part of the batch may have been delivered.
 *
 *******************************************************************************/
-uint8_t WritePacketToEzI2C(uint8_t* writebuffer, uint32_t bufferSize)
+uint8_t PushCommandsToEzI2C(i2c_master_t* master, uint8_t const* commands, uint32_t count)
 {
-    uint8_t status = TRANSFER_ERROR;
-    cy_en_scb_i2c_status_t  errorStatus;
-    uint32_t masterStatus;
-    /* Timeout 1 sec (one unit is us) */
-    uint32_t timeout = 1000000UL;
+    uint32_t used;
+    uint32_t run;
+    uint8_t tail;
 
-    /* Setup transfer specific parameters */
-    masterTransferCfg.buffer     = writebuffer;
-    masterTransferCfg.bufferSize = bufferSize;
+    if ((0UL == count) || (count > COMMAND_RING_MAX_BATCH))
+    {
+        return (TRANSFER_ERROR);
+    }
 
-    /* Initiate write transaction */
-    errorStatus = Cy_SCB_I2C_MasterWrite(CYBSP_I2C_HW, &masterTransferCfg, &CYBSP_I2C_context);
-    if(errorStatus == CY_SCB_I2C_SUCCESS)
+    used = (master->ringHead + COMMAND_RING_SLOTS - master->ringTail) % COMMAND_RING_SLOTS;
+    if (master->ringResync || ((COMMAND_RING_MAX_BATCH - used) < count))
     {
-        /* Wait until master complete read transfer or time out has occured */
-        do
+        if (READ_CMPLT != ReadEzI2C(master, (uint8_t)EZI2C_RING_TAIL_POS, &tail, sizeof(tail)))
         {
-            masterStatus  = Cy_SCB_I2C_MasterGetStatus(CYBSP_I2C_HW, &CYBSP_I2C_context);
-            Cy_SysLib_DelayUs(CY_SCB_WAIT_1_UNIT);
-            timeout--;
-
-        } while ((0UL != (masterStatus & CY_SCB_I2C_MASTER_BUSY)) && (timeout > 0));
-
-        if (timeout <= 0)
+            return (TRANSFER_ERROR);
+        }
+        master->ringTail = tail % COMMAND_RING_SLOTS;
+        if (master->ringResync)
         {
-            /* Timeout recovery */
-            Cy_SCB_I2C_Disable(CYBSP_I2C_HW, &CYBSP_I2C_context);
-            Cy_SCB_I2C_Enable(CYBSP_I2C_HW, &CYBSP_I2C_context);
+            /* Restart right behind the last slot the slave has taken. */
+            master->ringHead   = master->ringTail;
+            master->ringResync = false;
         }
-        else
+        used = (master->ringHead + COMMAND_RING_SLOTS - master->ringTail) % COMMAND_RING_SLOTS;
+        if ((COMMAND_RING_MAX_BATCH - used) < count)
         {
-            if ((0u == (MASTER_ERROR_MASK & masterStatus)) &&
-                (WRITE_PACKET_SIZE == Cy_SCB_I2C_MasterGetTransferCount(CYBSP_I2C_HW, &CYBSP_I2C_context)))
-            {
-                status = TRANSFER_CMPLT;
-            }
+            return (TRANSFER_ERROR);
+        }
+    }
+
+    run = COMMAND_RING_SLOTS - master->ringHead;
+    if (run > count)
+    {
+        run = count;
+    }
+    if ((TRANSFER_CMPLT != WriteRingSlots(master, commands, run)) ||
+        ((run < count) && (TRANSFER_CMPLT != WriteRingSlots(master, &commands[run], count - run))))
+    {
+        master->ringResync = true;
+        return (TRANSFER_ERROR);
+    }
+
+    return (TRANSFER_CMPLT);
+}
+
+/*******************************************************************************
+* Function Name: ReadCommandRingStatus
+****************************************************************************//**
+*
+* Summary:
+*   Reads the ring tail and the status packet in one offset read, so the
+*   master learns both the result of the last pass of the slave and how much
+*   of the ring is free.
+*
+* Parameters:
+*   master: Master handle
+*
+* Return:
+*   TRANSFER_CMPLT if the status packet acknowledges the last slot written
+*   with success, TRANSFER_STS_STALE if the slave has not reached it yet,
+*   TRANSFER_STS_FAIL if the slave rejected it, TRANSFER_ERROR otherwise.
+*
+*******************************************************************************/
+uint8_t ReadCommandRingStatus(i2c_master_t* master)
+{
+    uint8_t status;
+    uint32_t attempt = 0UL;
+
+    do
+    {
+        status = StartEzI2CRead(master, master->slaveAddress, (uint8_t)EZI2C_RING_TAIL_POS,
+                                &master->rxBuffer[MASTER_RX_POS(EZI2C_RING_TAIL_POS)], RING_STATUS_SIZE,
+                                &master->rxBuffer[MASTER_RX_POS(EZI2C_RPLY_SOP_POS)], NULL);
+        if (TRANSFER_PENDING == status)
+        {
+            status = WaitMasterTransfer(master, TRANSFER_TIMEOUT_AUTO);
         }
+    } while (RetryMasterTransfer(master, &attempt, true));
+
+    if (READ_CMPLT == status)
+    {
+        master->ringTail = master->rxBuffer[MASTER_RX_POS(EZI2C_RING_TAIL_POS)] % COMMAND_RING_SLOTS;
     }
 
     return (status);
 }
 
 /*******************************************************************************
-* Function Name: ReadStatusPacketFromEzI2C
+* Function Name: WriteStreamOpen
 ****************************************************************************//**
 *
 * Summary:
-*   Master initiates the read from EzI2C buffer.
-*   The status of the transfer is returned by comparing the data in EzI2C buffer.
+*   Writes the open frame of the stream in flight with the next sequence
+*   number.
+*
+* Parameters:
+*   master: Master handle
 *
 * Return:
-*   Status of the transfer by checking packets read.
-*   Note that if the status packet read is correct function returns TRANSFER_CMPLT
-*   and if status packet is incorrect function returns TRANSFER_ERROR.
+*   TRANSFER_CMPLT if the frame was written, TRANSFER_ERROR otherwise.
 *
 *******************************************************************************/
-uint8_t ReadStatusPacketFromEzI2C(void)
+static uint8_t WriteStreamOpen(i2c_master_t* master)
 {
-    uint8_t status = TRANSFER_ERROR;
-    cy_en_scb_i2c_status_t errorStatus;
-    uint32_t masterStatus;
-    /* Timeout 1 sec (one unit is us) */
-    uint32_t timeout = 1000000UL;
-    uint8_t buffer[READ_PACKET_SIZE];
+    uint8_t payload[STREAM_OPEN_PAYLOAD_SIZE];
+    uint8_t* operands = &payload[PROTO_OFS(proto_command_t, operands)];
 
-    /* Setup transfer specific parameters */
-    masterTransferCfg.buffer     = buffer;
-    masterTransferCfg.bufferSize = READ_PACKET_SIZE;
+    PROTO_PUT(proto_command_t, opcode, payload, CMD_OP_STREAM_OPEN);
+    PROTO_PUT(proto_stream_open_t, id, operands, master->streamId);
+    PROTO_PUT(proto_stream_open_t, size, operands, master->streamSize);
+
+    master->txBuffer[PACKET_ADDR_POS] = (uint8_t)EZI2C_CMD_FRAME_POS;
+    master->ackSeq = master->txSeq;
+    master->ackPending = true;
+    return (WriteEzI2C(master, master->txBuffer,
+                       1UL + BuildFrame(&master->txBuffer[PACKET_SOP_POS], master->txSeq++,
+                                        payload, STREAM_OPEN_PAYLOAD_SIZE),
+                       true));
+}
+
+/*******************************************************************************
+* Function Name: WriteStreamChunks
+****************************************************************************//**
+*
+* Summary:
+*   Writes count chunks into consecutive stream slots starting at the slot
+*   of chunk master->streamSent in one write transaction. The slots must not wrap
+*   past the last one. A chunk written twice is dropped by the slave, so
+*   the write may be repeated after a failure.
+*
+* Parameters:
+*   master: Master handle
+*
+* Return:
+*   TRANSFER_CMPLT if the chunks were written, TRANSFER_ERROR otherwise.
+*
+*******************************************************************************/
+static uint8_t WriteStreamChunks(i2c_master_t* master, uint32_t count)
+{
+    uint8_t payload[STREAM_CHUNK_PAYLOAD];
+    uint32_t size = 0UL;
+    uint32_t offset;
+    uint32_t len;
+    uint32_t i;
+    uint32_t j;
 
-    /* Initiate read transaction */
-    errorStatus = Cy_SCB_I2C_MasterRead(CYBSP_I2C_HW, &masterTransferCfg, &CYBSP_I2C_context);
-    if(errorStatus == CY_SCB_I2C_SUCCESS)
+    master->txBuffer[PACKET_ADDR_POS] =
+        (uint8_t)(EZI2C_STREAM_BASE_POS + ((master->streamSent % EZI2C_STREAM_SLOTS) * EZI2C_STREAM_SLOT_SIZE));
+    for (i = 0UL; i < count; i++)
     {
-        /* Wait until master complete read transfer or time out has occurred */
-        do
+        offset = (master->streamSent + i) * STREAM_CHUNK_SIZE;
+        len    = master->streamSize - offset;
+        if (len > STREAM_CHUNK_SIZE)
+        {
+            len = STREAM_CHUNK_SIZE;
+        }
+
+        PROTO_PUT(proto_stream_chunk_t, offset, payload, offset);
+        for (j = 0UL; j < len; j++)
         {
-            masterStatus  = Cy_SCB_I2C_MasterGetStatus(CYBSP_I2C_HW, &CYBSP_I2C_context);
-            Cy_SysLib_DelayUs(CY_SCB_WAIT_1_UNIT);
-            timeout--;
+            payload[STREAM_OFFSET_SIZE + j] = master->streamData[offset + j];
+        }
+        size = (i * EZI2C_STREAM_SLOT_SIZE) +
+               BuildFrame(&master->txBuffer[1UL + (i * EZI2C_STREAM_SLOT_SIZE)], master->streamId, payload,
+                          STREAM_OFFSET_SIZE + len);
+    }
+
+    if (TRANSFER_CMPLT != WriteEzI2C(master, master->txBuffer, 1UL + size, true))
+    {
+        return (TRANSFER_ERROR);
+    }
+
+    master->streamSent += count;
+    return (TRANSFER_CMPLT);
+}
+
+/*******************************************************************************
+* Function Name: OpenStreamToEzI2C
+****************************************************************************//**
+*
+* Summary:
+*   Starts streaming a payload to the EzI2C slave: writes the open frame
+*   carrying a new stream id and the size. The chunks are sent by
+*   PumpStreamToEzI2C(). The data must stay valid until the stream
+*   completes.
+*
+* Parameters:
+*   master: Master handle
+*   data: Payload to stream
+*   size: Size of the payload, 1 to STREAM_MAX_SIZE bytes
+*
+* Return:
+*   TRANSFER_CMPLT if the stream was opened.
+*   TRANSFER_ERROR if the size is out of range or the write failed. The
+*   stream then stays open and PumpStreamToEzI2C() resends the open frame.
+*
+*******************************************************************************/
+uint8_t OpenStreamToEzI2C(i2c_master_t* master, uint8_t const* data, uint32_t size)
+{
+    if ((0UL == size) || (size > STREAM_MAX_SIZE))
+    {
+        return (TRANSFER_ERROR);
+    }
+
+    master->streamData   = data;
+    master->streamSize   = size;
+    master->streamChunks = (size + STREAM_CHUNK_SIZE - 1UL) / STREAM_CHUNK_SIZE;
+    master->streamSent   = 0UL;
+    master->streamAcked  = 0UL;
+    master->streamStalls = 0UL;
+    master->streamId++;
+    master->streamOpen   = true;
+    master->streamResync = false;
+
+    if (TRANSFER_CMPLT != WriteStreamOpen(master))
+    {
+        master->streamResync = true;
+        return (TRANSFER_ERROR);
+    }
+
+    return (TRANSFER_CMPLT);
+}
+
+/*******************************************************************************
+* Function Name: PumpStreamToEzI2C
+****************************************************************************//**
+*
+* Summary:
+*   Moves the open stream forward. Chunks are written until
+*   EZI2C_STREAM_SLOTS of them are unacknowledged, in one write transaction
+*   per contiguous run of slots. The stream status is read back only when
+*   the window is full, all chunks are sent or a write failed. When the
+*   acknowledgement does not move for STREAM_STALL_READS reads, the chunks
+*   from the first unacknowledged one are sent again, and the open frame
+*   too if the slave does not report the stream id. The slave main loop must
+*   run between calls to take the chunks out of the slots.
+*
+* Parameters:
+*   master: Master handle
+*
+* Return:
+*   TRANSFER_CMPLT once the slave has taken the whole stream.
+*   TRANSFER_PENDING if chunks are in flight.
+*   TRANSFER_ERROR if no stream is open or a transfer failed. The stream
+*   stays open and the next call resumes from the acknowledged chunk.
+*
+*******************************************************************************/
+uint8_t PumpStreamToEzI2C(i2c_master_t* master)
+{
+    uint8_t* ack = &master->rxBuffer[MASTER_RX_POS(EZI2C_STREAM_ACK_POS)];
+    uint8_t const* id = &master->rxBuffer[MASTER_RX_POS(EZI2C_STREAM_ID_POS)];
+    uint32_t count;
+    uint32_t run;
+
+    if (!master->streamOpen)
+    {
+        return (TRANSFER_ERROR);
+    }
 
-        } while ((0UL != (masterStatus & CY_SCB_I2C_MASTER_BUSY)) && (timeout > 0));
+    if (master->streamResync || ((master->streamSent - master->streamAcked) >= EZI2C_STREAM_SLOTS) ||
+        (master->streamSent == master->streamChunks))
+    {
+        if (READ_CMPLT != ReadEzI2C(master, (uint8_t)EZI2C_STREAM_ACK_POS, ack, EZI2C_STREAM_STATUS_SIZE))
+        {
+            master->streamResync = true;
+            return (TRANSFER_ERROR);
+        }
 
-        if (timeout <= 0)
+        if ((*id == master->streamId) && (*ack > master->streamAcked) && (*ack <= master->streamChunks))
         {
-            /* Timeout recovery */
-            Cy_SCB_I2C_Disable(CYBSP_I2C_HW, &CYBSP_I2C_context);
-            Cy_SCB_I2C_Enable(CYBSP_I2C_HW, &CYBSP_I2C_context);
+            master->streamAcked  = *ack;
+            master->streamStalls = 0UL;
         }
-        else
+        else if (++master->streamStalls >= STREAM_STALL_READS)
         {
-            /* Check transfer status */
-            if (0u == (MASTER_ERROR_MASK & masterStatus))
+            /* Go back to the first chunk the slave has not taken. */
+            master->streamStalls = 0UL;
+            if (*id != master->streamId)
             {
-                /* Check packet structure and status */
-                if((PACKET_SOP   == buffer[EZI2C_RPLY_SOP_POS]) &&
-                    (PACKET_EOP   == buffer[EZI2C_RPLY_EOP_POS]) &&
-                    (STS_CMD_DONE == buffer[EZI2C_RPLY_STS_POS]) )
+                if (TRANSFER_CMPLT != WriteStreamOpen(master))
                 {
-                    status = TRANSFER_CMPLT;
+                    master->streamResync = true;
+                    return (TRANSFER_ERROR);
                 }
+                master->streamAcked = 0UL;
             }
+            master->streamResync = true;
+        }
+        else
+        {
+            /* Give the slave another pass */
+        }
+
+        if (master->streamResync)
+        {
+            master->streamResends += master->streamSent - master->streamAcked;
+            master->streamSent     = master->streamAcked;
+            master->streamResync   = false;
         }
     }
-    return (status);
 
+    if (master->streamAcked == master->streamChunks)
+    {
+        master->streamOpen = false;
+        return (TRANSFER_CMPLT);
+    }
+
+    count = master->streamAcked + EZI2C_STREAM_SLOTS;
+    if (count > master->streamChunks)
+    {
+        count = master->streamChunks;
+    }
+    count -= master->streamSent;
+    if (0UL == count)
+    {
+        return (TRANSFER_PENDING);
+    }
+
+    run = EZI2C_STREAM_SLOTS - (master->streamSent % EZI2C_STREAM_SLOTS);
+    if (run > count)
+    {
+        run = count;
+    }
+    if ((TRANSFER_CMPLT != WriteStreamChunks(master, run)) ||
+        ((run < count) && (TRANSFER_CMPLT != WriteStreamChunks(master, count - run))))
+    {
+        master->streamResync = true;
+        return (TRANSFER_ERROR);
+    }
+
+    return (TRANSFER_PENDING);
 }
 
 /*******************************************************************************
-* Function Name: initMaster
+* Function Name: GetStreamResends
+****************************************************************************//**
+*
+* Summary:
+*   Returns the number of stream chunks scheduled again after a failed write
+*   or a stalled acknowledgement, since reset.
+*
+* Parameters:
+*   master: Master handle
+*
+*******************************************************************************/
+uint32_t GetStreamResends(i2c_master_t const* master)
+{
+    return (master->streamResends);
+}
+
+/*******************************************************************************
+* Function Name: GetRecoveryStats
+****************************************************************************//**
+*
+* Summary:
+*   Returns the failure and recovery counters of the blocking functions of
+*   a master, since initMasterHandle().
+*
+* Parameters:
+*   master: Master handle
+*
+*******************************************************************************/
+i2c_recovery_stats_t const* GetRecoveryStats(i2c_master_t const* master)
+{
+    return (&master->recoveryStats);
+}
+
+/*******************************************************************************
+* Function Name: initMasterHandle
 ********************************************************************************
 *
 * Summary:
-*   This function initiates and enables master SCB
+*   Sets up a master handle for an SCB and initiates and enables the SCB in
+*   master mode. The handle addresses the EZI2C slave at I2C_SLAVE_ADDR and
+*   computes timeouts for I2C_DATA_RATE_HZ until told otherwise.
+*
+* Parameters:
+*   master: Handle to set up, must stay valid while the SCB is in use
+*   hw: Hardware of the SCB
+*   rxBuffer: MASTER_RX_SIZE bytes of caller memory the status reads land in
 *
 * Return:
 *   Status of initialization
 *
 *******************************************************************************/
-uint32_t initMaster(void)
+uint32_t initMasterHandle(i2c_master_t* master, i2c_master_hw_t const* hw, uint8_t* rxBuffer)
 {
     cy_en_scb_i2c_status_t initStatus;
     cy_en_sysint_status_t sysStatus;
-    cy_stc_sysint_t CYBSP_I2C_SCB_IRQ_cfg =
+    uint32_t i;
+    cy_stc_sysint_t irqCfg =
     {
-            /*.intrSrc =*/ CYBSP_I2C_IRQ,
-            /*.intrPriority =*/ 3u
+            /*.intrSrc =*/ hw->irq,
+            /*.intrPriority =*/ I2C_INTR_PRIORITY
     };
 
+    master->hw       = hw;
+    master->rxBuffer = rxBuffer;
+    master->xferConfig.slaveAddress = I2C_SLAVE_ADDR;
+    master->xferConfig.buffer       = NULL;
+    master->xferConfig.bufferSize   = 0U;
+    master->xferConfig.xferPending  = false;
+    master->xferStatus    = TRANSFER_CMPLT;
+    master->xferCallback  = NULL;
+    master->xferChained   = false;
+    master->xferFault     = 0UL;
+    master->recoveryStats = (i2c_recovery_stats_t){ 0UL };
+    master->record.sink   = NULL;
+    master->slaveAddress  = I2C_SLAVE_ADDR;
+    master->txSeq         = 0U;
+    master->ackSeq        = 0U;
+    master->ackPending    = false;
+    for (i = 0UL; i < MASTER_SEQ_SLAVES; i++)
+    {
+        master->seqSlaves[i].address = 0U;
+    }
+    master->dataRateHz    = I2C_DATA_RATE_HZ;
+    master->ringHead      = 0UL;
+    master->ringTail      = 0UL;
+    master->ringResync    = false;
+    master->streamResends = 0UL;
+    master->streamId      = 0U;
+    master->streamOpen    = false;
+    master->streamResync  = false;
+
     /*Initialize and enable the I2C in master mode*/
-    initStatus = Cy_SCB_I2C_Init(CYBSP_I2C_HW, &CYBSP_I2C_config, &CYBSP_I2C_context);
+    initStatus = Cy_SCB_I2C_Init(hw->base, hw->config, &master->context);
     if(initStatus != CY_SCB_I2C_SUCCESS)
     {
         return I2C_FAILURE;
     }
 
     /* Hook interrupt service routine */
-    sysStatus = Cy_SysInt_Init(&CYBSP_I2C_SCB_IRQ_cfg, &CYBSP_I2C_Interrupt);
+    sysStatus = Cy_SysInt_Init(&irqCfg, hw->isr);
     if(sysStatus != CY_SYSINT_SUCCESS)
     {
         return I2C_FAILURE;
     }
-    NVIC_EnableIRQ((IRQn_Type) CYBSP_I2C_SCB_IRQ_cfg.intrSrc);
-    Cy_SCB_I2C_Enable(CYBSP_I2C_HW, &CYBSP_I2C_context);
+    NVIC_EnableIRQ((IRQn_Type) irqCfg.intrSrc);
+    /* Transfer completion is reported through MasterEventCallback */
+    Cy_SCB_I2C_RegisterEventCallback(hw->base, &MasterEventCallback, &master->context);
+
+    /* Deep Sleep is refused while a transfer is on the bus */
+    master->deepSleepParams.base    = hw->base;
+    master->deepSleepParams.context = &master->context;
+    master->deepSleepCallback.callback       = &Cy_SCB_I2C_DeepSleepCallback;
+    master->deepSleepCallback.type           = CY_SYSPM_DEEPSLEEP;
+    master->deepSleepCallback.skipMode       = 0UL;
+    master->deepSleepCallback.callbackParams = &master->deepSleepParams;
+    master->deepSleepCallback.prevItm        = NULL;
+    master->deepSleepCallback.nextItm        = NULL;
+    master->deepSleepCallback.order          = 1U;
+    if (!Cy_SysPm_RegisterCallback(&master->deepSleepCallback))
+    {
+        return I2C_FAILURE;
+    }
+
+    Cy_SCB_I2C_Enable(hw->base, &master->context);
+
+    /* Microsecond clock for transfer deadlines */
+    initTime();
     return I2C_SUCCESS;
 }
 
+/*******************************************************************************
+* Function Name: initMaster
+********************************************************************************
+*
+* Summary:
+*   This function initiates and enables master SCB: sets up CYBSP_I2C_master
+*   for the CYBSP_I2C SCB.
+*
+* Return:
+*   Status of initialization
+*
+*******************************************************************************/
+uint32_t initMaster(void)
+{
+    return (initMasterHandle(&CYBSP_I2C_master, &CYBSP_I2C_master_hw, masterRxBuffer));
+}
 
+/* [] END OF FILE */
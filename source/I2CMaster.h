@@ -45,6 +45,10 @@
 
 #include "cy_pdl.h"
 #include "cybsp.h"
+#include "I2CPacket.h"
+#include "I2CInstrument.h"
+#include "I2CRecovery.h"
+#include "I2CRecord.h"
 
 /*******************************************************************************
 * Macros
@@ -54,24 +58,186 @@
 
 #define TRANSFER_CMPLT          (0x00UL)
 #define READ_CMPLT              (TRANSFER_CMPLT)
-/* Packet positions */
+#define TRANSFER_PENDING        (0x01UL)
+#define TRANSFER_STS_FAIL       (0x02UL)
+/* The status packet names an earlier frame: the command was delivered but
+ * the slave has not handled it yet. Read the status again after its pass.
+ */
+#define TRANSFER_STS_STALE      (0x03UL)
+#define TRANSFER_ERROR          (0xFFUL)
+#define READ_ERROR              (TRANSFER_ERROR)
+/* WaitMasterTransfer(): use the budget computed for the transfer in flight */
+#define TRANSFER_TIMEOUT_AUTO   (0UL)
+/* Command packet positions: EZI2C sub-address, then the command frame */
 #define PACKET_ADDR_POS         (0UL)
 #define PACKET_SOP_POS          (1UL)
-#define PACKET_STS_POS          (1UL)
-#define PACKET_CMD_POS          (2UL)
-#define PACKET_EOP_POS          (3UL)
-/* Start and end of packet markers */
-#define PACKET_SOP              (0x01UL)
-#define PACKET_EOP              (0x17UL)
-#define WRITE_PACKET_SIZE       (0x04UL)
-/* Start address of slave buffer */
-#define EZI2C_BUFFER_ADDRESS    (0x00)
+#define PACKET_SEQ_POS          (PACKET_SOP_POS + FRAME_SEQ_OFS)
+#define PACKET_OP_POS           (PACKET_SOP_POS + FRAME_PAYLOAD_OFS + PROTO_OFS(proto_command_t, opcode))
+/* First operand; the LED state of PrepareCommandPacket() */
+#define PACKET_CMD_POS          (PACKET_SOP_POS + FRAME_PAYLOAD_OFS + PROTO_OFS(proto_command_t, operands))
+#define WRITE_PACKET_SIZE       (1UL + FRAME_SIZE(PROTO_SIZE(proto_command_t)))
+/* Slots of the command ring in the slave buffer; one slot is kept free to
+ * tell a full ring from an empty one.
+ */
+#define COMMAND_RING_SLOTS      (EZI2C_RING_SLOTS)
+#define COMMAND_RING_MAX_BATCH  (COMMAND_RING_SLOTS - 1UL)
+/* The status region of the slave buffer, from the ring tail to the stream
+ * status, is read into the RX buffer of the handle at the same positions:
+ * the reply packet of ReadStatusPacketFromEzI2C() is at
+ * MASTER_RX_POS(EZI2C_RPLY_SOP_POS).
+ */
+#define MASTER_RX_SIZE          (EZI2C_STREAM_STS_POS - EZI2C_RING_TAIL_POS + 1UL)
+#define MASTER_RX_POS(pos)      ((pos) - EZI2C_RING_TAIL_POS)
+/* Staging buffer of a handle: a sub-address and a run of ring or stream slots */
+#define MASTER_TX_SIZE          (1UL + (EZI2C_STREAM_SLOTS * EZI2C_STREAM_SLOT_SIZE))
+/* Slaves besides the selected one whose sequence counters a handle keeps */
+#define MASTER_SEQ_SLAVES       (8UL)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Transfer completion callback, called from the I2C master ISR with
+ * TRANSFER_CMPLT, TRANSFER_STS_FAIL, TRANSFER_STS_STALE or TRANSFER_ERROR.
+ */
+typedef void (*i2c_master_callback_t)(uint8_t status);
+
+/* Sequence counters of a slave that is not selected. A free entry has
+ * address 0, the general call address.
+ */
+typedef struct
+{
+    uint8_t                         address;
+    uint8_t                         txSeq;
+    uint8_t                         ackSeq;
+    bool                            ackPending;
+} i2c_master_seq_t;
+
+/* Hardware of one master SCB. isr is hooked to irq and must call
+ * MasterInterrupt() with the handle of the SCB.
+ */
+typedef struct
+{
+    CySCB_Type*                     base;
+    cy_stc_scb_i2c_config_t const*  config;
+    IRQn_Type                       irq;
+    cy_israddress                   isr;
+    cy_en_divider_types_t           clkDivType;     /* Peripheral clock divider of the SCB */
+    uint32_t                        clkDivNum;
+    i2c_bus_pins_t                  pins;
+} i2c_master_hw_t;
+
+/* Master driver handle. Every function of the driver works on the handle it
+ * is given, so one image drives several master SCBs. Set up with
+ * initMasterHandle(); the fields are owned by the driver except rxBuffer,
+ * which the caller reads.
+ */
+typedef struct
+{
+    i2c_master_hw_t const*              hw;
+    cy_stc_scb_i2c_context_t            context;
+    cy_stc_scb_i2c_master_xfer_config_t xferConfig;
+    uint8_t*                            rxBuffer;       /* Caller memory, MASTER_RX_SIZE bytes */
+
+    /* Transfer in flight, updated from the master ISR */
+    volatile uint8_t        xferStatus;
+    i2c_master_callback_t   xferCallback;
+    uint32_t                xferSize;
+    uint32_t                xferTimeoutUs;
+    uint32_t                xferFault;      /* MASTER_ERROR_MASK or I2C_MASTER_TIMEOUT bits */
+    bool                    xferChained;    /* A read follows with a repeated START */
+    bool                    xferCombined;   /* Status + command transaction */
+    uint8_t                 subAddress;
+    uint8_t*                chainBuffer;
+    uint32_t                chainSize;
+    uint8_t const*          xferReply;      /* Status packet checked on completion */
+    uint8_t*                commandBuffer;  /* Written after the status packet */
+    uint32_t                commandSize;
+    uint8_t                 commandAck;     /* Status of the frame before */
+    i2c_record_t            record;         /* Transfer log, see SetMasterRecorder() */
+#if I2C_INSTRUMENT
+    uint32_t                instrXferStart; /* First MasterWrite of the transfer in flight */
+#endif
+    i2c_recovery_stats_t    recoveryStats;  /* Failures of the blocking functions */
+
+    /* Selected slave and its sequence counters. Each slave drops a frame
+     * that repeats its last one, so every slave has its own counter.
+     */
+    uint8_t                 slaveAddress;
+    uint8_t                 txSeq;
+    uint8_t                 ackSeq;         /* Frame the next status packet must name */
+    bool                    ackPending;     /* ackSeq is not acknowledged yet */
+    i2c_master_seq_t        seqSlaves[MASTER_SEQ_SLAVES];
+    uint32_t                dataRateHz;
+
+    /* Command ring */
+    uint32_t                ringHead;
+    uint32_t                ringTail;
+    bool                    ringResync;
+
+    /* Stream in flight, counted in chunks */
+    uint8_t const*          streamData;
+    uint32_t                streamSize;
+    uint32_t                streamChunks;
+    uint32_t                streamSent;
+    uint32_t                streamAcked;
+    uint32_t                streamStalls;
+    uint32_t                streamResends;
+    uint8_t                 streamId;
+    bool                    streamOpen;
+    bool                    streamResync;
+
+    uint8_t                             txBuffer[MASTER_TX_SIZE];
+    cy_stc_syspm_callback_params_t      deepSleepParams;
+    cy_stc_syspm_callback_t             deepSleepCallback;
+} i2c_master_t;
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Master on the CYBSP_I2C SCB, set up by initMaster() */
+extern i2c_master_t CYBSP_I2C_master;
 
 /*******************************************************************************
 * Function Prototypes
 *******************************************************************************/
-uint8_t WritePacketToEzI2C(uint8_t* writebuffer, uint32_t bufferSize);
-uint8_t ReadStatusPacketFromEzI2C(void);
+uint32_t PrepareCommandPacket(i2c_master_t* master, uint8_t* writebuffer, uint8_t cmd);
+uint32_t PrepareOpcodePacket(i2c_master_t* master, uint8_t* writebuffer, uint8_t opcode,
+                             uint8_t const* operands, uint32_t count);
+uint8_t WritePacketToEzI2C(i2c_master_t* master, uint8_t* writebuffer, uint32_t bufferSize);
+uint8_t ReadStatusPacketFromEzI2C(i2c_master_t* master);
+uint8_t ReadCommandResult(i2c_master_t* master, uint32_t* result);
+uint8_t WritePacketToEzI2CAsync(i2c_master_t* master, uint8_t* writebuffer, uint32_t bufferSize,
+                                i2c_master_callback_t callback);
+uint8_t ReadStatusPacketFromEzI2CAsync(i2c_master_t* master, i2c_master_callback_t callback);
+uint8_t ReadEzI2C(i2c_master_t* master, uint8_t offset, uint8_t* readbuffer, uint32_t size);
+uint8_t ReadEzI2CAsync(i2c_master_t* master, uint8_t offset, uint8_t* readbuffer, uint32_t size,
+                       i2c_master_callback_t callback);
+uint8_t ReadTelemetryFromEzI2C(i2c_master_t* master, uint8_t offset, uint8_t* readbuffer, uint32_t size);
+uint8_t ReadTelemetryFromEzI2CAsync(i2c_master_t* master, uint8_t offset, uint8_t* readbuffer, uint32_t size,
+                                    i2c_master_callback_t callback);
+uint8_t WriteCommandReadStatus(i2c_master_t* master, uint8_t* writebuffer, uint32_t bufferSize);
+uint8_t WriteCommandReadStatusAsync(i2c_master_t* master, uint8_t* writebuffer, uint32_t bufferSize,
+                                    i2c_master_callback_t callback);
+uint8_t PushCommandsToEzI2C(i2c_master_t* master, uint8_t const* commands, uint32_t count);
+uint8_t ReadCommandRingStatus(i2c_master_t* master);
+uint8_t OpenStreamToEzI2C(i2c_master_t* master, uint8_t const* data, uint32_t size);
+uint8_t PumpStreamToEzI2C(i2c_master_t* master);
+uint32_t GetStreamResends(i2c_master_t const* master);
+i2c_recovery_stats_t const* GetRecoveryStats(i2c_master_t const* master);
+uint8_t SelectEzI2CSlave(i2c_master_t* master, uint8_t slaveAddress);
+uint8_t GetMasterTransferStatus(i2c_master_t const* master);
+uint32_t GetMasterTransferTimeoutUs(i2c_master_t const* master);
+uint8_t WaitMasterTransfer(i2c_master_t* master, uint32_t timeoutUs);
+void SetMasterDataRate(i2c_master_t* master, uint32_t dataRateHz);
+#if I2C_RECORD
+void SetMasterRecorder(i2c_master_t* master, i2c_record_sink_t sink);
+#endif
+uint32_t ConfigureMasterDataRate(i2c_master_t* master, uint32_t dataRateHz);
+uint32_t RecoverMasterBus(i2c_master_t* master);
+void AbortMasterTransfer(i2c_master_t* master);
+void MasterInterrupt(i2c_master_t* master);
+void CYBSP_I2C_Interrupt(void);
+uint32_t initMasterHandle(i2c_master_t* master, i2c_master_hw_t const* hw, uint8_t* rxBuffer);
 uint32_t initMaster(void);
 
 #endif /* SOURCE_I2CMASTER_H_ */
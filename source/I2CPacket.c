@@ -0,0 +1,184 @@
+/******************************************************************************
+* File Name:   I2CPacket.c
+*
+* Description: This file contains the CRC-8 and the frame encoder and
+*              checker shared by the I2C master and the EZI2C slave.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include "I2CPacket.h"
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* CRC-8, polynomial 0x07: one lookup per byte, so checking a frame takes the
+ * same time whatever its contents.
+ */
+static const uint8_t crc8Table[256] =
+{
+    0x00U, 0x07U, 0x0EU, 0x09U, 0x1CU, 0x1BU, 0x12U, 0x15U,
+    0x38U, 0x3FU, 0x36U, 0x31U, 0x24U, 0x23U, 0x2AU, 0x2DU,
+    0x70U, 0x77U, 0x7EU, 0x79U, 0x6CU, 0x6BU, 0x62U, 0x65U,
+    0x48U, 0x4FU, 0x46U, 0x41U, 0x54U, 0x53U, 0x5AU, 0x5DU,
+    0xE0U, 0xE7U, 0xEEU, 0xE9U, 0xFCU, 0xFBU, 0xF2U, 0xF5U,
+    0xD8U, 0xDFU, 0xD6U, 0xD1U, 0xC4U, 0xC3U, 0xCAU, 0xCDU,
+    0x90U, 0x97U, 0x9EU, 0x99U, 0x8CU, 0x8BU, 0x82U, 0x85U,
+    0xA8U, 0xAFU, 0xA6U, 0xA1U, 0xB4U, 0xB3U, 0xBAU, 0xBDU,
+    0xC7U, 0xC0U, 0xC9U, 0xCEU, 0xDBU, 0xDCU, 0xD5U, 0xD2U,
+    0xFFU, 0xF8U, 0xF1U, 0xF6U, 0xE3U, 0xE4U, 0xEDU, 0xEAU,
+    0xB7U, 0xB0U, 0xB9U, 0xBEU, 0xABU, 0xACU, 0xA5U, 0xA2U,
+    0x8FU, 0x88U, 0x81U, 0x86U, 0x93U, 0x94U, 0x9DU, 0x9AU,
+    0x27U, 0x20U, 0x29U, 0x2EU, 0x3BU, 0x3CU, 0x35U, 0x32U,
+    0x1FU, 0x18U, 0x11U, 0x16U, 0x03U, 0x04U, 0x0DU, 0x0AU,
+    0x57U, 0x50U, 0x59U, 0x5EU, 0x4BU, 0x4CU, 0x45U, 0x42U,
+    0x6FU, 0x68U, 0x61U, 0x66U, 0x73U, 0x74U, 0x7DU, 0x7AU,
+    0x89U, 0x8EU, 0x87U, 0x80U, 0x95U, 0x92U, 0x9BU, 0x9CU,
+    0xB1U, 0xB6U, 0xBFU, 0xB8U, 0xADU, 0xAAU, 0xA3U, 0xA4U,
+    0xF9U, 0xFEU, 0xF7U, 0xF0U, 0xE5U, 0xE2U, 0xEBU, 0xECU,
+    0xC1U, 0xC6U, 0xCFU, 0xC8U, 0xDDU, 0xDAU, 0xD3U, 0xD4U,
+    0x69U, 0x6EU, 0x67U, 0x60U, 0x75U, 0x72U, 0x7BU, 0x7CU,
+    0x51U, 0x56U, 0x5FU, 0x58U, 0x4DU, 0x4AU, 0x43U, 0x44U,
+    0x19U, 0x1EU, 0x17U, 0x10U, 0x05U, 0x02U, 0x0BU, 0x0CU,
+    0x21U, 0x26U, 0x2FU, 0x28U, 0x3DU, 0x3AU, 0x33U, 0x34U,
+    0x4EU, 0x49U, 0x40U, 0x47U, 0x52U, 0x55U, 0x5CU, 0x5BU,
+    0x76U, 0x71U, 0x78U, 0x7FU, 0x6AU, 0x6DU, 0x64U, 0x63U,
+    0x3EU, 0x39U, 0x30U, 0x37U, 0x22U, 0x25U, 0x2CU, 0x2BU,
+    0x06U, 0x01U, 0x08U, 0x0FU, 0x1AU, 0x1DU, 0x14U, 0x13U,
+    0xAEU, 0xA9U, 0xA0U, 0xA7U, 0xB2U, 0xB5U, 0xBCU, 0xBBU,
+    0x96U, 0x91U, 0x98U, 0x9FU, 0x8AU, 0x8DU, 0x84U, 0x83U,
+    0xDEU, 0xD9U, 0xD0U, 0xD7U, 0xC2U, 0xC5U, 0xCCU, 0xCBU,
+    0xE6U, 0xE1U, 0xE8U, 0xEFU, 0xFAU, 0xFDU, 0xF4U, 0xF3U
+};
+
+/*******************************************************************************
+* Function Name: Crc8
+****************************************************************************//**
+*
+* Summary:
+*   Computes the CRC-8 of a block of bytes.
+*
+* Parameters:
+*   data: Bytes to cover
+*   size: Number of bytes
+*
+* Return:
+*   CRC-8 (initial value 0x00, no final XOR).
+*
+*******************************************************************************/
+uint8_t Crc8(uint8_t const* data, uint32_t size)
+{
+    uint8_t crc = 0U;
+    uint32_t i;
+
+    for (i = 0UL; i < size; i++)
+    {
+        crc = crc8Table[crc ^ data[i]];
+    }
+
+    return (crc);
+}
+
+/*******************************************************************************
+* Function Name: BuildFrame
+****************************************************************************//**
+*
+* Summary:
+*   Encodes a payload as a frame.
+*
+* Parameters:
+*   frame: Storage for FRAME_SIZE(size) bytes
+*   seq: Sequence number of the frame
+*   payload: Payload bytes
+*   size: Number of payload bytes
+*
+* Return:
+*   Size of the frame in bytes.
+*
+*******************************************************************************/
+uint32_t BuildFrame(uint8_t* frame, uint8_t seq, uint8_t const* payload, uint32_t size)
+{
+    uint32_t i;
+
+    frame[FRAME_SOP_OFS] = PACKET_SOP;
+    frame[FRAME_LEN_OFS] = (uint8_t)size;
+    frame[FRAME_SEQ_OFS] = seq;
+    for (i = 0UL; i < size; i++)
+    {
+        frame[FRAME_PAYLOAD_OFS + i] = payload[i];
+    }
+    frame[FRAME_CRC_OFS(size)] = Crc8(&frame[FRAME_LEN_OFS], size + 2UL);
+    frame[FRAME_EOP_OFS(size)] = PACKET_EOP;
+
+    return (FRAME_SIZE(size));
+}
+
+/*******************************************************************************
+* Function Name: CheckFrame
+****************************************************************************//**
+*
+* Summary:
+*   Checks the length, end marker and CRC of a frame that starts with
+*   PACKET_SOP. Duplicate detection is left to the receiver.
+*
+* Parameters:
+*   frame: Frame to check
+*   maxPayload: Largest payload that fits where the frame was received
+*
+* Return:
+*   STS_CMD_DONE if the frame is intact, STS_CMD_BAD_LEN if the length is out
+*   of range or the end marker is not where the length puts it, or
+*   STS_CMD_BAD_CRC.
+*
+*******************************************************************************/
+uint8_t CheckFrame(uint8_t const* frame, uint32_t maxPayload)
+{
+    uint32_t len = frame[FRAME_LEN_OFS];
+
+    if ((0UL == len) || (len > maxPayload) || (PACKET_EOP != frame[FRAME_EOP_OFS(len)]))
+    {
+        return (STS_CMD_BAD_LEN);
+    }
+    if (Crc8(&frame[FRAME_LEN_OFS], len + 2UL) != frame[FRAME_CRC_OFS(len)])
+    {
+        return (STS_CMD_BAD_CRC);
+    }
+
+    return (STS_CMD_DONE);
+}
+
+/* [] END OF FILE */
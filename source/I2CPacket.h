@@ -0,0 +1,390 @@
+/******************************************************************************
+* File Name:   I2CPacket.h
+*
+* Description: This file provides the packet format and the EZI2C buffer
+*              layout shared by the I2C master and the EZI2C slave, described
+*              once with compile-time layout checks and field codecs.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SOURCE_I2CPACKET_H_
+#define SOURCE_I2CPACKET_H_
+
+#include <stddef.h>
+#include "cy_pdl.h"
+#include "I2CTuning.h"
+
+/*******************************************************************************
+* Protocol description
+*******************************************************************************/
+/* Every message of the protocol is described once, below, as a list of
+ * X(field, bytes) entries in wire order. PROTO_LAYOUT_FIELD() turns a list
+ * into a struct of byte arrays, so the offset of every field and the size
+ * of the message come from the compiler and fields can neither overlap nor
+ * leave gaps. Master and slave encode and decode a field with PROTO_PUT()
+ * and PROTO_GET(): with its offset and width known at compile time, a
+ * field costs one store or load per byte, and adding a field costs nothing
+ * where it is not used. Multi-byte fields are little-endian.
+ */
+#define PROTO_LAYOUT_FIELD(field, bytes)    uint8_t field[bytes];
+#define PROTO_SUM_FIELD(field, bytes)       + (bytes)
+
+#define PROTO_OFS(msg, field)   ((uint32_t)offsetof(msg, field))
+#define PROTO_LEN(msg, field)   ((uint32_t)sizeof(((msg*)0)->field))
+#define PROTO_SIZE(msg)         ((uint32_t)sizeof(msg))
+
+#define PROTO_PUT(msg, field, buf, value) \
+    ProtoPut(&(buf)[PROTO_OFS(msg, field)], PROTO_LEN(msg, field), (uint32_t)(value))
+#define PROTO_GET(msg, field, buf) \
+    ProtoGet(&(buf)[PROTO_OFS(msg, field)], PROTO_LEN(msg, field))
+
+/* Compile-time check of the layout */
+#define PROTO_ASSERT(cond, msg) _Static_assert(cond, msg)
+#define PROTO_ASSERT_PACKED(msg, fields) \
+    PROTO_ASSERT(PROTO_SIZE(msg) == (0UL fields(PROTO_SUM_FIELD)), #msg " is padded")
+
+/* Frame header: SOP, LEN, SEQ, then LEN payload bytes, CRC-8 over LEN, SEQ
+ * and the payload, and EOP. The CRC is CRC-8 with polynomial 0x07 (SMBus
+ * PEC).
+ */
+#define PROTO_FRAME_HDR(X)      \
+    X(sop,          1)          \
+    X(len,          1)          \
+    X(seq,          1)
+typedef struct { PROTO_FRAME_HDR(PROTO_LAYOUT_FIELD) } proto_frame_hdr_t;
+
+/* Command payload: a CMD_OP_* opcode, then the operands of the opcode.
+ * The operands of each opcode are described below; a command carries
+ * exactly as many operand bytes as its description has.
+ */
+#define CMD_OPERANDS_MAX        (3UL)
+#define PROTO_COMMAND(X)        \
+    X(opcode,       1)          \
+    X(operands,     CMD_OPERANDS_MAX)
+typedef struct { PROTO_COMMAND(PROTO_LAYOUT_FIELD) } proto_command_t;
+
+/* CMD_OP_PING: a token the slave echoes as the result */
+#define PROTO_OP_PING(X)        \
+    X(token,        1)
+typedef struct { PROTO_OP_PING(PROTO_LAYOUT_FIELD) } proto_op_ping_t;
+
+/* CMD_OP_LED: the LED state */
+#define PROTO_OP_LED(X)         \
+    X(state,        1)
+typedef struct { PROTO_OP_LED(PROTO_LAYOUT_FIELD) } proto_op_led_t;
+
+/* CMD_OP_GPIO_READ, CMD_OP_REG_READ, CMD_OP_COUNTER_READ and
+ * CMD_OP_COUNTER_CLEAR: the pin, register or counter
+ */
+#define PROTO_OP_SELECT(X)      \
+    X(index,        1)
+typedef struct { PROTO_OP_SELECT(PROTO_LAYOUT_FIELD) } proto_op_select_t;
+
+/* CMD_OP_GPIO_WRITE: the pin and the level to drive */
+#define PROTO_OP_GPIO_WRITE(X)  \
+    X(pin,          1)          \
+    X(level,        1)
+typedef struct { PROTO_OP_GPIO_WRITE(PROTO_LAYOUT_FIELD) } proto_op_gpio_write_t;
+
+/* CMD_OP_REG_WRITE: the register and its new value */
+#define PROTO_OP_REG_WRITE(X)   \
+    X(reg,          1)          \
+    X(value,        2)
+typedef struct { PROTO_OP_REG_WRITE(PROTO_LAYOUT_FIELD) } proto_op_reg_write_t;
+
+/* CMD_OP_STREAM_OPEN, written at EZI2C_CMD_FRAME_POS: the stream id the
+ * chunks will carry and the total size
+ */
+#define PROTO_STREAM_OPEN(X)    \
+    X(id,           1)          \
+    X(size,         2)
+typedef struct { PROTO_STREAM_OPEN(PROTO_LAYOUT_FIELD) } proto_stream_open_t;
+
+/* Stream chunk payload, written into a stream slot: the byte offset of the
+ * chunk, then STREAM_CHUNK_SIZE data bytes (fewer for the last chunk). SEQ
+ * of the frame carries the stream id.
+ */
+#define PROTO_STREAM_CHUNK(X)   \
+    X(offset,       2)
+typedef struct { PROTO_STREAM_CHUNK(PROTO_LAYOUT_FIELD) } proto_stream_chunk_t;
+
+/* Status packet of the slave: the sequence number of the last command
+ * frame handled and the status of the pass that handled it, so the master
+ * tells the reply to its own frame from the reply to an earlier one. The
+ * sequence number is checked against a known value, so it also closes the
+ * packet; the buffer has no room for an end marker.
+ */
+#define PROTO_REPLY(X)          \
+    X(sop,          1)          \
+    X(seq,          1)          \
+    X(sts,          1)
+typedef struct { PROTO_REPLY(PROTO_LAYOUT_FIELD) } proto_reply_t;
+
+/* Result of the last command executed, written by its handler; zero for a
+ * command without a result
+ */
+#define PROTO_RESULT(X)         \
+    X(value,        4)
+typedef struct { PROTO_RESULT(PROTO_LAYOUT_FIELD) } proto_result_t;
+
+/* Stream status of the slave: chunks received in order, the id of the
+ * stream and the status of the last chunk handled
+ */
+#define PROTO_STREAM_STATUS(X)  \
+    X(ack,          1)          \
+    X(id,           1)          \
+    X(sts,          1)
+typedef struct { PROTO_STREAM_STATUS(PROTO_LAYOUT_FIELD) } proto_stream_status_t;
+
+/* Telemetry window, read-only at the second EZI2C address. The latency
+ * histograms and the end sequence byte follow (see I2CSlave.h).
+ */
+#define PROTO_TELEMETRY(X)      \
+    X(seq,          1)          \
+    X(led_state,    1)          \
+    X(last_sts,     1)          \
+    X(reserved,     1)          \
+    X(commands,     4)          \
+    X(writes,       4)          \
+    X(rejected,     4)          \
+    X(bus_errors,   4)
+typedef struct { PROTO_TELEMETRY(PROTO_LAYOUT_FIELD) } proto_telemetry_t;
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Start and end of packet markers */
+#define PACKET_SOP              (0x01UL)
+#define PACKET_EOP              (0x17UL)
+
+/* Frame positions */
+#define FRAME_SOP_OFS           (PROTO_OFS(proto_frame_hdr_t, sop))
+#define FRAME_LEN_OFS           (PROTO_OFS(proto_frame_hdr_t, len))
+#define FRAME_SEQ_OFS           (PROTO_OFS(proto_frame_hdr_t, seq))
+#define FRAME_PAYLOAD_OFS       (PROTO_SIZE(proto_frame_hdr_t))
+#define FRAME_CRC_OFS(len)      (FRAME_PAYLOAD_OFS + (len))
+#define FRAME_EOP_OFS(len)      (FRAME_PAYLOAD_OFS + (len) + 1UL)
+#define FRAME_SIZE(len)         (FRAME_PAYLOAD_OFS + (len) + 2UL)
+
+/* Command frames. A command with one operand byte, such as CMD_OP_LED,
+ * fits a ring slot; larger ones go to EZI2C_CMD_FRAME_POS.
+ */
+#define CMD_PAYLOAD_SIZE(count) (PROTO_OFS(proto_command_t, operands) + (count))
+#define COMMAND_PAYLOAD_SIZE    (CMD_PAYLOAD_SIZE(1UL))
+#define COMMAND_FRAME_SIZE      (FRAME_SIZE(COMMAND_PAYLOAD_SIZE))
+
+/* Opcodes. The slave dispatches through a table indexed by opcode, so the
+ * cost of a command does not depend on how many opcodes there are. New
+ * opcodes are added before CMD_OP_COUNT.
+ */
+#define CMD_OP_PING             (0x00UL)
+#define CMD_OP_LED              (0x01UL)
+#define CMD_OP_GPIO_READ        (0x02UL)
+#define CMD_OP_GPIO_WRITE       (0x03UL)
+#define CMD_OP_REG_READ         (0x04UL)
+#define CMD_OP_REG_WRITE        (0x05UL)
+#define CMD_OP_COUNTER_READ     (0x06UL)
+#define CMD_OP_COUNTER_CLEAR    (0x07UL)
+#define CMD_OP_STREAM_OPEN      (0x08UL)
+#define CMD_OP_COUNT            (0x09UL)
+
+/* Operands of the GPIO, register and counter commands */
+#define CMD_GPIO_LED1           (0x00UL)
+#define CMD_GPIO_COUNT          (0x01UL)
+#define CMD_REG_COUNT           (8UL)
+#define CMD_COUNTER_COMMANDS    (0x00UL)
+#define CMD_COUNTER_WRITES      (0x01UL)
+#define CMD_COUNTER_REJECTED    (0x02UL)
+#define CMD_COUNTER_BUS_ERRORS  (0x03UL)
+#define CMD_COUNTER_COUNT       (0x04UL)
+
+/* Stream open and chunk frames. Chunk k of a stream goes to slot
+ * k % EZI2C_STREAM_SLOTS. The slave acknowledges whole chunks in one byte,
+ * so a stream has at most 255. The largest payload follows the SRAM of the
+ * part, from the i2c_tuning.h of the target.
+ */
+#define STREAM_OPEN_PAYLOAD_SIZE (CMD_PAYLOAD_SIZE(PROTO_SIZE(proto_stream_open_t)))
+#define STREAM_OFFSET_SIZE      (PROTO_SIZE(proto_stream_chunk_t))
+#define STREAM_CHUNK_SIZE       (24UL)
+#define STREAM_CHUNK_PAYLOAD    (STREAM_OFFSET_SIZE + STREAM_CHUNK_SIZE)
+#define STREAM_MAX_SIZE         (I2C_TUNING_STREAM_MAX_SIZE)
+
+/* Status reported in the reply packet */
+#define STS_CMD_DONE            (0x00UL)
+#define STS_CMD_BAD_LEN         (0x01UL)
+#define STS_CMD_BAD_CRC         (0x02UL)
+#define STS_CMD_DUPLICATE       (0x03UL)
+#define STS_CMD_BAD_OP          (0x04UL)    /* Unknown opcode or wrong operand count */
+#define STS_CMD_BAD_ARG         (0x05UL)    /* Operand out of range */
+#define STS_CMD_FAIL            (0xFFUL)
+
+/* Slots of the command ring and the stream window */
+#define EZI2C_RING_SLOTS        (16UL)
+#define EZI2C_RING_SLOT_SIZE    (COMMAND_FRAME_SIZE)
+#define EZI2C_STREAM_SLOTS      (4UL)
+#define EZI2C_STREAM_SLOT_SIZE  (FRAME_SIZE(STREAM_CHUNK_PAYLOAD))
+
+/* EZI2C buffer layout (offsets are EZI2C sub-addresses). The ring tail is
+ * directly followed by the reply packet so both are read in one access,
+ * and the result follows the reply for the same reason. The stream status
+ * comes last. The buffer must stay within the 8-bit sub-address range.
+ */
+#define PROTO_EZI2C_BUFFER(X)   \
+    X(cmd_frame,    FRAME_SIZE(PROTO_SIZE(proto_command_t)))        \
+    X(ring_tail,    1)          \
+    X(reply,        PROTO_SIZE(proto_reply_t))                      \
+    X(result,       PROTO_SIZE(proto_result_t))                     \
+    X(stream_status, PROTO_SIZE(proto_stream_status_t))             \
+    X(ring,         EZI2C_RING_SLOTS * EZI2C_RING_SLOT_SIZE)        \
+    X(stream,       EZI2C_STREAM_SLOTS * EZI2C_STREAM_SLOT_SIZE)
+typedef struct { PROTO_EZI2C_BUFFER(PROTO_LAYOUT_FIELD) } proto_ezi2c_buffer_t;
+
+#define EZI2C_CMD_FRAME_POS     (PROTO_OFS(proto_ezi2c_buffer_t, cmd_frame))
+#define EZI2C_RING_TAIL_POS     (PROTO_OFS(proto_ezi2c_buffer_t, ring_tail))
+#define EZI2C_RPLY_SOP_POS      (PROTO_OFS(proto_ezi2c_buffer_t, reply) + PROTO_OFS(proto_reply_t, sop))
+#define EZI2C_RPLY_SEQ_POS      (PROTO_OFS(proto_ezi2c_buffer_t, reply) + PROTO_OFS(proto_reply_t, seq))
+#define EZI2C_RPLY_STS_POS      (PROTO_OFS(proto_ezi2c_buffer_t, reply) + PROTO_OFS(proto_reply_t, sts))
+#define EZI2C_RESULT_POS        (PROTO_OFS(proto_ezi2c_buffer_t, result))
+#define EZI2C_STREAM_ACK_POS    (PROTO_OFS(proto_ezi2c_buffer_t, stream_status) + \
+                                 PROTO_OFS(proto_stream_status_t, ack))
+#define EZI2C_STREAM_ID_POS     (PROTO_OFS(proto_ezi2c_buffer_t, stream_status) + \
+                                 PROTO_OFS(proto_stream_status_t, id))
+#define EZI2C_STREAM_STS_POS    (PROTO_OFS(proto_ezi2c_buffer_t, stream_status) + \
+                                 PROTO_OFS(proto_stream_status_t, sts))
+#define EZI2C_STREAM_STATUS_SIZE (PROTO_SIZE(proto_stream_status_t))
+#define EZI2C_RING_BASE_POS     (PROTO_OFS(proto_ezi2c_buffer_t, ring))
+#define EZI2C_STREAM_BASE_POS   (PROTO_OFS(proto_ezi2c_buffer_t, stream))
+#define EZI2C_BUFFER_SIZE       (PROTO_SIZE(proto_ezi2c_buffer_t))
+
+/* Largest payload of a frame written at EZI2C_CMD_FRAME_POS */
+#define CMD_FRAME_MAX_PAYLOAD   (PROTO_LEN(proto_ezi2c_buffer_t, cmd_frame) - FRAME_SIZE(0UL))
+
+/*******************************************************************************
+* Layout checks
+*******************************************************************************/
+PROTO_ASSERT_PACKED(proto_frame_hdr_t, PROTO_FRAME_HDR);
+PROTO_ASSERT_PACKED(proto_command_t, PROTO_COMMAND);
+PROTO_ASSERT_PACKED(proto_op_ping_t, PROTO_OP_PING);
+PROTO_ASSERT_PACKED(proto_op_led_t, PROTO_OP_LED);
+PROTO_ASSERT_PACKED(proto_op_select_t, PROTO_OP_SELECT);
+PROTO_ASSERT_PACKED(proto_op_gpio_write_t, PROTO_OP_GPIO_WRITE);
+PROTO_ASSERT_PACKED(proto_op_reg_write_t, PROTO_OP_REG_WRITE);
+PROTO_ASSERT_PACKED(proto_stream_open_t, PROTO_STREAM_OPEN);
+PROTO_ASSERT_PACKED(proto_stream_chunk_t, PROTO_STREAM_CHUNK);
+PROTO_ASSERT_PACKED(proto_reply_t, PROTO_REPLY);
+PROTO_ASSERT_PACKED(proto_result_t, PROTO_RESULT);
+PROTO_ASSERT_PACKED(proto_stream_status_t, PROTO_STREAM_STATUS);
+PROTO_ASSERT_PACKED(proto_telemetry_t, PROTO_TELEMETRY);
+PROTO_ASSERT_PACKED(proto_ezi2c_buffer_t, PROTO_EZI2C_BUFFER);
+
+PROTO_ASSERT(EZI2C_BUFFER_SIZE <= 256UL, "EZI2C buffer exceeds the 8-bit sub-address range");
+PROTO_ASSERT(PROTO_SIZE(proto_command_t) <= CMD_FRAME_MAX_PAYLOAD, "command frame does not fit its area");
+PROTO_ASSERT(PROTO_SIZE(proto_op_gpio_write_t) <= CMD_OPERANDS_MAX, "GPIO write operands too large");
+PROTO_ASSERT(PROTO_SIZE(proto_op_reg_write_t) <= CMD_OPERANDS_MAX, "register write operands too large");
+PROTO_ASSERT(PROTO_SIZE(proto_stream_open_t) <= CMD_OPERANDS_MAX, "stream open operands too large");
+PROTO_ASSERT(PROTO_SIZE(proto_op_led_t) == (COMMAND_PAYLOAD_SIZE - CMD_PAYLOAD_SIZE(0UL)),
+             "LED command does not fit a ring slot");
+PROTO_ASSERT(EZI2C_RPLY_SOP_POS == (EZI2C_RING_TAIL_POS + 1UL), "reply must follow the ring tail");
+PROTO_ASSERT(EZI2C_RESULT_POS == (EZI2C_RPLY_STS_POS + 1UL), "result must follow the reply");
+PROTO_ASSERT(STREAM_CHUNK_PAYLOAD <= 0xFFUL, "chunk payload exceeds the frame length byte");
+PROTO_ASSERT(((STREAM_MAX_SIZE + STREAM_CHUNK_SIZE - 1UL) / STREAM_CHUNK_SIZE) <= 0xFFUL,
+             "stream chunks exceed the acknowledgement byte");
+PROTO_ASSERT(STREAM_MAX_SIZE <= 0xFFFFUL, "stream size exceeds the open frame field");
+
+/*******************************************************************************
+* Function Name: ProtoPut
+****************************************************************************//**
+*
+* Summary:
+*   Stores a field of 1 to 4 bytes little-endian. Called through PROTO_PUT()
+*   with a constant width, it compiles to the stores of the field only.
+*
+*******************************************************************************/
+__STATIC_INLINE void ProtoPut(uint8_t* field, uint32_t bytes, uint32_t value)
+{
+    field[0] = (uint8_t)value;
+    if (bytes > 1UL)
+    {
+        field[1] = (uint8_t)(value >> 8U);
+    }
+    if (bytes > 2UL)
+    {
+        field[2] = (uint8_t)(value >> 16U);
+    }
+    if (bytes > 3UL)
+    {
+        field[3] = (uint8_t)(value >> 24U);
+    }
+}
+
+/*******************************************************************************
+* Function Name: ProtoGet
+****************************************************************************//**
+*
+* Summary:
+*   Loads a little-endian field of 1 to 4 bytes. Called through PROTO_GET()
+*   with a constant width, it compiles to the loads of the field only.
+*
+*******************************************************************************/
+__STATIC_INLINE uint32_t ProtoGet(uint8_t const* field, uint32_t bytes)
+{
+    uint32_t value = field[0];
+
+    if (bytes > 1UL)
+    {
+        value |= (uint32_t)field[1] << 8U;
+    }
+    if (bytes > 2UL)
+    {
+        value |= (uint32_t)field[2] << 16U;
+    }
+    if (bytes > 3UL)
+    {
+        value |= (uint32_t)field[3] << 24U;
+    }
+
+    return (value);
+}
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint8_t Crc8(uint8_t const* data, uint32_t size);
+uint32_t BuildFrame(uint8_t* frame, uint8_t seq, uint8_t const* payload, uint32_t size);
+uint8_t CheckFrame(uint8_t const* frame, uint32_t maxPayload);
+
+#endif /* SOURCE_I2CPACKET_H_ */
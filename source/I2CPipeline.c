@@ -0,0 +1,343 @@
+/******************************************************************************
+* File Name:   I2CPipeline.c
+*
+* Description: This file contains the pipelined main loop. The application
+*              task builds commands at the configured rate, the master task
+*              sends them through the asynchronous master API and the slave
+*              task parses the EZI2C buffer. Each task advances on its own
+*              events and none of them waits. When a command is queued
+*              behind the one on the slave, one status + command transaction
+*              acknowledges the first and writes the second, so the slave
+*              executes a command while the application builds the next.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include "I2CPipeline.h"
+#include "I2CSlave.h"
+#include "I2CTime.h"
+#include "LowPower.h"
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static i2c_master_t* pipeMaster;
+static pipeline_command_t pipeProducer = NULL;
+static uint32_t pipePeriodMs;
+static pipeline_stats_t pipeStats;
+
+/* Command queue between the application and the master task. The master
+ * sends pipeFrames[pipeHead] until a status packet names it as executed;
+ * the application fills the slot after the last queued one.
+ */
+static uint8_t pipeFrames[PIPELINE_DEPTH][WRITE_PACKET_SIZE];
+static uint32_t pipeSizes[PIPELINE_DEPTH];
+static uint32_t pipeHead;
+static uint32_t pipeQueued;
+
+/* Transaction in flight, the time it was started and whether it writes the
+ * frame behind the head
+ */
+static bool pipeBusy = false;
+static uint32_t pipeStartUs;
+static bool pipeOverlap;
+
+/* The head frame is on the slave: the next transactions read its status
+ * without writing the frame again, until PIPELINE_STATUS_READS reads found
+ * it still unreported.
+ */
+static bool pipeWritten = false;
+static uint32_t pipeStatusReads;
+
+/*******************************************************************************
+* Function Declaration
+*******************************************************************************/
+static void RunApplicationTask(void);
+static bool RunMasterTask(void);
+
+/*******************************************************************************
+* Function Name: RunApplicationTask
+****************************************************************************//**
+*
+* Summary:
+*   Starts the next command period and has the producer build a command
+*   when a queue slot is free and the period is over. The period runs from
+*   one command to the next, so it sets the command rate whatever the wire
+*   time and the time the producer takes; with a period of 0 the commands go
+*   back to back. A producer with nothing to send is asked again at the end
+*   of the next period.
+*
+*******************************************************************************/
+static void RunApplicationTask(void)
+{
+    uint32_t slot;
+    uint32_t size;
+
+    if ((pipeQueued < PIPELINE_DEPTH) && IsIdleTimerExpired())
+    {
+        if (0UL != pipePeriodMs)
+        {
+            StartIdleTimer(pipePeriodMs);
+        }
+
+        slot = (pipeHead + pipeQueued) % PIPELINE_DEPTH;
+        size = pipeProducer(pipeMaster, pipeFrames[slot]);
+        if (0UL != size)
+        {
+            pipeSizes[slot] = size;
+            pipeQueued++;
+            pipeStats.issued++;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: RunMasterTask
+****************************************************************************//**
+*
+* Summary:
+*   Completes the transaction in flight, if it is over, and starts the next
+*   one. The head frame is written first and stays queued until a status
+*   packet names it. With a frame queued behind it, the status is read in a
+*   status + command transaction that writes that frame once the head is
+*   acknowledged, so the next frame goes out without a transaction of its
+*   own; otherwise the status is read alone. A good status releases the
+*   head. A rejected head frame is written again (the slave drops it if it
+*   was executed already), and so is one the slave has not reported after
+*   PIPELINE_STATUS_READS reads; until then a status packet that still names
+*   the frame before is read again after the slave task has run. A
+*   transaction that outlives its timeout budget is aborted. After a bus
+*   error the bus is recovered and nothing is started until the next call,
+*   so the caller can use the bus in between; the transaction is repeated
+*   then.
+*
+* Return:
+*   true if a transaction failed on the bus.
+*
+*******************************************************************************/
+static bool RunMasterTask(void)
+{
+    uint8_t status;
+
+    if (pipeBusy)
+    {
+        status = GetMasterTransferStatus(pipeMaster);
+        if (TRANSFER_PENDING == status)
+        {
+            if ((GetTimeUs() - pipeStartUs) <= GetMasterTransferTimeoutUs(pipeMaster))
+            {
+                return (false);
+            }
+            AbortMasterTransfer(pipeMaster);
+            status = TRANSFER_ERROR;
+        }
+        pipeBusy = false;
+
+        if ((TRANSFER_CMPLT == status) && pipeWritten)
+        {
+            /* Head acknowledged; the frame behind it is on the slave now
+             * if the transaction wrote it.
+             */
+            pipeHead = (pipeHead + 1UL) % PIPELINE_DEPTH;
+            pipeQueued--;
+            pipeStats.sent++;
+            pipeStatusReads = 0UL;
+            pipeWritten = pipeOverlap;
+            if (pipeOverlap)
+            {
+                pipeStats.overlapped++;
+            }
+        }
+        else if (TRANSFER_CMPLT == status)
+        {
+            pipeStatusReads = 0UL;
+            pipeWritten = true;
+        }
+        else if ((TRANSFER_STS_STALE == status) && (++pipeStatusReads < PIPELINE_STATUS_READS))
+        {
+            pipeStats.statusReads++;
+        }
+        else if ((TRANSFER_STS_FAIL == status) || (TRANSFER_STS_STALE == status))
+        {
+            pipeStats.resent++;
+            pipeWritten = false;
+        }
+        else
+        {
+            /* Nothing changes: the same transaction is started again */
+            pipeStats.errors++;
+            (void)RecoverMasterBus(pipeMaster);
+            return (true);
+        }
+    }
+
+    if (0UL != pipeQueued)
+    {
+        pipeStartUs = GetTimeUs();
+        pipeOverlap = pipeWritten && (pipeQueued > 1UL);
+        if (pipeOverlap)
+        {
+            status = WriteCommandReadStatusAsync(pipeMaster, pipeFrames[(pipeHead + 1UL) % PIPELINE_DEPTH],
+                                                 pipeSizes[(pipeHead + 1UL) % PIPELINE_DEPTH], NULL);
+        }
+        else if (pipeWritten)
+        {
+            status = ReadStatusPacketFromEzI2CAsync(pipeMaster, NULL);
+        }
+        else
+        {
+            status = WritePacketToEzI2CAsync(pipeMaster, pipeFrames[pipeHead], pipeSizes[pipeHead], NULL);
+        }
+        if (TRANSFER_PENDING != status)
+        {
+            pipeStats.errors++;
+            return (true);
+        }
+        pipeBusy = true;
+    }
+
+    return (false);
+}
+
+/*******************************************************************************
+* Function Name: initPipeline
+****************************************************************************//**
+*
+* Summary:
+*   Sets up the pipeline on a master. Call it after the master and the low
+*   power idle timer are set up; the idle timer paces the commands. The first
+*   command is due right away.
+*
+* Parameters:
+*   master: Master handle the commands are sent on
+*   producer: Application task that builds the commands
+*   periodMs: Time from one command to the next, 0 for back to back
+*
+* Return:
+*   I2C_SUCCESS, or I2C_FAILURE without a master or producer.
+*
+*******************************************************************************/
+uint32_t initPipeline(i2c_master_t* master, pipeline_command_t producer, uint32_t periodMs)
+{
+    if ((NULL == master) || (NULL == producer))
+    {
+        return (I2C_FAILURE);
+    }
+
+    pipeMaster   = master;
+    pipeProducer = producer;
+    pipeHead     = 0UL;
+    pipeQueued   = 0UL;
+    pipeBusy     = false;
+    pipeWritten  = false;
+    pipeStatusReads = 0UL;
+    pipeStats    = (pipeline_stats_t){ 0UL };
+    SetCommandPeriod(periodMs);
+
+    return (I2C_SUCCESS);
+}
+
+/*******************************************************************************
+* Function Name: SetCommandPeriod
+****************************************************************************//**
+*
+* Summary:
+*   Changes the time from one command to the next. The next command is due
+*   right away.
+*
+* Parameters:
+*   periodMs: Command period in ms, 0 for back to back
+*
+*******************************************************************************/
+void SetCommandPeriod(uint32_t periodMs)
+{
+    pipePeriodMs = periodMs;
+    StartIdleTimer(0UL);
+}
+
+/*******************************************************************************
+* Function Name: RunPipeline
+****************************************************************************//**
+*
+* Summary:
+*   Advances the application, master and slave tasks by one step each and
+*   returns without waiting. Call it from the main loop; while it returns
+*   PIPELINE_IDLE the device can wait in EnterLowPowerIdle() for the next
+*   command period.
+*
+* Return:
+*   PIPELINE_IDLE, PIPELINE_BUSY or PIPELINE_ERROR.
+*
+*******************************************************************************/
+uint32_t RunPipeline(void)
+{
+    bool failed;
+
+    if (NULL == pipeProducer)
+    {
+        return (PIPELINE_IDLE);
+    }
+
+    RunApplicationTask();
+    failed = RunMasterTask();
+
+    /* Slave task: executes the command written by the previous transaction
+     * while the next one is on the bus.
+     */
+    CheckEzI2Cbuffer();
+
+    if (failed)
+    {
+        return (PIPELINE_ERROR);
+    }
+    return ((pipeBusy || (0UL != pipeQueued)) ? PIPELINE_BUSY : PIPELINE_IDLE);
+}
+
+/*******************************************************************************
+* Function Name: GetPipelineStats
+****************************************************************************//**
+*
+* Summary:
+*   Returns the command counters of the pipeline.
+*
+*******************************************************************************/
+pipeline_stats_t const* GetPipelineStats(void)
+{
+    return (&pipeStats);
+}
+
+/* [] END OF FILE */
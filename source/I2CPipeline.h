@@ -0,0 +1,94 @@
+/******************************************************************************
+* File Name:   I2CPipeline.h
+*
+* Description: This file provides the command producer type, the run states
+*              and the statistics of the pipelined main loop.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SOURCE_I2CPIPELINE_H_
+#define SOURCE_I2CPIPELINE_H_
+
+#include "I2CMaster.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Result of RunPipeline() */
+#define PIPELINE_IDLE           (0UL)   /* Nothing to do until the next command is due */
+#define PIPELINE_BUSY           (1UL)   /* A transfer is on the bus or a command is queued */
+#define PIPELINE_ERROR          (2UL)   /* A transfer failed; it is repeated on the next call */
+
+/* Commands queued between the application and the master task: one on the
+ * slave waiting for its status, one on the bus behind it and one being
+ * prepared.
+ */
+#define PIPELINE_DEPTH          (3UL)
+
+/* Status reads of a frame the slave has not reported yet, before the frame
+ * is sent again
+ */
+#define PIPELINE_STATUS_READS   (4UL)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Application task: builds the next command packet into frame, for example
+ * with PrepareCommandPacket(), and returns its size, or 0 if there is no
+ * command to send.
+ */
+typedef uint32_t (*pipeline_command_t)(i2c_master_t* master, uint8_t* frame);
+
+typedef struct
+{
+    uint32_t issued;        /* Commands built by the application task */
+    uint32_t sent;          /* Commands delivered with a good status */
+    uint32_t resent;        /* Frames sent again after a rejection */
+    uint32_t statusReads;   /* Status read again before the slave reported the frame */
+    uint32_t errors;        /* Transactions that failed on the bus */
+    uint32_t overlapped;    /* Commands written in the transaction that acknowledged the one before */
+} pipeline_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint32_t initPipeline(i2c_master_t* master, pipeline_command_t producer, uint32_t periodMs);
+void SetCommandPeriod(uint32_t periodMs);
+uint32_t RunPipeline(void);
+pipeline_stats_t const* GetPipelineStats(void);
+
+#endif /* SOURCE_I2CPIPELINE_H_ */
@@ -0,0 +1,221 @@
+/******************************************************************************
+* File Name:   I2CRecord.c
+*
+* Description: This file contains the master transfer recorder: each
+*              transfer phase of a master handle, with its data, status and
+*              timing, encoded as a compact record and handed to a sink.
+*              The file is empty when I2C_RECORD is 0.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include "I2CRecord.h"
+#include "I2CTime.h"
+
+#if I2C_RECORD
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define VARINT_MORE         (0x80UL)
+#define VARINT_BITS         (7U)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Record being encoded, shared by all handles */
+static uint8_t recordBuffer[RECORD_SIZE_MAX];
+
+/*******************************************************************************
+* Function Declaration
+*******************************************************************************/
+static uint32_t PutVarint(uint8_t* out, uint32_t value);
+static void PutWord(uint8_t* out, uint32_t value);
+
+/*******************************************************************************
+* Function Name: PutVarint
+****************************************************************************//**
+*
+* Summary:
+*   Encodes a value 7 bits per byte, least significant first.
+*
+* Return:
+*   Number of bytes written, at most RECORD_VARINT_MAX.
+*
+*******************************************************************************/
+static uint32_t PutVarint(uint8_t* out, uint32_t value)
+{
+    uint32_t size = 0UL;
+
+    while (value >= VARINT_MORE)
+    {
+        out[size++] = (uint8_t)(value | VARINT_MORE);
+        value >>= VARINT_BITS;
+    }
+    out[size++] = (uint8_t)value;
+
+    return (size);
+}
+
+/*******************************************************************************
+* Function Name: PutWord
+****************************************************************************//**
+*
+* Summary:
+*   Writes a little-endian 32-bit word.
+*
+*******************************************************************************/
+static void PutWord(uint8_t* out, uint32_t value)
+{
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8U);
+    out[2] = (uint8_t)(value >> 16U);
+    out[3] = (uint8_t)(value >> 24U);
+}
+
+/*******************************************************************************
+* Function Name: initRecord
+****************************************************************************//**
+*
+* Summary:
+*   Starts a log on a sink: the header is sent at once and every phase of
+*   the handle from then on is recorded. A NULL sink stops recording.
+*
+* Parameters:
+*   record: Recorder state of the master handle
+*   sink: Receives the log, can be NULL
+*   dataRateHz: Data rate of the master, stored in the header
+*
+*******************************************************************************/
+void initRecord(i2c_record_t* record, i2c_record_sink_t sink, uint32_t dataRateHz)
+{
+    uint32_t intrState = Cy_SysLib_EnterCriticalSection();
+
+    record->sink = sink;
+    if (NULL != sink)
+    {
+        PutWord(&recordBuffer[0], RECORD_MAGIC);
+        PutWord(&recordBuffer[4], RECORD_VERSION);
+        PutWord(&recordBuffer[8], dataRateHz);
+        record->endUs = GetTimeUs();
+        sink(recordBuffer, RECORD_HEADER_SIZE);
+    }
+    Cy_SysLib_ExitCriticalSection(intrState);
+}
+
+/*******************************************************************************
+* Function Name: RecordTransferStart
+****************************************************************************//**
+*
+* Summary:
+*   Stamps the start of a phase.
+*
+* Parameters:
+*   record: Recorder state of the master handle
+*   read: true for a read phase
+*
+*******************************************************************************/
+void RecordTransferStart(i2c_record_t* record, bool read)
+{
+    if (NULL != record->sink)
+    {
+        record->startUs = GetTimeUs();
+        record->read    = read;
+    }
+}
+
+/*******************************************************************************
+* Function Name: RecordTransferEnd
+****************************************************************************//**
+*
+* Summary:
+*   Encodes the phase that just ended and sends it to the sink. Called from
+*   the master ISR, and from the application when a transfer is aborted.
+*
+* Parameters:
+*   record: Recorder state of the master handle
+*   xfer: Transfer configuration of the phase
+*   flags: RECORD_F_TIMEOUT if the phase was aborted, otherwise 0
+*   masterStatus: Cy_SCB_I2C_MasterGetStatus() at the end of the phase
+*   count: Bytes transferred
+*
+*******************************************************************************/
+void RecordTransferEnd(i2c_record_t* record, cy_stc_scb_i2c_master_xfer_config_t const* xfer,
+                       uint32_t flags, uint32_t masterStatus, uint32_t count)
+{
+    uint32_t intrState;
+    uint32_t nowUs;
+    uint32_t dataSize;
+    uint32_t size = 2UL;
+    uint32_t i;
+
+    if (NULL == record->sink)
+    {
+        return;
+    }
+
+    intrState = Cy_SysLib_EnterCriticalSection();
+    nowUs     = GetTimeUs();
+    dataSize  = record->read ? count : xfer->bufferSize;
+    flags    |= (record->read ? RECORD_F_READ : 0UL) | (xfer->xferPending ? RECORD_F_PENDING : 0UL);
+    if (dataSize > RECORD_DATA_MAX)
+    {
+        dataSize = RECORD_DATA_MAX;
+        flags   |= RECORD_F_TRUNCATED;
+    }
+
+    recordBuffer[0] = (uint8_t)flags;
+    recordBuffer[1] = xfer->slaveAddress;
+    size += PutVarint(&recordBuffer[size], record->startUs - record->endUs);
+    size += PutVarint(&recordBuffer[size], nowUs - record->startUs);
+    size += PutVarint(&recordBuffer[size], masterStatus);
+    size += PutVarint(&recordBuffer[size], xfer->bufferSize);
+    size += PutVarint(&recordBuffer[size], count);
+    for (i = 0UL; (i < dataSize) && (NULL != xfer->buffer); i++)
+    {
+        recordBuffer[size++] = xfer->buffer[i];
+    }
+    record->endUs = nowUs;
+
+    record->sink(recordBuffer, size);
+    Cy_SysLib_ExitCriticalSection(intrState);
+}
+
+#endif /* I2C_RECORD */
+
+/* [] END OF FILE */
@@ -0,0 +1,124 @@
+/******************************************************************************
+* File Name:   I2CRecord.h
+*
+* Description: This file provides the log format and prototypes of the
+*              master transfer recorder.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_I2CRECORD_H_
+#define SOURCE_I2CRECORD_H_
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "I2CPacket.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* The recorder is built in unless I2C_RECORD=0 is set in DEFINES */
+#ifndef I2C_RECORD
+#define I2C_RECORD              (1)
+#endif
+
+/* Log header: "I2CR" read as a little-endian word, the version, a reserved
+ * half-word and the data rate of the master, all little-endian.
+ */
+#define RECORD_MAGIC            (0x52433249UL)
+#define RECORD_VERSION          (1UL)
+#define RECORD_HEADER_SIZE      (12UL)
+
+/* A record per transfer phase:
+ *   flags           1 byte, RECORD_F_*
+ *   slave address   1 byte
+ *   gap             varint, us from the end of the previous phase
+ *   duration        varint, us from the start to the end of the phase
+ *   master status   varint, Cy_SCB_I2C_MasterGetStatus() at the end
+ *   size            varint, bytes requested
+ *   count           varint, bytes transferred
+ *   data            the size bytes written, or the count bytes read
+ * A varint is 7 bits per byte, least significant first, with the top bit
+ * set on every byte but the last.
+ */
+#define RECORD_F_READ           (0x01UL)    /* Read phase, otherwise a write */
+#define RECORD_F_PENDING        (0x02UL)    /* No STOP: a repeated START follows */
+#define RECORD_F_TIMEOUT        (0x04UL)    /* Aborted by the transfer timeout */
+#define RECORD_F_TRUNCATED      (0x08UL)    /* Data cut to RECORD_DATA_MAX bytes */
+
+#define RECORD_VARINT_MAX       (5UL)
+/* A sub-address and the whole EZI2C buffer */
+#define RECORD_DATA_MAX         (1UL + EZI2C_BUFFER_SIZE)
+#define RECORD_SIZE_MAX         (2UL + (5UL * RECORD_VARINT_MAX) + RECORD_DATA_MAX)
+
+#if I2C_RECORD
+#define RECORD_START(record, read)                  RecordTransferStart((record), (read))
+#define RECORD_END(record, xfer, flags, status, count) \
+                                                    RecordTransferEnd((record), (xfer), (flags), (status), (count))
+#else
+#define RECORD_START(record, read)                  ((void)0)
+#define RECORD_END(record, xfer, flags, status, count) ((void)0)
+#endif
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Receives the log: the header, then one record per call. Called with
+ * interrupts masked, so it should only copy the bytes out.
+ */
+typedef void (*i2c_record_sink_t)(uint8_t const* data, uint32_t size);
+
+/* Recorder state of one master handle */
+typedef struct
+{
+    i2c_record_sink_t   sink;       /* NULL while not recording */
+    uint32_t            startUs;    /* Start of the phase in flight */
+    uint32_t            endUs;      /* End of the last phase recorded */
+    bool                read;       /* The phase in flight is a read */
+} i2c_record_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#if I2C_RECORD
+void initRecord(i2c_record_t* record, i2c_record_sink_t sink, uint32_t dataRateHz);
+void RecordTransferStart(i2c_record_t* record, bool read);
+void RecordTransferEnd(i2c_record_t* record, cy_stc_scb_i2c_master_xfer_config_t const* xfer,
+                       uint32_t flags, uint32_t masterStatus, uint32_t count);
+#endif
+
+#endif /* SOURCE_I2CRECORD_H_ */
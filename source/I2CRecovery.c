@@ -0,0 +1,320 @@
+/******************************************************************************
+* File Name:   I2CRecovery.c
+*
+* Description: This file contains the I2C master bus recovery: failure
+*              classification, the retry policy for each class and the
+*              stuck-SDA clock-out on the I2C master pins.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include "I2CRecovery.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define US_PER_SEC                  (1000000UL)
+
+/* Longest time a slave may stretch one bit of the clock-out */
+#define CLOCK_OUT_STRETCH_US        (1000UL)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Backoff jitter generator (xorshift32), seeded from SysTick on first use */
+static uint32_t jitterState = 0UL;
+
+/*******************************************************************************
+* Function Declaration
+*******************************************************************************/
+static uint32_t NextJitter(void);
+static bool WaitSclHigh(i2c_bus_pins_t const* pins, uint32_t halfBitUs);
+
+/*******************************************************************************
+* Function Name: ClassifyMasterFault
+****************************************************************************//**
+*
+* Summary:
+*   Maps the master status of a failed transfer to a failure class.
+*
+* Parameters:
+*   masterStatus: CY_SCB_I2C_MASTER_* error bits, or I2C_MASTER_TIMEOUT
+*
+* Return:
+*   I2C_FAULT_* class, I2C_FAULT_NONE when no error bit is set.
+*
+*******************************************************************************/
+uint32_t ClassifyMasterFault(uint32_t masterStatus)
+{
+    uint32_t fault = I2C_FAULT_NONE;
+
+    if (0UL != (masterStatus & I2C_MASTER_TIMEOUT))
+    {
+        fault = I2C_FAULT_TIMEOUT;
+    }
+    else if (0UL != (masterStatus & (CY_SCB_I2C_MASTER_BUS_ERR | CY_SCB_I2C_MASTER_ABORT_START)))
+    {
+        fault = I2C_FAULT_BUS_ERR;
+    }
+    else if (0UL != (masterStatus & CY_SCB_I2C_MASTER_ARB_LOST))
+    {
+        fault = I2C_FAULT_ARB_LOST;
+    }
+    else if (0UL != (masterStatus & (CY_SCB_I2C_MASTER_ADDR_NAK | CY_SCB_I2C_MASTER_DATA_NAK)))
+    {
+        fault = I2C_FAULT_NAK;
+    }
+    else
+    {
+        /* No bus fault */
+    }
+
+    return (fault);
+}
+
+/*******************************************************************************
+* Function Name: WaitSclHigh
+****************************************************************************//**
+*
+* Summary:
+*   Waits for SCL to go high after it was released, allowing the slave to
+*   stretch it for up to CLOCK_OUT_STRETCH_US.
+*
+* Parameters:
+*   pins: Bus pins
+*   halfBitUs: Polling interval
+*
+* Return:
+*   true if SCL is high.
+*
+*******************************************************************************/
+static bool WaitSclHigh(i2c_bus_pins_t const* pins, uint32_t halfBitUs)
+{
+    uint32_t waitedUs = 0UL;
+
+    while (0UL == Cy_GPIO_Read(pins->sclPort, pins->sclNum))
+    {
+        if (waitedUs >= CLOCK_OUT_STRETCH_US)
+        {
+            return (false);
+        }
+        Cy_SysLib_DelayUs((uint16_t)halfBitUs);
+        waitedUs += halfBitUs;
+    }
+
+    return (true);
+}
+
+/*******************************************************************************
+* Function Name: ClearStuckBus
+****************************************************************************//**
+*
+* Summary:
+*   Frees a bus whose SDA line is held low by a slave that lost track of a
+*   transfer. The master pins are switched to software GPIO, SCL is
+*   clocked until the slave releases SDA (at most BUS_CLEAR_CLOCKS clocks)
+*   and a STOP is generated, then the pins are given back to the SCB. Call
+*   it with the master SCB disabled.
+*
+* Parameters:
+*   stats: Recovery counters of the master
+*   pins: Bus pins of the master SCB
+*   dataRateHz: SCL rate of the clock-out
+*
+* Return:
+*   I2C_BUS_FREE if both lines are high, I2C_BUS_STUCK otherwise.
+*
+*******************************************************************************/
+uint32_t ClearStuckBus(i2c_recovery_stats_t* stats, i2c_bus_pins_t const* pins, uint32_t dataRateHz)
+{
+    uint32_t halfBitUs = ((US_PER_SEC / 2UL) + dataRateHz - 1UL) / dataRateHz;
+    uint32_t clocks;
+    bool free;
+
+    if (0UL != Cy_GPIO_Read(pins->sdaPort, pins->sdaNum))
+    {
+        return (I2C_BUS_FREE);
+    }
+    stats->stuckBus++;
+
+    /* Release both lines before the pins leave the SCB */
+    Cy_GPIO_Write(pins->sclPort, pins->sclNum, 1UL);
+    Cy_GPIO_Write(pins->sdaPort, pins->sdaNum, 1UL);
+    Cy_GPIO_SetHSIOM(pins->sclPort, pins->sclNum, HSIOM_SEL_GPIO);
+    Cy_GPIO_SetHSIOM(pins->sdaPort, pins->sdaNum, HSIOM_SEL_GPIO);
+
+    free = WaitSclHigh(pins, halfBitUs);
+    for (clocks = 0UL; free && (clocks < BUS_CLEAR_CLOCKS) &&
+         (0UL == Cy_GPIO_Read(pins->sdaPort, pins->sdaNum)); clocks++)
+    {
+        Cy_GPIO_Write(pins->sclPort, pins->sclNum, 0UL);
+        Cy_SysLib_DelayUs((uint16_t)halfBitUs);
+        Cy_GPIO_Write(pins->sclPort, pins->sclNum, 1UL);
+        free = WaitSclHigh(pins, halfBitUs);
+        Cy_SysLib_DelayUs((uint16_t)halfBitUs);
+    }
+
+    /* STOP: SDA goes low while SCL is low, then high while SCL is high */
+    Cy_GPIO_Write(pins->sclPort, pins->sclNum, 0UL);
+    Cy_GPIO_Write(pins->sdaPort, pins->sdaNum, 0UL);
+    Cy_SysLib_DelayUs((uint16_t)halfBitUs);
+    Cy_GPIO_Write(pins->sclPort, pins->sclNum, 1UL);
+    Cy_SysLib_DelayUs((uint16_t)halfBitUs);
+    Cy_GPIO_Write(pins->sdaPort, pins->sdaNum, 1UL);
+    Cy_SysLib_DelayUs((uint16_t)halfBitUs);
+
+    free = (0UL != Cy_GPIO_Read(pins->sdaPort, pins->sdaNum)) &&
+           (0UL != Cy_GPIO_Read(pins->sclPort, pins->sclNum));
+
+    Cy_GPIO_SetHSIOM(pins->sclPort, pins->sclNum, pins->sclHsiom);
+    Cy_GPIO_SetHSIOM(pins->sdaPort, pins->sdaNum, pins->sdaHsiom);
+
+    if (!free)
+    {
+        return (I2C_BUS_STUCK);
+    }
+    stats->clockOuts++;
+    return (I2C_BUS_FREE);
+}
+
+/*******************************************************************************
+* Function Name: NextJitter
+****************************************************************************//**
+*
+* Summary:
+*   Returns the next value of the backoff jitter generator.
+*
+*******************************************************************************/
+static uint32_t NextJitter(void)
+{
+    if (0UL == jitterState)
+    {
+        jitterState = Cy_SysTick_GetValue() | 1UL;
+    }
+    jitterState ^= jitterState << 13U;
+    jitterState ^= jitterState >> 17U;
+    jitterState ^= jitterState << 5U;
+
+    return (jitterState);
+}
+
+/*******************************************************************************
+* Function Name: NextMasterRetry
+****************************************************************************//**
+*
+* Summary:
+*   Counts a failed transfer and decides whether to retry it. The bus must
+*   already be recovered for a bus error or a timeout.
+*
+* Parameters:
+*   stats: Recovery counters of the master
+*   fault: I2C_FAULT_* class of the failure
+*   attempt: Number of retries already made for the transfer
+*   retryable: false if the transfer must not be repeated, because part of
+*              it may have gone through or the bus is still stuck
+*   delayUs: Delay to wait before the retry
+*
+* Return:
+*   true to retry after delayUs.
+*
+*******************************************************************************/
+bool NextMasterRetry(i2c_recovery_stats_t* stats, uint32_t fault, uint32_t attempt, bool retryable, uint32_t* delayUs)
+{
+    uint32_t backoff;
+    bool retry = false;
+
+    *delayUs = 0UL;
+    stats->failures++;
+
+    switch (fault)
+    {
+        case I2C_FAULT_NAK:
+            stats->naks++;
+            retry = retryable && (attempt < NAK_RETRY_MAX);
+            *delayUs = NAK_RETRY_DELAY_US;
+            break;
+
+        case I2C_FAULT_ARB_LOST:
+            stats->arbLost++;
+            retry = retryable && (attempt < ARB_RETRY_MAX);
+            backoff = ARB_BACKOFF_BASE_US << attempt;
+            *delayUs = backoff + (NextJitter() % backoff);
+            break;
+
+        case I2C_FAULT_BUS_ERR:
+            stats->busErrors++;
+            retry = retryable && (attempt < BUS_RETRY_MAX);
+            break;
+
+        case I2C_FAULT_TIMEOUT:
+            stats->timeouts++;
+            retry = retryable && (attempt < BUS_RETRY_MAX);
+            break;
+
+        default:
+            break;
+    }
+
+    if (retry)
+    {
+        stats->retries++;
+    }
+    else
+    {
+        stats->unrecovered++;
+    }
+
+    return (retry);
+}
+
+/*******************************************************************************
+* Function Name: RecordMasterRecovery
+****************************************************************************//**
+*
+* Summary:
+*   Counts a transfer that went through after one or more retries.
+*
+* Parameters:
+*   stats: Recovery counters of the master
+*
+*******************************************************************************/
+void RecordMasterRecovery(i2c_recovery_stats_t* stats)
+{
+    stats->recovered++;
+}
+
+/* [] END OF FILE */
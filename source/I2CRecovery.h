@@ -0,0 +1,129 @@
+/******************************************************************************
+* File Name:   I2CRecovery.h
+*
+* Description: This file provides the fault classes, retry policy and
+*              statistics of the I2C master bus recovery.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SOURCE_I2CRECOVERY_H_
+#define SOURCE_I2CRECOVERY_H_
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Master status bit recorded for a transfer that missed its deadline. It is
+ * outside the CY_SCB_I2C_MASTER_* status bits.
+ */
+#define I2C_MASTER_TIMEOUT          (0x80000000UL)
+
+/* Failure classes */
+#define I2C_FAULT_NONE              (0UL)
+#define I2C_FAULT_NAK               (1UL)
+#define I2C_FAULT_ARB_LOST          (2UL)
+#define I2C_FAULT_BUS_ERR           (3UL)
+#define I2C_FAULT_TIMEOUT           (4UL)
+
+/* Retry policy. A NAK is retried after a fixed delay. Arbitration loss backs
+ * off exponentially from ARB_BACKOFF_BASE_US with up to the same amount of
+ * random jitter, so two masters that collided do not collide again. A bus
+ * error or a timeout is retried once after the bus was recovered.
+ */
+#define NAK_RETRY_MAX               (3UL)
+#define NAK_RETRY_DELAY_US          (50UL)
+#define ARB_RETRY_MAX               (4UL)
+#define ARB_BACKOFF_BASE_US         (20UL)
+#define BUS_RETRY_MAX               (1UL)
+
+/* Longest retry delay: the last backoff plus as much jitter. The delay is
+ * waited with Cy_SysLib_DelayUs(), which takes 16 bits.
+ */
+#define RETRY_DELAY_MAX_US          (2UL * (ARB_BACKOFF_BASE_US << (ARB_RETRY_MAX - 1UL)))
+_Static_assert((RETRY_DELAY_MAX_US <= UINT16_MAX) && (NAK_RETRY_DELAY_US <= UINT16_MAX),
+               "retry delay does not fit Cy_SysLib_DelayUs()");
+
+/* Clock-out: a slave holding SDA low in the middle of a byte releases it
+ * within 9 SCL clocks.
+ */
+#define BUS_CLEAR_CLOCKS            (9UL)
+
+/* Bus state reported by ClearStuckBus() */
+#define I2C_BUS_FREE                (0UL)
+#define I2C_BUS_STUCK               (1UL)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Bus pins of a master SCB, taken over as software GPIO for a clock-out */
+typedef struct
+{
+    GPIO_PRT_Type*  sclPort;
+    uint32_t        sclNum;
+    en_hsiom_sel_t  sclHsiom;       /* Pin function of SCL when the SCB drives it */
+    GPIO_PRT_Type*  sdaPort;
+    uint32_t        sdaNum;
+    en_hsiom_sel_t  sdaHsiom;
+} i2c_bus_pins_t;
+
+/* Failure and recovery counters of one master, kept in its handle */
+typedef struct
+{
+    uint32_t failures;      /* Transfers that ended with a bus fault */
+    uint32_t naks;
+    uint32_t arbLost;
+    uint32_t busErrors;
+    uint32_t timeouts;
+    uint32_t stuckBus;      /* SDA found held low after a failure */
+    uint32_t clockOuts;     /* Clock-outs that released SDA */
+    uint32_t retries;
+    uint32_t recovered;     /* Failed transfers that went through on a retry */
+    uint32_t unrecovered;   /* Failed transfers given up */
+} i2c_recovery_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint32_t ClassifyMasterFault(uint32_t masterStatus);
+uint32_t ClearStuckBus(i2c_recovery_stats_t* stats, i2c_bus_pins_t const* pins, uint32_t dataRateHz);
+bool NextMasterRetry(i2c_recovery_stats_t* stats, uint32_t fault, uint32_t attempt, bool retryable,
+                     uint32_t* delayUs);
+void RecordMasterRecovery(i2c_recovery_stats_t* stats);
+
+#endif /* SOURCE_I2CRECOVERY_H_ */
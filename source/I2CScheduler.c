@@ -0,0 +1,522 @@
+/******************************************************************************
+* File Name:   I2CScheduler.c
+*
+* Description: This file contains the multi-slave I2C master scheduler. It
+*              keeps a table of EZI2C slaves with their priority and polling
+*              period and a queue of pending transactions, and issues them
+*              one at a time through the asynchronous master API.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include "I2CScheduler.h"
+#include "I2CTime.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* No transaction selected */
+#define NO_ENTRY            (SCHED_QUEUE_SIZE)
+#define NO_SLAVE            (SCHED_MAX_SLAVES)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    i2c_sched_xfer_t xfer;
+    uint32_t         queuedUs;
+    bool             used;
+
+    /* Command packet, built when the command is issued; it stays queued
+     * until a status packet names it.
+     */
+    uint8_t          frame[WRITE_PACKET_SIZE];
+    uint32_t         frameSize;
+    bool             written;
+    uint32_t         statusReads;
+} sched_entry_t;
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Master the slaves are on */
+static i2c_master_t* schedMaster;
+static i2c_slave_desc_t const* schedSlaves;
+static uint32_t schedSlaveCount = 0UL;
+static uint32_t schedPolicy;
+
+static sched_entry_t schedQueue[SCHED_QUEUE_SIZE];
+static uint32_t schedNextPollUs[SCHED_MAX_SLAVES];
+static i2c_slave_stats_t schedStats[SCHED_MAX_SLAVES];
+
+/* Transaction in flight: slave, queue entry (NO_ENTRY for a poll), the time
+ * it became due and the time it was started.
+ */
+static bool schedBusy = false;
+static uint32_t schedSlave;
+static uint32_t schedEntry;
+static uint32_t schedDueUs;
+static uint32_t schedStartUs;
+
+/* Slave served last, round-robin starts after it */
+static uint32_t schedLastSlave = 0UL;
+
+/* Time of the current RunScheduler() step */
+static uint32_t schedNowUs = 0UL;
+
+/*******************************************************************************
+* Function Declaration
+*******************************************************************************/
+static void FinishTransfer(uint8_t status);
+static bool PickTransfer(uint32_t* slave, uint32_t* entry);
+static uint8_t StartCommand(sched_entry_t* entry);
+static void StartTransfer(uint32_t slave, uint32_t entry);
+
+/*******************************************************************************
+* Function Name: initScheduler
+****************************************************************************//**
+*
+* Summary:
+*   Sets up the scheduler for a table of slaves on the bus of a master. Call
+*   it after the master is set up. The first poll of every slave is due right
+*   away.
+*
+* Parameters:
+*   master: Master handle the transactions are started on
+*   slaves: Slave descriptors, must stay valid while the scheduler runs
+*   count: Number of slaves, 1 to SCHED_MAX_SLAVES
+*   policy: SCHED_POLICY_ROUND_ROBIN or SCHED_POLICY_PRIORITY
+*
+* Return:
+*   I2C_SUCCESS, or I2C_FAILURE for a bad table.
+*
+*******************************************************************************/
+uint32_t initScheduler(i2c_master_t* master, i2c_slave_desc_t const* slaves, uint32_t count, uint32_t policy)
+{
+    uint32_t i;
+
+    if ((NULL == master) || (NULL == slaves) || (0UL == count) || (count > SCHED_MAX_SLAVES))
+    {
+        return (I2C_FAILURE);
+    }
+
+    schedMaster     = master;
+    schedSlaves     = slaves;
+    schedSlaveCount = count;
+    schedPolicy     = policy;
+    schedBusy       = false;
+    schedLastSlave  = count - 1UL;
+    schedNowUs      = GetTimeUs();
+
+    for (i = 0UL; i < SCHED_QUEUE_SIZE; i++)
+    {
+        schedQueue[i].used = false;
+    }
+    for (i = 0UL; i < count; i++)
+    {
+        schedNextPollUs[i] = schedNowUs;
+        schedStats[i] = (i2c_slave_stats_t){ 0UL };
+    }
+
+    return (I2C_SUCCESS);
+}
+
+/*******************************************************************************
+* Function Name: ScheduleTransfer
+****************************************************************************//**
+*
+* Summary:
+*   Queues a transaction. It is issued by RunScheduler() when its slave is
+*   next in turn.
+*
+* Parameters:
+*   xfer: Transaction, copied into the queue
+*
+* Return:
+*   I2C_SUCCESS, or I2C_FAILURE if the queue is full, the slave unknown or
+*   a command has too many operands.
+*
+*******************************************************************************/
+uint32_t ScheduleTransfer(i2c_sched_xfer_t const* xfer)
+{
+    uint32_t i;
+
+    if ((xfer->slave >= schedSlaveCount) || ((SCHED_XFER_COMMAND == xfer->kind) && (xfer->size > CMD_OPERANDS_MAX)))
+    {
+        return (I2C_FAILURE);
+    }
+
+    for (i = 0UL; i < SCHED_QUEUE_SIZE; i++)
+    {
+        if (!schedQueue[i].used)
+        {
+            schedQueue[i].xfer        = *xfer;
+            schedQueue[i].queuedUs    = GetTimeUs();
+            schedQueue[i].frameSize   = 0UL;
+            schedQueue[i].written     = false;
+            schedQueue[i].statusReads = 0UL;
+            schedQueue[i].used        = true;
+            return (I2C_SUCCESS);
+        }
+    }
+
+    return (I2C_FAILURE);
+}
+
+/*******************************************************************************
+* Function Name: FinishTransfer
+****************************************************************************//**
+*
+* Summary:
+*   Accounts the transaction in flight and calls its owner. A command whose
+*   frame was delivered, or whose status the slave has not reported yet,
+*   stays queued for a status read on a later turn of its slave.
+*
+*******************************************************************************/
+static void FinishTransfer(uint8_t status)
+{
+    i2c_slave_stats_t* stats = &schedStats[schedSlave];
+    uint32_t latencyUs = schedNowUs - schedDueUs;
+    sched_entry_t* entry;
+
+    schedBusy = false;
+
+    if (TRANSFER_ERROR == status)
+    {
+        stats->failed++;
+    }
+    else
+    {
+        stats->completed++;
+    }
+    if (latencyUs > stats->worstLatencyUs)
+    {
+        stats->worstLatencyUs = latencyUs;
+    }
+
+    if (NO_ENTRY == schedEntry)
+    {
+        stats->polls++;
+    }
+    else
+    {
+        entry = &schedQueue[schedEntry];
+        if (SCHED_XFER_COMMAND == entry->xfer.kind)
+        {
+            if ((TRANSFER_CMPLT == status) && !entry->written)
+            {
+                entry->written = true;
+                return;
+            }
+            if ((TRANSFER_STS_STALE == status) && (++entry->statusReads < SCHED_STATUS_READS))
+            {
+                return;
+            }
+        }
+
+        entry->used = false;
+        if (NULL != entry->xfer.callback)
+        {
+            entry->xfer.callback(&entry->xfer, status);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: PickTransfer
+****************************************************************************//**
+*
+* Summary:
+*   Selects the next transaction. Slaves are scanned starting after the one
+*   served last; round-robin takes the first slave with pending work,
+*   priority takes the highest-priority one (round-robin among equals).
+*   Within a slave, the queued transaction or poll that became due first
+*   goes first.
+*
+* Parameters:
+*   slave: Selected slave
+*   entry: Selected queue entry, NO_ENTRY for a poll
+*
+* Return:
+*   true if a transaction was selected.
+*
+*******************************************************************************/
+static bool PickTransfer(uint32_t* slave, uint32_t* entry)
+{
+    uint32_t best = NO_SLAVE;
+    uint32_t bestEntry = NO_ENTRY;
+    uint32_t k;
+    uint32_t s;
+    uint32_t i;
+    uint32_t oldest;
+
+    for (k = 1UL; k <= schedSlaveCount; k++)
+    {
+        s = (schedLastSlave + k) % schedSlaveCount;
+        if ((NO_SLAVE != best) && (schedSlaves[s].priority >= schedSlaves[best].priority))
+        {
+            continue;
+        }
+
+        oldest = NO_ENTRY;
+        for (i = 0UL; i < SCHED_QUEUE_SIZE; i++)
+        {
+            if (schedQueue[i].used && (schedQueue[i].xfer.slave == s) &&
+                ((NO_ENTRY == oldest) || !TIME_REACHED(schedQueue[i].queuedUs, schedQueue[oldest].queuedUs)))
+            {
+                oldest = i;
+            }
+        }
+
+        if ((0UL != schedSlaves[s].periodUs) && TIME_REACHED(schedNowUs, schedNextPollUs[s]) &&
+            ((NO_ENTRY == oldest) || TIME_REACHED(schedQueue[oldest].queuedUs, schedNextPollUs[s])))
+        {
+            best      = s;
+            bestEntry = NO_ENTRY;
+        }
+        else if (NO_ENTRY != oldest)
+        {
+            best      = s;
+            bestEntry = oldest;
+        }
+        else
+        {
+            continue;
+        }
+
+        if (SCHED_POLICY_ROUND_ROBIN == schedPolicy)
+        {
+            break;
+        }
+    }
+
+    *slave = best;
+    *entry = bestEntry;
+    return (NO_SLAVE != best);
+}
+
+/*******************************************************************************
+* Function Name: StartCommand
+****************************************************************************//**
+*
+* Summary:
+*   Starts the next transaction of a queued command: the write of its frame,
+*   or once the frame is delivered, the read of its status packet. The frame
+*   is built on its first issue, with the slave selected, so it takes the
+*   sequence number of its own slave whatever was selected when the command
+*   was queued. It is kept for the status read.
+*
+* Parameters:
+*   entry: Queue entry of the command
+*
+* Return:
+*   TRANSFER_PENDING if the transaction was started, TRANSFER_ERROR otherwise.
+*
+*******************************************************************************/
+static uint8_t StartCommand(sched_entry_t* entry)
+{
+    if (entry->written)
+    {
+        return (ReadStatusPacketFromEzI2CAsync(schedMaster, NULL));
+    }
+
+    if (0UL == entry->frameSize)
+    {
+        entry->frameSize = PrepareOpcodePacket(schedMaster, entry->frame, entry->xfer.opcode,
+                                               entry->xfer.operands, entry->xfer.size);
+    }
+    return (WritePacketToEzI2CAsync(schedMaster, entry->frame, entry->frameSize, NULL));
+}
+
+/*******************************************************************************
+* Function Name: StartTransfer
+****************************************************************************//**
+*
+* Summary:
+*   Addresses the slave and starts the selected transaction.
+*
+*******************************************************************************/
+static void StartTransfer(uint32_t slave, uint32_t entry)
+{
+    i2c_slave_desc_t const* desc = &schedSlaves[slave];
+    i2c_sched_xfer_t const* xfer;
+    uint8_t status = TRANSFER_ERROR;
+
+    schedBusy      = true;
+    schedSlave     = slave;
+    schedEntry     = entry;
+    schedStartUs   = schedNowUs;
+    schedLastSlave = slave;
+
+    if (NO_ENTRY == entry)
+    {
+        /* Next poll is one period after this one, or after now if the
+         * slave fell behind by more than a period.
+         */
+        schedDueUs = schedNextPollUs[slave];
+        schedNextPollUs[slave] += desc->periodUs;
+        if (TIME_REACHED(schedNowUs, schedNextPollUs[slave]))
+        {
+            schedNextPollUs[slave] = schedNowUs + desc->periodUs;
+        }
+    }
+    else
+    {
+        schedDueUs = schedQueue[entry].queuedUs;
+    }
+
+    if (TRANSFER_CMPLT == SelectEzI2CSlave(schedMaster, desc->address))
+    {
+        if (NO_ENTRY == entry)
+        {
+            status = ReadEzI2CAsync(schedMaster, desc->pollOffset, desc->pollBuffer, desc->pollSize, NULL);
+        }
+        else
+        {
+            xfer = &schedQueue[entry].xfer;
+            switch (xfer->kind)
+            {
+                case SCHED_XFER_WRITE:
+                    status = WritePacketToEzI2CAsync(schedMaster, xfer->buffer, xfer->size, NULL);
+                    break;
+                case SCHED_XFER_COMMAND:
+                    status = StartCommand(&schedQueue[entry]);
+                    break;
+                case SCHED_XFER_READ:
+                    status = ReadEzI2CAsync(schedMaster, xfer->offset, xfer->buffer, xfer->size, NULL);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    if (TRANSFER_PENDING != status)
+    {
+        FinishTransfer(TRANSFER_ERROR);
+    }
+}
+
+/*******************************************************************************
+* Function Name: RunScheduler
+****************************************************************************//**
+*
+* Summary:
+*   Runs one step of the scheduler from the main loop: completes the
+*   transaction in flight when the master is done with it, aborts it when it
+*   overruns its timeout budget, and starts the next one when the bus is
+*   free. Never waits for the bus.
+*
+*******************************************************************************/
+void RunScheduler(void)
+{
+    uint32_t slave;
+    uint32_t entry;
+    uint8_t status;
+
+    if (0UL == schedSlaveCount)
+    {
+        return;
+    }
+
+    schedNowUs = GetTimeUs();
+
+    if (schedBusy)
+    {
+        status = GetMasterTransferStatus(schedMaster);
+        if (TRANSFER_PENDING == status)
+        {
+            if ((schedNowUs - schedStartUs) <= GetMasterTransferTimeoutUs(schedMaster))
+            {
+                return;
+            }
+            AbortMasterTransfer(schedMaster);
+            (void)RecoverMasterBus(schedMaster);
+            status = TRANSFER_ERROR;
+        }
+        FinishTransfer(status);
+    }
+
+    if (PickTransfer(&slave, &entry))
+    {
+        StartTransfer(slave, entry);
+    }
+}
+
+/*******************************************************************************
+* Function Name: IsSchedulerIdle
+****************************************************************************//**
+*
+* Summary:
+*   Returns true when no transaction is queued or in flight. Polls that are
+*   not due yet do not count.
+*
+*******************************************************************************/
+bool IsSchedulerIdle(void)
+{
+    uint32_t i;
+
+    if (schedBusy)
+    {
+        return (false);
+    }
+    for (i = 0UL; i < SCHED_QUEUE_SIZE; i++)
+    {
+        if (schedQueue[i].used)
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+/*******************************************************************************
+* Function Name: GetSlaveStats
+****************************************************************************//**
+*
+* Summary:
+*   Returns the counters of a slave of the table.
+*
+*******************************************************************************/
+i2c_slave_stats_t const* GetSlaveStats(uint32_t slave)
+{
+    return (&schedStats[slave % SCHED_MAX_SLAVES]);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,129 @@
+/******************************************************************************
+* File Name:   I2CScheduler.h
+*
+* Description: This file provides the slave descriptors, transaction and
+*              statistics types of the multi-slave I2C master scheduler.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SOURCE_I2CSCHEDULER_H_
+#define SOURCE_I2CSCHEDULER_H_
+
+#include "I2CMaster.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SCHED_MAX_SLAVES            (8UL)
+#define SCHED_QUEUE_SIZE            (16UL)
+
+/* Status reads of a command the slave has not reported yet, before the
+ * command is completed with TRANSFER_STS_STALE
+ */
+#define SCHED_STATUS_READS          (4UL)
+
+/* Order in which slaves with pending work are served */
+#define SCHED_POLICY_ROUND_ROBIN    (0UL)
+#define SCHED_POLICY_PRIORITY       (1UL)
+
+/* Transaction kinds */
+#define SCHED_XFER_WRITE            (0U)    /* WritePacketToEzI2CAsync() */
+#define SCHED_XFER_COMMAND          (1U)    /* Command frame, then its status packet */
+#define SCHED_XFER_READ             (2U)    /* ReadEzI2CAsync() */
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct i2c_sched_xfer i2c_sched_xfer_t;
+
+/* Transaction completion callback, called from RunScheduler() with
+ * TRANSFER_CMPLT, TRANSFER_STS_FAIL, TRANSFER_STS_STALE or TRANSFER_ERROR.
+ */
+typedef void (*i2c_sched_callback_t)(i2c_sched_xfer_t const* xfer, uint8_t status);
+
+/* Queued transaction. The buffer must stay valid until the callback. A
+ * command carries its opcode and operands instead of a packet: the frame is
+ * built when the command is issued, after its slave is selected, so it
+ * takes the sequence number of that slave. It is completed when a status
+ * packet of the slave names it.
+ */
+struct i2c_sched_xfer
+{
+    uint8_t  slave;                 /* Index in the slave table */
+    uint8_t  kind;                  /* SCHED_XFER_* */
+    uint8_t  offset;                /* EZI2C sub-address of a read */
+    uint8_t  opcode;                /* CMD_OP_* of a command */
+    uint8_t  operands[CMD_OPERANDS_MAX];
+    uint8_t* buffer;                /* Data of a write or a read */
+    uint32_t size;                  /* Bytes of buffer, or operand bytes of a command */
+    i2c_sched_callback_t callback;  /* Can be NULL */
+};
+
+/* Slave descriptor. A slave with a non-zero period is polled by reading
+ * pollSize bytes at pollOffset into pollBuffer every periodUs.
+ */
+typedef struct
+{
+    uint8_t  address;               /* EZI2C address of the command buffer */
+    uint8_t  priority;              /* 0 is the highest */
+    uint32_t periodUs;
+    uint8_t  pollOffset;
+    uint8_t* pollBuffer;
+    uint32_t pollSize;
+} i2c_slave_desc_t;
+
+/* Per-slave counters. Latency runs from the time a transaction was queued,
+ * or a poll was due, to its completion.
+ */
+typedef struct
+{
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t polls;
+    uint32_t worstLatencyUs;
+} i2c_slave_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint32_t initScheduler(i2c_master_t* master, i2c_slave_desc_t const* slaves, uint32_t count, uint32_t policy);
+uint32_t ScheduleTransfer(i2c_sched_xfer_t const* xfer);
+void RunScheduler(void);
+bool IsSchedulerIdle(void);
+i2c_slave_stats_t const* GetSlaveStats(uint32_t slave);
+
+#endif /* SOURCE_I2CSCHEDULER_H_ */
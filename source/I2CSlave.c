@@ -42,6 +42,11 @@
 
 /* Header file includes */
 #include "I2CSlave.h"
+#include "I2CPacket.h"
+#include "I2CDataRate.h"
+#include "I2CInstrument.h"
+#include "I2CTrace.h"
+#include "I2CTuning.h"
 
 /*******************************************************************************
 * Macros
@@ -50,26 +55,102 @@
 #define EZI2C_INTR_NUM          CYBSP_EZI2C_IRQ
 #define EZI2C_INTR_PRIORITY         (3UL)
 
-#define EZI2C_BUFFER_SIZE           (0x08UL)
+/* Command ring: EZI2C_RING_SLOTS command frames written by the master in
+ * batches. The slave consumes slots from the tail and publishes the tail
+ * index at EZI2C_RING_TAIL_POS so the master knows how many slots are free.
+ * The start marker of a slot commits it, so the master needs no separate
+ * head update and a whole batch goes out in one write.
+ */
+#define RING_SLOT(ezBuffer, idx)    (&(ezBuffer)[EZI2C_RING_BASE_POS + ((idx) * EZI2C_RING_SLOT_SIZE)])
+
+/* Stream slots: chunk k of the open stream is taken from slot
+ * k % EZI2C_STREAM_SLOTS, in order, whichever buffer it landed in.
+ */
+#define STREAM_SLOT(ezBuffer, idx)  (&(ezBuffer)[EZI2C_STREAM_BASE_POS + ((idx) * EZI2C_STREAM_SLOT_SIZE)])
+#define STREAM_CHUNKS(bytes)        (((bytes) + STREAM_CHUNK_SIZE - 1UL) / STREAM_CHUNK_SIZE)
+
+/* Dirty tracking: the buffer is a map of EZI2C_DIRTY_BLOCK_SIZE-byte
+ * blocks, one bit each in a 64-bit mask. The ISR marks the blocks a write
+ * covered, and the application only visits the regions with a marked
+ * block, so parsing costs what was written rather than the buffer size.
+ * Blocks are small enough that the status fields do not share one with
+ * the command frame or the ring.
+ */
+#define EZI2C_DIRTY_BLOCK_SIZE      (4UL)
+#define EZI2C_DIRTY_ALL             (0xFFFFFFFFFFFFFFFFULL)
+#define DIRTY_BLOCK(pos)            ((pos) / EZI2C_DIRTY_BLOCK_SIZE)
+#define DIRTY_RANGE(first, last)    ((EZI2C_DIRTY_ALL >> (63UL - (last))) & (EZI2C_DIRTY_ALL << (first)))
+#define DIRTY_REGION(field)         DIRTY_RANGE(DIRTY_BLOCK(PROTO_OFS(proto_ezi2c_buffer_t, field)), \
+                                                DIRTY_BLOCK(PROTO_OFS(proto_ezi2c_buffer_t, field) + \
+                                                            PROTO_LEN(proto_ezi2c_buffer_t, field) - 1UL))
+#define DIRTY_CMD_FRAME             DIRTY_REGION(cmd_frame)
+#define DIRTY_RING                  DIRTY_REGION(ring)
+#define DIRTY_STREAM                DIRTY_REGION(stream)
+
+/* Ring slots a single write covered whole, one bit per slot */
+#define RING_SLOT_BITS(first, last) (((1UL << (last)) - 1UL) & ~((1UL << (first)) - 1UL))
+#define RING_WHOLE_ALL              RING_SLOT_BITS(0UL, EZI2C_RING_SLOTS)
 
-/* Start and end of packet markers */
-#define PACKET_SOP                  (0x01UL)
-#define PACKET_EOP                  (0x17UL)
+PROTO_ASSERT(EZI2C_BUFFER_SIZE <= (64UL * EZI2C_DIRTY_BLOCK_SIZE), "dirty mask does not cover the buffer");
+PROTO_ASSERT(DIRTY_BLOCK(EZI2C_CMD_FRAME_POS + PROTO_LEN(proto_ezi2c_buffer_t, cmd_frame) - 1UL) <
+             DIRTY_BLOCK(EZI2C_RESULT_POS), "command frame shares the result block");
+PROTO_ASSERT(DIRTY_BLOCK(EZI2C_STREAM_STS_POS) < DIRTY_BLOCK(EZI2C_RING_BASE_POS), "ring shares the status block");
 
-/* Command valid status */
-#define STS_CMD_DONE                (0x00UL)
-#define STS_CMD_FAIL                (0xFFUL)
+/* The telemetry window needs the second address, and the master writes an
+ * 8-bit sub-address (see I2CTuning.h).
+ */
+PROTO_ASSERT(I2C_TUNING_EZI2C_ADDRESSES == 2UL, "design.modus must give the EZI2C two addresses");
+PROTO_ASSERT(I2C_TUNING_SUB_ADDR_BYTES == 1UL, "design.modus must select an 8-bit EZI2C sub-address");
 
-/* Packet data position in buffer */
-#define EzPACKET_SOP_POS            (0x00UL)
-#define EzPACKET_CMD_POS            (0x01UL)
-#define EzPACKET_EOP_POS            (0x02UL)
-#define PACKET_RPLY_SOP_POS         (0x05UL)
-#define PACKET_RPLY_STS_POS         (0x06UL)
-#define PACKET_RPLY_EOP_POS         (0x07UL)
+/* MarkWritten() takes the range of a write from two fields of the EZI2C
+ * context that the PDL does not document: baseAddr1, the sub-address the
+ * master wrote, and idx, the index after the last byte taken. They are
+ * checked against the EZI2C sources of SCB driver 4.x; check them again
+ * before moving to another major version.
+ */
+#define EZI2C_CONTEXT_DRV_MAJOR     4
+#if !defined(CY_SCB_DRV_VERSION_MAJOR) || (CY_SCB_DRV_VERSION_MAJOR != EZI2C_CONTEXT_DRV_MAJOR)
+#error "MarkWritten() reads baseAddr1 and idx of the EZI2C context of SCB driver 4.x"
+#endif
+
+/* Ping-pong receive buffers */
+#define EZI2C_BUFFER_COUNT          (2UL)
+#define OTHER_BUFFER(idx)           ((idx) ^ 1UL)
 
 #define ZERO                        (0UL)
 
+/* Accesses to the command buffer that end with the buffer free to swap */
+#define EZI2C_ACCESS_DONE           (CY_SCB_EZI2C_STATUS_READ1 | CY_SCB_EZI2C_STATUS_WRITE1)
+
+/* EZI2C activity traced: the end of an access or an error */
+#define TRACE_EZI2C_EVENTS          (CY_SCB_EZI2C_STATUS_READ1 | CY_SCB_EZI2C_STATUS_WRITE1 | \
+                                     CY_SCB_EZI2C_STATUS_READ2 | CY_SCB_EZI2C_STATUS_WRITE2 | \
+                                     CY_SCB_EZI2C_STATUS_ERR)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+/* Command handler: decodes the operands of its opcode, executes the command
+ * and sets the result. Returns the status reported in the reply packet.
+ */
+typedef uint8_t (*cmd_handler_t)(uint8_t const *operands, uint32_t *result);
+
+/* Entry of the dispatch table: the handler of an opcode and the number of
+ * operand bytes it takes
+ */
+typedef struct
+{
+    cmd_handler_t   handler;
+    uint32_t        operands;
+} cmd_entry_t;
+
+/* Pin a GPIO command may read or drive */
+typedef struct
+{
+    GPIO_PRT_Type*  port;
+    uint32_t        pin;
+} cmd_gpio_t;
+
 /*******************************************************************************
 * Global variables
 *******************************************************************************/
@@ -87,78 +168,982 @@ cy_stc_sysint_t CYBSP_EZI2C_SCB_IRQ_cfg =
         /*.intrPriority =*/ 3u
 };
 
-/* EZI2C buffer */
-uint8_t buffer[EZI2C_BUFFER_SIZE] ;
+/* Deep Sleep callback: Deep Sleep waits for the end of an access, and a
+ * master addressing the slave wakes the device (EnableWakeup in design.modus).
+ */
+static cy_stc_syspm_callback_params_t ezi2cDeepSleepParams =
+{
+    /*.base =*/ CYBSP_EZI2C_HW,
+    /*.context =*/ &CYBSP_EZI2C_context
+};
+static cy_stc_syspm_callback_t ezi2cDeepSleepCallback =
+{
+    /*.callback =*/ &Cy_SCB_EZI2C_DeepSleepCallback,
+    /*.type =*/ CY_SYSPM_DEEPSLEEP,
+    /*.skipMode =*/ 0UL,
+    /*.callbackParams =*/ &ezi2cDeepSleepParams,
+    /*.prevItm =*/ NULL,
+    /*.nextItm =*/ NULL,
+    /*.order =*/ 0U
+};
+
+/* EZI2C buffers. The master writes into the active one while the
+ * application parses the other; the ISR swaps them when a write completes.
+ */
+uint8_t buffer[EZI2C_BUFFER_COUNT][EZI2C_BUFFER_SIZE] ;
+static volatile uint32_t activeBuffer = ZERO;
+
+/* A write completed into the active buffer and it was not swapped yet */
+static bool swapPending = false;
+
+/* Completed writes per buffer, counted by the ISR, and the count the
+ * application has parsed. Each side writes only its own counter, so neither
+ * side masks the other; a buffer is free while the two are equal. The ISR
+ * also stamps the first write into a free buffer so that the application
+ * parses the buffers in the order they were filled.
+ */
+static volatile uint32_t bufferWrites[EZI2C_BUFFER_COUNT];
+static volatile uint32_t bufferParsed[EZI2C_BUFFER_COUNT];
+static volatile uint32_t bufferFirstSeq[EZI2C_BUFFER_COUNT];
+
+/* Blocks written since the buffer was last free, set by the ISR before it
+ * counts the write. The application reads the mask after the write count,
+ * so every write it parses is covered; the ISR starts a new mask only
+ * with the first write into a free buffer.
+ */
+static volatile uint64_t bufferDirty[EZI2C_BUFFER_COUNT];
+
+/* Frames written whole since the buffer was last free, kept with the dirty
+ * mask: the bytes of the longest write that started at the command frame
+ * and the ring slots a write covered. A write cut short by a bus fault leaves
+ * the tail of an older frame behind a new start marker, and that frame
+ * checks out; only frames written whole are taken. A ring slot consumed
+ * from one buffer is dropped from both, see ReleaseRingSlot().
+ */
+static volatile uint32_t bufferCmdWritten[EZI2C_BUFFER_COUNT];
+static volatile uint32_t bufferRingWhole[EZI2C_BUFFER_COUNT];
+static uint32_t writeSeq = ZERO;
+
+/* Next ring slot to consume */
+static uint32_t ringTail = 0UL;
+
+/* Telemetry window at the second address and the counters behind it.
+ * busErrors is counted by the ISR, the rest by the application.
+ */
+static uint8_t telemetry[TLM_SIZE];
+static uint8_t telemetrySeq = 0U;
+static uint32_t commandCount = ZERO;
+static uint32_t writeCount = ZERO;
+static uint32_t rejectCount = ZERO;
+static volatile uint32_t busErrors = ZERO;
+static uint32_t busErrorsPublished = ZERO;
+static uint8_t lastStatus = STS_CMD_FAIL;
+
+/* Result of the last command executed, published after the reply */
+static uint32_t lastResult = ZERO;
+
+/* Registers of CMD_OP_REG_READ and CMD_OP_REG_WRITE, read by the
+ * application with GetSlaveRegister()
+ */
+static uint32_t slaveRegs[CMD_REG_COUNT];
+
+/* Counter values at the last CMD_OP_COUNTER_CLEAR. A clear moves the base
+ * instead of zeroing the counter, so busErrors stays owned by the ISR and
+ * the telemetry counters keep counting.
+ */
+static uint32_t counterBase[CMD_COUNTER_COUNT];
+
+/* Pins of the GPIO commands, indexed by the CMD_GPIO_* operand */
+static const cmd_gpio_t cmdGpios[CMD_GPIO_COUNT] =
+{
+    { CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM }   /* CMD_GPIO_LED1 */
+};
+
+/* Sequence number of the last frame executed, for duplicate detection */
+static uint8_t lastSeq;
+static bool lastSeqValid = false;
+
+/* Sequence number of the last frame handled, executed or not, which the
+ * reply names
+ */
+static uint8_t replySeq = 0U;
+
+/* Stream sink: the size announced by the open frame, the bytes received in
+ * order and the status of the last chunk handled
+ */
+static uint8_t streamData[STREAM_MAX_SIZE];
+static uint32_t streamSize = ZERO;
+static uint32_t streamReceived = ZERO;
+static uint8_t streamId = 0U;
+static uint8_t streamStatus = STS_CMD_FAIL;
 
 /*******************************************************************************
 * Function Declaration
 *******************************************************************************/
 void SEzI2C_InterruptHandler(void);
+static uint8_t ExecuteFrame(uint8_t *frame, uint32_t maxPayload, uint32_t written);
+static uint8_t DispatchCommand(uint8_t const *payload, uint32_t size, uint32_t *result);
+static uint8_t CmdPing(uint8_t const *operands, uint32_t *result);
+static uint8_t CmdLed(uint8_t const *operands, uint32_t *result);
+static uint8_t CmdGpioRead(uint8_t const *operands, uint32_t *result);
+static uint8_t CmdGpioWrite(uint8_t const *operands, uint32_t *result);
+static uint8_t CmdRegRead(uint8_t const *operands, uint32_t *result);
+static uint8_t CmdRegWrite(uint8_t const *operands, uint32_t *result);
+static uint8_t CmdCounterRead(uint8_t const *operands, uint32_t *result);
+static uint8_t CmdCounterClear(uint8_t const *operands, uint32_t *result);
+static uint32_t CounterValue(uint32_t counter);
+static uint8_t OpenStream(uint8_t const *operands, uint32_t *result);
+static uint32_t DrainCommandRing(uint8_t *ezBuffer, uint32_t whole, uint8_t *status);
+static void ReleaseRingSlot(uint32_t slot);
+static bool DrainStream(uint8_t *ezBuffer);
+static void MarkWritten(uint32_t idx, uint32_t ezi2cState, bool first);
+static void ParseBuffer(uint32_t idx, uint64_t dirty);
+static void PublishTelemetry(void);
+
+/* Dispatch table, indexed by opcode. The operand counts come from the
+ * operand descriptions in I2CPacket.h.
+ */
+static const cmd_entry_t cmdTable[CMD_OP_COUNT] =
+{
+    [CMD_OP_PING]          = { &CmdPing,         PROTO_SIZE(proto_op_ping_t) },
+    [CMD_OP_LED]           = { &CmdLed,          PROTO_SIZE(proto_op_led_t) },
+    [CMD_OP_GPIO_READ]     = { &CmdGpioRead,     PROTO_SIZE(proto_op_select_t) },
+    [CMD_OP_GPIO_WRITE]    = { &CmdGpioWrite,    PROTO_SIZE(proto_op_gpio_write_t) },
+    [CMD_OP_REG_READ]      = { &CmdRegRead,      PROTO_SIZE(proto_op_select_t) },
+    [CMD_OP_REG_WRITE]     = { &CmdRegWrite,     PROTO_SIZE(proto_op_reg_write_t) },
+    [CMD_OP_COUNTER_READ]  = { &CmdCounterRead,  PROTO_SIZE(proto_op_select_t) },
+    [CMD_OP_COUNTER_CLEAR] = { &CmdCounterClear, PROTO_SIZE(proto_op_select_t) },
+    [CMD_OP_STREAM_OPEN]   = { &OpenStream,      PROTO_SIZE(proto_stream_open_t) },
+};
 
 /*******************************************************************************
 * Function Name: SEzI2C_InterruptHandler
 ****************************************************************************//**
 *
 * Summary:
-*   Execute interrupt service routine.
+*   Execute interrupt service routine. When a master write completes, the
+*   written buffer is handed to CheckEzI2Cbuffer() and the EZI2C is pointed
+*   at the other buffer, if the application has finished with it. A swap
+*   that finds the next access already started is retried when a later
+*   access to the buffer completes.
 *
 *******************************************************************************/
 void SEzI2C_InterruptHandler(void)
 {
+    INSTR_ENTER(instrIsrEntry);
+    uint32_t ezi2cState;
+    uint32_t written;
+
     /* ISR implementation for EZI2C. */
     Cy_SCB_EZI2C_Interrupt(CYBSP_EZI2C_HW, &CYBSP_EZI2C_context);
+
+    /* Read and clear the EZI2C status; only clean write completion is of interest. */
+    ezi2cState = Cy_SCB_EZI2C_GetActivity(CYBSP_EZI2C_HW, &CYBSP_EZI2C_context);
+    if (0u != (ezi2cState & TRACE_EZI2C_EVENTS))
+    {
+        TRACE_EVENT(TRACE_S_ACCESS, ezi2cState, writeSeq);
+    }
+    if (0u != (ezi2cState & CY_SCB_EZI2C_STATUS_ERR))
+    {
+        busErrors++;
+    }
+    else if (0u != (ezi2cState & CY_SCB_EZI2C_STATUS_WRITE1))
+    {
+        written = activeBuffer;
+        if (bufferWrites[written] == bufferParsed[written])
+        {
+            bufferFirstSeq[written] = writeSeq;
+            MarkWritten(written, ezi2cState, true);
+        }
+        else
+        {
+            MarkWritten(written, ezi2cState, false);
+        }
+        writeSeq++;
+        bufferWrites[written]++;
+        swapPending = true;
+    }
+    else
+    {
+        /* Reads and sub-address only writes leave the buffers as they are */
+    }
+
+    /* The buffer may only be changed between accesses: when the next access
+     * has already been addressed, the swap waits for it to complete. A write
+     * of the sub-address alone does not count, as the read that follows
+     * starts at that sub-address. If the application still owns the other
+     * buffer, the next write lands in the active one again and is parsed on
+     * the following pass.
+     */
+    if (swapPending && (0u != (ezi2cState & EZI2C_ACCESS_DONE)) &&
+        (0u == (ezi2cState & CY_SCB_EZI2C_STATUS_BUSY)))
+    {
+        written = activeBuffer;
+        if (bufferWrites[OTHER_BUFFER(written)] == bufferParsed[OTHER_BUFFER(written)])
+        {
+            Cy_SCB_EZI2C_SetBuffer1(CYBSP_EZI2C_HW, buffer[OTHER_BUFFER(written)], EZI2C_BUFFER_SIZE,
+                                    EZI2C_BUFFER_SIZE, &CYBSP_EZI2C_context);
+            activeBuffer = OTHER_BUFFER(written);
+            swapPending = false;
+        }
+    }
+    INSTR_SINCE(INSTR_H_SLAVE_ISR, instrIsrEntry);
 }
 
 /*******************************************************************************
-* Function Name: CheckEzI2Cbuffer
+* Function Name: MarkWritten
 ****************************************************************************//**
 *
 * Summary:
-*   Continuously read the contents of EzI2C buffer. Compare the packets and
-*   execute the command.
+*   Records what the write that just completed covered, from the sub-address
+*   the master wrote to the index after the last byte taken, as kept in the
+*   EZI2C context: the dirty blocks and the frames written whole. When
+*   another access has already started, the context no longer describes the
+*   write and the whole buffer is marked. The context fields are pinned to
+*   SCB driver 4.x at compile time (EZI2C_CONTEXT_DRV_MAJOR).
+*
+* Parameters:
+*   idx: Buffer written
+*   ezi2cState: Activity read with Cy_SCB_EZI2C_GetActivity()
+*   first: The write is the first since the buffer was last free
 *
 *******************************************************************************/
-void CheckEzI2Cbuffer( void )
+static void MarkWritten(uint32_t idx, uint32_t ezi2cState, bool first)
 {
-    uint32_t ezi2cState;
+    uint32_t start = CYBSP_EZI2C_context.baseAddr1;
+    uint32_t end = CYBSP_EZI2C_context.idx;
+    uint64_t dirty = ZERO;
+    uint32_t cmdWritten = ZERO;
+    uint32_t ringWhole = ZERO;
+    uint32_t firstSlot;
+    uint32_t lastSlot;
 
-    /* Disable the EZI2C interrupts so that ISR is not serviced while
-     * checking for EZI2C status.
-     */
-    NVIC_DisableIRQ(CYBSP_EZI2C_SCB_IRQ_cfg.intrSrc);
+    if ((0u != (ezi2cState & CY_SCB_EZI2C_STATUS_BUSY)) || (end > EZI2C_BUFFER_SIZE))
+    {
+        dirty      = EZI2C_DIRTY_ALL;
+        cmdWritten = EZI2C_BUFFER_SIZE;
+        ringWhole  = RING_WHOLE_ALL;
+    }
+    else if (end > start)
+    {
+        dirty = DIRTY_RANGE(DIRTY_BLOCK(start), DIRTY_BLOCK(end - 1UL));
+        if (EZI2C_CMD_FRAME_POS == start)
+        {
+            cmdWritten = end - start;
+        }
+        if (end > EZI2C_RING_BASE_POS)
+        {
+            firstSlot = (start <= EZI2C_RING_BASE_POS) ? ZERO :
+                        (((start - EZI2C_RING_BASE_POS) + EZI2C_RING_SLOT_SIZE - 1UL) / EZI2C_RING_SLOT_SIZE);
+            lastSlot  = (end - EZI2C_RING_BASE_POS) / EZI2C_RING_SLOT_SIZE;
+            if (lastSlot > EZI2C_RING_SLOTS)
+            {
+                lastSlot = EZI2C_RING_SLOTS;
+            }
+            if (lastSlot > firstSlot)
+            {
+                ringWhole = RING_SLOT_BITS(firstSlot, lastSlot);
+            }
+        }
+    }
+    else
+    {
+        /* Nothing written */
+    }
 
-    /* Read the EZi2C status */
-    ezi2cState = Cy_SCB_EZI2C_GetActivity(CYBSP_EZI2C_HW, &CYBSP_EZI2C_context);
+    if (first)
+    {
+        bufferDirty[idx]      = dirty;
+        bufferCmdWritten[idx] = cmdWritten;
+        bufferRingWhole[idx]  = ringWhole;
+    }
+    else
+    {
+        bufferDirty[idx]      |= dirty;
+        bufferRingWhole[idx]  |= ringWhole;
+        if (cmdWritten > bufferCmdWritten[idx])
+        {
+            bufferCmdWritten[idx] = cmdWritten;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: ExecuteFrame
+****************************************************************************//**
+*
+* Summary:
+*   Checks a received command frame and executes it unless it is damaged or
+*   repeats the last frame executed. The frame is consumed either way; a
+*   rejected frame leaves the result of the last command in place.
+*
+* Parameters:
+*   frame: Frame starting with PACKET_SOP
+*   maxPayload: Largest payload that fits where the frame was received
+*   written: Bytes from the start of the frame the master is known to have
+*            written; a longer frame was cut short and is rejected
+*
+* Return:
+*   STS_CMD_DONE if executed, otherwise the reason the frame was rejected.
+*
+*******************************************************************************/
+static uint8_t ExecuteFrame(uint8_t *frame, uint32_t maxPayload, uint32_t written)
+{
+    uint8_t status = CheckFrame(frame, maxPayload);
+
+    if ((STS_CMD_DONE == status) && (FRAME_SIZE(frame[FRAME_LEN_OFS]) > written))
+    {
+        status = STS_CMD_BAD_LEN;
+    }
+
+    if ((STS_CMD_DONE == status) && lastSeqValid && (frame[FRAME_SEQ_OFS] == lastSeq))
+    {
+        status = STS_CMD_DUPLICATE;
+    }
+
+    if (STS_CMD_DONE == status)
+    {
+        status = DispatchCommand(&frame[FRAME_PAYLOAD_OFS], frame[FRAME_LEN_OFS], &lastResult);
+    }
+
+    if (STS_CMD_DONE == status)
+    {
+        lastSeq      = frame[FRAME_SEQ_OFS];
+        lastSeqValid = true;
+    }
+    else
+    {
+        rejectCount++;
+    }
+
+    replySeq = frame[FRAME_SEQ_OFS];
+    TRACE_EVENT(TRACE_S_FRAME, status, frame[FRAME_SEQ_OFS]);
+
+    /* Clear the location so that any new frames written to buffer will be known. */
+    frame[FRAME_SOP_OFS] = ZERO;
+
+    return (status);
+}
+
+/*******************************************************************************
+* Function Name: DispatchCommand
+****************************************************************************//**
+*
+* Summary:
+*   Executes the command in a checked frame payload through cmdTable. The
+*   opcode indexes the table directly, so dispatch costs the same for every
+*   opcode however many there are.
+*
+* Parameters:
+*   payload: Frame payload, the opcode then its operands
+*   size: Payload size, at least one byte
+*   result: Set by the handler; cleared first
+*
+* Return:
+*   Status of the handler, or STS_CMD_BAD_OP if the opcode is unknown or
+*   the operand count does not match it.
+*
+*******************************************************************************/
+static uint8_t DispatchCommand(uint8_t const *payload, uint32_t size, uint32_t *result)
+{
+    uint32_t opcode = PROTO_GET(proto_command_t, opcode, payload);
+
+    if ((opcode >= CMD_OP_COUNT) || (size != CMD_PAYLOAD_SIZE(cmdTable[opcode].operands)))
+    {
+        return (STS_CMD_BAD_OP);
+    }
+
+    *result = ZERO;
+    return (cmdTable[opcode].handler(&payload[PROTO_OFS(proto_command_t, operands)], result));
+}
+
+/*******************************************************************************
+* Function Name: CmdPing
+****************************************************************************//**
+*
+* Summary:
+*   CMD_OP_PING: returns the token as the result.
+*
+*******************************************************************************/
+static uint8_t CmdPing(uint8_t const *operands, uint32_t *result)
+{
+    *result = PROTO_GET(proto_op_ping_t, token, operands);
+    return (STS_CMD_DONE);
+}
+
+/*******************************************************************************
+* Function Name: CmdLed
+****************************************************************************//**
+*
+* Summary:
+*   CMD_OP_LED: sets the user LED.
+*
+*******************************************************************************/
+static uint8_t CmdLed(uint8_t const *operands, uint32_t *result)
+{
+    CY_UNUSED_PARAMETER(result);
+    Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM, PROTO_GET(proto_op_led_t, state, operands));
+    return (STS_CMD_DONE);
+}
+
+/*******************************************************************************
+* Function Name: CmdGpioRead
+****************************************************************************//**
+*
+* Summary:
+*   CMD_OP_GPIO_READ: returns the level of a pin of cmdGpios.
+*
+*******************************************************************************/
+static uint8_t CmdGpioRead(uint8_t const *operands, uint32_t *result)
+{
+    uint32_t pin = PROTO_GET(proto_op_select_t, index, operands);
 
-    /* Write complete without errors: parse packets, otherwise ignore. */
-    if((0u != (ezi2cState & CY_SCB_EZI2C_STATUS_WRITE1)) && (0u == (ezi2cState & CY_SCB_EZI2C_STATUS_ERR)))
+    if (pin >= CMD_GPIO_COUNT)
     {
-        /* Check buffer content to know any new packets are written from master. */
-        if( ( buffer[EzPACKET_SOP_POS] ==PACKET_SOP) && ( buffer[EzPACKET_EOP_POS] ==PACKET_EOP) )
+        return (STS_CMD_BAD_ARG);
+    }
+
+    *result = Cy_GPIO_Read(cmdGpios[pin].port, cmdGpios[pin].pin);
+    return (STS_CMD_DONE);
+}
+
+/*******************************************************************************
+* Function Name: CmdGpioWrite
+****************************************************************************//**
+*
+* Summary:
+*   CMD_OP_GPIO_WRITE: drives a pin of cmdGpios.
+*
+*******************************************************************************/
+static uint8_t CmdGpioWrite(uint8_t const *operands, uint32_t *result)
+{
+    uint32_t pin = PROTO_GET(proto_op_gpio_write_t, pin, operands);
+
+    CY_UNUSED_PARAMETER(result);
+    if (pin >= CMD_GPIO_COUNT)
+    {
+        return (STS_CMD_BAD_ARG);
+    }
+
+    Cy_GPIO_Write(cmdGpios[pin].port, cmdGpios[pin].pin, PROTO_GET(proto_op_gpio_write_t, level, operands));
+    return (STS_CMD_DONE);
+}
+
+/*******************************************************************************
+* Function Name: CmdRegRead
+****************************************************************************//**
+*
+* Summary:
+*   CMD_OP_REG_READ: returns the value of a register.
+*
+*******************************************************************************/
+static uint8_t CmdRegRead(uint8_t const *operands, uint32_t *result)
+{
+    uint32_t reg = PROTO_GET(proto_op_select_t, index, operands);
+
+    if (reg >= CMD_REG_COUNT)
+    {
+        return (STS_CMD_BAD_ARG);
+    }
+
+    *result = slaveRegs[reg];
+    return (STS_CMD_DONE);
+}
+
+/*******************************************************************************
+* Function Name: CmdRegWrite
+****************************************************************************//**
+*
+* Summary:
+*   CMD_OP_REG_WRITE: sets a register.
+*
+*******************************************************************************/
+static uint8_t CmdRegWrite(uint8_t const *operands, uint32_t *result)
+{
+    uint32_t reg = PROTO_GET(proto_op_reg_write_t, reg, operands);
+
+    CY_UNUSED_PARAMETER(result);
+    if (reg >= CMD_REG_COUNT)
+    {
+        return (STS_CMD_BAD_ARG);
+    }
+
+    slaveRegs[reg] = PROTO_GET(proto_op_reg_write_t, value, operands);
+    return (STS_CMD_DONE);
+}
+
+/*******************************************************************************
+* Function Name: CounterValue
+****************************************************************************//**
+*
+* Summary:
+*   Returns the raw value of a CMD_COUNTER_* counter. The commands counter
+*   does not include the frames of the buffer being parsed.
+*
+*******************************************************************************/
+static uint32_t CounterValue(uint32_t counter)
+{
+    static uint32_t const volatile* const counters[CMD_COUNTER_COUNT] =
+    {
+        [CMD_COUNTER_COMMANDS]   = &commandCount,
+        [CMD_COUNTER_WRITES]     = &writeCount,
+        [CMD_COUNTER_REJECTED]   = &rejectCount,
+        [CMD_COUNTER_BUS_ERRORS] = &busErrors,
+    };
+
+    return (*counters[counter]);
+}
+
+/*******************************************************************************
+* Function Name: CmdCounterRead
+****************************************************************************//**
+*
+* Summary:
+*   CMD_OP_COUNTER_READ: returns a counter, counted since it was last
+*   cleared.
+*
+*******************************************************************************/
+static uint8_t CmdCounterRead(uint8_t const *operands, uint32_t *result)
+{
+    uint32_t counter = PROTO_GET(proto_op_select_t, index, operands);
+
+    if (counter >= CMD_COUNTER_COUNT)
+    {
+        return (STS_CMD_BAD_ARG);
+    }
+
+    *result = CounterValue(counter) - counterBase[counter];
+    return (STS_CMD_DONE);
+}
+
+/*******************************************************************************
+* Function Name: CmdCounterClear
+****************************************************************************//**
+*
+* Summary:
+*   CMD_OP_COUNTER_CLEAR: clears a counter as seen by CMD_OP_COUNTER_READ.
+*   The telemetry window keeps the running count.
+*
+*******************************************************************************/
+static uint8_t CmdCounterClear(uint8_t const *operands, uint32_t *result)
+{
+    uint32_t counter = PROTO_GET(proto_op_select_t, index, operands);
+
+    CY_UNUSED_PARAMETER(result);
+    if (counter >= CMD_COUNTER_COUNT)
+    {
+        return (STS_CMD_BAD_ARG);
+    }
+
+    counterBase[counter] = CounterValue(counter);
+    return (STS_CMD_DONE);
+}
+
+/*******************************************************************************
+* Function Name: OpenStream
+****************************************************************************//**
+*
+* Summary:
+*   CMD_OP_STREAM_OPEN: starts receiving a new stream. Chunks of earlier
+*   streams still in the slots are dropped, as they carry another stream id.
+*
+* Parameters:
+*   operands: Operands of the open command
+*   result: Not used
+*
+* Return:
+*   STS_CMD_DONE, or STS_CMD_BAD_LEN if the stream does not fit the sink.
+*
+*******************************************************************************/
+static uint8_t OpenStream(uint8_t const *operands, uint32_t *result)
+{
+    uint32_t size = PROTO_GET(proto_stream_open_t, size, operands);
+
+    CY_UNUSED_PARAMETER(result);
+    if ((ZERO == size) || (size > STREAM_MAX_SIZE))
+    {
+        return (STS_CMD_BAD_LEN);
+    }
+
+    streamId       = (uint8_t)PROTO_GET(proto_stream_open_t, id, operands);
+    streamSize     = size;
+    streamReceived = ZERO;
+    streamStatus   = STS_CMD_DONE;
+
+    return (STS_CMD_DONE);
+}
+
+/*******************************************************************************
+* Function Name: DrainStream
+****************************************************************************//**
+*
+* Summary:
+*   Takes the chunks of the open stream that follow the bytes received so
+*   far from the slots of the given buffer, and copies them to the sink.
+*   A chunk that is damaged, of another stream or at another offset is
+*   dropped and stops the pass: the master resends from the acknowledged
+*   chunk, and a copy that landed in the other buffer is taken when that
+*   buffer is parsed.
+*
+* Parameters:
+*   ezBuffer: Buffer to drain
+*
+* Return:
+*   true if a chunk frame was found.
+*
+*******************************************************************************/
+static bool DrainStream(uint8_t *ezBuffer)
+{
+    uint8_t *slot;
+    uint32_t offset;
+    uint32_t len;
+    uint32_t i;
+    bool framed = false;
+
+    while (streamReceived < streamSize)
+    {
+        slot = STREAM_SLOT(ezBuffer, (streamReceived / STREAM_CHUNK_SIZE) % EZI2C_STREAM_SLOTS);
+        if (slot[FRAME_SOP_OFS] != PACKET_SOP)
         {
-            Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM, buffer[EzPACKET_CMD_POS]);
+            break;
+        }
+        framed = true;
 
-            /* Clear the location so that any new packets written to buffer will be known. */
-            buffer[EzPACKET_SOP_POS]      = ZERO;
-            buffer[EzPACKET_EOP_POS]      = ZERO;
+        len = STREAM_CHUNK_SIZE;
+        if ((streamSize - streamReceived) < len)
+        {
+            len = streamSize - streamReceived;
+        }
+        offset = PROTO_GET(proto_stream_chunk_t, offset, &slot[FRAME_PAYLOAD_OFS]);
 
-            /* Write to buffer the data related to status. */
-            buffer[PACKET_RPLY_SOP_POS] = PACKET_SOP;
-            buffer[PACKET_RPLY_STS_POS] = STS_CMD_DONE;
-            buffer[PACKET_RPLY_EOP_POS] = PACKET_EOP;
+        streamStatus = CheckFrame(slot, STREAM_CHUNK_PAYLOAD);
+        if ((STS_CMD_DONE == streamStatus) &&
+            ((slot[FRAME_SEQ_OFS] != streamId) || (offset != streamReceived)))
+        {
+            streamStatus = STS_CMD_DUPLICATE;
+        }
+        else if ((STS_CMD_DONE == streamStatus) && (slot[FRAME_LEN_OFS] != (STREAM_OFFSET_SIZE + len)))
+        {
+            streamStatus = STS_CMD_BAD_LEN;
         }
         else
         {
-            /* write to buffer the data related to status. */
-            buffer[PACKET_RPLY_SOP_POS] = PACKET_SOP;
-            buffer[PACKET_RPLY_STS_POS] = STS_CMD_FAIL;
-            buffer[PACKET_RPLY_EOP_POS] = PACKET_EOP;
+            /* Checked */
+        }
+
+        if (STS_CMD_DONE != streamStatus)
+        {
+            slot[FRAME_SOP_OFS] = ZERO;
+            rejectCount++;
+            break;
+        }
+
+        for (i = ZERO; i < len; i++)
+        {
+            streamData[offset + i] = slot[FRAME_PAYLOAD_OFS + STREAM_OFFSET_SIZE + i];
         }
+        streamReceived += len;
+        slot[FRAME_SOP_OFS] = ZERO;
     }
-     /* Enable interrupts for servicing ISR. */
-    NVIC_EnableIRQ(CYBSP_EZI2C_SCB_IRQ_cfg.intrSrc);
+
+    return (framed);
 }
 
+/*******************************************************************************
+* Function Name: ReleaseRingSlot
+****************************************************************************//**
+*
+* Summary:
+*   Drops a consumed ring slot from both buffers: its start marker and its
+*   whole mark. A copy of the slot left in the other buffer, cut short or
+*   whole, would otherwise stop the drain of that buffer when the ring wraps
+*   back to the slot. The master writes the slot again only once the new
+*   ring tail is published, so no write into it is in flight.
+*
+* Parameters:
+*   slot: Ring slot consumed
+*
+*******************************************************************************/
+static void ReleaseRingSlot(uint32_t slot)
+{
+    uint32_t intrState;
+    uint32_t i;
+
+    for (i = ZERO; i < EZI2C_BUFFER_COUNT; i++)
+    {
+        RING_SLOT(buffer[i], slot)[FRAME_SOP_OFS] = ZERO;
+    }
+
+    /* The ISR adds to the whole marks of the other slots meanwhile */
+    intrState = Cy_SysLib_EnterCriticalSection();
+    for (i = ZERO; i < EZI2C_BUFFER_COUNT; i++)
+    {
+        bufferRingWhole[i] &= ~RING_SLOT_BITS(slot, slot + 1UL);
+    }
+    Cy_SysLib_ExitCriticalSection(intrState);
+}
+
+/*******************************************************************************
+* Function Name: DrainCommandRing
+****************************************************************************//**
+*
+* Summary:
+*   Consumes every committed frame in the ring of the given buffer, starting
+*   at the tail. A slot that no write covered whole stops the drain and is
+*   left for the master to write again.
+*
+* Parameters:
+*   ezBuffer: Buffer to drain
+*   whole: Ring slots written whole since the buffer was last free
+*   status: Updated with the reason of the last rejected frame, if any
+*
+* Return:
+*   Number of commands executed.
+*
+*******************************************************************************/
+static uint32_t DrainCommandRing(uint8_t *ezBuffer, uint32_t whole, uint8_t *status)
+{
+    uint32_t count = ZERO;
+    uint8_t *slot = RING_SLOT(ezBuffer, ringTail);
+    uint8_t slotStatus;
+
+    while (slot[FRAME_SOP_OFS] == PACKET_SOP)
+    {
+        if (ZERO == (whole & RING_SLOT_BITS(ringTail, ringTail + 1UL)))
+        {
+            *status = STS_CMD_BAD_LEN;
+            rejectCount++;
+            break;
+        }
+
+        slotStatus = ExecuteFrame(slot, COMMAND_PAYLOAD_SIZE, EZI2C_RING_SLOT_SIZE);
+        if (STS_CMD_DONE == slotStatus)
+        {
+            count++;
+        }
+        else
+        {
+            *status = slotStatus;
+        }
+
+        ReleaseRingSlot(ringTail);
+        ringTail = (ringTail + 1UL) % EZI2C_RING_SLOTS;
+        slot = RING_SLOT(ezBuffer, ringTail);
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: ParseBuffer
+****************************************************************************//**
+*
+* Summary:
+*   Executes the command frame and the ring frames written into one buffer,
+*   then publishes the status and the ring tail in both buffers so the
+*   master reads them whichever buffer is active. Only the regions with a
+*   dirty block are visited, and only frames written whole are executed.
+*
+* Parameters:
+*   idx: Buffer to parse
+*   dirty: Blocks written since the buffer was last parsed
+*
+*******************************************************************************/
+static void ParseBuffer(uint32_t idx, uint64_t dirty)
+{
+    uint8_t *ezBuffer = buffer[idx];
+    uint8_t *reply;
+    uint8_t *stream;
+    uint32_t executed = ZERO;
+    uint8_t status = STS_CMD_DONE;
+    bool framed = false;
+    uint32_t i;
+
+    /* Check buffer content to know any new frames are written from master. */
+    if ((ZERO != (dirty & DIRTY_CMD_FRAME)) && (ezBuffer[EZI2C_CMD_FRAME_POS + FRAME_SOP_OFS] == PACKET_SOP))
+    {
+        framed = true;
+        status = ExecuteFrame(&ezBuffer[EZI2C_CMD_FRAME_POS], CMD_FRAME_MAX_PAYLOAD,
+                              bufferCmdWritten[idx]);
+        if (STS_CMD_DONE == status)
+        {
+            executed++;
+        }
+    }
+
+    /* Execute the batch of commands queued in the ring. */
+    if ((ZERO != (dirty & DIRTY_RING)) && (RING_SLOT(ezBuffer, ringTail)[FRAME_SOP_OFS] == PACKET_SOP))
+    {
+        framed = true;
+        executed += DrainCommandRing(ezBuffer, bufferRingWhole[idx], &status);
+    }
+
+    /* Take the stream chunks that arrived in order. */
+    if ((ZERO != (dirty & DIRTY_STREAM)) && DrainStream(ezBuffer))
+    {
+        framed = true;
+    }
+
+    /* A write without any frame is reported as a failed command. */
+    if (!framed)
+    {
+        status = STS_CMD_FAIL;
+        rejectCount++;
+    }
+
+    writeCount++;
+    commandCount += executed;
+    lastStatus = status;
+
+    /* Write to buffer the data related to status. Every field of the reply
+     * is a single byte and SOP never changes. The status is written
+     * before the sequence number the master reads ahead of it, so a
+     * concurrent read that sees the new number also sees the new status;
+     * the result is only read after the reply reports its command. The
+     * stream ack is written before the stream id, so a read that overlaps
+     * the open of a stream sees the old id and no ack.
+     */
+    for (i = ZERO; i < EZI2C_BUFFER_COUNT; i++)
+    {
+        reply  = &buffer[i][EZI2C_RPLY_SOP_POS];
+        stream = &buffer[i][EZI2C_STREAM_ACK_POS];
+        PROTO_PUT(proto_ezi2c_buffer_t, ring_tail, buffer[i], ringTail);
+        PROTO_PUT(proto_reply_t, sop, reply, PACKET_SOP);
+        PROTO_PUT(proto_reply_t, sts, reply, lastStatus);
+        PROTO_PUT(proto_reply_t, seq, reply, replySeq);
+        PROTO_PUT(proto_ezi2c_buffer_t, result, buffer[i], lastResult);
+        PROTO_PUT(proto_stream_status_t, ack, stream, STREAM_CHUNKS(streamReceived));
+        PROTO_PUT(proto_stream_status_t, id, stream, streamId);
+        PROTO_PUT(proto_stream_status_t, sts, stream, streamStatus);
+    }
+}
+
+/*******************************************************************************
+* Function Name: PublishTelemetry
+****************************************************************************//**
+*
+* Summary:
+*   Updates the telemetry window. The master may read it at any time, so the
+*   end sequence byte is written first and the start one last: a read that
+*   overlaps the update sees two different sequence bytes.
+*
+*******************************************************************************/
+static void PublishTelemetry(void)
+{
+    telemetrySeq++;
+    busErrorsPublished = busErrors;
+
+    telemetry[TLM_SEQ_END_POS]   = telemetrySeq;
+    PROTO_PUT(proto_telemetry_t, led_state, telemetry,
+              Cy_GPIO_ReadOut(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_NUM));
+    PROTO_PUT(proto_telemetry_t, last_sts, telemetry, lastStatus);
+    PROTO_PUT(proto_telemetry_t, commands, telemetry, commandCount);
+    PROTO_PUT(proto_telemetry_t, writes, telemetry, writeCount);
+    PROTO_PUT(proto_telemetry_t, rejected, telemetry, rejectCount);
+    PROTO_PUT(proto_telemetry_t, bus_errors, telemetry, busErrorsPublished);
+    INSTR_EXPORT(&telemetry[TLM_HIST_POS]);
+    PROTO_PUT(proto_telemetry_t, seq, telemetry, telemetrySeq);
+}
+
+/*******************************************************************************
+* Function Name: CheckEzI2Cbuffer
+****************************************************************************//**
+*
+* Summary:
+*   Continuously read the contents of EzI2C buffer. Compare the packets and
+*   execute the command. Both the single command packet and every command
+*   queued in the command ring are executed. Only buffers the ISR has handed
+*   over are parsed, in the order they were filled, and the EZI2C interrupt
+*   stays enabled throughout.
+*
+*******************************************************************************/
+void CheckEzI2Cbuffer( void )
+{
+    uint32_t idx;
+    uint32_t writes;
+    bool pending0;
+    bool pending1;
+    bool parsed = false;
+
+    for (;;)
+    {
+        pending0 = (bufferWrites[0] != bufferParsed[0]);
+        pending1 = (bufferWrites[1] != bufferParsed[1]);
+        if (!pending0 && !pending1)
+        {
+            break;
+        }
+
+        /* Oldest first: ring commands may span both buffers. */
+        if (pending0 && pending1)
+        {
+            idx = ((int32_t)(bufferFirstSeq[1] - bufferFirstSeq[0]) < 0) ? 1UL : 0UL;
+        }
+        else
+        {
+            idx = pending0 ? 0UL : 1UL;
+        }
+
+        /* The masks are read after the count, so they cover every counted
+         * write; a write that lands while they are read only adds to them.
+         */
+        writes = bufferWrites[idx];
+        ParseBuffer(idx, bufferDirty[idx]);
+        bufferParsed[idx] = writes;
+        parsed = true;
+    }
+
+    if (parsed || (busErrors != busErrorsPublished))
+    {
+        PublishTelemetry();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: GetStreamData
+****************************************************************************//**
+*
+* Summary:
+*   Returns the data of the last stream once all of it has been received.
+*
+* Parameters:
+*   size: Set to the size of the stream
+*
+* Return:
+*   The stream data, or NULL while the stream is incomplete or none was
+*   opened.
+*
+*******************************************************************************/
+uint8_t const* GetStreamData(uint32_t* size)
+{
+    if ((ZERO == streamSize) || (streamReceived != streamSize))
+    {
+        return (NULL);
+    }
+
+    *size = streamSize;
+    return (streamData);
+}
+
+/*******************************************************************************
+* Function Name: GetSlaveRegister
+****************************************************************************//**
+*
+* Summary:
+*   Returns a register set by the master with CMD_OP_REG_WRITE.
+*
+* Parameters:
+*   reg: Register, below CMD_REG_COUNT
+*
+* Return:
+*   The register value, or 0 for a register out of range.
+*
+*******************************************************************************/
+uint32_t GetSlaveRegister(uint32_t reg)
+{
+    return ((reg < CMD_REG_COUNT) ? slaveRegs[reg] : ZERO);
+}
 
 /*******************************************************************************
 * Function Name: handle_error
@@ -169,6 +1154,9 @@ void CheckEzI2Cbuffer( void )
 *   In case of such error the system will stay in the infinite loop of this
 *   function.
 *   Note that if error occurs interrupts are disabled.
+*   The WDT is stopped as well: initLowPower() may have started it, and with
+*   its match interrupt no longer served it would reset the device on the
+*   third unserviced match, hiding the error behind a restart.
 *
 *******************************************************************************/
 void handle_error(void)
@@ -176,10 +1164,47 @@ void handle_error(void)
     /* Disable all interrupts. */
     __disable_irq();
 
+    /* Stop the WDT so the device stays in the error state */
+    Cy_WDT_Disable();
+
     /* Infinite loop. */
     while(1u) {}
 }
 
+/*******************************************************************************
+* Function Name: ConfigureSlaveDataRate
+****************************************************************************//**
+*
+* Summary:
+*   Reprograms the clock divider of the EZI2C slave SCB so it keeps up with
+*   a new data rate. The SCB is disabled while the divider changes; an
+*   access from a master in that time is not acknowledged.
+*
+* Parameters:
+*   dataRateHz: SCL rate in Hz the master will use
+*
+* Return:
+*   I2C_SUCCESS, or I2C_FAILURE if no divider fits the rate.
+*
+*******************************************************************************/
+uint32_t ConfigureSlaveDataRate(uint32_t dataRateHz)
+{
+    uint32_t divider = GetScbClockDivider(dataRateHz, false);
+
+    if (ZERO == divider)
+    {
+        return I2C_FAILURE;
+    }
+
+    Cy_SCB_EZI2C_Disable(CYBSP_EZI2C_HW, &CYBSP_EZI2C_context);
+    (void)Cy_SysClk_PeriphDisableDivider(CYBSP_EZI2C_CLK_DIV_HW, CYBSP_EZI2C_CLK_DIV_NUM);
+    (void)Cy_SysClk_PeriphSetDivider(CYBSP_EZI2C_CLK_DIV_HW, CYBSP_EZI2C_CLK_DIV_NUM, divider - 1UL);
+    (void)Cy_SysClk_PeriphEnableDivider(CYBSP_EZI2C_CLK_DIV_HW, CYBSP_EZI2C_CLK_DIV_NUM);
+    Cy_SCB_EZI2C_Enable(CYBSP_EZI2C_HW);
+
+    return I2C_SUCCESS;
+}
+
 /*******************************************************************************
 * Function Name: initSlave
 ********************************************************************************
@@ -210,8 +1235,21 @@ uint32_t initSlave(void)
     }
     NVIC_EnableIRQ((IRQn_Type) CYBSP_EZI2C_SCB_IRQ_cfg.intrSrc);
 
+    if (!Cy_SysPm_RegisterCallback(&ezi2cDeepSleepCallback))
+    {
+        return I2C_FAILURE;
+    }
+
     /* Configure buffer for communication with master. */
-    Cy_SCB_EZI2C_SetBuffer1(CYBSP_EZI2C_HW, buffer, EZI2C_BUFFER_SIZE, EZI2C_BUFFER_SIZE, &CYBSP_EZI2C_context);
+    Cy_SCB_EZI2C_SetBuffer1(CYBSP_EZI2C_HW, buffer[activeBuffer], EZI2C_BUFFER_SIZE, EZI2C_BUFFER_SIZE,
+                            &CYBSP_EZI2C_context);
+
+    /* Telemetry at the second address: read-only (no bytes below the
+     * read/write boundary), so monitoring reads never touch the command
+     * buffer.
+     */
+    PublishTelemetry();
+    Cy_SCB_EZI2C_SetBuffer2(CYBSP_EZI2C_HW, telemetry, TLM_SIZE, ZERO, &CYBSP_EZI2C_context);
 
     /* Enable SCB for the EZI2C operation. */
     Cy_SCB_EZI2C_Enable(CYBSP_EZI2C_HW);
@@ -45,6 +45,8 @@
 
 #include "cy_pdl.h"
 #include "cybsp.h"
+#include "I2CInstrument.h"
+#include "I2CPacket.h"
 
 /*******************************************************************************
 * Macros
@@ -52,11 +54,32 @@
 #define I2C_SUCCESS         (0UL)
 #define I2C_FAILURE         (1UL)
 
+/* Telemetry window (proto_telemetry_t in I2CPacket.h), read-only at the
+ * second EZI2C address. Counters are 32-bit little-endian. A read that
+ * covers both TLM_SEQ_POS and TLM_SEQ_END_POS is consistent when the two
+ * bytes are equal. With I2C_INSTRUMENT the latency histograms
+ * (INSTR_EXPORT_SIZE bytes) sit at TLM_HIST_POS and TLM_SEQ_END_POS follows
+ * them.
+ */
+#define TLM_SEQ_POS         (PROTO_OFS(proto_telemetry_t, seq))
+#define TLM_LED_STATE_POS   (PROTO_OFS(proto_telemetry_t, led_state))
+#define TLM_LAST_STS_POS    (PROTO_OFS(proto_telemetry_t, last_sts))
+#define TLM_COMMANDS_POS    (PROTO_OFS(proto_telemetry_t, commands))
+#define TLM_WRITES_POS      (PROTO_OFS(proto_telemetry_t, writes))
+#define TLM_REJECTED_POS    (PROTO_OFS(proto_telemetry_t, rejected))
+#define TLM_BUS_ERRORS_POS  (PROTO_OFS(proto_telemetry_t, bus_errors))
+#define TLM_HIST_POS        (PROTO_SIZE(proto_telemetry_t))
+#define TLM_SEQ_END_POS     (TLM_HIST_POS + INSTR_EXPORT_SIZE)
+#define TLM_SIZE            (TLM_SEQ_END_POS + 1UL)
+
 /*******************************************************************************
 * Function Prototypes
 *******************************************************************************/
 void CheckEzI2Cbuffer( void );
 uint32_t initSlave(void);
+uint32_t ConfigureSlaveDataRate(uint32_t dataRateHz);
+uint8_t const* GetStreamData(uint32_t* size);
+uint32_t GetSlaveRegister(uint32_t reg);
 void handle_error(void);
 
 #endif /* SOURCE_I2CSLAVE_H_ */
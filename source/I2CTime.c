@@ -0,0 +1,115 @@
+/******************************************************************************
+* File Name:   I2CTime.c
+*
+* Description: This file contains the microsecond clock of the example,
+*              built from SysTick running free from the CPU clock. The
+*              master deadlines, the pipeline, the scheduler and the
+*              transfer recorder all read it.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include "I2CTime.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define US_PER_SEC          (1000000UL)
+
+/* SysTick runs free from the CPU clock as a 24-bit down counter */
+#define SYSTICK_RELOAD      (0xFFFFFFUL)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Time at the last read and the SysTick ticks not yet a whole microsecond */
+static uint32_t timeNowUs = 0UL;
+static uint32_t timeTicks = 0UL;
+static uint32_t timeLastTick = 0UL;
+
+/*******************************************************************************
+* Function Name: initTime
+****************************************************************************//**
+*
+* Summary:
+*   Starts SysTick free-running from the CPU clock. The clock keeps its
+*   time when SysTick is started again, so every master handle may call it.
+*
+*******************************************************************************/
+void initTime(void)
+{
+    uint32_t intrState = Cy_SysLib_EnterCriticalSection();
+
+    Cy_SysTick_Init(CY_SYSTICK_CLOCK_SOURCE_CLK_CPU, SYSTICK_RELOAD);
+    timeLastTick = Cy_SysTick_GetValue();
+    timeTicks    = 0UL;
+    Cy_SysLib_ExitCriticalSection(intrState);
+}
+
+/*******************************************************************************
+* Function Name: GetTimeUs
+****************************************************************************//**
+*
+* Summary:
+*   Advances the clock by the SysTick ticks elapsed since the last read and
+*   returns it. The clock wraps after about 71 minutes; compare times with
+*   TIME_REACHED() or by subtraction. It must be read at least once per
+*   SysTick period (about 350 ms at 48 MHz) for the time to be exact. It can
+*   be read from interrupts.
+*
+* Return:
+*   Current time in microseconds.
+*
+*******************************************************************************/
+uint32_t GetTimeUs(void)
+{
+    uint32_t ticksPerUs = SystemCoreClock / US_PER_SEC;
+    uint32_t intrState = Cy_SysLib_EnterCriticalSection();
+    uint32_t tick = Cy_SysTick_GetValue();
+    uint32_t nowUs;
+
+    timeTicks   += (timeLastTick - tick) & SYSTICK_RELOAD;
+    timeLastTick = tick;
+    timeNowUs   += timeTicks / ticksPerUs;
+    timeTicks   %= ticksPerUs;
+    nowUs        = timeNowUs;
+    Cy_SysLib_ExitCriticalSection(intrState);
+
+    return (nowUs);
+}
+
+/* [] END OF FILE */
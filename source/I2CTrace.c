@@ -0,0 +1,111 @@
+/******************************************************************************
+* File Name:   I2CTrace.c
+*
+* Description: This file contains the bus event trace: a fixed-size ring of
+*              8-byte records written from the master and slave paths. The
+*              file is empty when I2C_TRACE is 0.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include "I2CTrace.h"
+
+#if I2C_TRACE
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static i2c_trace_t i2cTrace;
+
+/*******************************************************************************
+* Function Name: initTrace
+****************************************************************************//**
+*
+* Summary:
+*   Fills in the dump header and empties the ring.
+*
+*******************************************************************************/
+void initTrace(void)
+{
+    i2cTrace.magic   = TRACE_MAGIC;
+    i2cTrace.version = (uint16_t)TRACE_VERSION;
+    i2cTrace.records = (uint16_t)TRACE_RECORDS;
+    i2cTrace.clockHz = SystemCoreClock;
+    i2cTrace.head    = 0UL;
+}
+
+/*******************************************************************************
+* Function Name: RecordTraceEvent
+****************************************************************************//**
+*
+* Summary:
+*   Appends one record, stamped with SysTick. Called from the ISRs and from
+*   the application, so the slot is claimed with interrupts masked.
+*
+* Parameters:
+*   event: TRACE_* event code
+*   status: Status bits of the event, the low 16 bits are kept
+*   count: Count of the event, the low 16 bits are kept
+*
+*******************************************************************************/
+void RecordTraceEvent(uint32_t event, uint32_t status, uint32_t count)
+{
+    uint32_t intrState = Cy_SysLib_EnterCriticalSection();
+    i2c_trace_record_t* record = &i2cTrace.ring[i2cTrace.head & TRACE_INDEX_MASK];
+
+    i2cTrace.head++;
+    record->eventStamp  = (event << TRACE_EVENT_SHIFT) | (Cy_SysTick_GetValue() & TRACE_STAMP_MASK);
+    record->statusCount = (count << TRACE_COUNT_SHIFT) | (status & TRACE_STATUS_MASK);
+    Cy_SysLib_ExitCriticalSection(intrState);
+}
+
+/*******************************************************************************
+* Function Name: GetTrace
+****************************************************************************//**
+*
+* Summary:
+*   Returns the trace, to be dumped as sizeof(i2c_trace_t) raw bytes.
+*
+*******************************************************************************/
+i2c_trace_t const* GetTrace(void)
+{
+    return (&i2cTrace);
+}
+
+#endif /* I2C_TRACE */
+
+/* [] END OF FILE */
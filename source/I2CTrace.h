@@ -0,0 +1,128 @@
+/******************************************************************************
+* File Name:   I2CTrace.h
+*
+* Description: This file provides the record format, event codes and
+*              prototypes of the bus event trace.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SOURCE_I2CTRACE_H_
+#define SOURCE_I2CTRACE_H_
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* The trace is built in unless I2C_TRACE=0 is set in DEFINES */
+#ifndef I2C_TRACE
+#define I2C_TRACE               (1)
+#endif
+
+/* Records kept, a power of two. The oldest record is overwritten. */
+#ifndef TRACE_RECORDS
+#define TRACE_RECORDS           (32UL)
+#endif
+#define TRACE_INDEX_MASK        (TRACE_RECORDS - 1UL)
+
+/* Dump header: "I2CT" read as a little-endian word */
+#define TRACE_MAGIC             (0x54433249UL)
+#define TRACE_VERSION           (1UL)
+
+/* Record fields: eventStamp holds the event code in the top byte and the
+ * SysTick value (24-bit down counter at clockHz) below it; statusCount holds
+ * the count in the top half and the status bits in the bottom half.
+ */
+#define TRACE_EVENT_SHIFT       (24U)
+#define TRACE_STAMP_MASK        (0xFFFFFFUL)
+#define TRACE_COUNT_SHIFT       (16U)
+#define TRACE_STATUS_MASK       (0xFFFFUL)
+
+/* Event codes                     status                  count */
+#define TRACE_M_WRITE           (0x01UL)  /* Slave address  Bytes to write */
+#define TRACE_M_READ            (0x02UL)  /* Slave address  Bytes to read */
+#define TRACE_M_WR_CMPLT        (0x03UL)  /* masterStatus   Bytes transferred */
+#define TRACE_M_RD_CMPLT        (0x04UL)  /* masterStatus   Bytes transferred */
+#define TRACE_M_ERR             (0x05UL)  /* masterStatus   Bytes transferred */
+#define TRACE_M_TIMEOUT         (0x06UL)  /* masterStatus   Bytes transferred */
+#define TRACE_M_DONE            (0x07UL)  /* TRANSFER_*     - */
+#define TRACE_M_RETRY           (0x08UL)  /* I2C_FAULT_*    Attempt */
+#define TRACE_M_RECOVER         (0x09UL)  /* I2C_BUS_*      - */
+#define TRACE_S_ACCESS          (0x10UL)  /* ezi2cState     Writes received */
+#define TRACE_S_FRAME           (0x11UL)  /* STS_*          Frame SEQ */
+
+#if I2C_TRACE
+#define TRACE_INIT()            initTrace()
+#define TRACE_EVENT(event, status, count) RecordTraceEvent((event), (status), (count))
+#else
+#define TRACE_INIT()            ((void)0)
+#define TRACE_EVENT(event, status, count) ((void)0)
+#endif
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t eventStamp;
+    uint32_t statusCount;
+} i2c_trace_record_t;
+
+/* The trace is dumped as the raw bytes of this structure, for example with
+ * the debugger, and decoded by host/trace_decode.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t records;           /* TRACE_RECORDS */
+    uint32_t clockHz;           /* SysTick clock */
+    volatile uint32_t head;     /* Records written since initTrace() */
+    i2c_trace_record_t ring[TRACE_RECORDS];
+} i2c_trace_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#if I2C_TRACE
+void initTrace(void);
+void RecordTraceEvent(uint32_t event, uint32_t status, uint32_t count);
+i2c_trace_t const* GetTrace(void);
+#endif
+
+#endif /* SOURCE_I2CTRACE_H_ */
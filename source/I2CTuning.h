@@ -0,0 +1,87 @@
+/******************************************************************************
+* File Name:   I2CTuning.h
+*
+* Description: This file provides the bus configuration of the target: the
+*              slave addresses, data rate and sub-address size set in its
+*              design.modus. They come from the i2c_tuning.h header that
+*              host/gen_tuning.py generates next to design.modus, or from
+*              the defaults below when the BSP has none.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_I2CTUNING_H_
+#define SOURCE_I2CTUNING_H_
+
+#if defined(__has_include)
+#if __has_include("i2c_tuning.h")
+#include "i2c_tuning.h"
+#endif
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Defaults: the settings every design.modus of this example ships with */
+#ifndef I2C_TUNING_MASTER_DATA_RATE_HZ
+#define I2C_TUNING_MASTER_DATA_RATE_HZ  (400000UL)
+#endif
+/* Fastest data rate of the part; Fast-mode Plus only where the generator
+ * found the pins and clocks for it
+ */
+#ifndef I2C_TUNING_MAX_DATA_RATE_HZ
+#define I2C_TUNING_MAX_DATA_RATE_HZ     (400000UL)
+#endif
+#ifndef I2C_TUNING_SLAVE_ADDR
+#define I2C_TUNING_SLAVE_ADDR           (0x08U)
+#endif
+#ifndef I2C_TUNING_TELEMETRY_ADDR
+#define I2C_TUNING_TELEMETRY_ADDR       (0x09U)
+#endif
+#ifndef I2C_TUNING_EZI2C_ADDRESSES
+#define I2C_TUNING_EZI2C_ADDRESSES      (2UL)
+#endif
+#ifndef I2C_TUNING_SUB_ADDR_BYTES
+#define I2C_TUNING_SUB_ADDR_BYTES       (1UL)
+#endif
+
+/* Largest stream payload; the EZI2C slave keeps a buffer of this size */
+#ifndef I2C_TUNING_STREAM_MAX_SIZE
+#define I2C_TUNING_STREAM_MAX_SIZE      (1024UL)
+#endif
+
+#endif /* SOURCE_I2CTUNING_H_ */
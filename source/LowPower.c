@@ -0,0 +1,253 @@
+/******************************************************************************
+* File Name:   LowPower.c
+*
+* Description: This file contains the low-power idle between master commands.
+*              The WDT, clocked by the ILO, times the idle period and the
+*              device waits in Deep Sleep, or in Sleep when a driver refuses
+*              Deep Sleep. The EZI2C slave wakes the device on an address
+*              match.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include "LowPower.h"
+#include "I2CSlave.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* WDT interrupt */
+#define WDT_INTR_NUM            srss_interrupt_wdt_IRQn
+#define WDT_INTR_PRIORITY       (3UL)
+
+/* Nominal ILO frequency. The ILO is not trimmed, so idle periods are
+ * approximate.
+ */
+#define ILO_FREQ_HZ             (40000UL)
+#define MS_PER_SEC              (1000UL)
+#define ILO_TICKS_PER_MS        (ILO_FREQ_HZ / MS_PER_SEC)
+
+/* Longest idle period whose tick count fits 32 bits, about 29 hours */
+#define IDLE_DELAY_MAX_MS       (UINT32_MAX / ILO_TICKS_PER_MS)
+
+/* Longest period of the 16-bit WDT counter; longer idle periods are timed
+ * in several matches.
+ */
+#define WDT_COUNT_MASK          (0xFFFFUL)
+#define WDT_MAX_TICKS           (WDT_COUNT_MASK)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* WDT ticks of the idle period not yet armed, and expiry flag */
+static volatile uint32_t idleTicksLeft = 0UL;
+static volatile bool idleExpired = true;
+
+static low_power_stats_t lowPowerStats;
+
+/*******************************************************************************
+* Function Declaration
+*******************************************************************************/
+void WDT_InterruptHandler(void);
+static void ArmIdleTimer(void);
+
+/*******************************************************************************
+* Function Name: ArmIdleTimer
+****************************************************************************//**
+*
+* Summary:
+*   Sets the WDT match for the next part of the idle period.
+*
+*******************************************************************************/
+static void ArmIdleTimer(void)
+{
+    uint32_t ticks = (idleTicksLeft > WDT_MAX_TICKS) ? WDT_MAX_TICKS : idleTicksLeft;
+
+    idleTicksLeft -= ticks;
+    Cy_WDT_SetMatch((Cy_WDT_GetCount() + ticks) & WDT_COUNT_MASK);
+}
+
+/*******************************************************************************
+* Function Name: WDT_InterruptHandler
+****************************************************************************//**
+*
+* Summary:
+*   WDT match: arms the rest of the idle period, or ends it.
+*
+*******************************************************************************/
+void WDT_InterruptHandler(void)
+{
+    Cy_WDT_ClearInterrupt();
+    lowPowerStats.timerWakeups++;
+
+    if (0UL != idleTicksLeft)
+    {
+        ArmIdleTimer();
+    }
+    else
+    {
+        idleExpired = true;
+    }
+}
+
+/*******************************************************************************
+* Function Name: StartIdleTimer
+****************************************************************************//**
+*
+* Summary:
+*   Starts an idle period of delayMs. IsIdleTimerExpired() turns true when it
+*   is over. A period longer than IDLE_DELAY_MAX_MS is cut to it.
+*
+*******************************************************************************/
+void StartIdleTimer(uint32_t delayMs)
+{
+    NVIC_DisableIRQ(WDT_INTR_NUM);
+
+    idleTicksLeft = ((delayMs < IDLE_DELAY_MAX_MS) ? delayMs : IDLE_DELAY_MAX_MS) * ILO_TICKS_PER_MS;
+    idleExpired   = (0UL == idleTicksLeft);
+    if (!idleExpired)
+    {
+        ArmIdleTimer();
+    }
+    Cy_WDT_ClearInterrupt();
+
+    NVIC_EnableIRQ(WDT_INTR_NUM);
+}
+
+/*******************************************************************************
+* Function Name: IsIdleTimerExpired
+****************************************************************************//**
+*
+* Summary:
+*   Returns true when the idle period started by StartIdleTimer() is over.
+*
+*******************************************************************************/
+bool IsIdleTimerExpired(void)
+{
+    return (idleExpired);
+}
+
+/*******************************************************************************
+* Function Name: EnterLowPowerIdle
+****************************************************************************//**
+*
+* Summary:
+*   Waits for the next interrupt in Deep Sleep, or in Sleep if a driver
+*   refuses Deep Sleep (a transfer is in progress). Returns at once if the
+*   idle period is over. The expiry is checked with interrupts disabled, so
+*   a WDT match that comes before the WFI still wakes it; the ISRs run when
+*   interrupts are enabled again on the way out.
+*
+* Return:
+*   LP_MODE_DEEPSLEEP, LP_MODE_SLEEP or LP_MODE_NONE.
+*
+*******************************************************************************/
+uint32_t EnterLowPowerIdle(void)
+{
+    uint32_t mode = LP_MODE_NONE;
+
+    __disable_irq();
+    if (!idleExpired)
+    {
+        if (CY_SYSPM_SUCCESS == Cy_SysPm_CpuEnterDeepSleep())
+        {
+            lowPowerStats.deepSleeps++;
+            mode = LP_MODE_DEEPSLEEP;
+        }
+        else
+        {
+            (void)Cy_SysPm_CpuEnterSleep();
+            lowPowerStats.sleeps++;
+            mode = LP_MODE_SLEEP;
+        }
+    }
+    __enable_irq();
+
+    return (mode);
+}
+
+/*******************************************************************************
+* Function Name: GetLowPowerStats
+****************************************************************************//**
+*
+* Summary:
+*   Returns the Deep Sleep, Sleep and WDT wakeup counters.
+*
+*******************************************************************************/
+low_power_stats_t const* GetLowPowerStats(void)
+{
+    return (&lowPowerStats);
+}
+
+/*******************************************************************************
+* Function Name: initLowPower
+****************************************************************************//**
+*
+* Summary:
+*   Hooks the WDT interrupt and starts the WDT. Call it after initSlave()
+*   and initMaster(), which register the Deep Sleep callbacks of the SCBs.
+*
+* Return:
+*   Status of initialization.
+*
+*******************************************************************************/
+uint32_t initLowPower(void)
+{
+    cy_stc_sysint_t wdtIrqCfg =
+    {
+            /*.intrSrc =*/ WDT_INTR_NUM,
+            /*.intrPriority =*/ WDT_INTR_PRIORITY
+    };
+
+    if (CY_SYSINT_SUCCESS != Cy_SysInt_Init(&wdtIrqCfg, &WDT_InterruptHandler))
+    {
+        return I2C_FAILURE;
+    }
+
+    lowPowerStats = (low_power_stats_t){ 0UL };
+    idleTicksLeft = 0UL;
+    idleExpired   = true;
+
+    Cy_WDT_ClearInterrupt();
+    Cy_WDT_UnmaskInterrupt();
+    Cy_WDT_Enable();
+    NVIC_EnableIRQ(WDT_INTR_NUM);
+
+    return I2C_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,76 @@
+/******************************************************************************
+* File Name:   LowPower.h
+*
+* Description: This file provides the constants and prototypes of the
+*              low-power idle between master commands.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2020-2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SOURCE_LOWPOWER_H_
+#define SOURCE_LOWPOWER_H_
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Power mode used by EnterLowPowerIdle() */
+#define LP_MODE_NONE            (0UL)   /* Idle timer already expired */
+#define LP_MODE_SLEEP           (1UL)
+#define LP_MODE_DEEPSLEEP       (2UL)
+
+/*******************************************************************************
+* Data types
+*******************************************************************************/
+typedef struct
+{
+    uint32_t deepSleeps;
+    uint32_t sleeps;        /* Deep Sleep refused by a driver, Sleep used */
+    uint32_t timerWakeups;  /* WDT matches, including intermediate ones */
+} low_power_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint32_t initLowPower(void);
+void StartIdleTimer(uint32_t delayMs);
+bool IsIdleTimerExpired(void);
+uint32_t EnterLowPowerIdle(void);
+low_power_stats_t const* GetLowPowerStats(void);
+
+#endif /* SOURCE_LOWPOWER_H_ */
@@ -45,6 +45,10 @@
 #include "cybsp.h"
 #include "I2CMaster.h"
 #include "I2CSlave.h"
+#include "I2CDataRate.h"
+#include "LowPower.h"
+#include "I2CPipeline.h"
+#include "I2CTrace.h"
 
 /*******************************************************************************
 * Macros
@@ -53,8 +57,37 @@
 #define OFF                     CYBSP_LED_STATE_OFF
 #define ON                      CYBSP_LED_STATE_ON
 
-/* Delay duration */
-#define CMD_TO_CMD_DELAY        (1000UL)
+/* Time from one command to the next, in ms; 0 sends them back to back */
+#define CMD_PERIOD_MS           (1000UL)
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static uint8_t cmd = ON;
+
+/*******************************************************************************
+* Function Name: NextLedCommand
+****************************************************************************//**
+*
+* Summary:
+*   Application task of the pipeline: builds the command packet that turns
+*   the LED to the other state.
+*
+* Parameters:
+*   master: Master handle the packet is sent on
+*   frame: Packet buffer, WRITE_PACKET_SIZE bytes
+*
+* Return:
+*   Size of the packet.
+*
+*******************************************************************************/
+static uint32_t NextLedCommand(i2c_master_t* master, uint8_t* frame)
+{
+    uint32_t size = PrepareCommandPacket(master, frame, cmd);
+
+    cmd = (cmd == ON) ? OFF : ON;
+    return (size);
+}
 
 /*******************************************************************************
  * Function Name: main
@@ -62,12 +95,13 @@
  *
  *  The main function performs the following actions:
  *   1. Initializes the BSP
- *   2. Calls the functions to set up I2C Master and EZI2C Slave.
- *   3. Sets up the command packet to be sent to the slave.
- *   4. I2C Master send the packet to EZI2C Slave and received the status
- *      packet.
- *   5. Changes the status of the LED depending on the command received.
- *   6. Updates the command packet.
+ *   2. Calls the functions to set up I2C Master and EZI2C Slave, and
+ *      probes the fastest data rate the bus runs at without errors.
+ *   3. Sets up the pipeline that builds a command every CMD_PERIOD_MS.
+ *   4. Runs the pipeline: the I2C Master sends each command and reads the
+ *      status packet in one transaction while the EZI2C Slave executes
+ *      the previous command and changes the status of the LED.
+ *   5. Waits for the next command in Deep Sleep.
  *
  ******************************************************************************/
 int main(void)
@@ -81,9 +115,10 @@ int main(void)
         CY_ASSERT(0);
     }
 
-    uint8_t cmd = ON;
     uint32_t status;
-    uint8_t buffer[WRITE_PACKET_SIZE];
+
+    /* Bus event trace, recorded from here on */
+    TRACE_INIT();
 
     /* Initiate and enable Slave and Master SCBs */
     status = initSlave();
@@ -96,41 +131,50 @@ int main(void)
     {
         handle_error();
     }
+    status = initLowPower();
+    if(status != I2C_SUCCESS)
+    {
+        handle_error();
+    }
 
     /* Enable interrupts */
     __enable_irq();
 
+    /* Run the bus as fast as the wiring allows, down to 100 kHz */
+    (void)ProbeDataRate(I2C_DATA_RATE_MAX_HZ);
+
+    /* Master, slave and application tasks of the main loop */
+    status = initPipeline(&CYBSP_I2C_master, &NextLedCommand, CMD_PERIOD_MS);
+    if(status != I2C_SUCCESS)
+    {
+        handle_error();
+    }
+
     for(;;)
     {
-        /* Create packet to be sent to slave.  */
-        buffer[PACKET_ADDR_POS] = EZI2C_BUFFER_ADDRESS;
-        buffer[PACKET_SOP_POS] = PACKET_SOP;
-        buffer[PACKET_EOP_POS] = PACKET_EOP;
-        buffer[PACKET_CMD_POS] = cmd;
-
-        /* Send packet with command to the slave */
-        if (TRANSFER_CMPLT == WritePacketToEzI2C(buffer, WRITE_PACKET_SIZE))
+        /* Each call advances every task by one step without waiting: the
+         * master sends the next command and reads the status packet back in
+         * the same transaction (repeated START), while the slave function
+         * checks the EZI2C buffer for the command received before and
+         * changes the status of the LED. The slave function is implemented
+         * in this code example so that the master function can be tested
+         * without the need of one more kit.
+         */
+        status = RunPipeline();
+        if (PIPELINE_IDLE == status)
         {
-            /* The below code is for slave function. It is implemented in
-             * this code example so that the master function can be tested
-             * without the need of one more kit.
+            /* Sleep until the next command is due. The WDT ends the idle
+             * period; a master addressing the slave wakes the device in
+             * between, and the slave buffer is checked after every wakeup.
              */
-
-            /* Read response packet from the slave */
-            if (TRANSFER_CMPLT == ReadStatusPacketFromEzI2C())
-            {
-                /* Next command to be written */
-                cmd = (cmd == ON) ? OFF : ON;
-            }
-
-            /* Check the EZI2C Slave buffer for the received command. If
-             * the received packet is valid, change the status of LED
-             * based on the command received.
+            (void)EnterLowPowerIdle();
+        }
+        else if (PIPELINE_ERROR == status)
+        {
+            /* The bus failed: step down to a rate it runs at. The command
+             * is sent again on the next call.
              */
-            CheckEzI2Cbuffer();
-
-            /* Give 1 Second delay between commands */
-            Cy_SysLib_Delay(CMD_TO_CMD_DELAY);
+            (void)ProbeDataRate(GetDataRate());
         }
     }
 }
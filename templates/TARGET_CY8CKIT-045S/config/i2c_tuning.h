@@ -0,0 +1,31 @@
+/******************************************************************************
+* File Name:   i2c_tuning.h
+*
+* Description: Bus configuration generated by host/gen_tuning.py from the
+*              design.modus of TARGET_CY8CKIT-045S. Do not edit; run
+*              the generator again after changing the CYBSP_I2C or
+*              CYBSP_EZI2C settings.
+*
+*              Timing at the master data rate:
+*                byte on the wire         : 22.5 us
+*                bytes per master ISR     : 8 (FIFOs enabled)
+*                master ISR latency budget: 180.0 us
+*                master SCB clock         : 9.600 MHz
+*                EZI2C SCB clock          : 12.000 MHz
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+
+#ifndef I2C_TUNING_H_
+#define I2C_TUNING_H_
+
+#define I2C_TUNING_MASTER_DATA_RATE_HZ  (400000UL)
+#define I2C_TUNING_MAX_DATA_RATE_HZ     (1000000UL)
+#define I2C_TUNING_SLAVE_ADDR           (0x08U)
+#define I2C_TUNING_TELEMETRY_ADDR       (0x09U)
+#define I2C_TUNING_EZI2C_ADDRESSES      (2UL)
+#define I2C_TUNING_SUB_ADDR_BYTES       (1UL)
+#define I2C_TUNING_STREAM_MAX_SIZE      (1024UL)
+
+#endif /* I2C_TUNING_H_ */